@@ -11,6 +11,7 @@ import numpy as np
 if __name__ != "__main__":
     import pxr
     import omni
+    import carb
     from pxr import UsdGeom, Gf, Usd
     from omni.syntheticdata import sensors, _syntheticdata
 else:
@@ -31,6 +32,7 @@ else:
 XR_KHR_OPENGL_ENABLE_EXTENSION_NAME = "XR_KHR_opengl_enable"
 XR_KHR_OPENGL_ES_ENABLE_EXTENSION_NAME = "XR_KHR_opengl_es_enable"
 XR_KHR_VULKAN_ENABLE_EXTENSION_NAME = "XR_KHR_vulkan_enable"
+XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME = "XR_KHR_vulkan_enable2"
 XR_KHR_D3D11_ENABLE_EXTENSION_NAME = "XR_KHR_D3D11_enable"
 XR_KHR_D3D12_ENABLE_EXTENSION_NAME = "XR_KHR_D3D12_enable"
 
@@ -43,6 +45,7 @@ XR_ENVIRONMENT_BLEND_MODE_ALPHA_BLEND = 3
 
 XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO = 1
 XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO = 2
+XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO = 1000037000
 
 XR_REFERENCE_SPACE_TYPE_VIEW = 1    # +Y up, +X to the right, and -Z forward
 XR_REFERENCE_SPACE_TYPE_LOCAL = 2   # +Y up, +X to the right, and -Z forward
@@ -59,6 +62,68 @@ XR_INFINITE_DURATION = 2**32
 XR_MIN_HAPTIC_DURATION = -1
 XR_FREQUENCY_UNSPECIFIED = 0
 
+XR_EXT_PERFORMANCE_SETTINGS_EXTENSION_NAME = "XR_EXT_performance_settings"
+XR_EXT_THERMAL_QUERY_EXTENSION_NAME = "XR_EXT_thermal_query"
+
+XR_PERF_SETTINGS_DOMAIN_CPU_EXT = 1
+XR_PERF_SETTINGS_DOMAIN_GPU_EXT = 2
+
+XR_PERF_SETTINGS_SUB_DOMAIN_COMPOSITING_EXT = 1
+XR_PERF_SETTINGS_SUB_DOMAIN_RENDERING_EXT = 2
+XR_PERF_SETTINGS_SUB_DOMAIN_THERMAL_EXT = 3
+
+XR_PERF_SETTINGS_LEVEL_POWER_SAVINGS_EXT = 0
+XR_PERF_SETTINGS_LEVEL_SUSTAINED_LOW_EXT = 25
+XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIGH_EXT = 50
+XR_PERF_SETTINGS_LEVEL_BOOST_EXT = 75
+
+XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT = 0
+XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT = 25
+XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT = 75
+
+XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME = "XR_KHR_composition_layer_depth"
+XR_KHR_COMPOSITION_LAYER_CYLINDER_EXTENSION_NAME = "XR_KHR_composition_layer_cylinder"
+XR_KHR_COMPOSITION_LAYER_EQUIRECT2_EXTENSION_NAME = "XR_KHR_composition_layer_equirect2"
+XR_KHR_COMPOSITION_LAYER_CUBE_EXTENSION_NAME = "XR_KHR_composition_layer_cube"
+XR_KHR_COMPOSITION_LAYER_COLOR_SCALE_BIAS_EXTENSION_NAME = "XR_KHR_composition_layer_color_scale_bias"
+
+XR_KHR_VISIBILITY_MASK_EXTENSION_NAME = "XR_KHR_visibility_mask"
+
+XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR = 1
+XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR = 2
+XR_VISIBILITY_MASK_TYPE_LINE_LOOP_KHR = 3
+
+XR_FB_SPACE_WARP_EXTENSION_NAME = "XR_FB_space_warp"
+
+XR_VARJO_QUAD_VIEWS_EXTENSION_NAME = "XR_VARJO_quad_views"
+
+XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME = "XR_FB_display_refresh_rate"
+
+XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME = "XR_MSFT_composition_layer_reprojection"
+
+XR_REPROJECTION_MODE_DEPTH_MSFT = 1
+XR_REPROJECTION_MODE_PLANAR_FROM_DEPTH_MSFT = 2
+XR_REPROJECTION_MODE_PLANAR_MANUAL_MSFT = 3
+XR_REPROJECTION_MODE_ORIENTATION_ONLY_MSFT = 4
+
+XR_EXT_DEBUG_UTILS_EXTENSION_NAME = "XR_EXT_debug_utils"
+XR_MNDX_EGL_ENABLE_EXTENSION_NAME = "XR_MNDX_egl_enable"
+XR_MND_HEADLESS_EXTENSION_NAME = "XR_MND_headless"
+
+STARTUP_PHASES = ["enumeration", "instance", "system", "graphics binding", "graphics resources", 
+                  "session", "reference spaces", "interaction profiles", "action spaces", "swapchains"]
+
+GRAPHICS_BACKEND_OPENGL = 0
+GRAPHICS_BACKEND_VULKAN = 1
+GRAPHICS_BACKEND_HEADLESS = 2
+
+GRAPHICS_BACKENDS = {"OpenGL": GRAPHICS_BACKEND_OPENGL, "Vulkan": GRAPHICS_BACKEND_VULKAN, "Headless": GRAPHICS_BACKEND_HEADLESS}
+
+LOG_LEVEL_DEBUG = 0
+LOG_LEVEL_INFO = 1
+LOG_LEVEL_WARNING = 2
+LOG_LEVEL_ERROR = 3
+
 
 def acquire_openxr_interface(disable_openxr: bool = False):
     return OpenXR(disable_openxr)
@@ -68,6 +133,60 @@ def release_openxr_interface(xr):
         xr.destroy()
         xr = None
 
+def get_available_graphics_backends(use_ctypes: bool = False, disable_openxr: bool = False) -> list:
+    """
+    Get the graphics backends compiled in the library (e.g. to list only the selectable backends in a user interface)
+
+    Parameters
+    ----------
+    use_ctypes: bool, optional
+        If true, use ctypes as C/C++ interface instead of pybind11 (default)
+    disable_openxr: bool, optional
+        If true, the library is not loaded and all the backends are listed (default: False)
+
+    Returns
+    -------
+    list of str
+        Names of the available graphics backends (OpenGL, Vulkan or Headless). Empty if the library cannot be loaded
+    """
+    if disable_openxr:
+        return list(GRAPHICS_BACKENDS.keys())
+    try:
+        lib = _load_library(use_ctypes)
+    except Exception as e:
+        print("[ERROR] OpenXR library:", e)
+        return []
+    return [name for name, backend in GRAPHICS_BACKENDS.items() if bool(lib.isGraphicsBackendAvailable(backend) if use_ctypes else lib.OpenXrApplication.isGraphicsBackendAvailable(backend))]
+
+def _load_library(use_ctypes: bool):
+    # libraries path
+    if __name__ == "__main__":
+        extension_path = os.getcwd()[:os.getcwd().find("/semu/xr/openxr")]
+    else:
+        extension_path = __file__[:__file__.find("/semu/xr/openxr")]
+
+    # ctypes
+    if use_ctypes:
+        ctypes.PyDLL(os.path.join(extension_path, "bin", "libGL.so"), mode = ctypes.RTLD_GLOBAL)
+        ctypes.PyDLL(os.path.join(extension_path, "bin", "libSDL2.so"), mode = ctypes.RTLD_GLOBAL)
+        ctypes.PyDLL(os.path.join(extension_path, "bin", "libopenxr_loader.so"), mode = ctypes.RTLD_GLOBAL)
+        return ctypes.PyDLL(os.path.join(extension_path, "bin", "xrlib_c.so"), mode = ctypes.RTLD_GLOBAL)
+
+    # pybind11
+    sys.setdlopenflags(os.RTLD_GLOBAL | os.RTLD_LAZY)
+    if os.path.join(extension_path, "bin") not in sys.path:
+        sys.path.append(os.path.join(extension_path, "bin"))
+    # change cwd
+    tmp_dir= os.getcwd()
+    os.chdir(extension_path)
+    #import library
+    try:
+        import xrlib_p
+    finally:
+        #restore cwd
+        os.chdir(tmp_dir)
+    return xrlib_p
+
 
 
 
@@ -78,6 +197,12 @@ XrStructureType = ctypes.c_int
 class XrQuaternionf(ctypes.Structure):
     _fields_ = [('x', ctypes.c_float), ('y', ctypes.c_float), ('z', ctypes.c_float), ('w', ctypes.c_float)]
 
+class XrColor4f(ctypes.Structure):
+    _fields_ = [('r', ctypes.c_float), ('g', ctypes.c_float), ('b', ctypes.c_float), ('a', ctypes.c_float)]
+
+class XrVector2f(ctypes.Structure):
+    _fields_ = [('x', ctypes.c_float), ('y', ctypes.c_float)]
+
 class XrVector3f(ctypes.Structure):
     _fields_ = [('x', ctypes.c_float), ('y', ctypes.c_float), ('z', ctypes.c_float)]
 
@@ -124,15 +249,17 @@ class OpenXR:
         self._app = None
 
         self._graphics = None
+        self._graphics_backend = GRAPHICS_BACKEND_OPENGL
         self._use_ctypes = False
         
-        # views
-        self._prim_left = None
-        self._prim_right = None
-        self._frame_left = None
-        self._frame_right = None
-        self._viewport_window_left = None
-        self._viewport_window_right = None
+        # views (mono: 0, stereo: 0 left and 1 right, quad views: 0 and 1 context, 2 and 3 inner foveal)
+        self._prims = []
+        self._frames = []
+        self._depths = []
+        self._space_warp_frames = None
+        self._layer_frames = {}
+        self._viewport_windows = []
+        self._inner_view_ratios = {}
 
         self._meters_per_unit = 1.0
         self._reference_position = Gf.Vec3d(0, 0, 0)
@@ -150,6 +277,21 @@ class OpenXR:
         self._callback_action_pose_events = {}
         self._callback_middle_render = None
         self._callback_render = None
+        self._callback_middle_performance_settings = None
+        self._callback_performance_settings = None
+        self._callback_middle_log = None
+        self._callback_log = None
+        self._callback_middle_display_refresh_rate = None
+        self._callback_display_refresh_rate = None
+
+        # performance settings (render resolution scale and render rate divisor by notification level)
+        self._performance_settings_policy = {XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT: (1.0, 1),
+                                             XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT: (0.75, 1),
+                                             XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT: (0.5, 2)}
+        self._performance_settings_levels = {}
+        self._render_scale = 1.0
+        self._render_rate_divisor = 1
+        self._render_counter = 0
 
     def init(self, graphics: str = "OpenGL", use_ctypes: bool = False) -> bool:
         """
@@ -158,8 +300,9 @@ class OpenXR:
         Parameters
         ----------
         graphics: str
-            OpenXR graphics API supported by the runtime (OpenGL, OpenGLES, Vulkan, D3D11, D3D12).
-            Note: At the moment only OpenGL is available
+            OpenXR graphics API supported by the runtime (OpenGL, OpenGLES, Vulkan, D3D11, D3D12) or Headless (tracking-only session).
+            Note: At the moment only OpenGL, Vulkan (if compiled in the library, see get_available_graphics_backends) and Headless are available.
+            The backend is selected at runtime, without rebuilding the library
         use_ctypes: bool, optional
             If true, use ctypes as C/C++ interface instead of pybind11 (default)
 
@@ -175,17 +318,21 @@ class OpenXR:
             print("[INFO] Using legacy viewport interface")
             self._viewport_interface = omni.kit.viewport_legacy.get_viewport_interface()
 
-        # TODO: what about no graphic API (only controllers for example)?
         self._use_ctypes = use_ctypes
         # graphics API
         if graphics in ["OpenGL", XR_KHR_OPENGL_ENABLE_EXTENSION_NAME]:
             self._graphics = XR_KHR_OPENGL_ENABLE_EXTENSION_NAME
+            self._graphics_backend = GRAPHICS_BACKEND_OPENGL
         elif graphics in ["OpenGLES", XR_KHR_OPENGL_ES_ENABLE_EXTENSION_NAME]:
             self._graphics = XR_KHR_OPENGL_ES_ENABLE_EXTENSION_NAME
             raise NotImplementedError("OpenGLES graphics API is not implemented yet")
-        elif graphics in ["Vulkan", XR_KHR_VULKAN_ENABLE_EXTENSION_NAME]:
-            self._graphics = XR_KHR_VULKAN_ENABLE_EXTENSION_NAME
-            raise NotImplementedError("Vulkan graphics API is not implemented yet")
+        elif graphics in ["Vulkan", XR_KHR_VULKAN_ENABLE_EXTENSION_NAME, XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME]:
+            self._graphics = XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME
+            self._graphics_backend = GRAPHICS_BACKEND_VULKAN
+        elif graphics in ["Headless", XR_MND_HEADLESS_EXTENSION_NAME]:
+            # the graphics extension of the fallback backend is enabled by the library if supported by the runtime
+            self._graphics = None
+            self._graphics_backend = GRAPHICS_BACKEND_HEADLESS
         elif graphics in ["D3D11", XR_KHR_D3D11_ENABLE_EXTENSION_NAME]:
             self._graphics = XR_KHR_D3D11_ENABLE_EXTENSION_NAME
             raise NotImplementedError("D3D11 graphics API is not implemented yet")
@@ -193,47 +340,36 @@ class OpenXR:
             self._graphics = XR_KHR_D3D12_ENABLE_EXTENSION_NAME
             raise NotImplementedError("D3D12 graphics API is not implemented yet")
         else:
-            raise ValueError("Invalid graphics API ({}). Valid graphics APIs are OpenGL, OpenGLES, Vulkan, D3D11, D3D12".format(graphics))
+            raise ValueError("Invalid graphics API ({}). Valid graphics APIs are OpenGL, OpenGLES, Vulkan, D3D11, D3D12 and Headless".format(graphics))
 
-        # libraries path
-        if __name__ == "__main__":
-            extension_path = os.getcwd()[:os.getcwd().find("/semu/xr/openxr")]
-        else:
-            extension_path = __file__[:__file__.find("/semu/xr/openxr")]
-        
         if self._disable_openxr:
             return True
 
         try:
+            self._lib = _load_library(self._use_ctypes)
             # ctypes
             if self._use_ctypes:
-                ctypes.PyDLL(os.path.join(extension_path, "bin", "libGL.so"), mode = ctypes.RTLD_GLOBAL)
-                ctypes.PyDLL(os.path.join(extension_path, "bin", "libSDL2.so"), mode = ctypes.RTLD_GLOBAL)
-                ctypes.PyDLL(os.path.join(extension_path, "bin", "libopenxr_loader.so"), mode = ctypes.RTLD_GLOBAL)
-                
-                self._lib = ctypes.PyDLL(os.path.join(extension_path, "bin", "xrlib_c.so"), mode = ctypes.RTLD_GLOBAL)
                 self._app = self._lib.openXrApplication()
                 print("[INFO] OpenXR initialized using ctypes interface")
-            
             # pybind11
             else:
-                sys.setdlopenflags(os.RTLD_GLOBAL | os.RTLD_LAZY)
-                sys.path.append(os.path.join(extension_path, "bin"))
-                # change cwd
-                tmp_dir= os.getcwd()
-                os.chdir(extension_path)
-                #import library
-                import xrlib_p
-                #restore cwd
-                os.chdir(tmp_dir)
-
-                self._lib = xrlib_p
-                self._app = xrlib_p.OpenXrApplication()
+                self._app = self._lib.OpenXrApplication()
                 print("[INFO] OpenXR initialized using pybind11 interface")
         except Exception as e:
             print("[ERROR] OpenXR initialization:", e)
             return False
 
+        # select the graphics backend (all the graphics APIs compiled in the library are available)
+        if self._use_ctypes:
+            status = bool(self._lib.setGraphicsBackend(self._app, self._graphics_backend))
+        else:
+            status = self._app.setGraphicsBackend(self._graphics_backend)
+        if not status:
+            print("[ERROR] OpenXR initialization: {} graphics backend is not available".format(graphics))
+            return False
+
+        # route the library log messages into the Kit's logger
+        self.subscribe_log_event()
         return True
 
     def destroy(self) -> bool:
@@ -246,6 +382,8 @@ class OpenXR:
             True if destruction was successful, otherwise False
         """
         if self._app is not None:
+            # the log messages are written to stdout once the Python callback is released
+            self.subscribe_log_event(None)
             if self._use_ctypes:
                 return bool(self._lib.destroy(self._app))
             else:
@@ -292,6 +430,7 @@ class OpenXR:
             [Extensions](https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#extensions) to be loaded.
             Note: At the moment only the graphic extensions are configured.
             Note: The graphics API selected during initialization (init) is automatically included in the extensions to be loaded.
+            Note: XR_EXT_performance_settings, XR_EXT_thermal_query and the composition layer extensions (XR_KHR_composition_layer_depth, XR_KHR_composition_layer_cylinder, XR_KHR_composition_layer_equirect2, XR_KHR_composition_layer_cube and XR_KHR_composition_layer_color_scale_bias), XR_KHR_visibility_mask, XR_FB_space_warp, XR_VARJO_quad_views, XR_FB_display_refresh_rate and XR_MSFT_composition_layer_reprojection are automatically loaded if they are supported by the runtime.
         
         Returns
         -------
@@ -301,7 +440,7 @@ class OpenXR:
         if self._disable_openxr:
             return True
 
-        if self._graphics not in extensions:
+        if self._graphics is not None and self._graphics not in extensions:
             extensions += [self._graphics]
         
         if self._use_ctypes:
@@ -343,8 +482,9 @@ class OpenXR:
             Desired [form factor](https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#form_factor_description) from XrFormFactor enum (default: XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY)
         blend_mode: {XR_ENVIRONMENT_BLEND_MODE_OPAQUE, XR_ENVIRONMENT_BLEND_MODE_ADDITIVE, XR_ENVIRONMENT_BLEND_MODE_ALPHA_BLEND}, optional
             Desired environment [blend mode](https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#environment_blend_mode) from XrEnvironmentBlendMode enum (default: XR_ENVIRONMENT_BLEND_MODE_OPAQUE)
-        view_configuration_type: {XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO}, optional
-            Primary [view configuration](https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#view_configurations) type from XrViewConfigurationType enum (default: XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO)
+        view_configuration_type: {XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO}, optional
+            Primary [view configuration](https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#view_configurations) type from XrViewConfigurationType enum (default: XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO).
+            XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO requires the runtime to support XR_VARJO_quad_views
 
         Returns
         -------
@@ -360,9 +500,9 @@ class OpenXR:
             raise ValueError("Invalid blend mode ({}). Valid blend modes are XR_ENVIRONMENT_BLEND_MODE_OPAQUE ({}), XR_ENVIRONMENT_BLEND_MODE_ADDITIVE ({}), XR_ENVIRONMENT_BLEND_MODE_ALPHA_BLEND ({})" \
                              .format(blend_mode, XR_ENVIRONMENT_BLEND_MODE_OPAQUE, XR_ENVIRONMENT_BLEND_MODE_ADDITIVE, XR_ENVIRONMENT_BLEND_MODE_ALPHA_BLEND))
         # check view_configuration_type
-        if not view_configuration_type in [XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO]:
-            raise ValueError("Invalid view configuration type ({}). Valid view configuration types are XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO ({}), XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO ({})" \
-                             .format(view_configuration_type, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO))
+        if not view_configuration_type in [XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO]:
+            raise ValueError("Invalid view configuration type ({}). Valid view configuration types are XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO ({}), XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO ({}), XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO ({})" \
+                             .format(view_configuration_type, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO))
 
         if self._disable_openxr:
             return True
@@ -410,11 +550,17 @@ class OpenXR:
         - xrBeginSession
         - xrEndSession
 
+        Performance settings notifications (XR_EXT_performance_settings) are dispatched to the callback subscribed with subscribe_performance_settings_event.
+        If no callback has been subscribed, an internal callback will be used
+
         Returns
         -------
         bool
             False if the running session needs to end (due to the user closing or switching the application, etc.), otherwise False
         """
+        if self._callback_performance_settings is None:
+            self.subscribe_performance_settings_event()
+
         if self._disable_openxr:
             return True
 
@@ -514,13 +660,9 @@ class OpenXR:
 
         if self._disable_openxr:
             # test sensor reading
-            if self._viewport_window_left is not None:
-                frame_left = sensors.get_rgb(self._viewport_window_left)
-                cv2.imshow("frame_left {}".format(frame_left.shape), frame_left)
-                cv2.waitKey(1)
-            if self._viewport_window_right is not None:
-                frame_right = sensors.get_rgb(self._viewport_window_right)
-                cv2.imshow("frame_right {}".format(frame_right.shape), frame_right)
+            for i, viewport_window in enumerate(self._viewport_windows):
+                frame = sensors.get_rgb(viewport_window)
+                cv2.imshow("frame_{} {}".format(i, frame.shape), frame)
                 cv2.waitKey(1)
             return True
 
@@ -691,232 +833,1598 @@ class OpenXR:
         else:
             return self._app.stopHapticFeedback(path)
 
-    # view utilities
+    # performance utilities
 
-    def setup_mono_view(self, camera: Union[str, pxr.Sdf.Path, pxr.Usd.Prim] = "/OpenXR/Cameras/camera", camera_properties: dict = {"focalLength": 10}) -> None:
+    def set_performance_level(self, domain: int, level: int) -> bool:
         """
-        Setup Omniverse viewport and camera for monoscopic rendering
+        Provide a performance level hint to the runtime for the given domain (XR_EXT_performance_settings)
+
+        OpenXR internal function calls:
+        - xrPerfSettingsSetPerformanceLevelEXT
 
-        This method obtains the viewport window for the given camera. If the viewport window does not exist, a new one is created and the camera is set as active. If the given camera does not exist, a new camera is created with the same path and set to the recommended resolution of the display device
-        
         Parameters
         ----------
-        camera: str, pxr.Sdf.Path or pxr.Usd.Prim, optional
-            Omniverse camera prim or path (default: '/OpenXR/Cameras/camera')
-        camera_properties: dict
-            Dictionary containing the [camera properties](https://docs.omniverse.nvidia.com/app_create/prod_materials-and-rendering/cameras.html#camera-properties) supported by the Omniverse kit to be set (default: {"focalLength": 10})
+        domain: {XR_PERF_SETTINGS_DOMAIN_CPU_EXT, XR_PERF_SETTINGS_DOMAIN_GPU_EXT}
+            Processing domain from XrPerfSettingsDomainEXT enum
+        level: {XR_PERF_SETTINGS_LEVEL_POWER_SAVINGS_EXT, XR_PERF_SETTINGS_LEVEL_SUSTAINED_LOW_EXT, XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIGH_EXT, XR_PERF_SETTINGS_LEVEL_BOOST_EXT}
+            Performance level from XrPerfSettingsLevelEXT enum
+
+        Returns
+        -------
+        bool
+            True if the performance level has been set, otherwise False (e.g. the extension is not supported by the runtime)
         """
-        self.setup_stereo_view(camera, None, camera_properties)
+        if not domain in [XR_PERF_SETTINGS_DOMAIN_CPU_EXT, XR_PERF_SETTINGS_DOMAIN_GPU_EXT]:
+            raise ValueError("Invalid performance settings domain ({}). Valid domains are XR_PERF_SETTINGS_DOMAIN_CPU_EXT ({}), XR_PERF_SETTINGS_DOMAIN_GPU_EXT ({})" \
+                             .format(domain, XR_PERF_SETTINGS_DOMAIN_CPU_EXT, XR_PERF_SETTINGS_DOMAIN_GPU_EXT))
 
-    def setup_stereo_view(self, left_camera: Union[str, pxr.Sdf.Path, pxr.Usd.Prim] = "/OpenXR/Cameras/left_camera", right_camera: Union[str, pxr.Sdf.Path, pxr.Usd.Prim, None] = "/OpenXR/Cameras/right_camera", camera_properties: dict = {"focalLength": 10}) -> None:
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            return bool(self._lib.setPerformanceLevel(self._app, domain, level))
+        else:
+            return self._app.setPerformanceLevel(domain, level)
+
+    def get_thermal_temperature_trend(self, domain: int) -> Union[dict, None]:
         """
-        Setup Omniverse viewports and cameras for stereoscopic rendering
+        Query the current temperature warning level and trend for the given domain (XR_EXT_thermal_query)
+
+        OpenXR internal function calls:
+        - xrThermalGetTemperatureTrendEXT
 
-        This method obtains the viewport window for each camera. If the viewport window does not exist, a new one is created and the camera is set as active. If the given cameras do not exist, new cameras are created with the same path and set to the recommended resolution of the display device
-        
         Parameters
         ----------
-        left_camera: str, pxr.Sdf.Path or pxr.Usd.Prim, optional
-            Omniverse left camera prim or path (default: '/OpenXR/Cameras/left_camera')
-        right_camera: str, pxr.Sdf.Path or pxr.Usd.Prim, optional
-            Omniverse right camera prim or path (default: '/OpenXR/Cameras/right_camera')
-        camera_properties: dict
-            Dictionary containing the [camera properties](https://docs.omniverse.nvidia.com/app_create/prod_materials-and-rendering/cameras.html#camera-properties) supported by the Omniverse kit to be set (default: {"focalLength": 10})
+        domain: {XR_PERF_SETTINGS_DOMAIN_CPU_EXT, XR_PERF_SETTINGS_DOMAIN_GPU_EXT}
+            Processing domain from XrPerfSettingsDomainEXT enum
+
+        Returns
+        -------
+        dict or None
+            Dictionary with the notification level ("notification_level"), the temperature headroom ("temp_headroom") 
+            and the temperature slope ("temp_slope"), or None if the query failed (e.g. the extension is not supported by the runtime)
         """
-        def get_or_create_vieport_window(camera, teleport=True, window_size=(400, 300), resolution=(1280, 720)):
-            window = None
-            camera = str(camera.GetPath() if type(camera) is Usd.Prim else camera)
-            # get viewport window
-            for interface in self._viewport_interface.get_instance_list():
-                w = self._viewport_interface.get_viewport_window(interface)
-                if camera == w.get_active_camera():
-                    window = w
-                    # check visibility
-                    if not w.is_visible():
-                        w.set_visible(True)
-                    break
-            # create viewport window if not exist
-            if window is None:
-                window = self._viewport_interface.get_viewport_window(self._viewport_interface.create_instance())
-                window.set_window_size(*window_size)
-                window.set_active_camera(camera)
-                window.set_texture_resolution(*resolution)
-                if teleport:
-                    window.set_camera_position(camera, 1.0, 1.0, 1.0, True)
-                    window.set_camera_target(camera, 0.0, 0.0, 0.0, True)
-            return window
-        
-        stage = omni.usd.get_context().get_stage()
+        if self._disable_openxr:
+            return {"notification_level": XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT, "temp_headroom": 0.0, "temp_slope": 0.0}
 
-        # left camera
-        teleport_camera = False
-        self._prim_left = None
-        if type(left_camera) is Usd.Prim:
-            self._prim_left = left_camera
-        elif stage.GetPrimAtPath(left_camera).IsValid():
-            self._prim_left = stage.GetPrimAtPath(left_camera)
-        else:
-            teleport_camera = True
-            self._prim_left = stage.DefinePrim(omni.usd.get_stage_next_free_path(stage, left_camera, False), "Camera")
-        self._viewport_window_left = get_or_create_vieport_window(self._prim_left, teleport=teleport_camera)
-
-        # right camera
-        teleport_camera = False
-        self._prim_right = None
-        if right_camera is not None:
-            if type(right_camera) is Usd.Prim:
-                self._prim_right = right_camera
-            elif stage.GetPrimAtPath(right_camera).IsValid():
-                self._prim_right = stage.GetPrimAtPath(right_camera)
-            else:
-                teleport_camera = True
-                self._prim_right = stage.DefinePrim(omni.usd.get_stage_next_free_path(stage, right_camera, False), "Camera")
-            self._viewport_window_right = get_or_create_vieport_window(self._prim_right, teleport=teleport_camera)
+        if self._use_ctypes:
+            notification_level = ctypes.c_int(0)
+            temp_headroom = ctypes.c_float(0)
+            temp_slope = ctypes.c_float(0)
+            if not self._lib.getThermalTemperatureTrend(self._app, domain, ctypes.byref(notification_level), ctypes.byref(temp_headroom), ctypes.byref(temp_slope)):
+                return None
+            return {"notification_level": notification_level.value, "temp_headroom": temp_headroom.value, "temp_slope": temp_slope.value}
+        else:
+            result = self._app.getThermalTemperatureTrend(domain)
+            if not result[0]:
+                return None
+            return {"notification_level": result[1], "temp_headroom": result[2], "temp_slope": result[3]}
+
+    def subscribe_performance_settings_event(self, callback: Union[Callable[[int, int, int, int], None], None] = None, policy: Union[dict, None] = None) -> None:
+        """
+        Subscribe a callback function to the performance settings notifications (XR_EXT_performance_settings)
+
+        The callback function (a callable object) should have only the following 4 parameters:
+        - domain: int
+           Processing domain (XR_PERF_SETTINGS_DOMAIN_CPU_EXT, XR_PERF_SETTINGS_DOMAIN_GPU_EXT)
+        - sub_domain: int
+           Sub-domain (XR_PERF_SETTINGS_SUB_DOMAIN_COMPOSITING_EXT, XR_PERF_SETTINGS_SUB_DOMAIN_RENDERING_EXT, XR_PERF_SETTINGS_SUB_DOMAIN_THERMAL_EXT)
+        - from_level: int
+           Previous notification level (XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT, XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT, XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT)
+        - to_level: int
+           New notification level
+
+        If the callback is None, an internal callback will be used. This internal callback lowers the render resolution 
+        (Omniverse viewport texture resolution) and the render rate (the internal render callback only updates the frames every N display frames)
+        according to the worst notification level reported by the runtime, before the runtime starts dropping frames
+
+        Parameters
+        ----------
+        callback: callable object (4 parameters) or None, optional
+            Callback invoked on each performance settings notification (default: None)
+        policy: dict or None, optional
+            Dictionary mapping each notification level to a tuple (render resolution scale, render rate divisor) used by the internal callback
+            (default: None, {NORMAL: (1.0, 1), WARNING: (0.75, 1), IMPAIRED: (0.5, 2)})
+        """
+        def _internal_performance_settings(domain, sub_domain, from_level, to_level):
+            self._performance_settings_levels[(domain, sub_domain)] = to_level
+            level = max(self._performance_settings_levels.values())
+            scale, divisor = self._performance_settings_policy.get(level, (1.0, 1))
+            print("[INFO] Performance settings notification level {}: render scale {}, render rate divisor {}".format(level, scale, divisor))
+            self.set_render_quality(scale, divisor)
+
+        if policy is not None:
+            self._performance_settings_policy.update(policy)
+
+        self._callback_performance_settings = callback
+        if callback is None:
+            self._callback_performance_settings = _internal_performance_settings
+
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._callback_middle_performance_settings = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int)(self._callback_performance_settings)
+            self._lib.setPerfSettingsCallback(self._app, self._callback_middle_performance_settings)
+        else:
+            self._callback_middle_performance_settings = self._callback_performance_settings
+            self._app.setPerfSettingsCallback(self._callback_middle_performance_settings)
+
+    def set_render_quality(self, scale: float = 1.0, rate_divisor: int = 1) -> None:
+        """
+        Set the render resolution scale and the render rate divisor used by the internal render callback
+
+        Parameters
+        ----------
+        scale: float, optional
+            Scale applied to the recommended resolution of the display device to define the Omniverse viewports resolution (default: 1.0)
+        rate_divisor: int, optional
+            The internal render callback updates the frames every rate_divisor display frames (default: 1)
+        """
+        assert scale > 0 and rate_divisor >= 1
+        self._render_scale = scale
+        self._render_rate_divisor = int(rate_divisor)
 
-        # set recommended resolution
+        # each view has its own recommended resolution (e.g. the context and inner views of quad views)
         resolutions = self.get_recommended_resolutions()
-        if len(resolutions) and self._viewport_window_left is not None:
-            self._viewport_window_left.set_texture_resolution(*resolutions[0])
-        if len(resolutions) == 2 and self._viewport_window_right is not None:
-            self._viewport_window_right.set_texture_resolution(*resolutions[1])
+        for resolution, viewport_window in zip(resolutions, self._viewport_windows):
+            viewport_window.set_texture_resolution(*[int(r * scale) for r in resolution])
 
-        # set camera properties
-        for property in camera_properties:
-            self._prim_left.GetAttribute(property).Set(camera_properties[property])
-            if right_camera is not None:
-                self._prim_right.GetAttribute(property).Set(camera_properties[property])
-        
-        # enable sensors
-        if self._viewport_window_left is not None:
-            sensors.enable_sensors(self._viewport_window_left, [_syntheticdata.SensorType.Rgb])
-        if self._viewport_window_right is not None:
-            sensors.enable_sensors(self._viewport_window_right, [_syntheticdata.SensorType.Rgb])
+    # display refresh rate utilities
 
-    def get_recommended_resolutions(self) -> tuple:
+    def get_display_refresh_rates(self) -> list:
         """
-        Get the recommended resolution of the display device
-        
+        Get the display refresh rates supported by the device (XR_FB_display_refresh_rate)
+
+        OpenXR internal function calls:
+        - xrEnumerateDisplayRefreshRatesFB
+
         Returns
         -------
-        tuple
-            Tuple containing the recommended resolutions (width, height) of each device view.
-            If the tuple length is 2, index 0 represents the left eye and index 1 represents the right eye
+        list of float
+            Supported display refresh rates in Hz (empty if the extension is not supported by the runtime)
         """
         if self._disable_openxr:
-            return ([512, 512], [1024, 1024])
+            return [90.0]
 
         if self._use_ctypes:
-            num_views = self._lib.getViewConfigurationViewsSize(self._app)
-            views = (XrViewConfigurationView * num_views)()
-            if self._lib.getViewConfigurationViews(self._app, views, num_views):
-                return [(view.recommendedImageRectWidth, view.recommendedImageRectHeight) for view in views]
-            else:
-                return tuple([])
+            count = ctypes.c_int(0)
+            if not self._lib.getDisplayRefreshRates(self._app, None, 0, ctypes.byref(count)):
+                return []
+            rates = (ctypes.c_float * count.value)()
+            if not self._lib.getDisplayRefreshRates(self._app, rates, count.value, ctypes.byref(count)):
+                return []
+            return list(rates)
         else:
-            return tuple([(view["recommendedImageRectWidth"], view["recommendedImageRectHeight"]) for view in self._app.getViewConfigurationViews()])
+            result = self._app.getDisplayRefreshRates()
+            return list(result[1]) if result[0] else []
 
-    def set_reference_system_pose(self, position: Union[pxr.Gf.Vec3d, None] = None, rotation: Union[pxr.Gf.Vec3d, None] = None) -> None:
+    def get_display_refresh_rate(self) -> Union[float, None]:
         """
-        Set the pose of the origin of the reference system
+        Get the current display refresh rate (XR_FB_display_refresh_rate)
 
-        Parameters
-        ----------
-        position: pxr.Gf.Vec3d or None, optional
-            Cartesian position (in stage unit) (default: None)
-        rotation: pxr.Gf.Vec3d or None, optional
-            Rotation (in degress) on each axis (default: None)
+        OpenXR internal function calls:
+        - xrGetDisplayRefreshRateFB
+
+        Returns
+        -------
+        float or None
+            Current display refresh rate in Hz, or None if the query failed (e.g. the extension is not supported by the runtime)
         """
-        self._reference_position = position
-        self._reference_rotation = rotation
+        if self._disable_openxr:
+            return 90.0
 
-    def set_stereo_rectification(self, x: float = 0, y: float = 0, z: float = 0) -> None:
+        if self._use_ctypes:
+            rate = ctypes.c_float(0)
+            if not self._lib.getDisplayRefreshRate(self._app, ctypes.byref(rate)):
+                return None
+            return rate.value
+        else:
+            result = self._app.getDisplayRefreshRate()
+            return result[1] if result[0] else None
+
+    def request_display_refresh_rate(self, rate: float = 0.0) -> bool:
         """
-        Set the angle (in radians) of the rotation axes for stereoscopic view rectification
+        Request a display refresh rate (XR_FB_display_refresh_rate)
+
+        The change is notified through the callback subscribed with subscribe_display_refresh_rate_event.
+        The requested rate is requested again when the session is recreated (see set_session_recovery)
+
+        OpenXR internal function calls:
+        - xrRequestDisplayRefreshRateFB
 
         Parameters
         ----------
-        x: float, optional
-            Angle (in radians) of the X-axis (default: 0)
-        y: float, optional
-            Angle (in radians) of the Y-axis (default: 0)
-        x: float, optional
-            Angle (in radians) of the Z-axis (default: 0)
+        rate: float, optional
+            One of the supported display refresh rates (get_display_refresh_rates) in Hz or 0 to let the runtime choose (default: 0.0)
+
+        Returns
+        -------
+        bool
+            True if the display refresh rate has been requested, otherwise False (e.g. the rate or the extension is not supported by the runtime)
         """
-        self._rectification_quat_left = pxr.Gf.Quatd(1, 0, 0, 0)
-        self._rectification_quat_right = pxr.Gf.Quatd(1, 0, 0, 0)
-        if x:   # w,x,y,z = cos(a/2), sin(a/2), 0, 0
-            self._rectification_quat_left *= pxr.Gf.Quatd(np.cos(x/2), np.sin(x/2), 0, 0)
-            self._rectification_quat_right *= pxr.Gf.Quatd(np.cos(-x/2), np.sin(-x/2), 0, 0)
-        if y:   # w,x,y,z = cos(a/2), 0, sin(a/2), 0
-            self._rectification_quat_left *= pxr.Gf.Quatd(np.cos(y/2), 0, np.sin(y/2), 0)
-            self._rectification_quat_right *= pxr.Gf.Quatd(np.cos(-y/2), 0, np.sin(-y/2), 0)
-        if z:   # w,x,y,z = cos(a/2), 0, 0, sin(a/2)
-            self._rectification_quat_left *= pxr.Gf.Quatd(np.cos(z/2), 0, 0, np.sin(z/2))
-            self._rectification_quat_right *= pxr.Gf.Quatd(np.cos(-z/2), 0, 0, np.sin(-z/2))
+        if self._disable_openxr:
+            return True
 
-    def set_meters_per_unit(self, meters_per_unit: float):
+        if self._use_ctypes:
+            return bool(self._lib.requestDisplayRefreshRate(self._app, ctypes.c_float(rate)))
+        else:
+            return self._app.requestDisplayRefreshRate(rate)
+
+    def match_display_refresh_rate(self, simulation_rate: float) -> Union[float, None]:
         """
-        Specify the meters per unit to be applied to transformations
+        Request the lowest supported display refresh rate that is an integer multiple of the simulation rate (XR_FB_display_refresh_rate)
+
+        Every simulation step is then displayed the same number of frames, without the judder of a display rate that does not divide evenly 
+        (e.g. a 60 Hz simulation on a 90 Hz display). Use the render rate divisor (set_render_quality) to update the frames once per simulation step
+        when the selected rate is a multiple greater than 1
 
-        E.g. 1 meter: 1.0, 1 centimeter: 0.01
-        
         Parameters
         ----------
-        meters_per_unit: float
-            Meters per unit
+        simulation_rate: float
+            Simulation rate in Hz (the inverse of the physics step)
+
+        Returns
+        -------
+        float or None
+            Requested display refresh rate in Hz, or None if no supported rate is a multiple of the simulation rate (or the extension is not supported by the runtime)
         """
-        assert meters_per_unit != 0
-        self._meters_per_unit = meters_per_unit
+        if self._disable_openxr:
+            return simulation_rate
 
-    def set_frame_transformations(self, fit: bool = False, flip: Union[int, tuple, None] = None) -> None:
+        if self._use_ctypes:
+            rate = ctypes.c_float(0)
+            if not self._lib.matchDisplayRefreshRate(self._app, ctypes.c_float(simulation_rate), ctypes.byref(rate)):
+                return None
+            return rate.value
+        else:
+            result = self._app.matchDisplayRefreshRate(simulation_rate)
+            return result[1] if result[0] else None
+
+    def subscribe_display_refresh_rate_event(self, callback: Union[Callable[[float, float], None], None] = None) -> None:
         """
-        Specify the transformations to be applied to the rendered images
+        Subscribe a callback function to the display refresh rate changes (XR_FB_display_refresh_rate)
+
+        The callback function (a callable object) should have only the following 2 parameters:
+        - from_rate: float
+           Previous display refresh rate in Hz
+        - to_rate: float
+           New display refresh rate in Hz
 
         Parameters
         ----------
-        fit: bool, optional
-            Adjust each rendered image to the recommended resolution of the display device by cropping and scaling the image from its center (default: False)
-            OpenCV.resize method with INTER_LINEAR interpolation will be used to scale the image to the recommended resolution
-        flip: int, tuple or None, optional
-            Flip each image around vertical (0), horizontal (1), or both axes (0,1) (default: None) 
+        callback: callable object (2 parameters) or None, optional
+            Callback invoked on each display refresh rate change, requested by the application or changed by the runtime (default: None)
         """
-        self._transform_fit = fit
-        self._transform_flip = flip
+        self._callback_display_refresh_rate = callback
 
-    def teleport_prim(self, prim: pxr.Usd.Prim, position: pxr.Gf.Vec3d, rotation: pxr.Gf.Quatd, reference_position: Union[pxr.Gf.Vec3d, None] = None, reference_rotation: Union[pxr.Gf.Vec3d, None] = None) -> None:
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._callback_middle_display_refresh_rate = ctypes.CFUNCTYPE(None, ctypes.c_float, ctypes.c_float)(callback) if callback is not None else None
+            self._lib.setDisplayRefreshRateCallback(self._app, self._callback_middle_display_refresh_rate)
+        else:
+            self._callback_middle_display_refresh_rate = callback
+            self._app.setDisplayRefreshRateCallback(self._callback_middle_display_refresh_rate)
+
+    # reprojection utilities
+
+    def get_reprojection_modes(self) -> list:
         """
-        Teleport the prim specified by the given transformation (position and rotation)
+        Get the reprojection modes supported by the runtime for the view configuration (XR_MSFT_composition_layer_reprojection)
 
-        Parameters
-        ----------
-        prim: pxr.Usd.Prim
-            Target prim
-        position: pxr.Gf.Vec3d
-            Cartesian position (in stage unit) used to transform the prim
-        rotation: pxr.Gf.Quatd
-            Rotation (as quaternion) used to transform the prim
-        reference_position: pxr.Gf.Vec3d or None, optional
-            Cartesian position (in stage unit) used as reference system (default: None)
-        reference_rotation: pxr.Gf.Vec3d or None, optional
-            Rotation (in degress) on each axis used as reference system (default: None)
+        The modes are negotiated when the session is created
+
+        OpenXR internal function calls:
+        - xrEnumerateReprojectionModesMSFT
+
+        Returns
+        -------
+        list of int
+            Supported reprojection modes (XR_REPROJECTION_MODE_*_MSFT). Empty if the session is not created or the extension is not supported by the runtime
         """
-        properties = prim.GetPropertyNames()
+        if self._disable_openxr:
+            return []
 
-        # reference position
-        if reference_position is not None:
-            if "xformOp:translate" in properties or "xformOp:translation" in properties:
-                prim.GetAttribute("xformOp:translate").Set(reference_position + position)
-            else:
-                print("[INFO] Create UsdGeom.XformOp.TypeTranslate for", prim.GetPath())
-                UsdGeom.Xformable(prim).AddXformOp(UsdGeom.XformOp.TypeTranslate, UsdGeom.XformOp.PrecisionDouble, "").Set(reference_position + position)
+        if self._use_ctypes:
+            count = ctypes.c_int(0)
+            if not self._lib.getReprojectionModes(self._app, None, 0, ctypes.byref(count)):
+                return []
+            modes = (ctypes.c_int * count.value)()
+            if not self._lib.getReprojectionModes(self._app, modes, count.value, ctypes.byref(count)):
+                return []
+            return list(modes)
         else:
-            if "xformOp:translate" in properties or "xformOp:translation" in properties:
-                prim.GetAttribute("xformOp:translate").Set(position)
-            else:
-                print("[INFO] Create UsdGeom.XformOp.TypeTranslate for", prim.GetPath())
-                UsdGeom.Xformable(prim).AddXformOp(UsdGeom.XformOp.TypeTranslate, UsdGeom.XformOp.PrecisionDouble, "").Set(position)
+            result = self._app.getReprojectionModes()
+            return list(result[1]) if result[0] else []
 
-        # reference rotation
+    def set_reprojection_mode(self, mode: int = 0) -> bool:
+        """
+        Set the reprojection mode hinted to the runtime with every projection layer (XR_MSFT_composition_layer_reprojection)
+
+        Depth reprojection (XR_REPROJECTION_MODE_DEPTH_MSFT) requires the depth frames (set_frames), while orientation-only reprojection 
+        (XR_REPROJECTION_MODE_ORIENTATION_ONLY_MSFT) suits content with no stable geometry (e.g. video or distant scenery).
+        A mode set before the session is created is validated when it is created
+
+        Parameters
+        ----------
+        mode: int, optional
+            Reprojection mode (XR_REPROJECTION_MODE_*_MSFT) or 0 to let the runtime choose (default: 0)
+
+        Returns
+        -------
+        bool
+            True if the mode has been set, otherwise False (e.g. the mode or the extension is not supported by the runtime)
+        """
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            return bool(self._lib.setReprojectionMode(self._app, mode))
+        else:
+            return self._app.setReprojectionMode(mode)
+
+    def set_reprojection_plane(self, enable: bool = True, position: tuple = (0, 0, -1), normal: tuple = (0, 0, 1), velocity: tuple = (0, 0, 0)) -> bool:
+        """
+        Override the stabilization plane of the planar reprojection modes (XR_MSFT_composition_layer_reprojection)
+
+        The plane is submitted with every projection layer unless the orientation-only mode is set (set_reprojection_mode).
+        Without a mode, the runtime uses it if its default reprojection is planar
+
+        Parameters
+        ----------
+        enable: bool, optional
+            Whether to submit the plane override (default: True)
+        position: tuple, optional
+            Position (x, y, z) of a point on the plane in the reference space, in meters (default: (0, 0, -1))
+        normal: tuple, optional
+            Normal (x, y, z) of the plane in the reference space. It is normalized before being submitted (default: (0, 0, 1))
+        velocity: tuple, optional
+            Velocity (x, y, z) of the plane in the reference space, in meters per second (default: (0, 0, 0))
+
+        Returns
+        -------
+        bool
+            True if the plane has been set, otherwise False (e.g. the normal has zero length or the extension is not supported by the runtime)
+        """
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            return bool(self._lib.setReprojectionPlane(self._app, enable, ctypes.byref(XrVector3f(*position)), ctypes.byref(XrVector3f(*normal)), ctypes.byref(XrVector3f(*velocity))))
+        else:
+            return self._app.setReprojectionPlane(enable, position, normal, velocity)
+
+    # logging utilities
+
+    def subscribe_log_event(self, callback: Union[Callable[[int, str], None], None] = "kit") -> None:
+        """
+        Subscribe a callback function to the library log messages
+
+        The messages are dispatched from a background thread. 
+        Messages from the same site are rate limited (see set_log_rate_limit)
+
+        Parameters
+        ----------
+        callback: callable, None or "kit", optional
+            Callback function with the signature: callback(level: int, message: str).
+            If "kit" (default), the messages will be routed to the Kit's logger (carb.log_*).
+            If None, the messages will be written to the standard output
+        """
+        def _kit_log(level, message):
+            if __name__ == "__main__":
+                print(message)
+            elif level == LOG_LEVEL_ERROR:
+                carb.log_error(message)
+            elif level == LOG_LEVEL_WARNING:
+                carb.log_warn(message)
+            else:
+                carb.log_info(message)
+
+        def _middle_callback(level, message):
+            if self._callback_log is not None:
+                self._callback_log(level, message.decode("utf-8", "replace"))
+
+        self._callback_log = _kit_log if callback == "kit" else callback
+
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            if self._callback_log is None:
+                self._lib.setLogCallback(self._app, None)
+            else:
+                # the same C callback is kept alive (the background thread may still be using it)
+                if self._callback_middle_log is None:
+                    self._callback_middle_log = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.c_char_p)(_middle_callback)
+                self._lib.setLogCallback(self._app, self._callback_middle_log)
+        else:
+            self._app.setLogCallback(self._callback_log)
+
+    def set_log_level(self, level: int = LOG_LEVEL_INFO) -> None:
+        """
+        Set the minimum level of the library log messages
+
+        Parameters
+        ----------
+        level: {LOG_LEVEL_DEBUG, LOG_LEVEL_INFO, LOG_LEVEL_WARNING, LOG_LEVEL_ERROR}, optional
+            Minimum log level (default: LOG_LEVEL_INFO)
+        """
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._lib.setLogLevel(self._app, level)
+        else:
+            self._app.setLogLevel(level)
+
+    def set_log_rate_limit(self, milliseconds: int = 1000) -> None:
+        """
+        Set the rate limit window of the library log messages. 
+        A limited number of messages from the same site (e.g. tracking loss warnings in the render loop) are accepted per window
+
+        Parameters
+        ----------
+        milliseconds: int, optional
+            Rate limit window in milliseconds (default: 1000). If 0, the rate limiting will be disabled
+        """
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._lib.setLogRateLimit(self._app, milliseconds)
+        else:
+            self._app.setLogRateLimit(milliseconds)
+
+    def set_verbose(self, enable: bool = True) -> None:
+        """
+        Print the setup information (API layers, extensions, system properties, view configurations, bindings, etc.) and the startup timing.
+        By default, only warnings and errors are printed during the setup
+
+        Parameters
+        ----------
+        enable: bool, optional
+            Whether to print the setup information (default: True)
+        """
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._lib.setVerbose(self._app, enable)
+        else:
+            self._app.setVerbose(enable)
+
+    def get_startup_timing(self) -> dict:
+        """
+        Get the time spent in each startup phase of the last instance and session creation (create_instance, get_system and create_session)
+
+        Returns
+        -------
+        dict
+            Dictionary mapping each startup phase (see STARTUP_PHASES) to its duration in milliseconds
+        """
+        if self._disable_openxr:
+            return {phase: 0.0 for phase in STARTUP_PHASES}
+
+        if self._use_ctypes:
+            timing = (ctypes.c_double * len(STARTUP_PHASES))()
+            length = self._lib.getStartupTiming(self._app, timing, len(STARTUP_PHASES))
+            return {STARTUP_PHASES[i]: timing[i] for i in range(length)}
+        else:
+            return dict(zip(STARTUP_PHASES, self._app.getStartupTiming()))
+
+    def set_session_recovery(self, enable: bool = True) -> None:
+        """
+        Recreate the session when it is lost (XR_SESSION_STATE_LOSS_PENDING, e.g. headset disconnection) or the instance 
+        when it is lost (e.g. runtime restart) instead of ending the application loop. 
+        The graphics resources are kept and the registered actions are replayed on the new instance. 
+        While recovering, poll_events returns True and is_session_running returns False
+
+        Parameters
+        ----------
+        enable: bool, optional
+            Whether to recover the lost session or instance (default: True)
+        """
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._lib.setSessionRecovery(self._app, enable)
+        else:
+            self._app.setSessionRecovery(enable)
+
+    def is_recovering(self) -> bool:
+        """
+        Whether a lost session or instance is being recreated
+
+        Returns
+        -------
+        bool
+            True if the session or instance is being recreated, otherwise False
+        """
+        if self._disable_openxr:
+            return False
+
+        if self._use_ctypes:
+            return bool(self._lib.isRecovering(self._app))
+        else:
+            return self._app.isRecovering()
+
+    def get_recovery_metrics(self) -> dict:
+        """
+        Get the session recovery metrics
+
+        Returns
+        -------
+        dict
+            Dictionary with the number of recoveries ("count") and the time-to-recovery in milliseconds of the last recovery ("time", -1 if none)
+        """
+        if self._disable_openxr:
+            return {"count": 0, "time": -1.0}
+
+        if self._use_ctypes:
+            time, count = ctypes.c_double(-1), ctypes.c_int(0)
+            self._lib.getRecoveryMetrics(self._app, ctypes.byref(time), ctypes.byref(count))
+            return {"count": count.value, "time": time.value}
+        else:
+            return {"count": self._app.getRecoveryCount(), "time": self._app.getRecoveryTime()}
+
+    def set_debug_utils(self, enable: bool = True) -> None:
+        """
+        Enable the XR_EXT_debug_utils extension (if available) to route the runtime and API layers messages through the library log. 
+        It must be called before creating the instance (create_instance)
+
+        Parameters
+        ----------
+        enable: bool, optional
+            Whether to enable the runtime messages (default: True)
+        """
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._lib.setDebugUtils(self._app, enable)
+        else:
+            self._app.setDebugUtils(enable)
+
+    def set_egl_context(self, enable: bool = True) -> None:
+        """
+        Use a surfaceless (or pbuffer) EGL context instead of the SDL window and GLX context for the OpenGL graphics binding.
+        It requires a runtime supporting the XR_MNDX_egl_enable extension (otherwise, GLX is used) and allows to run without an X server. 
+        It must be called before creating the instance (create_instance)
+
+        Parameters
+        ----------
+        enable: bool, optional
+            Whether to use an EGL context (default: True)
+        """
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._lib.setEglContext(self._app, enable)
+        else:
+            self._app.setEglContext(enable)
+
+    def set_headless(self, enable: bool = True) -> None:
+        """
+        Create a tracking-only session, without graphics binding and swapchains (no frames are submitted to the runtime).
+        It requires a runtime supporting the XR_MND_headless extension (otherwise, a regular session is created).
+        Actions (poll_actions), pose location, view location (render callback) and haptic feedback keep working.
+        The internal render callback (subscribe_render_event) skips the camera update and the viewport readback in this mode.
+        It must be called before creating the instance (create_instance)
+
+        Parameters
+        ----------
+        enable: bool, optional
+            Whether to create a tracking-only session (default: True)
+        """
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._lib.setHeadless(self._app, enable)
+        else:
+            self._app.setHeadless(enable)
+
+    def is_headless(self) -> bool:
+        """
+        Whether the session was created in tracking-only mode (XR_MND_headless)
+
+        Returns
+        -------
+        bool
+            Return True if the session has no graphics binding, False otherwise
+        """
+        if self._disable_openxr:
+            return False
+
+        if self._use_ctypes:
+            return bool(self._lib.isHeadless(self._app))
+        else:
+            return self._app.isHeadless()
+
+    def get_graphics_backend(self) -> str:
+        """
+        Graphics backend used by the session (OpenGL, Vulkan or Headless).
+        A Headless backend falls back to OpenGL (or Vulkan) when the runtime doesn't support the XR_MND_headless extension
+
+        Returns
+        -------
+        str
+            Name of the graphics backend
+        """
+        if self._disable_openxr:
+            backend = self._graphics_backend
+        elif self._use_ctypes:
+            backend = self._lib.getGraphicsBackend(self._app)
+        else:
+            backend = self._app.getGraphicsBackend()
+        return {value: key for key, value in GRAPHICS_BACKENDS.items()}.get(backend, "")
+
+    def set_mirror(self, enable: bool = True, view: int = 0, scale: float = 0.5, rate: float = 15) -> bool:
+        """
+        Show what the headset shows in a desktop window (OpenGL backend with SDL window only).
+        The swapchain image of one view is blitted into the window at a reduced size and rate, 
+        without re-rendering the eye frames or waiting for the desktop vertical sync.
+        It can be called at any moment after creating the session (create_session)
+
+        Parameters
+        ----------
+        enable: bool, optional
+            Whether to show the desktop mirror (default: True)
+        view: int, optional
+            Index of the view to mirror (default: 0, left eye for stereo)
+        scale: float, optional
+            Window size relative to the view resolution, in the range (0, 1] (default: 0.5)
+        rate: float, optional
+            Mirror refresh rate in Hz (default: 15)
+
+        Returns
+        -------
+        bool
+            True if the settings are valid, otherwise False
+        """
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            return bool(self._lib.setMirror(self._app, enable, view, ctypes.c_float(scale), ctypes.c_float(rate)))
+        else:
+            return self._app.setMirror(enable, view, scale, rate)
+
+    def set_upload_worker(self, enable: bool = True) -> None:
+        """
+        Upload the frames on a worker thread with an OpenGL context shared with the frame loop (OpenGL backend only).
+        The frames are uploaded as soon as they are set (set_frames) and the frame loop only waits on the upload fence, 
+        so the upload latency is removed from the interval in which the swapchain images are held.
+        It must be called before creating the session (create_session)
+
+        Parameters
+        ----------
+        enable: bool, optional
+            Whether to upload the frames on a worker thread (default: True)
+        """
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._lib.setUploadWorker(self._app, enable)
+        else:
+            self._app.setUploadWorker(enable)
+
+    # session record and replay utilities
+
+    def start_recording(self, path: str) -> bool:
+        """
+        Start recording the session (predicted display times, located views, action states and action poses) to a binary log
+
+        The recording must be started after getting the system (get_system) and it is stopped when the application is destroyed
+
+        Parameters
+        ----------
+        path: str
+            Path of the session log file
+
+        Returns
+        -------
+        bool
+            True if the recording has been started, otherwise False
+        """
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            return bool(self._lib.startRecording(self._app, ctypes.create_string_buffer(path.encode('utf-8'))))
+        else:
+            return self._app.startRecording(path)
+
+    def stop_recording(self) -> None:
+        """
+        Stop recording the session
+        """
+        if self._disable_openxr:
+            return
+
+        if self._use_ctypes:
+            self._lib.stopRecording(self._app)
+        else:
+            self._app.stopRecording()
+
+    def start_replay(self, path: str, speed: float = 0) -> bool:
+        """
+        Replay a recorded session without an OpenXR runtime
+
+        The replay must be started before creating the instance (create_instance). 
+        The recorded data is fed to the same methods (poll_actions, render_views and the subscribed callbacks) 
+        and poll_events ends the session when the end of the log is reached
+
+        Parameters
+        ----------
+        path: str
+            Path of the session log file
+        speed: float, optional
+            Replay speed relative to the recording (default: 0, replay as fast as possible)
+
+        Returns
+        -------
+        bool
+            True if the session log has been loaded, otherwise False
+        """
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            return bool(self._lib.startReplay(self._app, ctypes.create_string_buffer(path.encode('utf-8')), ctypes.c_float(speed)))
+        else:
+            return self._app.startReplay(path, speed)
+
+    # composition layer utilities
+
+    def add_quad_layer(self, width: int, height: int, position: tuple = (0, 0, -1), orientation: tuple = (0, 0, 0, 1), size: tuple = (1.0, 0.5), reference_space: int = XR_REFERENCE_SPACE_TYPE_LOCAL) -> int:
+        """
+        Add a quad composition layer (e.g. HUD or UI overlay) with its own swapchain
+
+        The layer is submitted after the projection layer and composited by the runtime at native sharpness. 
+        Its content (set_layer_image) is uploaded only when it changes: static overlays have no per-frame upload cost.
+        It can be called before or after creating the session (create_session)
+
+        Parameters
+        ----------
+        width: int
+            Swapchain width in pixels (the images are scaled to this size)
+        height: int
+            Swapchain height in pixels (the images are scaled to this size)
+        position: tuple, optional
+            Position (x, y, z) of the center of the quad in the reference space, in meters (default: (0, 0, -1))
+        orientation: tuple, optional
+            Orientation quaternion (x, y, z, w) of the quad in the reference space (default: (0, 0, 0, 1))
+        size: tuple, optional
+            Width and height of the quad in meters (default: (1.0, 0.5))
+        reference_space: int, optional
+            Reference space type in which the quad is placed: XR_REFERENCE_SPACE_TYPE_VIEW (head-locked), 
+            XR_REFERENCE_SPACE_TYPE_LOCAL (default) or XR_REFERENCE_SPACE_TYPE_STAGE
+
+        Returns
+        -------
+        int
+            Identifier of the quad layer or -1 if the layer cannot be created
+        """
+        if self._disable_openxr:
+            return 0
+
+        if self._use_ctypes:
+            pose = XrPosef(XrQuaternionf(*orientation), XrVector3f(*position))
+            return self._lib.addQuadLayer(self._app, width, height, reference_space, ctypes.byref(pose), ctypes.c_float(size[0]), ctypes.c_float(size[1]))
+        else:
+            return self._app.addQuadLayer(width, height, reference_space, position, orientation, size)
+
+    def add_cylinder_layer(self, width: int, height: int, position: tuple = (0, 0, 0), orientation: tuple = (0, 0, 0, 1), radius: float = 2.0, 
+                           central_angle: float = np.pi / 2, aspect_ratio: float = 16 / 9, reference_space: int = XR_REFERENCE_SPACE_TYPE_LOCAL) -> int:
+        """
+        Add a cylinder composition layer (XR_KHR_composition_layer_cylinder) with its own swapchain (e.g. curved screen for a camera feed)
+
+        The runtime samples the layer swapchain directly: streamed frames (set_layer_frame) are not rendered by the simulator nor read back.
+        It must be called after creating the instance (create_instance)
+
+        Parameters
+        ----------
+        width: int
+            Swapchain width in pixels (the images are scaled to this size)
+        height: int
+            Swapchain height in pixels (the images are scaled to this size)
+        position: tuple, optional
+            Position (x, y, z) of the center of the cylinder in the reference space, in meters (default: (0, 0, 0))
+        orientation: tuple, optional
+            Orientation quaternion (x, y, z, w) of the cylinder in the reference space (default: (0, 0, 0, 1)). The visible segment is centered on the -Z axis
+        radius: float, optional
+            Radius of the cylinder in meters (default: 2.0). 0 is an infinite radius
+        central_angle: float, optional
+            Horizontal angle of the visible segment in radians (default: pi / 2)
+        aspect_ratio: float, optional
+            Ratio of the visible segment width to its height (default: 16 / 9)
+        reference_space: int, optional
+            Reference space type in which the cylinder is placed: XR_REFERENCE_SPACE_TYPE_VIEW (head-locked), 
+            XR_REFERENCE_SPACE_TYPE_LOCAL (default) or XR_REFERENCE_SPACE_TYPE_STAGE
+
+        Returns
+        -------
+        int
+            Identifier of the layer or -1 if the layer cannot be created (e.g. the extension is not supported by the runtime)
+        """
+        if self._disable_openxr:
+            return 0
+
+        if self._use_ctypes:
+            pose = XrPosef(XrQuaternionf(*orientation), XrVector3f(*position))
+            return self._lib.addCylinderLayer(self._app, width, height, reference_space, ctypes.byref(pose), 
+                                              ctypes.c_float(radius), ctypes.c_float(central_angle), ctypes.c_float(aspect_ratio))
+        else:
+            return self._app.addCylinderLayer(width, height, reference_space, position, orientation, radius, central_angle, aspect_ratio)
+
+    def add_equirect_layer(self, width: int, height: int, position: tuple = (0, 0, 0), orientation: tuple = (0, 0, 0, 1), radius: float = 0.0, 
+                           central_horizontal_angle: float = 2 * np.pi, upper_vertical_angle: float = np.pi / 2, lower_vertical_angle: float = -np.pi / 2, 
+                           reference_space: int = XR_REFERENCE_SPACE_TYPE_LOCAL) -> int:
+        """
+        Add an equirectangular composition layer (XR_KHR_composition_layer_equirect2) with its own swapchain (e.g. 360 degree camera feed)
+
+        The runtime samples the layer swapchain directly: streamed frames (set_layer_frame) are not rendered by the simulator nor read back.
+        It must be called after creating the instance (create_instance)
+
+        Parameters
+        ----------
+        width: int
+            Swapchain width in pixels (the images are scaled to this size)
+        height: int
+            Swapchain height in pixels (the images are scaled to this size)
+        position: tuple, optional
+            Position (x, y, z) of the center of the sphere in the reference space, in meters (default: (0, 0, 0))
+        orientation: tuple, optional
+            Orientation quaternion (x, y, z, w) of the sphere in the reference space (default: (0, 0, 0, 1)). The image center is mapped to the -Z axis
+        radius: float, optional
+            Radius of the sphere in meters (default: 0.0, infinite sphere)
+        central_horizontal_angle: float, optional
+            Horizontal angle covered by the image in radians (default: 2 * pi)
+        upper_vertical_angle: float, optional
+            Angle of the image top edge above the horizon in radians (default: pi / 2)
+        lower_vertical_angle: float, optional
+            Angle of the image bottom edge below the horizon in radians (default: -pi / 2)
+        reference_space: int, optional
+            Reference space type in which the sphere is placed: XR_REFERENCE_SPACE_TYPE_VIEW (head-locked), 
+            XR_REFERENCE_SPACE_TYPE_LOCAL (default) or XR_REFERENCE_SPACE_TYPE_STAGE
+
+        Returns
+        -------
+        int
+            Identifier of the layer or -1 if the layer cannot be created (e.g. the extension is not supported by the runtime)
+        """
+        if self._disable_openxr:
+            return 0
+
+        if self._use_ctypes:
+            pose = XrPosef(XrQuaternionf(*orientation), XrVector3f(*position))
+            return self._lib.addEquirectLayer(self._app, width, height, reference_space, ctypes.byref(pose), ctypes.c_float(radius), 
+                                              ctypes.c_float(central_horizontal_angle), ctypes.c_float(upper_vertical_angle), ctypes.c_float(lower_vertical_angle))
+        else:
+            return self._app.addEquirectLayer(width, height, reference_space, position, orientation, radius, 
+                                              central_horizontal_angle, upper_vertical_angle, lower_vertical_angle)
+
+    def add_cube_layer(self, size: int, orientation: tuple = (0, 0, 0, 1), reference_space: int = XR_REFERENCE_SPACE_TYPE_LOCAL) -> int:
+        """
+        Add a cube map environment layer (XR_KHR_composition_layer_cube) drawn behind the simulator views (e.g. a skybox)
+
+        The layer uses a static swapchain: its content is set once (set_layer_image) and reused by the runtime every frame.
+        Setting a new content recreates the swapchain. The simulator views are blended over the environment using their alpha channel,
+        so they must be RGBA images with alpha 0 where the environment should be visible.
+        It must be called after creating the instance (create_instance)
+
+        Parameters
+        ----------
+        size: int
+            Size (width and height) of each cube face in pixels
+        orientation: tuple, optional
+            Orientation quaternion (x, y, z, w) of the cube map in the reference space (default: (0, 0, 0, 1))
+        reference_space: int, optional
+            Reference space type in which the cube map is oriented: XR_REFERENCE_SPACE_TYPE_LOCAL (default) or XR_REFERENCE_SPACE_TYPE_STAGE
+
+        Returns
+        -------
+        int
+            Identifier of the layer or -1 if the layer cannot be created (e.g. the extension is not supported by the runtime)
+        """
+        if self._disable_openxr:
+            return 0
+
+        if self._use_ctypes:
+            quaternion = XrQuaternionf(*orientation)
+            return self._lib.addCubeLayer(self._app, size, reference_space, ctypes.byref(quaternion))
+        else:
+            return self._app.addCubeLayer(size, reference_space, orientation)
+
+    def set_layer_image(self, layer: int, image: np.ndarray) -> bool:
+        """
+        Set the content of a composition layer
+
+        The image is copied and uploaded in the next frame (it is uploaded again if the session is recreated). 
+        RGBA images are blended using their alpha channel
+
+        Parameters
+        ----------
+        layer: int
+            Identifier of the layer (returned by add_quad_layer, add_cylinder_layer, add_equirect_layer or add_cube_layer)
+        image: numpy.ndarray
+            RGB or RGBA image (numpy.uint8). 
+            Cube map faces are given with shape (6, size, size, channels) or stacked vertically with shape (6 * size, size, channels) 
+            in the order +X, -X, +Y, -Y, +Z, -Z
+
+        Returns
+        -------
+        bool
+            True if the content has been set, otherwise False
+        """
+        if self._disable_openxr:
+            return True
+
+        image = np.ascontiguousarray(image, dtype=np.uint8)
+        if image.ndim == 4:
+            image = image.reshape(-1, image.shape[2], image.shape[3])
+        use_rgba = True if image.shape[2] == 4 else False
+        if self._use_ctypes:
+            return bool(self._lib.setLayerImage(self._app, layer, image.shape[1], image.shape[0], image.ctypes.data_as(ctypes.c_void_p), use_rgba))
+        else:
+            return self._app.setLayerImage(layer, image, use_rgba)
+
+    def set_layer_frame(self, layer: int, frame: np.ndarray) -> bool:
+        """
+        Stream a frame (e.g. video or camera feed) into a composition layer
+
+        Unlike set_layer_image, the frame is not copied: it is uploaded directly into the layer swapchain in the next frame.
+        The frames are expected to change every frame (their content is not uploaded again if the session is recreated)
+
+        Parameters
+        ----------
+        layer: int
+            Identifier of the layer (returned by add_quad_layer, add_cylinder_layer or add_equirect_layer)
+        frame: numpy.ndarray
+            RGB or RGBA image (numpy.uint8)
+
+        Returns
+        -------
+        bool
+            True if the frame has been set, otherwise False
+        """
+        if self._disable_openxr:
+            return True
+
+        # the reference is kept until the frame is uploaded
+        frame = np.ascontiguousarray(frame, dtype=np.uint8)
+        self._layer_frames[layer] = frame
+        use_rgba = True if frame.shape[2] == 4 else False
+        if self._use_ctypes:
+            return bool(self._lib.setLayerFrame(self._app, layer, frame.shape[1], frame.shape[0], frame.ctypes.data_as(ctypes.c_void_p), use_rgba))
+        else:
+            return self._app.setLayerFrame(layer, frame, use_rgba)
+
+    def set_layer_pose(self, layer: int, position: tuple = (0, 0, 0), orientation: tuple = (0, 0, 0, 1), reference_space: int = XR_REFERENCE_SPACE_TYPE_LOCAL) -> bool:
+        """
+        Place a composition layer, keeping its geometry (the content is not uploaded again)
+
+        Parameters
+        ----------
+        layer: int
+            Identifier of the layer (returned by add_quad_layer, add_cylinder_layer, add_equirect_layer or add_cube_layer)
+        position: tuple, optional
+            Position (x, y, z) of the layer in the reference space, in meters (default: (0, 0, 0)). It is ignored by cube map layers
+        orientation: tuple, optional
+            Orientation quaternion (x, y, z, w) of the layer in the reference space (default: (0, 0, 0, 1))
+        reference_space: int, optional
+            Reference space type in which the layer is placed (default: XR_REFERENCE_SPACE_TYPE_LOCAL)
+
+        Returns
+        -------
+        bool
+            True if the layer has been placed, otherwise False
+        """
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            pose = XrPosef(XrQuaternionf(*orientation), XrVector3f(*position))
+            return bool(self._lib.setLayerPose(self._app, layer, reference_space, ctypes.byref(pose)))
+        else:
+            return self._app.setLayerPose(layer, reference_space, position, orientation)
+
+    def set_quad_layer_pose(self, layer: int, position: tuple = (0, 0, -1), orientation: tuple = (0, 0, 0, 1), size: tuple = (1.0, 0.5), reference_space: int = XR_REFERENCE_SPACE_TYPE_LOCAL) -> bool:
+        """
+        Place a quad composition layer (the content is not uploaded again)
+
+        Parameters
+        ----------
+        layer: int
+            Identifier of the quad layer (returned by add_quad_layer)
+        position: tuple, optional
+            Position (x, y, z) of the center of the quad in the reference space, in meters (default: (0, 0, -1))
+        orientation: tuple, optional
+            Orientation quaternion (x, y, z, w) of the quad in the reference space (default: (0, 0, 0, 1))
+        size: tuple, optional
+            Width and height of the quad in meters (default: (1.0, 0.5))
+        reference_space: int, optional
+            Reference space type in which the quad is placed (default: XR_REFERENCE_SPACE_TYPE_LOCAL)
+
+        Returns
+        -------
+        bool
+            True if the layer has been placed, otherwise False
+        """
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            pose = XrPosef(XrQuaternionf(*orientation), XrVector3f(*position))
+            return bool(self._lib.setQuadLayerPose(self._app, layer, reference_space, ctypes.byref(pose), ctypes.c_float(size[0]), ctypes.c_float(size[1])))
+        else:
+            return self._app.setQuadLayerPose(layer, reference_space, position, orientation, size)
+
+    def set_layer_visible(self, layer: int, visible: bool = True) -> bool:
+        """
+        Show or hide a composition layer (its content is kept)
+
+        Parameters
+        ----------
+        layer: int
+            Identifier of the layer (returned by add_quad_layer, add_cylinder_layer, add_equirect_layer or add_cube_layer)
+        visible: bool, optional
+            Whether the layer is submitted (default: True)
+
+        Returns
+        -------
+        bool
+            True if the layer exists, otherwise False
+        """
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            return bool(self._lib.setLayerVisible(self._app, layer, visible))
+        else:
+            return self._app.setLayerVisible(layer, visible)
+
+    def remove_layer(self, layer: int) -> bool:
+        """
+        Remove a composition layer and destroy its swapchain
+
+        Parameters
+        ----------
+        layer: int
+            Identifier of the layer (returned by add_quad_layer, add_cylinder_layer, add_equirect_layer or add_cube_layer)
+
+        Returns
+        -------
+        bool
+            True if the layer has been removed, otherwise False
+        """
+        if self._disable_openxr:
+            return True
+
+        self._layer_frames.pop(layer, None)
+        if self._use_ctypes:
+            return bool(self._lib.removeLayer(self._app, layer))
+        else:
+            return self._app.removeLayer(layer)
+
+    def set_quad_layer_image(self, layer: int, image: np.ndarray) -> bool:
+        """
+        Set the content of a quad composition layer (same as set_layer_image, kept for the first quad layer API)
+        """
+        return self.set_layer_image(layer, image)
+
+    def set_quad_layer_visible(self, layer: int, visible: bool = True) -> bool:
+        """
+        Show or hide a quad composition layer (same as set_layer_visible, kept for the first quad layer API)
+        """
+        return self.set_layer_visible(layer, visible)
+
+    def remove_quad_layer(self, layer: int) -> bool:
+        """
+        Remove a quad composition layer (same as remove_layer, kept for the first quad layer API)
+        """
+        return self.remove_layer(layer)
+
+    def set_color_scale_bias(self, scale: tuple = (1, 1, 1, 1), bias: tuple = (0, 0, 0, 0), duration: float = 0.0, layer: int = -1) -> bool:
+        """
+        Fade or dim a layer in the compositor (XR_KHR_composition_layer_color_scale_bias)
+
+        The output color is computed by the runtime as color * scale + bias, without rendering or uploading new frames.
+        The values are interpolated from the current ones over the duration, using the display time of the submitted frames.
+        They are only evaluated when a frame is submitted (render_views): while the frame loop is not running (e.g. the simulator is blocked loading assets), 
+        the compositor keeps the last submitted values and the fade continues, at the value given by the elapsed time, with the next submitted frame.
+        Calling it with the default values restores the layer colors.
+        It must be called after creating the instance (create_instance)
+
+        Example: fade the simulator views to black over one second: ``set_color_scale_bias(scale=(0, 0, 0, 1), duration=1.0)``
+
+        Parameters
+        ----------
+        scale: tuple, optional
+            Color scale (r, g, b, a) (default: (1, 1, 1, 1))
+        bias: tuple, optional
+            Color bias (r, g, b, a) (default: (0, 0, 0, 0))
+        duration: float, optional
+            Duration of the fade in seconds (default: 0.0, the values are applied in the next frame)
+        layer: int, optional
+            Identifier of the composition layer (returned by add_quad_layer, add_cylinder_layer, add_equirect_layer or add_cube_layer) 
+            or -1 for the projection layer (simulator views) (default: -1)
+
+        Returns
+        -------
+        bool
+            True if the fade has been set, otherwise False (e.g. the extension is not supported by the runtime)
+        """
+        if self._disable_openxr:
+            return True
+
+        if self._use_ctypes:
+            color_scale, color_bias = XrColor4f(*scale), XrColor4f(*bias)
+            return bool(self._lib.setColorScaleBias(self._app, layer, ctypes.byref(color_scale), ctypes.byref(color_bias), ctypes.c_float(duration)))
+        else:
+            return self._app.setColorScaleBias(layer, scale, bias, duration)
+
+    def get_visibility_mask(self, view: int, mask_type: int = XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR) -> Union[tuple, None]:
+        """
+        Get the visibility mask of a view (XR_KHR_visibility_mask)
+
+        The vertices are in view space, on the z = -1 plane. They can be mapped to image pixels using the tangents of the view field of view (get_recommended_resolutions and the views returned by the render callback).
+        The mask is cached and fetched again when the runtime notifies a change (XrEventDataVisibilityMaskChangedKHR).
+        The visible area of each view is also used internally to skip the upload and copy of the hidden pixels of the frames.
+        It must be called after creating the session (create_session)
+
+        OpenXR internal function calls:
+        - xrGetVisibilityMaskKHR
+
+        Parameters
+        ----------
+        view: int
+            View index (0: left eye or mono view, 1: right eye)
+        mask_type: {XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR, XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR, XR_VISIBILITY_MASK_TYPE_LINE_LOOP_KHR}, optional
+            Type of the mask (default: XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR)
+
+        Returns
+        -------
+        tuple or None
+            Vertices (numpy array of shape (N, 2) and dtype float32) and indices (numpy array of dtype uint32), 
+            or None if the query failed (e.g. the extension is not supported by the runtime)
+        """
+        if self._disable_openxr:
+            return None
+
+        if self._use_ctypes:
+            vertex_count, index_count = ctypes.c_int(0), ctypes.c_int(0)
+            if not self._lib.getVisibilityMask(self._app, view, mask_type, None, 0, None, 0, ctypes.byref(vertex_count), ctypes.byref(index_count)):
+                return None
+            vertices = np.zeros((vertex_count.value, 2), dtype=np.float32)
+            indices = np.zeros((index_count.value,), dtype=np.uint32)
+            if not self._lib.getVisibilityMask(self._app, view, mask_type, 
+                                               vertices.ctypes.data_as(ctypes.c_void_p), vertex_count.value, 
+                                               indices.ctypes.data_as(ctypes.c_void_p), index_count.value, 
+                                               ctypes.byref(vertex_count), ctypes.byref(index_count)):
+                return None
+            return vertices, indices
+        else:
+            result = self._app.getVisibilityMask(view, mask_type)
+            if not result[0]:
+                return None
+            return result[1], result[2]
+
+    # application space warp
+
+    def set_space_warp(self, enable: bool = True) -> bool:
+        """
+        Enable or disable the application space warp (XR_FB_space_warp)
+
+        When enabled, the frames passed with motion vectors and depth (set_space_warp_frames) are submitted with the space warp information, 
+        and the runtime synthesizes every other frame from them. The motion vector and depth swapchains are created with the first space warp frames.
+        It must be called after creating the instance (create_instance)
+
+        Parameters
+        ----------
+        enable: bool, optional
+            Whether to enable the application space warp (default: True)
+
+        Returns
+        -------
+        bool
+            True if the space warp has been enabled (or disabled), otherwise False (e.g. the extension is not supported by the runtime)
+        """
+        if self._disable_openxr:
+            return True
+
+        self._space_warp_frames = None
+        if self._use_ctypes:
+            return bool(self._lib.setSpaceWarp(self._app, enable))
+        else:
+            return self._app.setSpaceWarp(enable)
+
+    def is_space_warp_active(self) -> bool:
+        """
+        Whether the last submitted frame carried the space warp information of all the views (XR_FB_space_warp)
+
+        While it is active, the runtime synthesizes every other display frame: the frame loop is paced at half the display rate 
+        and the simulator only needs to produce frames (render_views) at that rate
+
+        Returns
+        -------
+        bool
+            True if the runtime synthesizes the intermediate frames, otherwise False
+        """
+        if self._disable_openxr:
+            return False
+
+        if self._use_ctypes:
+            return bool(self._lib.isSpaceWarpActive(self._app))
+        else:
+            return self._app.isSpaceWarpActive()
+
+    def get_space_warp_resolution(self) -> Union[tuple, None]:
+        """
+        Get the recommended resolution of the motion vectors and depth images (XR_FB_space_warp)
+
+        It must be called after creating the instance (create_instance)
+
+        Returns
+        -------
+        tuple or None
+            Width and height of the motion vector images, or None if the extension is not supported by the runtime
+        """
+        if self._disable_openxr:
+            return None
+
+        if self._use_ctypes:
+            width, height = ctypes.c_int(0), ctypes.c_int(0)
+            if not self._lib.getSpaceWarpResolution(self._app, ctypes.byref(width), ctypes.byref(height)):
+                return None
+            return width.value, height.value
+        else:
+            result = self._app.getSpaceWarpResolution()
+            if not result[0]:
+                return None
+            return result[1], result[2]
+
+    def set_space_warp_frames(self, left_motion_vectors: numpy.ndarray, left_depth: numpy.ndarray, 
+                              right_motion_vectors: numpy.ndarray = None, right_depth: numpy.ndarray = None, near: float = 0.1, far: float = 1000.0) -> bool:
+        """
+        Pass the motion vectors and depth of the frames set in the same render callback (XR_FB_space_warp)
+
+        In the case of stereoscopic devices, the left and right parameters represent the left eye and right eye respectively.
+        For monoscopic devices only the left parameters are used.
+        Use set_view_space_warp_frames for other view configurations (e.g. quad views)
+
+        The motion vectors are the motion of each pixel from the previous frame in normalized device coordinates (x, y, z) 
+        and the depth is the linear distance to the image plane in stage units. 
+        Both images have the same size, not larger than the recommended resolution (get_space_warp_resolution), and the same row order as the frames. 
+        The transformations defined by the set_frame_transformations function are not applied.
+        The space warp information only applies to the next submitted frame: it must be passed in every render callback to keep the runtime synthesizing frames.
+        Passing None as left_motion_vectors submits the next frames without space warp information
+
+        Parameters
+        ----------
+        left_motion_vectors: numpy.ndarray or None
+            Motion vectors of the left (or single) view with 3 or 4 channels (numpy.float32)
+        left_depth: numpy.ndarray or None
+            Linear depth image of the left (or single) view in stage units
+        right_motion_vectors: numpy.ndarray or None, optional
+            Motion vectors of the right view with 3 or 4 channels (numpy.float32)
+        right_depth: numpy.ndarray or None, optional
+            Linear depth image of the right view in stage units
+        near: float, optional
+            Near clipping plane distance in stage units (default: 0.1)
+        far: float, optional
+            Far clipping plane distance in stage units (default: 1000.0)
+
+        Returns
+        -------
+        bool
+            True if the space warp frames have been set, otherwise False (e.g. the space warp is not enabled)
+        """
+        # the number of views is used (not the given images): None images submit the views without space warp information
+        if len(self.get_recommended_resolutions()) == 1:
+            return self.set_view_space_warp_frames([left_motion_vectors], [left_depth], near, far)
+        return self.set_view_space_warp_frames([left_motion_vectors, right_motion_vectors], [left_depth, right_depth], near, far)
+
+    def set_view_space_warp_frames(self, motion_vectors: list, depths: list, near: float = 0.1, far: float = 1000.0) -> bool:
+        """
+        Pass the motion vectors and depth of each view of any view configuration (XR_FB_space_warp)
+
+        The images are indexed as the views (see set_view_frames) and follow the same rules as set_space_warp_frames. 
+        A None motion vector image submits its view without space warp information
+
+        Parameters
+        ----------
+        motion_vectors: list of numpy.ndarray or None
+            Motion vectors of each view with 3 or 4 channels (numpy.float32)
+        depths: list of numpy.ndarray or None
+            Linear depth image of each view in stage units
+        near: float, optional
+            Near clipping plane distance in stage units (default: 0.1)
+        far: float, optional
+            Far clipping plane distance in stage units (default: 1000.0)
+
+        Returns
+        -------
+        bool
+            True if the space warp frames have been set, otherwise False (e.g. the space warp is not enabled or the number of images does not match the number of views)
+        """
+        if len(motion_vectors) != len(depths):
+            return False
+
+        if self._disable_openxr:
+            return True
+
+        # the references are kept because the library only stores the pointers until the next frame
+        def _motion_vectors(motion_vectors):
+            if motion_vectors is None:
+                return None
+            if motion_vectors.shape[2] == 3:
+                motion_vectors = np.concatenate((motion_vectors, np.zeros(motion_vectors.shape[:2] + (1,), dtype=motion_vectors.dtype)), axis=2)
+            return np.ascontiguousarray(motion_vectors, dtype=np.float32)
+
+        def _depth(depth):
+            if depth is None:
+                return None
+            if self._meters_per_unit != 1.0:
+                depth = depth * self._meters_per_unit
+            return np.ascontiguousarray(depth, dtype=np.float32)
+
+        motion_vectors = [_motion_vectors(frame) for frame in motion_vectors]
+        depths = [_depth(depth) for depth in depths]
+        self._space_warp_frames = (motion_vectors, depths)
+        near, far = near * self._meters_per_unit, far * self._meters_per_unit
+        if self._use_ctypes:
+            num_views = len(motion_vectors)
+            widths = (ctypes.c_int * num_views)(*[frame.shape[1] if frame is not None else 0 for frame in motion_vectors])
+            heights = (ctypes.c_int * num_views)(*[frame.shape[0] if frame is not None else 0 for frame in motion_vectors])
+            pointers = (ctypes.c_void_p * num_views)(*[frame.ctypes.data if frame is not None else None for frame in motion_vectors])
+            depth_widths = (ctypes.c_int * num_views)(*[depth.shape[1] if depth is not None else 0 for depth in depths])
+            depth_heights = (ctypes.c_int * num_views)(*[depth.shape[0] if depth is not None else 0 for depth in depths])
+            depth_pointers = (ctypes.c_void_p * num_views)(*[depth.ctypes.data if depth is not None else None for depth in depths])
+            return bool(self._lib.setViewSpaceWarpFrames(self._app, num_views, widths, heights, pointers, depth_widths, depth_heights, depth_pointers, 
+                                                         ctypes.c_float(near), ctypes.c_float(far)))
+        else:
+            return self._app.setViewSpaceWarpFrames(motion_vectors, depths, near, far)
+
+    # view utilities
+
+    def setup_mono_view(self, camera: Union[str, pxr.Sdf.Path, pxr.Usd.Prim] = "/OpenXR/Cameras/camera", camera_properties: dict = {"focalLength": 10}) -> None:
+        """
+        Setup Omniverse viewport and camera for monoscopic rendering
+
+        This method obtains the viewport window for the given camera. If the viewport window does not exist, a new one is created and the camera is set as active. If the given camera does not exist, a new camera is created with the same path and set to the recommended resolution of the display device
+        
+        Parameters
+        ----------
+        camera: str, pxr.Sdf.Path or pxr.Usd.Prim, optional
+            Omniverse camera prim or path (default: '/OpenXR/Cameras/camera')
+        camera_properties: dict
+            Dictionary containing the [camera properties](https://docs.omniverse.nvidia.com/app_create/prod_materials-and-rendering/cameras.html#camera-properties) supported by the Omniverse kit to be set (default: {"focalLength": 10})
+        """
+        self.setup_views([camera], camera_properties)
+
+    def setup_stereo_view(self, left_camera: Union[str, pxr.Sdf.Path, pxr.Usd.Prim] = "/OpenXR/Cameras/left_camera", right_camera: Union[str, pxr.Sdf.Path, pxr.Usd.Prim, None] = "/OpenXR/Cameras/right_camera", camera_properties: dict = {"focalLength": 10}) -> None:
+        """
+        Setup Omniverse viewports and cameras for stereoscopic rendering
+
+        This method obtains the viewport window for each camera. If the viewport window does not exist, a new one is created and the camera is set as active. If the given cameras do not exist, new cameras are created with the same path and set to the recommended resolution of the display device
+        
+        Parameters
+        ----------
+        left_camera: str, pxr.Sdf.Path or pxr.Usd.Prim, optional
+            Omniverse left camera prim or path (default: '/OpenXR/Cameras/left_camera')
+        right_camera: str, pxr.Sdf.Path or pxr.Usd.Prim, optional
+            Omniverse right camera prim or path (default: '/OpenXR/Cameras/right_camera')
+        camera_properties: dict
+            Dictionary containing the [camera properties](https://docs.omniverse.nvidia.com/app_create/prod_materials-and-rendering/cameras.html#camera-properties) supported by the Omniverse kit to be set (default: {"focalLength": 10})
+        """
+        self.setup_views([left_camera] if right_camera is None else [left_camera, right_camera], camera_properties)
+
+    def setup_views(self, cameras: Union[list, None] = None, camera_properties: dict = {"focalLength": 10}) -> None:
+        """
+        Setup Omniverse viewports and cameras for any view configuration (one camera per view)
+
+        This method obtains the viewport window for each camera. If the viewport window does not exist, a new one is created and the camera is set as active. If the given cameras do not exist, new cameras are created with the same path and set to the recommended resolution of their view.
+        For quad views (XR_VARJO_quad_views), the cameras of the inner foveal views (2 and 3) are kept in the same pose as the context views (0 and 1) 
+        by the internal render callback and their focal length is scaled to the narrower field of view of the inner views
+
+        Parameters
+        ----------
+        cameras: list of str, pxr.Sdf.Path or pxr.Usd.Prim, or None, optional
+            Omniverse camera prims or paths, one per view (default: None).
+            If None, the cameras are created under '/OpenXR/Cameras' according to the number of views of the system (e.g. 'left_camera', 'right_camera', 'left_inner_camera' and 'right_inner_camera' for quad views)
+        camera_properties: dict
+            Dictionary containing the [camera properties](https://docs.omniverse.nvidia.com/app_create/prod_materials-and-rendering/cameras.html#camera-properties) supported by the Omniverse kit to be set (default: {"focalLength": 10})
+        """
+        def get_or_create_vieport_window(camera, teleport=True, window_size=(400, 300), resolution=(1280, 720)):
+            window = None
+            camera = str(camera.GetPath() if type(camera) is Usd.Prim else camera)
+            # get viewport window
+            for interface in self._viewport_interface.get_instance_list():
+                w = self._viewport_interface.get_viewport_window(interface)
+                if camera == w.get_active_camera():
+                    window = w
+                    # check visibility
+                    if not w.is_visible():
+                        w.set_visible(True)
+                    break
+            # create viewport window if not exist
+            if window is None:
+                window = self._viewport_interface.get_viewport_window(self._viewport_interface.create_instance())
+                window.set_window_size(*window_size)
+                window.set_active_camera(camera)
+                window.set_texture_resolution(*resolution)
+                if teleport:
+                    window.set_camera_position(camera, 1.0, 1.0, 1.0, True)
+                    window.set_camera_target(camera, 0.0, 0.0, 0.0, True)
+            return window
+
+        if cameras is None:
+            names = {1: ["camera"], 2: ["left_camera", "right_camera"], 4: ["left_camera", "right_camera", "left_inner_camera", "right_inner_camera"]}
+            num_views = len(self.get_recommended_resolutions())
+            cameras = ["/OpenXR/Cameras/" + name for name in names.get(num_views, ["camera_{}".format(i) for i in range(num_views)])]
+        
+        stage = omni.usd.get_context().get_stage()
+
+        self._prims = []
+        self._viewport_windows = []
+        self._inner_view_ratios = {}
+        for camera in cameras:
+            teleport_camera = False
+            if type(camera) is Usd.Prim:
+                prim = camera
+            elif stage.GetPrimAtPath(camera).IsValid():
+                prim = stage.GetPrimAtPath(camera)
+            else:
+                teleport_camera = True
+                prim = stage.DefinePrim(omni.usd.get_stage_next_free_path(stage, camera, False), "Camera")
+            self._prims.append(prim)
+            self._viewport_windows.append(get_or_create_vieport_window(prim, teleport=teleport_camera))
+
+        # set recommended resolution (scaled according to the current render quality)
+        self.set_render_quality(self._render_scale, self._render_rate_divisor)
+
+        # set camera properties
+        for prim in self._prims:
+            for property in camera_properties:
+                prim.GetAttribute(property).Set(camera_properties[property])
+        
+        # enable sensors
+        for viewport_window in self._viewport_windows:
+            sensors.enable_sensors(viewport_window, [_syntheticdata.SensorType.Rgb])
+
+    def get_recommended_resolutions(self) -> tuple:
+        """
+        Get the recommended resolution of the display device
+        
+        Returns
+        -------
+        tuple
+            Tuple containing the recommended resolutions (width, height) of each device view.
+            If the tuple length is 2, index 0 represents the left eye and index 1 represents the right eye.
+            If the tuple length is 4 (quad views), indices 0 and 1 represent the context views and indices 2 and 3 the inner foveal views of the left and right eye
+        """
+        if self._disable_openxr:
+            return ([512, 512], [1024, 1024])
+
+        if self._use_ctypes:
+            num_views = self._lib.getViewConfigurationViewsSize(self._app)
+            views = (XrViewConfigurationView * num_views)()
+            if self._lib.getViewConfigurationViews(self._app, views, num_views):
+                return [(view.recommendedImageRectWidth, view.recommendedImageRectHeight) for view in views]
+            else:
+                return tuple([])
+        else:
+            return tuple([(view["recommendedImageRectWidth"], view["recommendedImageRectHeight"]) for view in self._app.getViewConfigurationViews()])
+
+    def set_reference_system_pose(self, position: Union[pxr.Gf.Vec3d, None] = None, rotation: Union[pxr.Gf.Vec3d, None] = None) -> None:
+        """
+        Set the pose of the origin of the reference system
+
+        Parameters
+        ----------
+        position: pxr.Gf.Vec3d or None, optional
+            Cartesian position (in stage unit) (default: None)
+        rotation: pxr.Gf.Vec3d or None, optional
+            Rotation (in degress) on each axis (default: None)
+        """
+        self._reference_position = position
+        self._reference_rotation = rotation
+
+    def set_stereo_rectification(self, x: float = 0, y: float = 0, z: float = 0) -> None:
+        """
+        Set the angle (in radians) of the rotation axes for stereoscopic view rectification
+
+        Parameters
+        ----------
+        x: float, optional
+            Angle (in radians) of the X-axis (default: 0)
+        y: float, optional
+            Angle (in radians) of the Y-axis (default: 0)
+        x: float, optional
+            Angle (in radians) of the Z-axis (default: 0)
+        """
+        self._rectification_quat_left = pxr.Gf.Quatd(1, 0, 0, 0)
+        self._rectification_quat_right = pxr.Gf.Quatd(1, 0, 0, 0)
+        if x:   # w,x,y,z = cos(a/2), sin(a/2), 0, 0
+            self._rectification_quat_left *= pxr.Gf.Quatd(np.cos(x/2), np.sin(x/2), 0, 0)
+            self._rectification_quat_right *= pxr.Gf.Quatd(np.cos(-x/2), np.sin(-x/2), 0, 0)
+        if y:   # w,x,y,z = cos(a/2), 0, sin(a/2), 0
+            self._rectification_quat_left *= pxr.Gf.Quatd(np.cos(y/2), 0, np.sin(y/2), 0)
+            self._rectification_quat_right *= pxr.Gf.Quatd(np.cos(-y/2), 0, np.sin(-y/2), 0)
+        if z:   # w,x,y,z = cos(a/2), 0, 0, sin(a/2)
+            self._rectification_quat_left *= pxr.Gf.Quatd(np.cos(z/2), 0, 0, np.sin(z/2))
+            self._rectification_quat_right *= pxr.Gf.Quatd(np.cos(-z/2), 0, 0, np.sin(-z/2))
+
+    def set_meters_per_unit(self, meters_per_unit: float):
+        """
+        Specify the meters per unit to be applied to transformations
+
+        E.g. 1 meter: 1.0, 1 centimeter: 0.01
+        
+        Parameters
+        ----------
+        meters_per_unit: float
+            Meters per unit
+        """
+        assert meters_per_unit != 0
+        self._meters_per_unit = meters_per_unit
+
+    def set_frame_transformations(self, fit: bool = False, flip: Union[int, tuple, None] = None) -> None:
+        """
+        Specify the transformations to be applied to the rendered images
+
+        Parameters
+        ----------
+        fit: bool, optional
+            Adjust each rendered image to the recommended resolution of the display device by cropping and scaling the image from its center (default: False)
+            OpenCV.resize method with INTER_LINEAR interpolation will be used to scale the image to the recommended resolution
+        flip: int, tuple or None, optional
+            Flip each image around vertical (0), horizontal (1), or both axes (0,1) (default: None) 
+        """
+        self._transform_fit = fit
+        self._transform_flip = flip
+
+    def teleport_prim(self, prim: pxr.Usd.Prim, position: pxr.Gf.Vec3d, rotation: pxr.Gf.Quatd, reference_position: Union[pxr.Gf.Vec3d, None] = None, reference_rotation: Union[pxr.Gf.Vec3d, None] = None) -> None:
+        """
+        Teleport the prim specified by the given transformation (position and rotation)
+
+        Parameters
+        ----------
+        prim: pxr.Usd.Prim
+            Target prim
+        position: pxr.Gf.Vec3d
+            Cartesian position (in stage unit) used to transform the prim
+        rotation: pxr.Gf.Quatd
+            Rotation (as quaternion) used to transform the prim
+        reference_position: pxr.Gf.Vec3d or None, optional
+            Cartesian position (in stage unit) used as reference system (default: None)
+        reference_rotation: pxr.Gf.Vec3d or None, optional
+            Rotation (in degress) on each axis used as reference system (default: None)
+        """
+        properties = prim.GetPropertyNames()
+
+        # reference position
+        if reference_position is not None:
+            if "xformOp:translate" in properties or "xformOp:translation" in properties:
+                prim.GetAttribute("xformOp:translate").Set(reference_position + position)
+            else:
+                print("[INFO] Create UsdGeom.XformOp.TypeTranslate for", prim.GetPath())
+                UsdGeom.Xformable(prim).AddXformOp(UsdGeom.XformOp.TypeTranslate, UsdGeom.XformOp.PrecisionDouble, "").Set(reference_position + position)
+        else:
+            if "xformOp:translate" in properties or "xformOp:translation" in properties:
+                prim.GetAttribute("xformOp:translate").Set(position)
+            else:
+                print("[INFO] Create UsdGeom.XformOp.TypeTranslate for", prim.GetPath())
+                UsdGeom.Xformable(prim).AddXformOp(UsdGeom.XformOp.TypeTranslate, UsdGeom.XformOp.PrecisionDouble, "").Set(position)
+
+        # reference rotation
         if reference_rotation is not None:
             if "xformOp:rotate" in properties:
                 prim.GetAttribute("xformOp:rotate").Set(reference_rotation)
@@ -946,7 +2454,7 @@ class OpenXR:
 
         The callback function (a callable object) should have only the following 3 parameters:
         - num_views: int
-           The number of views to render: mono (1), stereo (2)
+           The number of views to render: mono (1), stereo (2), quad views (4: left and right context views, left and right inner foveal views)
         - views: tuple of XrView structure
            A [XrView](https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrView) structure contains the view pose and projection state necessary to render a image.
            The length of the tuple corresponds to the number of views (if the tuple length is 2, index 0 represents the left eye and index 1 represents the right eye)
@@ -954,9 +2462,10 @@ class OpenXR:
            A [XrViewConfigurationView](https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrViewConfigurationView) structure specifies properties related to rendering of a view (e.g. the optimal width and height to be used when rendering the view).
            The length of the tuple corresponds to the number of views (if the tuple length is 2, index 0 represents the left eye and index 1 represents the right eye)
 
-        The callback function must call the set_frames function to pass to the selected graphics API the image or images to be rendered
+        The callback function must call the set_frames (or set_view_frames for any number of views) function to pass to the selected graphics API the image or images to be rendered
 
         If the callback is None, an internal callback will be used to render the views. This internal callback updates the pose of the cameras according to the specified reference system, gets the images from the previously configured viewports and invokes the set_frames function to render the views.
+        In a tracking-only session (set_headless) the callback only delivers the view poses: the internal callback does nothing and a custom callback should not render nor call set_frames
 
         Parameters
         ----------
@@ -1000,26 +2509,28 @@ class OpenXR:
             self._callback_render(num_views, _views, _configuration_views)
 
         def _internal_render(num_views, views, configuration_views):
-            # teleport left camera
-            position = views[0].pose.position
-            rotation = views[0].pose.orientation
-            position = Gf.Vec3d(position.x, -position.z, position.y) / self._meters_per_unit
-            rotation = Gf.Quatd(rotation.w, rotation.x, rotation.y, rotation.z) * self._rectification_quat_left
-            self.teleport_prim(self._prim_left, position, rotation, self._reference_position, self._reference_rotation)            
-
-            # teleport right camera
-            if num_views == 2:
-                position = views[1].pose.position
-                rotation = views[1].pose.orientation
+            # lower render rate (keep the last frames)
+            self._render_counter += 1
+            if self._render_rate_divisor > 1 and self._render_counter % self._render_rate_divisor:
+                return
+            # tracking-only session: there are no swapchains to fill, so the cameras are not moved and the viewports are not read back
+            if self.is_headless():
+                return
+
+            # teleport cameras (the inner views of quad views share the eye of the context views)
+            for i in range(min(num_views, len(self._prims))):
+                position = views[i].pose.position
+                rotation = views[i].pose.orientation
                 position = Gf.Vec3d(position.x, -position.z, position.y) / self._meters_per_unit
-                rotation = Gf.Quatd(rotation.w, rotation.x, rotation.y, rotation.z) * self._rectification_quat_right
-                self.teleport_prim(self._prim_right, position, rotation, self._reference_position, self._reference_rotation)
-            
+                rotation = Gf.Quatd(rotation.w, rotation.x, rotation.y, rotation.z) * (self._rectification_quat_right if i % 2 else self._rectification_quat_left)
+                self.teleport_prim(self._prims[i], position, rotation, self._reference_position, self._reference_rotation)
+                if i >= 2:
+                    self._fit_inner_view(i, views)
+
             # set frames
             try:
-                frame_left = sensors.get_rgb(self._viewport_window_left)
-                frame_right = sensors.get_rgb(self._viewport_window_right) if num_views == 2 else None
-                self.set_frames(configuration_views, frame_left, frame_right)
+                frames = [sensors.get_rgb(viewport_window) for viewport_window in self._viewport_windows[:num_views]]
+                self.set_view_frames(configuration_views, frames)
             except Exception as e:
                 print("[ERROR]", str(e))
         
@@ -1037,15 +2548,20 @@ class OpenXR:
             self._callback_middle_render = _middle_callback
             self._app.setRenderCallback(self._callback_middle_render)
 
-    def set_frames(self, configuration_views: list, left: numpy.ndarray, right: numpy.ndarray = None) -> bool:
+    def set_frames(self, configuration_views: list, left: numpy.ndarray, right: numpy.ndarray = None, 
+                   left_depth: numpy.ndarray = None, right_depth: numpy.ndarray = None, near: float = 0.1, far: float = 1000.0) -> bool:
         """
         Pass to the selected graphics API the images to be rendered in the views
 
         In the case of stereoscopic devices, the parameters left and right represent the left eye and right eye respectively.
-        To pass an image to the graphic API of monoscopic devices only the parameter left should be used (the parameter right must be None)
+        To pass an image to the graphic API of monoscopic devices only the parameter left should be used (the parameter right must be None).
+        Use set_view_frames for other view configurations (e.g. quad views)
 
         This function will apply to each image the transformations defined by the set_frame_transformations function if they were specified
 
+        The depth images (linear distance to the image plane in stage units) are submitted through the XR_KHR_composition_layer_depth extension, if it is supported by the runtime, 
+        to improve the runtime's reprojection. They must be the same size as the frames once transformed and not larger than the recommended size
+
         Parameters
         ----------
         configuration_views: tuple of XrViewConfigurationView structure
@@ -1054,37 +2570,100 @@ class OpenXR:
             RGB or RGBA image (numpy.uint8)  
         right: numpy.ndarray or None
             RGB or RGBA image (numpy.uint8)
+        left_depth: numpy.ndarray or None, optional
+            Linear depth image of the left (or single) view in stage units (None: no depth is submitted)
+        right_depth: numpy.ndarray or None, optional
+            Linear depth image of the right view in stage units (None: no depth is submitted)
+        near: float, optional
+            Near clipping plane distance in stage units (default: 0.1)
+        far: float, optional
+            Far clipping plane distance in stage units (default: 1000.0)
+
+        Returns
+        -------
+        bool
+            True if there is no error during the passing to the selected graphics API, otherwise False
+        """
+        if right is None:
+            return self.set_view_frames(configuration_views, [left], [left_depth], near, far)
+        return self.set_view_frames(configuration_views, [left, right], [left_depth, right_depth], near, far)
+
+    def set_view_frames(self, configuration_views: list, frames: list, depths: Union[list, None] = None, near: float = 0.1, far: float = 1000.0) -> bool:
+        """
+        Pass to the selected graphics API the images to be rendered in each view of any view configuration
+
+        The images are indexed as the views: mono (0), stereo (0: left eye, 1: right eye), quad views (0 and 1: left and right context views, 2 and 3: left and right inner foveal views).
+        Each image may have a different size (e.g. the recommended resolution of its view). A None image is not rendered in its view
+
+        This function will apply to each image the transformations defined by the set_frame_transformations function if they were specified
+
+        Parameters
+        ----------
+        configuration_views: tuple of XrViewConfigurationView structure
+            A [XrViewConfigurationView](https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrViewConfigurationView) structure specifies properties related to rendering of a view (e.g. the optimal width and height to be used when rendering the view)
+        frames: list of numpy.ndarray or None
+            RGB or RGBA image (numpy.uint8) of each view. All the images must have the same number of channels
+        depths: list of numpy.ndarray or None, or None, optional
+            Linear depth image of each view in stage units (None: no depth is submitted) (see set_frames)
+        near: float, optional
+            Near clipping plane distance in stage units (default: 0.1)
+        far: float, optional
+            Far clipping plane distance in stage units (default: 1000.0)
 
         Returns
         -------
         bool
             True if there is no error during the passing to the selected graphics API, otherwise False
         """
-        use_rgba = True if left.shape[2] == 4 else False
+        use_rgba = any(frame is not None and frame.shape[2] == 4 for frame in frames)
 
         if self._disable_openxr:
             return True
 
+        # the references are kept because the library only stores the pointers until the next frame
+        self._frames = [self._transform(configuration_views[i], frame) if frame is not None else None for i, frame in enumerate(frames)]
         if self._use_ctypes:
-            self._frame_left = self._transform(configuration_views[0], left)
-            if right is None:
-                return bool(self._lib.setFrames(self._app, 
-                                                self._frame_left.shape[1], self._frame_left.shape[0], self._frame_left.ctypes.data_as(ctypes.c_void_p),
-                                                0, 0, None, 
-                                                use_rgba))
-            else:
-                self._frame_right = self._transform(configuration_views[1], right)
-                return bool(self._lib.setFrames(self._app, 
-                                                self._frame_left.shape[1], self._frame_left.shape[0], self._frame_left.ctypes.data_as(ctypes.c_void_p),
-                                                self._frame_right.shape[1], self._frame_right.shape[0], self._frame_right.ctypes.data_as(ctypes.c_void_p),
-                                                use_rgba))
-        else:
-            self._frame_left = self._transform(configuration_views[0], left)
-            if right is None:
-                return self._app.setFrames(self._frame_left, np.array(None), use_rgba)
-            else:
-                self._frame_right = self._transform(configuration_views[1], right)
-                return self._app.setFrames(self._frame_left, self._frame_right, use_rgba)
+            num_views = len(self._frames)
+            widths = (ctypes.c_int * num_views)(*[frame.shape[1] if frame is not None else 0 for frame in self._frames])
+            heights = (ctypes.c_int * num_views)(*[frame.shape[0] if frame is not None else 0 for frame in self._frames])
+            pointers = (ctypes.c_void_p * num_views)(*[frame.ctypes.data if frame is not None else None for frame in self._frames])
+            status = bool(self._lib.setViewFrames(self._app, num_views, widths, heights, pointers, use_rgba))
+        else:
+            status = self._app.setViewFrames(self._frames, use_rgba)
+        
+        # depth (submitted only if any view has or had depth)
+        depths = depths if depths is not None else [None] * len(self._frames)
+        if not status or all(depth is None for depth in list(depths) + self._depths):
+            return status
+        self._depths = [self._transform_depth(configuration_views[i], depth) for i, depth in enumerate(depths[:len(self._frames)])]
+        self._depths += [None] * (len(self._frames) - len(self._depths))
+        near, far = near * self._meters_per_unit, far * self._meters_per_unit
+        if self._use_ctypes:
+            num_views = len(self._depths)
+            widths = (ctypes.c_int * num_views)(*[depth.shape[1] if depth is not None else 0 for depth in self._depths])
+            heights = (ctypes.c_int * num_views)(*[depth.shape[0] if depth is not None else 0 for depth in self._depths])
+            pointers = (ctypes.c_void_p * num_views)(*[depth.ctypes.data if depth is not None else None for depth in self._depths])
+            return bool(self._lib.setViewDepthFrames(self._app, num_views, widths, heights, pointers, ctypes.c_float(near), ctypes.c_float(far)))
+        else:
+            return self._app.setViewDepthFrames(self._depths, near, far)
+
+    def _fit_inner_view(self, index: int, views: list) -> None:
+        # scale the focal length of an inner view camera (quad views) by the ratio of the field of view of its context view
+        context, inner = views[index - 2].fov, views[index].fov
+        ratio = (np.tan(context.angleRight) - np.tan(context.angleLeft)) / (np.tan(inner.angleRight) - np.tan(inner.angleLeft))
+        if self._inner_view_ratios.get(index) == ratio:
+            return
+        self._inner_view_ratios[index] = ratio
+        focal_length = self._prims[index - 2].GetAttribute("focalLength").Get()
+        self._prims[index].GetAttribute("focalLength").Set(focal_length * ratio)
+
+    def _transform_depth(self, configuration_view: XrViewConfigurationView, depth: np.ndarray) -> np.ndarray:
+        if depth is None:
+            return None
+        depth = self._transform(configuration_view, depth)
+        if self._meters_per_unit != 1.0:
+            depth = depth * self._meters_per_unit
+        return np.ascontiguousarray(depth, dtype=np.float32)
 
     def _transform(self, configuration_view: XrViewConfigurationView, frame: np.ndarray) -> np.ndarray:
         transformed = False
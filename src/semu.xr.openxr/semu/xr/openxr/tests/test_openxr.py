@@ -7,8 +7,10 @@ import omni.kit.test
 from semu.xr.openxr import _openxr
 
 import cv2
+import ctypes
 import time
 import numpy as np
+from unittest import mock
 
 # Having a test class dervived from omni.kit.test.AsyncTestCase declared on the root of module will make it auto-discoverable by omni.kit.test
 class TestOpenXR(omni.kit.test.AsyncTestCaseFailOnLogError):
@@ -46,6 +48,514 @@ class TestOpenXR(omni.kit.test.AsyncTestCaseFailOnLogError):
             print("FPS: {} ({} frames / {} seconds)".format(num_frames / delta, num_frames, delta))
             print("RESOLUTION: {} x {}".format(self._frame.shape[1], self._frame.shape[0]))
 
+    def mocked_interface(self, use_ctypes=True):
+        # OpenXR enabled on a mocked library: the Python side (arguments, per-view handling) runs without a runtime
+        lib = mock.MagicMock()
+        with mock.patch.object(_openxr, "_load_library", return_value=lib):
+            xr = _openxr.acquire_openxr_interface()
+            self.assertTrue(xr.init(use_ctypes=use_ctypes))
+        return xr, lib
+
+    def configuration_views(self, resolutions):
+        configuration_views = []
+        for width, height in resolutions:
+            configuration_view = _openxr.XrViewConfigurationView()
+            configuration_view.recommendedImageRectWidth = width
+            configuration_view.recommendedImageRectHeight = height
+            configuration_views.append(configuration_view)
+        return configuration_views
+
+    # mono/stereo delegation (OpenXR disabled: no runtime is required)
+    async def test_view_frames_delegation(self):
+        xr = _openxr.acquire_openxr_interface(disable_openxr=True)
+        self.assertTrue(xr.init())
+
+        frame = np.zeros((64, 64, 3), dtype=np.uint8)
+        depth = np.ones((64, 64), dtype=np.float32)
+        configuration_views = [None] * 2
+
+        with mock.patch.object(xr, "set_view_frames", return_value=True) as set_view_frames:
+            self.assertTrue(xr.set_frames(configuration_views, frame))
+            set_view_frames.assert_called_with(configuration_views, [frame], [None], 0.1, 1000.0)
+            self.assertTrue(xr.set_frames(configuration_views, frame, frame, depth, depth))
+            set_view_frames.assert_called_with(configuration_views, [frame, frame], [depth, depth], 0.1, 1000.0)
+
+        _openxr.release_openxr_interface(xr)
+
+    # quad views (context views 0 and 1, inner views 2 and 3): per-view sizes, missing views and depth in meters
+    async def test_view_frames(self):
+        xr, lib = self.mocked_interface()
+        xr.set_meters_per_unit(0.01)
+        configuration_views = self.configuration_views([(64, 48), (64, 48), (32, 32), (32, 32)])
+
+        frame = np.zeros((48, 64, 3), dtype=np.uint8)
+        inner_frame = np.zeros((32, 32, 4), dtype=np.uint8)
+        depth = np.full((48, 64), 200.0)
+        inner_depth = np.full((32, 32), 50.0)
+        self.assertTrue(xr.set_view_frames(configuration_views, [frame, frame, inner_frame, None], [depth, None, inner_depth, None], near=10, far=1000))
+
+        args = lib.setViewFrames.call_args[0]
+        self.assertEqual(args[1], 4)
+        self.assertEqual(list(args[2]), [64, 64, 32, 0])
+        self.assertEqual(list(args[3]), [48, 48, 32, 0])
+        self.assertEqual(args[4][0], frame.ctypes.data)
+        self.assertIsNone(args[4][3])
+        self.assertTrue(args[5])
+
+        args = lib.setViewDepthFrames.call_args[0]
+        self.assertEqual(list(args[2]), [64, 0, 32, 0])
+        self.assertEqual(list(args[3]), [48, 0, 32, 0])
+        self.assertAlmostEqual(args[5].value, 0.1, places=5)
+        self.assertAlmostEqual(args[6].value, 10.0, places=5)
+        self.assertEqual(xr._depths[0].dtype, np.float32)
+        self.assertTrue(np.allclose(xr._depths[0], 2.0) and np.allclose(xr._depths[2], 0.5))
+
+        # the depth submission is stopped (empty views) once the depth images are no longer passed
+        lib.setViewDepthFrames.reset_mock()
+        self.assertTrue(xr.set_view_frames(configuration_views, [frame, frame, inner_frame, inner_frame]))
+        self.assertEqual(list(lib.setViewDepthFrames.call_args[0][2]), [0, 0, 0, 0])
+        lib.setViewDepthFrames.reset_mock()
+        self.assertTrue(xr.set_view_frames(configuration_views, [frame, frame, inner_frame, inner_frame]))
+        lib.setViewDepthFrames.assert_not_called()
+
+        _openxr.release_openxr_interface(xr)
+
+    # frame transformations of the depth: each view is fitted to its own recommended size
+    async def test_transform_depth(self):
+        xr, lib = self.mocked_interface()
+        xr.set_meters_per_unit(0.01)
+        xr.set_frame_transformations(fit=True, flip=0)
+        context_view, inner_view = self.configuration_views([(64, 48), (32, 32)])
+
+        depth = np.repeat(np.arange(60, dtype=np.float32)[:, None], 100, axis=1)
+        context_depth = xr._transform_depth(context_view, depth)
+        inner_depth = xr._transform_depth(inner_view, depth)
+        self.assertEqual(context_depth.shape, (48, 64))
+        self.assertEqual(inner_depth.shape, (32, 32))
+        self.assertEqual(context_depth.dtype, np.float32)
+        self.assertTrue(context_depth.flags["C_CONTIGUOUS"])
+        # flipped rows, in meters
+        self.assertGreater(context_depth[0, 0], context_depth[-1, 0])
+        self.assertLessEqual(context_depth.max(), 0.59 + 1e-6)
+        self.assertIsNone(xr._transform_depth(context_view, None))
+
+        _openxr.release_openxr_interface(xr)
+
+    # inner view cameras (quad views): focal length scaled by the field of view ratio, only when it changes
+    async def test_fit_inner_view(self):
+        xr, lib = self.mocked_interface()
+        xr._prims = [mock.MagicMock() for _ in range(4)]
+        xr._prims[0].GetAttribute.return_value.Get.return_value = 10.0
+
+        views = [_openxr.XrView() for _ in range(4)]
+        for view, angle in zip(views, [0.8, 0.8, 0.4, 0.4]):
+            view.fov.angleLeft, view.fov.angleRight = -angle, angle
+        xr._fit_inner_view(2, views)
+        focal_length_set = xr._prims[2].GetAttribute.return_value.Set
+        focal_length_set.assert_called_once()
+        self.assertAlmostEqual(focal_length_set.call_args[0][0], 10.0 * np.tan(0.8) / np.tan(0.4), places=4)
+
+        xr._fit_inner_view(2, views)
+        focal_length_set.assert_called_once()
+        views[2].fov.angleLeft, views[2].fov.angleRight = -0.2, 0.2
+        xr._fit_inner_view(2, views)
+        self.assertEqual(focal_length_set.call_count, 2)
+        self.assertAlmostEqual(focal_length_set.call_args[0][0], 10.0 * np.tan(0.8) / np.tan(0.2), places=4)
+
+        _openxr.release_openxr_interface(xr)
+
+    async def test_view_space_warp_frames(self):
+        xr = _openxr.acquire_openxr_interface(disable_openxr=True)
+        self.assertTrue(xr.init())
+
+        motion_vectors = np.zeros((32, 32, 3), dtype=np.float32)
+        depth = np.ones((32, 32), dtype=np.float32)
+        self.assertFalse(xr.set_view_space_warp_frames([motion_vectors] * 4, [depth] * 2))
+
+        with mock.patch.object(xr, "set_view_space_warp_frames", return_value=True) as set_view_space_warp_frames:
+            with mock.patch.object(xr, "get_recommended_resolutions", return_value=([512, 512],)):
+                self.assertTrue(xr.set_space_warp_frames(motion_vectors, depth))
+                set_view_space_warp_frames.assert_called_with([motion_vectors], [depth], 0.1, 1000.0)
+            with mock.patch.object(xr, "get_recommended_resolutions", return_value=([512, 512], [512, 512])):
+                self.assertTrue(xr.set_space_warp_frames(motion_vectors, depth, motion_vectors, depth))
+                set_view_space_warp_frames.assert_called_with([motion_vectors, motion_vectors], [depth, depth], 0.1, 1000.0)
+                self.assertTrue(xr.set_space_warp_frames(None, None))
+                set_view_space_warp_frames.assert_called_with([None, None], [None, None], 0.1, 1000.0)
+
+        _openxr.release_openxr_interface(xr)
+
+        # quad views: per-view arguments, views without space warp information
+        xr, lib = self.mocked_interface()
+        self.assertFalse(xr.set_view_space_warp_frames([motion_vectors] * 4, [depth] * 2))
+        lib.setViewSpaceWarpFrames.assert_not_called()
+        inner_motion_vectors = np.zeros((16, 16, 4), dtype=np.float32)
+        inner_depth = np.ones((16, 16), dtype=np.float32)
+        self.assertTrue(xr.set_view_space_warp_frames([motion_vectors, None, inner_motion_vectors, None], [depth, None, inner_depth, None]))
+        args = lib.setViewSpaceWarpFrames.call_args[0]
+        self.assertEqual(args[1], 4)
+        self.assertEqual(list(args[2]), [32, 0, 16, 0])
+        self.assertEqual(list(args[6]), [32, 0, 16, 0])
+        self.assertIsNone(args[4][1])
+        self.assertEqual(args[7][2], xr._space_warp_frames[1][2].ctypes.data)
+
+        _openxr.release_openxr_interface(xr)
+
+    # performance settings (internal callback): the worst notification level of all the domains selects the render quality
+    async def test_performance_settings_policy(self):
+        xr = _openxr.acquire_openxr_interface(disable_openxr=True)
+        self.assertTrue(xr.init())
+
+        with mock.patch.object(xr, "set_render_quality") as set_render_quality:
+            xr.subscribe_performance_settings_event()
+            notify = xr._callback_performance_settings
+            notify(_openxr.XR_PERF_SETTINGS_DOMAIN_GPU_EXT, _openxr.XR_PERF_SETTINGS_SUB_DOMAIN_RENDERING_EXT, 
+                   _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT, _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT)
+            set_render_quality.assert_called_with(0.75, 1)
+            notify(_openxr.XR_PERF_SETTINGS_DOMAIN_CPU_EXT, _openxr.XR_PERF_SETTINGS_SUB_DOMAIN_THERMAL_EXT, 
+                   _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT, _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT)
+            set_render_quality.assert_called_with(0.5, 2)
+            # the GPU domain is still in warning level
+            notify(_openxr.XR_PERF_SETTINGS_DOMAIN_CPU_EXT, _openxr.XR_PERF_SETTINGS_SUB_DOMAIN_THERMAL_EXT, 
+                   _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT, _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT)
+            set_render_quality.assert_called_with(0.75, 1)
+            notify(_openxr.XR_PERF_SETTINGS_DOMAIN_GPU_EXT, _openxr.XR_PERF_SETTINGS_SUB_DOMAIN_RENDERING_EXT, 
+                   _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT, _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT)
+            set_render_quality.assert_called_with(1.0, 1)
+
+            # custom policy: only the given levels are replaced
+            xr.subscribe_performance_settings_event(policy={_openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT: (0.9, 1)})
+            notify = xr._callback_performance_settings
+            notify(_openxr.XR_PERF_SETTINGS_DOMAIN_GPU_EXT, _openxr.XR_PERF_SETTINGS_SUB_DOMAIN_RENDERING_EXT, 
+                   _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT, _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT)
+            set_render_quality.assert_called_with(0.9, 1)
+            notify(_openxr.XR_PERF_SETTINGS_DOMAIN_GPU_EXT, _openxr.XR_PERF_SETTINGS_SUB_DOMAIN_RENDERING_EXT, 
+                   _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT, _openxr.XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT)
+            set_render_quality.assert_called_with(0.5, 2)
+
+        # a custom callback replaces the internal policy
+        callback = mock.MagicMock()
+        xr.subscribe_performance_settings_event(callback)
+        self.assertIs(xr._callback_performance_settings, callback)
+
+        _openxr.release_openxr_interface(xr)
+
+    # internal render callback: the frames are only updated every rate divisor display frames (and never in a tracking-only session)
+    async def test_render_rate_divisor(self):
+        xr = _openxr.acquire_openxr_interface(disable_openxr=True)
+        self.assertTrue(xr.init())
+        xr.subscribe_render_event()
+        xr.set_render_quality(0.5, 3)
+        self.assertEqual((xr._render_scale, xr._render_rate_divisor), (0.5, 3))
+
+        configuration_views = self.configuration_views([(64, 64), (64, 64)])
+        with mock.patch.object(xr, "set_view_frames", return_value=True) as set_view_frames:
+            with mock.patch.object(xr, "is_headless", return_value=False):
+                for i in range(6):
+                    xr._callback_render(2, [None, None], configuration_views)
+                self.assertEqual(set_view_frames.call_count, 2)
+                xr.set_render_quality(1.0, 1)
+                for i in range(3):
+                    xr._callback_render(2, [None, None], configuration_views)
+                self.assertEqual(set_view_frames.call_count, 5)
+            with mock.patch.object(xr, "is_headless", return_value=True):
+                xr._callback_render(2, [None, None], configuration_views)
+                self.assertEqual(set_view_frames.call_count, 5)
+
+        # the viewports are resized with the recommended resolution of each view
+        xr._viewport_windows = [mock.MagicMock(), mock.MagicMock()]
+        xr.set_render_quality(0.5, 1)
+        xr._viewport_windows[0].set_texture_resolution.assert_called_with(256, 256)
+        xr._viewport_windows[1].set_texture_resolution.assert_called_with(512, 512)
+
+        _openxr.release_openxr_interface(xr)
+
+    # space warp frames: 3-channel motion vectors padded to RGBA, depth and clipping planes in meters
+    async def test_space_warp_frames(self):
+        xr, lib = self.mocked_interface(use_ctypes=False)
+        app = lib.OpenXrApplication.return_value
+        xr.set_meters_per_unit(0.01)
+
+        motion_vectors = np.full((16, 24, 3), 0.25, dtype=np.float32)
+        rgba_motion_vectors = np.full((16, 24, 4), 0.5, dtype=np.float32)
+        depth = np.full((16, 24), 300.0)
+        with mock.patch.object(xr, "get_recommended_resolutions", return_value=([512, 512], [512, 512])):
+            self.assertTrue(xr.set_space_warp_frames(motion_vectors, depth, rgba_motion_vectors, depth, near=10, far=1000))
+
+        motion_vectors, depths, near, far = app.setViewSpaceWarpFrames.call_args[0]
+        self.assertEqual(motion_vectors[0].shape, (16, 24, 4))
+        self.assertTrue(np.all(motion_vectors[0][:, :, :3] == 0.25) and np.all(motion_vectors[0][:, :, 3] == 0))
+        self.assertTrue(np.all(motion_vectors[1] == 0.5))
+        self.assertTrue(all(frame.dtype == np.float32 and frame.flags["C_CONTIGUOUS"] for frame in motion_vectors + depths))
+        self.assertTrue(np.allclose(depths[0], 3.0) and np.allclose(depths[1], 3.0))
+        self.assertAlmostEqual(near, 0.1)
+        self.assertAlmostEqual(far, 10.0)
+        # the references are kept until the next frame
+        self.assertIs(xr._space_warp_frames[0][0], motion_vectors[0])
+
+        # enabling or disabling the space warp drops the last frames
+        self.assertTrue(xr.set_space_warp(False))
+        self.assertIsNone(xr._space_warp_frames)
+
+        _openxr.release_openxr_interface(xr)
+
+    # display refresh rate matching: the simulation rate without OpenXR, None when no supported rate is a multiple
+    async def test_match_display_refresh_rate(self):
+        xr = _openxr.acquire_openxr_interface(disable_openxr=True)
+        self.assertTrue(xr.init())
+        self.assertEqual(xr.match_display_refresh_rate(60.0), 60.0)
+        _openxr.release_openxr_interface(xr)
+
+        # ctypes: the rate is returned through the output argument
+        xr, lib = self.mocked_interface()
+        def match(app, simulation_rate, rate):
+            if simulation_rate.value == 30.0:
+                rate._obj.value = 120.0
+                return 1
+            return 0
+        lib.matchDisplayRefreshRate.side_effect = match
+        self.assertEqual(xr.match_display_refresh_rate(30.0), 120.0)
+        self.assertIsNone(xr.match_display_refresh_rate(70.0))
+
+        def rates(app, rates, capacity, count):
+            count._obj.value = 3
+            if rates is not None:
+                rates[:3] = [72.0, 90.0, 120.0]
+            return 1
+        lib.getDisplayRefreshRates.side_effect = rates
+        self.assertEqual(xr.get_display_refresh_rates(), [72.0, 90.0, 120.0])
+        lib.getDisplayRefreshRates.side_effect = None
+        lib.getDisplayRefreshRates.return_value = 0
+        self.assertEqual(xr.get_display_refresh_rates(), [])
+        lib.getDisplayRefreshRate.return_value = 0
+        self.assertIsNone(xr.get_display_refresh_rate())
+        _openxr.release_openxr_interface(xr)
+
+        # pybind11: the status and the rate are returned as a tuple
+        xr, lib = self.mocked_interface(use_ctypes=False)
+        app = lib.OpenXrApplication.return_value
+        app.matchDisplayRefreshRate.return_value = (True, 120.0)
+        self.assertEqual(xr.match_display_refresh_rate(30.0), 120.0)
+        app.matchDisplayRefreshRate.return_value = (False, 0.0)
+        self.assertIsNone(xr.match_display_refresh_rate(70.0))
+        app.getDisplayRefreshRates.return_value = (False, [])
+        self.assertEqual(xr.get_display_refresh_rates(), [])
+        _openxr.release_openxr_interface(xr)
+
+    # session record and replay: the log path is passed as a C string and the replay speed as a float
+    async def test_record_replay(self):
+        xr, lib = self.mocked_interface()
+        self.assertTrue(xr.start_recording("/tmp/session.xrlog"))
+        self.assertEqual(lib.startRecording.call_args[0][1].value, b"/tmp/session.xrlog")
+        xr.stop_recording()
+        lib.stopRecording.assert_called_once()
+        lib.startReplay.return_value = 0
+        self.assertFalse(xr.start_replay("/tmp/missing.xrlog", 2))
+        args = lib.startReplay.call_args[0]
+        self.assertEqual(args[1].value, b"/tmp/missing.xrlog")
+        self.assertEqual(args[2].value, 2.0)
+        _openxr.release_openxr_interface(xr)
+
+    # log messages: routed to the subscribed callback (decoded), the same C callback is kept alive, None restores the standard output
+    async def test_log_callback(self):
+        xr, lib = self.mocked_interface()
+        callback = mock.MagicMock()
+        xr.subscribe_log_event(callback)
+        c_callback = lib.setLogCallback.call_args[0][1]
+        self.assertIsNotNone(c_callback)
+        c_callback(_openxr.LOG_LEVEL_WARNING, "tracking lost \xb0".encode("utf-8"))
+        callback.assert_called_once_with(_openxr.LOG_LEVEL_WARNING, "tracking lost \xb0")
+        c_callback(_openxr.LOG_LEVEL_ERROR, b"invalid \xff")
+        callback.assert_called_with(_openxr.LOG_LEVEL_ERROR, "invalid �")
+
+        xr.subscribe_log_event(mock.MagicMock())
+        self.assertIs(lib.setLogCallback.call_args[0][1], c_callback)
+        xr.subscribe_log_event(None)
+        self.assertIsNone(lib.setLogCallback.call_args[0][1])
+        # messages still in flight are dropped
+        c_callback(_openxr.LOG_LEVEL_INFO, b"late message")
+        self.assertEqual(callback.call_count, 2)
+        _openxr.release_openxr_interface(xr)
+
+    # startup timing: one duration per startup phase returned by the library
+    async def test_startup_timing(self):
+        xr = _openxr.acquire_openxr_interface(disable_openxr=True)
+        self.assertEqual(xr.get_startup_timing(), {phase: 0.0 for phase in _openxr.STARTUP_PHASES})
+        _openxr.release_openxr_interface(xr)
+
+        xr, lib = self.mocked_interface()
+        def timing(app, values, length):
+            values[0], values[1] = 1.5, 20.0
+            return 2
+        lib.getStartupTiming.side_effect = timing
+        self.assertEqual(xr.get_startup_timing(), {_openxr.STARTUP_PHASES[0]: 1.5, _openxr.STARTUP_PHASES[1]: 20.0})
+        self.assertEqual(lib.getStartupTiming.call_args[0][2], len(_openxr.STARTUP_PHASES))
+        _openxr.release_openxr_interface(xr)
+
+        xr, lib = self.mocked_interface(use_ctypes=False)
+        lib.OpenXrApplication.return_value.getStartupTiming.return_value = [1.0] * len(_openxr.STARTUP_PHASES)
+        self.assertEqual(list(xr.get_startup_timing().keys()), _openxr.STARTUP_PHASES)
+        _openxr.release_openxr_interface(xr)
+
+    # session recovery metrics: number of recoveries and time-to-recovery of the last one
+    async def test_recovery_metrics(self):
+        xr = _openxr.acquire_openxr_interface(disable_openxr=True)
+        self.assertEqual(xr.get_recovery_metrics(), {"count": 0, "time": -1.0})
+        self.assertFalse(xr.is_recovering())
+        _openxr.release_openxr_interface(xr)
+
+        xr, lib = self.mocked_interface()
+        def metrics(app, time, count):
+            time._obj.value, count._obj.value = 350.5, 2
+        lib.getRecoveryMetrics.side_effect = metrics
+        self.assertEqual(xr.get_recovery_metrics(), {"count": 2, "time": 350.5})
+        lib.isRecovering.return_value = 0
+        self.assertFalse(xr.is_recovering())
+        xr.set_session_recovery(True)
+        self.assertTrue(lib.setSessionRecovery.call_args[0][1])
+        _openxr.release_openxr_interface(xr)
+
+    # graphics backends: only the backends compiled in the library are listed, the backend is selected when initializing
+    async def test_graphics_backends(self):
+        self.assertEqual(_openxr.get_available_graphics_backends(disable_openxr=True), ["OpenGL", "Vulkan", "Headless"])
+
+        lib = mock.MagicMock()
+        lib.isGraphicsBackendAvailable.side_effect = lambda backend: backend != _openxr.GRAPHICS_BACKEND_VULKAN
+        with mock.patch.object(_openxr, "_load_library", return_value=lib):
+            self.assertEqual(_openxr.get_available_graphics_backends(use_ctypes=True), ["OpenGL", "Headless"])
+        with mock.patch.object(_openxr, "_load_library", side_effect=OSError("xrlib_c.so")):
+            self.assertEqual(_openxr.get_available_graphics_backends(use_ctypes=True), [])
+
+        lib = mock.MagicMock()
+        lib.setGraphicsBackend.return_value = 0
+        with mock.patch.object(_openxr, "_load_library", return_value=lib):
+            xr = _openxr.acquire_openxr_interface()
+            self.assertFalse(xr.init(graphics="Vulkan", use_ctypes=True))
+        self.assertEqual(lib.setGraphicsBackend.call_args[0][1], _openxr.GRAPHICS_BACKEND_VULKAN)
+        with self.assertRaises(ValueError):
+            xr.init(graphics="Metal")
+        _openxr.release_openxr_interface(xr)
+
+    # quad layers: pose and size arguments, and the names of the first quad layer API
+    async def test_quad_layer(self):
+        xr, lib = self.mocked_interface()
+        lib.addQuadLayer.return_value = 3
+        self.assertEqual(xr.add_quad_layer(256, 64, position=(0, 0.1, -1), size=(0.4, 0.1), reference_space=_openxr.XR_REFERENCE_SPACE_TYPE_VIEW), 3)
+        args = lib.addQuadLayer.call_args[0]
+        self.assertEqual(args[1:4], (256, 64, _openxr.XR_REFERENCE_SPACE_TYPE_VIEW))
+        pose = args[4]._obj
+        self.assertEqual((pose.position.x, pose.position.z, pose.orientation.w), (0, -1, 1))
+        self.assertAlmostEqual(pose.position.y, 0.1, places=6)
+        self.assertAlmostEqual(args[5].value, 0.4, places=6)
+        self.assertAlmostEqual(args[6].value, 0.1, places=6)
+
+        with mock.patch.object(xr, "set_layer_image", return_value=True) as set_layer_image:
+            image = np.zeros((64, 256, 4), dtype=np.uint8)
+            self.assertTrue(xr.set_quad_layer_image(3, image))
+            set_layer_image.assert_called_once_with(3, image)
+        with mock.patch.object(xr, "set_layer_visible", return_value=True) as set_layer_visible:
+            self.assertTrue(xr.set_quad_layer_visible(3, False))
+            set_layer_visible.assert_called_once_with(3, False)
+        with mock.patch.object(xr, "remove_layer", return_value=True) as remove_layer:
+            self.assertTrue(xr.remove_quad_layer(3))
+            remove_layer.assert_called_once_with(3)
+        _openxr.release_openxr_interface(xr)
+
+    # streamed layer frames: not copied, the reference is kept until the layer is removed
+    async def test_layer_frames(self):
+        xr, lib = self.mocked_interface(use_ctypes=False)
+        app = lib.OpenXrApplication.return_value
+        frame = np.zeros((360, 720, 3), dtype=np.uint8)
+        self.assertTrue(xr.set_layer_frame(1, frame))
+        app.setLayerFrame.assert_called_once_with(1, frame, False)
+        self.assertIs(xr._layer_frames[1], frame)
+
+        # non-contiguous frames are copied once (and kept)
+        rgba_frame = np.zeros((720, 360, 4), dtype=np.uint8).transpose(1, 0, 2)
+        self.assertTrue(xr.set_layer_frame(1, rgba_frame))
+        self.assertTrue(xr._layer_frames[1].flags["C_CONTIGUOUS"])
+        self.assertIs(app.setLayerFrame.call_args[0][1], xr._layer_frames[1])
+        self.assertTrue(app.setLayerFrame.call_args[0][2])
+
+        self.assertTrue(xr.remove_layer(1))
+        self.assertNotIn(1, xr._layer_frames)
+        app.removeLayer.assert_called_once_with(1)
+        _openxr.release_openxr_interface(xr)
+
+    # cube map faces: (6, size, size, channels) arrays are passed stacked vertically
+    async def test_cube_layer_image(self):
+        xr, lib = self.mocked_interface()
+        faces = np.zeros((6, 32, 32, 3), dtype=np.uint8)
+        faces[5] = 255
+        self.assertTrue(xr.set_layer_image(2, faces))
+        args = lib.setLayerImage.call_args[0]
+        self.assertEqual(args[1:4], (2, 32, 6 * 32))
+        self.assertFalse(args[5])
+        # the last face (-Z) is at the bottom of the stacked image
+        stacked = np.ctypeslib.as_array(ctypes.cast(args[4], ctypes.POINTER(ctypes.c_uint8)), shape=(6 * 32, 32, 3))
+        self.assertTrue(np.all(stacked[5 * 32:] == 255) and np.all(stacked[:5 * 32] == 0))
+        _openxr.release_openxr_interface(xr)
+
+    # color scale and bias: the values and the fade duration are passed for the given layer
+    async def test_color_scale_bias(self):
+        xr, lib = self.mocked_interface()
+        self.assertTrue(xr.set_color_scale_bias(scale=(0, 0, 0, 1), bias=(0.1, 0.2, 0.3, 0), duration=1.5))
+        args = lib.setColorScaleBias.call_args[0]
+        self.assertEqual(args[1], -1)
+        scale, bias = args[2]._obj, args[3]._obj
+        self.assertEqual((scale.r, scale.g, scale.b, scale.a), (0, 0, 0, 1))
+        self.assertAlmostEqual(bias.g, 0.2, places=6)
+        self.assertEqual(args[4].value, 1.5)
+        _openxr.release_openxr_interface(xr)
+
+        xr, lib = self.mocked_interface(use_ctypes=False)
+        self.assertTrue(xr.set_color_scale_bias(layer=4))
+        lib.OpenXrApplication.return_value.setColorScaleBias.assert_called_once_with(4, (1, 1, 1, 1), (0, 0, 0, 0), 0.0)
+        _openxr.release_openxr_interface(xr)
+
+    # visibility mask: sizes queried first, then the vertices and indices are filled
+    async def test_visibility_mask(self):
+        xr = _openxr.acquire_openxr_interface(disable_openxr=True)
+        self.assertIsNone(xr.get_visibility_mask(0))
+        _openxr.release_openxr_interface(xr)
+
+        xr, lib = self.mocked_interface()
+        def mask(app, view, mask_type, vertices, vertex_capacity, indices, index_capacity, vertex_count, index_count):
+            vertex_count._obj.value, index_count._obj.value = 3, 3
+            if vertices is not None:
+                np.ctypeslib.as_array(ctypes.cast(vertices, ctypes.POINTER(ctypes.c_float)), shape=(vertex_capacity, 2))[:] = [[-1, -1], [1, -1], [0, 1]]
+                np.ctypeslib.as_array(ctypes.cast(indices, ctypes.POINTER(ctypes.c_uint32)), shape=(index_capacity,))[:] = [0, 1, 2]
+            return 1
+        lib.getVisibilityMask.side_effect = mask
+        vertices, indices = xr.get_visibility_mask(1, _openxr.XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR)
+        self.assertEqual((vertices.shape, vertices.dtype, indices.dtype), ((3, 2), np.float32, np.uint32))
+        self.assertEqual(vertices[2].tolist(), [0, 1])
+        self.assertEqual(indices.tolist(), [0, 1, 2])
+        self.assertEqual(lib.getVisibilityMask.call_args[0][1:3], (1, _openxr.XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR))
+
+        lib.getVisibilityMask.side_effect = None
+        lib.getVisibilityMask.return_value = 0
+        self.assertIsNone(xr.get_visibility_mask(0))
+        _openxr.release_openxr_interface(xr)
+
+    # reprojection: supported modes queried in two calls, plane arguments
+    async def test_reprojection(self):
+        xr, lib = self.mocked_interface()
+        def modes(app, values, capacity, count):
+            count._obj.value = 2
+            if values is not None:
+                values[0], values[1] = _openxr.XR_REPROJECTION_MODE_DEPTH_MSFT, _openxr.XR_REPROJECTION_MODE_ORIENTATION_ONLY_MSFT
+            return 1
+        lib.getReprojectionModes.side_effect = modes
+        self.assertEqual(xr.get_reprojection_modes(), [_openxr.XR_REPROJECTION_MODE_DEPTH_MSFT, _openxr.XR_REPROJECTION_MODE_ORIENTATION_ONLY_MSFT])
+
+        self.assertTrue(xr.set_reprojection_plane(position=(0, 1, -2), normal=(0, 0, 2), velocity=(0.5, 0, 0)))
+        args = lib.setReprojectionPlane.call_args[0]
+        self.assertTrue(args[1])
+        self.assertEqual((args[2]._obj.y, args[2]._obj.z, args[3]._obj.z, args[4]._obj.x), (1, -2, 2, 0.5))
+        lib.setReprojectionMode.return_value = 0
+        self.assertFalse(xr.set_reprojection_mode(_openxr.XR_REPROJECTION_MODE_PLANAR_MANUAL_MSFT))
+        _openxr.release_openxr_interface(xr)
+
     # Actual test, notice it is "async" function, so "await" can be used if needed
     async def test_openxr(self):
         self._xr = _openxr.acquire_openxr_interface()
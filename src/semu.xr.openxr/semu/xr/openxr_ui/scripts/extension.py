@@ -56,8 +56,7 @@ class Extension(omni.ext.IExt):
 
     def _on_start_openxr(self):
         # get parameters from ui
-        graphics = [_openxr.XR_KHR_OPENGL_ENABLE_EXTENSION_NAME]
-        graphics = graphics[self._xr_settings_graphics_api.model.get_item_value_model().as_int]
+        graphics = self._graphics_backends[self._xr_settings_graphics_api.model.get_item_value_model().as_int]
 
         form_factor = [_openxr.XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY, _openxr.XR_FORM_FACTOR_HANDHELD_DISPLAY]
         form_factor = form_factor[self._xr_settings_form_factor.model.get_item_value_model().as_int]
@@ -65,7 +64,7 @@ class Extension(omni.ext.IExt):
         blend_mode = [_openxr.XR_ENVIRONMENT_BLEND_MODE_OPAQUE, _openxr.XR_ENVIRONMENT_BLEND_MODE_ADDITIVE, _openxr.XR_ENVIRONMENT_BLEND_MODE_ALPHA_BLEND]
         blend_mode = blend_mode[self._xr_settings_blend_mode.model.get_item_value_model().as_int]
 
-        view_configuration_type = [_openxr.XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO, _openxr.XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO]
+        view_configuration_type = [_openxr.XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO, _openxr.XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO, _openxr.XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO]
         view_configuration_type = view_configuration_type[self._xr_settings_view_configuration_type.model.get_item_value_model().as_int]
 
         # disable static parameters ui
@@ -79,6 +78,9 @@ class Extension(omni.ext.IExt):
             if not self._xr.init(graphics=graphics, use_ctypes=False):
                 print("[ERROR] OpenXR.init with graphics: {}".format(graphics))
 
+            # recreate the session (keeping the graphics resources) when the headset is disconnected or the runtime restarts
+            self._xr.set_session_recovery(True)
+
             # set stage unit
             stage = omni.usd.get_context().get_stage()
             self._xr.set_meters_per_unit(UsdGeom.GetStageMetersPerUnit(stage))
@@ -93,6 +95,8 @@ class Extension(omni.ext.IExt):
                             self._xr.setup_mono_view()
                         elif view_configuration_type == _openxr.XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO:
                             self._xr.setup_stereo_view()
+                        else:
+                            self._xr.setup_views()
                         # enable/disable buttons
                         self._ui_start_xr.enabled = False
                         self._ui_stop_xr.enabled = True
@@ -152,7 +156,9 @@ class Extension(omni.ext.IExt):
                     ui.Spacer(height=5)
                     with ui.HStack(height=0):
                         ui.Label("Graphics API:", width=85, tooltip="OpenXR graphics API supported by the runtime")
-                        self._xr_settings_graphics_api = ui.ComboBox(0, "OpenGL")
+                        # only the backends compiled in the library (e.g. Vulkan is not linked by default)
+                        self._graphics_backends = _openxr.get_available_graphics_backends(disable_openxr=self._disable_openxr) or ["OpenGL"]
+                        self._xr_settings_graphics_api = ui.ComboBox(0, *self._graphics_backends)
                     
                     ui.Spacer(height=5)
                     with ui.HStack(height=0):
@@ -164,8 +170,8 @@ class Extension(omni.ext.IExt):
                         self._xr_settings_blend_mode = ui.ComboBox(0, "Opaque", "Additive", "Alpha blend")
                     ui.Spacer(height=5)
                     with ui.HStack(height=0):
-                        ui.Label("View configuration type:", width=145, tooltip="XrViewConfigurationType enum. MONO: one primary display (e.g. an AR phone's screen). STEREO: two primary displays, which map to a left-eye and right-eye view")
-                        self._xr_settings_view_configuration_type = ui.ComboBox(1, "Mono", "Stereo")
+                        ui.Label("View configuration type:", width=145, tooltip="XrViewConfigurationType enum. MONO: one primary display (e.g. an AR phone's screen). STEREO: two primary displays, which map to a left-eye and right-eye view. QUAD VIEWS: two context and two inner foveal views (XR_VARJO_quad_views)")
+                        self._xr_settings_view_configuration_type = ui.ComboBox(1, "Mono", "Stereo", "Quad views")
 
                     ui.Spacer(height=5)
                     ui.Separator(height=1, width=0)
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+# delete old files
+rm layers/api_layers/libXrApiLayer_semu_timing.so
+
+# set variables
+export OPENXR_DIR=$(pwd)"/thirdparty/openxr"
+
+export CFLAGS="-std=c++17 -pthread -O2 -fPIC -fvisibility=hidden"
+export INCFLAGS="-I$OPENXR_DIR/include"
+export LDFLAGS="-lrt"
+
+# generate shared library (XR_APILAYER_semu_timing)
+g++ $CFLAGS $INCFLAGS -shared -Wl,-soname,libXrApiLayer_semu_timing.so -o layers/api_layers/libXrApiLayer_semu_timing.so layers/xr_api_layer_timing.cpp $LDFLAGS
+
+# copy compiled file and manifest
+mkdir -p ../bin/api_layers
+cp layers/api_layers/libXrApiLayer_semu_timing.so ../bin/api_layers/
+cp layers/api_layers/XrApiLayer_semu_timing.json ../bin/api_layers/
@@ -9,20 +9,21 @@ export OPENXR_DIR=$(pwd)"/thirdparty/openxr"
 export OPENGL_DIR=$(pwd)"/thirdparty/opengl"
 export SDL_DIR=$(pwd)"/thirdparty/sdl2"
 
-export DFLAGS="-DAPPLICATION -DCTYPES -DXR_USE_PLATFORM_XLIB -DXR_USE_GRAPHICS_API_OPENGL"
+export DFLAGS="-DXR_USE_PLATFORM_XLIB -DXR_USE_GRAPHICS_API_OPENGL"
 export CFLAGS="-std=c++17 -pthread -O2 -fpermissive -Wwrite-strings"
 export INCFLAGS="-I$OPENGL_DIR/include -I$OPENXR_DIR/include -I$SDL_DIR"
 export LIBFLAGS="-L$OPENGL_DIR/lib -L$OPENXR_DIR/lib -L$SDL_DIR/lib"
-export LDFLAGS="-lopenxr_loader -lGL -lSDL2 -lX11"      # -lvulkan -lSDL2_image -ldl
+export LDFLAGS="-lopenxr_loader -lGL -lEGL -lSDL2 -lX11"      # -lvulkan -lSDL2_image -ldl
 
 # generate executable
-# g++ $DFLAGS $CFLAGS $INCFLAGS -o xrapp $CPPFILES xr_opengl.cpp xr.cpp $LIBFLAGS $LDFLAGS
+# g++ $DFLAGS $CFLAGS $INCFLAGS -o xrapp xr.cpp xr_app.cpp $LIBFLAGS $LDFLAGS
 
-# generate object file
-g++ $DFLAGS $CFLAGS $INCFLAGS -fPIC -c -o xrlib.o xr.cpp $LIBFLAGS $LDFLAGS
+# generate object files (library and C interface)
+g++ $DFLAGS $CFLAGS $INCFLAGS -fPIC -c -o xrlib.o xr.cpp
+g++ $DFLAGS $CFLAGS $INCFLAGS -fPIC -c -o xrlib_ctypes.o xr_ctypes.cpp
 
 # generate shared library
-g++ -shared -Wl,-soname,xrlib_c.so -o xrlib_c.so xrlib.o
+g++ -shared -Wl,-soname,xrlib_c.so -o xrlib_c.so xrlib.o xrlib_ctypes.o
 
 # copy compiled file
 cp xrlib_c* ../bin/xrlib_c.so
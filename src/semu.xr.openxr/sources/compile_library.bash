@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# delete old files
+rm ../bin/libsemu_xr*
+
+# set variables
+export OPENXR_DIR=$(pwd)"/thirdparty/openxr"
+export OPENGL_DIR=$(pwd)"/thirdparty/opengl"
+export SDL_DIR=$(pwd)"/thirdparty/sdl2"
+
+export DFLAGS="-DXR_USE_PLATFORM_XLIB -DXR_USE_GRAPHICS_API_OPENGL"
+export CFLAGS="-std=c++17 -pthread -O2 -fpermissive -Wwrite-strings"
+export INCFLAGS="-I$OPENGL_DIR/include -I$OPENXR_DIR/include -I$SDL_DIR"
+export LIBFLAGS="-L$OPENGL_DIR/lib -L$OPENXR_DIR/lib -L$SDL_DIR/lib"
+export LDFLAGS="-lopenxr_loader -lGL -lEGL -lSDL2 -lX11"      # -lvulkan -lSDL2_image -ldl
+
+# optional Vulkan backend (Vulkan headers and loader required, e.g. from the Vulkan SDK): VULKAN=1 bash compile_library.bash
+if [ "$VULKAN" = "1" ]; then
+    export DFLAGS="$DFLAGS -DXR_USE_GRAPHICS_API_VULKAN"
+    [ -n "$VULKAN_SDK" ] && export INCFLAGS="$INCFLAGS -I$VULKAN_SDK/include" && export LIBFLAGS="$LIBFLAGS -L$VULKAN_SDK/lib"
+    export LDFLAGS="$LDFLAGS -lvulkan"
+fi
+
+# generate object file
+g++ $DFLAGS $CFLAGS $INCFLAGS -fPIC -c -o libsemu_xr.o xr.cpp
+
+# generate static library
+ar rcs libsemu_xr.a libsemu_xr.o
+
+# generate shared library
+g++ -shared -Wl,-soname,libsemu_xr.so -o libsemu_xr.so libsemu_xr.o $LIBFLAGS $LDFLAGS
+
+# copy compiled files (the public header is xr.h)
+cp libsemu_xr.a libsemu_xr.so ../bin/
+
+# delete temporal data
+rm libsemu_xr*
+
+# link a C++ host against the library (e.g. the standalone application)
+# g++ $DFLAGS $CFLAGS $INCFLAGS -o xrapp xr_app.cpp -L../bin -lsemu_xr $LIBFLAGS $LDFLAGS -Wl,-rpath=../bin
@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# delete old files
+rm runtimes/libXrRuntime_semu_stub.so
+rm xrsoak
+
+# set variables
+export OPENXR_DIR=$(pwd)"/thirdparty/openxr"
+export OPENGL_DIR=$(pwd)"/thirdparty/opengl"
+export SDL_DIR=$(pwd)"/thirdparty/sdl2"
+
+export DFLAGS="-DAPPLICATION_SOAK -DXR_USE_PLATFORM_XLIB -DXR_USE_GRAPHICS_API_OPENGL"
+export CFLAGS="-std=c++17 -pthread -O2 -fpermissive -Wwrite-strings"
+export INCFLAGS="-I$OPENGL_DIR/include -I$OPENXR_DIR/include -I$SDL_DIR"
+export LIBFLAGS="-L$OPENGL_DIR/lib -L$OPENXR_DIR/lib -L$SDL_DIR/lib"
+export LDFLAGS="-lopenxr_loader -lGL -lEGL -lSDL2 -lX11"
+
+# generate shared library (stub runtime)
+g++ -std=c++17 -pthread -O2 -fPIC -fvisibility=hidden $INCFLAGS -shared -Wl,-soname,libXrRuntime_semu_stub.so -o runtimes/libXrRuntime_semu_stub.so runtimes/xr_runtime_stub.cpp -L$OPENGL_DIR/lib -lGL
+
+# generate executable (soak benchmark)
+g++ $DFLAGS $CFLAGS $INCFLAGS -o xrsoak xr.cpp xr_app.cpp $LIBFLAGS $LDFLAGS
+
+# run (e.g. 8 hours, without an X server): XR_RUNTIME_JSON=runtimes/XrRuntime_semu_stub.json ./xrsoak --egl --duration 28800 --sample-interval 60 --warmup 300
@@ -0,0 +1,112 @@
+import os
+import sys
+import time
+import mmap
+import struct
+import argparse
+
+# shared memory layout (see xr_api_layer_timing.h)
+SEMU_TIMING_SHM_NAME = "/semu_xr_timing"
+SEMU_TIMING_MAGIC = 0x474e494d49545853
+SEMU_TIMING_VERSION = 1
+SEMU_TIMING_MAX_NAME_SIZE = 32
+SEMU_TIMING_MIN_OCTAVE = 10
+SEMU_TIMING_SUB_BUCKETS = 4
+
+HEADER_FORMAT = "<QIIIIQQ"
+HISTOGRAM_FORMAT = "<{}s6Q".format(SEMU_TIMING_MAX_NAME_SIZE)
+
+
+def bucket_lower_bound(index: int) -> int:
+    """
+    Lower bound (in nanoseconds) of a histogram bucket
+    """
+    if index == 0:
+        return 0
+    octave = (index - 1) // SEMU_TIMING_SUB_BUCKETS + SEMU_TIMING_MIN_OCTAVE
+    sub = (index - 1) % SEMU_TIMING_SUB_BUCKETS
+    return (1 << octave) + sub * (1 << (octave - 2))
+
+def percentile(buckets: list, count: int, p: float) -> int:
+    """
+    Approximate percentile (in nanoseconds) as the lower bound of the bucket containing it
+    """
+    if not count:
+        return 0
+    target = p * count
+    accumulated = 0
+    for i, value in enumerate(buckets):
+        accumulated += value
+        if accumulated >= target:
+            return bucket_lower_bound(i)
+    return bucket_lower_bound(len(buckets) - 1)
+
+def read(name: str = SEMU_TIMING_SHM_NAME) -> dict:
+    """
+    Read the histograms published by the XR_APILAYER_semu_timing API layer
+
+    Parameters
+    ----------
+    name: str, optional
+        Shared memory object name (default: '/semu_xr_timing')
+
+    Returns
+    -------
+    dict
+        Dictionary with the header information and the histogram of each intercepted function
+    """
+    path = os.path.join("/dev/shm", name.lstrip("/"))
+    with open(path, "rb") as f:
+        with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as memory:
+            magic, version, entry_point_count, bucket_count, pid, start_time_ns, instance_count = struct.unpack_from(HEADER_FORMAT, memory, 0)
+            if magic != SEMU_TIMING_MAGIC or version != SEMU_TIMING_VERSION:
+                raise RuntimeError("Invalid or uninitialized shared memory ({})".format(path))
+
+            histograms = {}
+            offset = struct.calcsize(HEADER_FORMAT)
+            for _ in range(entry_point_count):
+                name, count, total_ns, min_ns, max_ns, last_ns, failures = struct.unpack_from(HISTOGRAM_FORMAT, memory, offset)
+                offset += struct.calcsize(HISTOGRAM_FORMAT)
+                buckets = list(struct.unpack_from("<{}Q".format(bucket_count), memory, offset))
+                offset += 8 * bucket_count
+                histograms[name.split(b"\0", 1)[0].decode("utf-8")] = {"count": count,
+                                                                       "total_ns": total_ns,
+                                                                       "min_ns": min_ns if count else 0,
+                                                                       "max_ns": max_ns,
+                                                                       "last_ns": last_ns,
+                                                                       "failures": failures,
+                                                                       "buckets": buckets}
+    return {"pid": pid, "start_time_ns": start_time_ns, "instance_count": instance_count, "histograms": histograms}
+
+def report(data: dict) -> str:
+    lines = ["pid: {}, instances: {}".format(data["pid"], data["instance_count"]),
+             "{:<26}{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}".format("function (us)", "count", "mean", "p50", "p95", "p99", "max", "failures")]
+    for name, histogram in data["histograms"].items():
+        count = histogram["count"]
+        mean = histogram["total_ns"] / count if count else 0
+        lines.append("{:<26}{:>10}{:>10.1f}{:>10.1f}{:>10.1f}{:>10.1f}{:>10.1f}{:>10}".format(name, count, mean / 1000,
+                     percentile(histogram["buckets"], count, 0.50) / 1000,
+                     percentile(histogram["buckets"], count, 0.95) / 1000,
+                     percentile(histogram["buckets"], count, 0.99) / 1000,
+                     histogram["max_ns"] / 1000, histogram["failures"]))
+    return "\n".join(lines)
+
+
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="XR_APILAYER_semu_timing histogram reader")
+    parser.add_argument("--name", type=str, default=os.environ.get("XR_SEMU_TIMING_SHM_NAME", SEMU_TIMING_SHM_NAME), help="shared memory object name")
+    parser.add_argument("--interval", type=float, default=0, help="refresh interval in seconds (0: print once)")
+    args = parser.parse_args()
+
+    while True:
+        try:
+            print(report(read(args.name)))
+        except (FileNotFoundError, RuntimeError) as e:
+            print("[ERROR]", e)
+            sys.exit(1)
+        if args.interval <= 0:
+            break
+        print("")
+        time.sleep(args.interval)
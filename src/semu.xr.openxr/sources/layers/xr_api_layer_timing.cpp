@@ -0,0 +1,403 @@
+// XR_APILAYER_semu_timing
+// Lightweight OpenXR API layer that measures the latency of the hot entry points of the frame loop
+// and publishes per-call histograms in a POSIX shared memory segment (see xr_api_layer_timing.h)
+
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+#include <openxr/openxr.h>
+
+#include "xr_api_layer_timing.h"
+
+#if defined(__GNUC__)
+#define LAYER_EXPORT extern "C" __attribute__((visibility("default")))
+#else
+#define LAYER_EXPORT extern "C"
+#endif
+
+
+// loader <-> API layer negotiation interface (ABI defined by the OpenXR loader, loader_interfaces.h)
+// the bundled OpenXR headers do not ship it, so the required structures are declared here
+
+typedef enum XrLoaderInterfaceStructs{
+	XR_LOADER_INTERFACE_STRUCT_UNINTIALIZED = 0,
+	XR_LOADER_INTERFACE_STRUCT_LOADER_INFO,
+	XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST,
+	XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST,
+	XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO,
+	XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO,
+} XrLoaderInterfaceStructs;
+
+#define XR_LOADER_INFO_STRUCT_VERSION 1
+#define XR_API_LAYER_INFO_STRUCT_VERSION 1
+#define XR_API_LAYER_NEXT_INFO_STRUCT_VERSION 1
+#define XR_API_LAYER_CREATE_INFO_STRUCT_VERSION 1
+#define XR_API_LAYER_MAX_SETTINGS_PATH_SIZE 512
+#define CURRENT_LOADER_API_LAYER_VERSION 1
+
+typedef struct XrNegotiateLoaderInfo{
+	XrLoaderInterfaceStructs structType;
+	uint32_t structVersion;
+	size_t structSize;
+	uint32_t minInterfaceVersion;
+	uint32_t maxInterfaceVersion;
+	XrVersion minApiVersion;
+	XrVersion maxApiVersion;
+} XrNegotiateLoaderInfo;
+
+struct XrApiLayerCreateInfo;
+typedef XrResult (XRAPI_PTR *PFN_xrCreateApiLayerInstance)(const XrInstanceCreateInfo *, const struct XrApiLayerCreateInfo *, XrInstance *);
+
+typedef struct XrNegotiateApiLayerRequest{
+	XrLoaderInterfaceStructs structType;
+	uint32_t structVersion;
+	size_t structSize;
+	uint32_t layerInterfaceVersion;
+	XrVersion layerApiVersion;
+	PFN_xrGetInstanceProcAddr getInstanceProcAddr;
+	PFN_xrCreateApiLayerInstance createApiLayerInstance;
+} XrNegotiateApiLayerRequest;
+
+typedef struct XrApiLayerNextInfo{
+	XrLoaderInterfaceStructs structType;
+	uint32_t structVersion;
+	size_t structSize;
+	char layerName[XR_MAX_API_LAYER_NAME_SIZE];
+	PFN_xrGetInstanceProcAddr nextGetInstanceProcAddr;
+	PFN_xrCreateApiLayerInstance nextCreateApiLayerInstance;
+	struct XrApiLayerNextInfo * next;
+} XrApiLayerNextInfo;
+
+typedef struct XrApiLayerCreateInfo{
+	XrLoaderInterfaceStructs structType;
+	uint32_t structVersion;
+	size_t structSize;
+	void * loaderInstance;
+	char settings_file_location[XR_API_LAYER_MAX_SETTINGS_PATH_SIZE];
+	XrApiLayerNextInfo * nextInfo;
+} XrApiLayerCreateInfo;
+
+
+// next layer (or runtime) dispatch table, per instance
+// NOTE: the hot entry points receive session, space or swapchain handles (not the instance),
+//       so they use the dispatch table of the last created instance that is still alive (one instance per process)
+struct NextDispatch{
+	PFN_xrGetInstanceProcAddr getInstanceProcAddr = nullptr;
+	PFN_xrDestroyInstance destroyInstance = nullptr;
+	PFN_xrWaitFrame waitFrame = nullptr;
+	PFN_xrBeginFrame beginFrame = nullptr;
+	PFN_xrEndFrame endFrame = nullptr;
+	PFN_xrLocateViews locateViews = nullptr;
+	PFN_xrLocateSpace locateSpace = nullptr;
+	PFN_xrSyncActions syncActions = nullptr;
+	PFN_xrAcquireSwapchainImage acquireSwapchainImage = nullptr;
+	PFN_xrWaitSwapchainImage waitSwapchainImage = nullptr;
+	PFN_xrReleaseSwapchainImage releaseSwapchainImage = nullptr;
+};
+
+static std::map<XrInstance, NextDispatch> instance_dispatches;
+static NextDispatch next_dispatch;
+static XrInstance next_dispatch_instance = XR_NULL_HANDLE;
+static std::mutex layer_mutex;
+static SemuTimingSharedMemory * shared_memory = nullptr;
+
+static const char * entry_point_names[SEMU_TIMING_ENTRY_POINT_COUNT] = {
+	"xrWaitFrame",
+	"xrBeginFrame",
+	"xrEndFrame",
+	"xrLocateViews",
+	"xrLocateSpace",
+	"xrSyncActions",
+	"xrAcquireSwapchainImage",
+	"xrWaitSwapchainImage",
+	"xrReleaseSwapchainImage",
+};
+
+
+static inline uint64_t monotonicTimeNs(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void resetHistograms(SemuTimingSharedMemory * memory){
+	memset(memory->histograms, 0, sizeof(memory->histograms));
+	for(uint32_t i = 0; i < SEMU_TIMING_ENTRY_POINT_COUNT; i++){
+		strncpy(memory->histograms[i].name, entry_point_names[i], SEMU_TIMING_MAX_NAME_SIZE - 1);
+		memory->histograms[i].minNs = UINT64_MAX;
+	}
+	memory->startTimeNs = monotonicTimeNs();
+}
+
+static bool mapSharedMemory(){
+	if(shared_memory)
+		return true;
+
+	const char * name = getenv(SEMU_TIMING_SHM_NAME_ENV);
+	if(!name || !strlen(name))
+		name = SEMU_TIMING_SHM_NAME;
+
+	int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+	if(fd < 0){
+		std::cout << "[" << SEMU_TIMING_LAYER_NAME << "] Unable to open shared memory " << name << std::endl;
+		return false;
+	}
+	if(ftruncate(fd, sizeof(SemuTimingSharedMemory)) != 0){
+		std::cout << "[" << SEMU_TIMING_LAYER_NAME << "] Unable to resize shared memory " << name << std::endl;
+		close(fd);
+		return false;
+	}
+	void * address = mmap(nullptr, sizeof(SemuTimingSharedMemory), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(address == MAP_FAILED){
+		std::cout << "[" << SEMU_TIMING_LAYER_NAME << "] Unable to map shared memory " << name << std::endl;
+		return false;
+	}
+
+	shared_memory = (SemuTimingSharedMemory*)address;
+	// invalidate the header while the histograms are being reset
+	__atomic_store_n(&shared_memory->magic, 0, __ATOMIC_RELEASE);
+	shared_memory->version = SEMU_TIMING_VERSION;
+	shared_memory->entryPointCount = SEMU_TIMING_ENTRY_POINT_COUNT;
+	shared_memory->bucketCount = SEMU_TIMING_BUCKET_COUNT;
+	shared_memory->pid = (uint32_t)getpid();
+	shared_memory->instanceCount = 0;
+	resetHistograms(shared_memory);
+	__atomic_store_n(&shared_memory->magic, SEMU_TIMING_MAGIC, __ATOMIC_RELEASE);
+	return true;
+}
+
+static inline void record(SemuTimingEntryPoint entryPoint, uint64_t start, XrResult result){
+	uint64_t ns = monotonicTimeNs() - start;
+	if(!shared_memory)
+		return;
+	SemuTimingHistogram & histogram = shared_memory->histograms[entryPoint];
+	__atomic_fetch_add(&histogram.count, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&histogram.totalNs, ns, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&histogram.buckets[semuTimingBucketIndex(ns)], 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&histogram.lastNs, ns, __ATOMIC_RELAXED);
+	if(XR_FAILED(result))
+		__atomic_fetch_add(&histogram.failures, 1, __ATOMIC_RELAXED);
+
+	uint64_t current = __atomic_load_n(&histogram.maxNs, __ATOMIC_RELAXED);
+	while(ns > current && !__atomic_compare_exchange_n(&histogram.maxNs, &current, ns, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+	current = __atomic_load_n(&histogram.minNs, __ATOMIC_RELAXED);
+	while(ns < current && !__atomic_compare_exchange_n(&histogram.minNs, &current, ns, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+
+// intercepted functions
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrWaitFrame(XrSession session, const XrFrameWaitInfo * frameWaitInfo, XrFrameState * frameState){
+	uint64_t start = monotonicTimeNs();
+	XrResult result = next_dispatch.waitFrame(session, frameWaitInfo, frameState);
+	record(SEMU_TIMING_WAIT_FRAME, start, result);
+	return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrBeginFrame(XrSession session, const XrFrameBeginInfo * frameBeginInfo){
+	uint64_t start = monotonicTimeNs();
+	XrResult result = next_dispatch.beginFrame(session, frameBeginInfo);
+	record(SEMU_TIMING_BEGIN_FRAME, start, result);
+	return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrEndFrame(XrSession session, const XrFrameEndInfo * frameEndInfo){
+	uint64_t start = monotonicTimeNs();
+	XrResult result = next_dispatch.endFrame(session, frameEndInfo);
+	record(SEMU_TIMING_END_FRAME, start, result);
+	return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrLocateViews(XrSession session, const XrViewLocateInfo * viewLocateInfo, XrViewState * viewState, uint32_t viewCapacityInput, uint32_t * viewCountOutput, XrView * views){
+	uint64_t start = monotonicTimeNs();
+	XrResult result = next_dispatch.locateViews(session, viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views);
+	record(SEMU_TIMING_LOCATE_VIEWS, start, result);
+	return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation * location){
+	uint64_t start = monotonicTimeNs();
+	XrResult result = next_dispatch.locateSpace(space, baseSpace, time, location);
+	record(SEMU_TIMING_LOCATE_SPACE, start, result);
+	return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrSyncActions(XrSession session, const XrActionsSyncInfo * syncInfo){
+	uint64_t start = monotonicTimeNs();
+	XrResult result = next_dispatch.syncActions(session, syncInfo);
+	record(SEMU_TIMING_SYNC_ACTIONS, start, result);
+	return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo * acquireInfo, uint32_t * index){
+	uint64_t start = monotonicTimeNs();
+	XrResult result = next_dispatch.acquireSwapchainImage(swapchain, acquireInfo, index);
+	record(SEMU_TIMING_ACQUIRE_SWAPCHAIN_IMAGE, start, result);
+	return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo * waitInfo){
+	uint64_t start = monotonicTimeNs();
+	XrResult result = next_dispatch.waitSwapchainImage(swapchain, waitInfo);
+	record(SEMU_TIMING_WAIT_SWAPCHAIN_IMAGE, start, result);
+	return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo * releaseInfo){
+	uint64_t start = monotonicTimeNs();
+	XrResult result = next_dispatch.releaseSwapchainImage(swapchain, releaseInfo);
+	record(SEMU_TIMING_RELEASE_SWAPCHAIN_IMAGE, start, result);
+	return result;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrDestroyInstance(XrInstance instance){
+	PFN_xrDestroyInstance destroyInstance = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(layer_mutex);
+		auto it = instance_dispatches.find(instance);
+		if(it != instance_dispatches.end()){
+			destroyInstance = it->second.destroyInstance;
+			instance_dispatches.erase(it);
+		}
+		// the hot entry points keep the dispatch table of the other instances, 
+		// and switch to a live instance only when the instance that installed it is destroyed
+		if(instance == next_dispatch_instance){
+			if(instance_dispatches.empty()){
+				next_dispatch = NextDispatch();
+				next_dispatch_instance = XR_NULL_HANDLE;
+			}
+			else{
+				next_dispatch = instance_dispatches.rbegin()->second;
+				next_dispatch_instance = instance_dispatches.rbegin()->first;
+			}
+		}
+	}
+	// the shared memory is kept mapped (and not unlinked) so that it can still be inspected after the session
+	return destroyInstance ? destroyInstance(instance) : XR_ERROR_HANDLE_INVALID;
+}
+
+
+// layer entry points
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrGetInstanceProcAddr(XrInstance instance, const char * name, PFN_xrVoidFunction * function){
+	if(!name || !function)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	const std::string functionName(name);
+	if(functionName == "xrGetInstanceProcAddr"){
+		*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrGetInstanceProcAddr);
+		return XR_SUCCESS;
+	}
+	PFN_xrGetInstanceProcAddr nextGetInstanceProcAddr = nullptr;
+	bool created = false;
+	{
+		std::lock_guard<std::mutex> lock(layer_mutex);
+		auto it = instance_dispatches.find(instance);
+		created = it != instance_dispatches.end();
+		nextGetInstanceProcAddr = created ? it->second.getInstanceProcAddr : next_dispatch.getInstanceProcAddr;
+	}
+	if(created){
+		if(functionName == "xrDestroyInstance")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrDestroyInstance);
+		else if(functionName == "xrWaitFrame")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrWaitFrame);
+		else if(functionName == "xrBeginFrame")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrBeginFrame);
+		else if(functionName == "xrEndFrame")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrEndFrame);
+		else if(functionName == "xrLocateViews")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrLocateViews);
+		else if(functionName == "xrLocateSpace")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrLocateSpace);
+		else if(functionName == "xrSyncActions")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrSyncActions);
+		else if(functionName == "xrAcquireSwapchainImage")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrAcquireSwapchainImage);
+		else if(functionName == "xrWaitSwapchainImage")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrWaitSwapchainImage);
+		else if(functionName == "xrReleaseSwapchainImage")
+			*function = reinterpret_cast<PFN_xrVoidFunction>(layer_xrReleaseSwapchainImage);
+		else
+			return nextGetInstanceProcAddr(instance, name, function);
+		return XR_SUCCESS;
+	}
+	if(nextGetInstanceProcAddr)
+		return nextGetInstanceProcAddr(instance, name, function);
+	*function = nullptr;
+	return XR_ERROR_FUNCTION_UNSUPPORTED;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL layer_xrCreateApiLayerInstance(const XrInstanceCreateInfo * info, const XrApiLayerCreateInfo * apiLayerInfo, XrInstance * instance){
+	if(!apiLayerInfo || !apiLayerInfo->nextInfo ||
+	   apiLayerInfo->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO ||
+	   apiLayerInfo->nextInfo->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO ||
+	   strcmp(apiLayerInfo->nextInfo->layerName, SEMU_TIMING_LAYER_NAME) != 0)
+		return XR_ERROR_INITIALIZATION_FAILED;
+
+	// create the instance down the chain
+	XrApiLayerCreateInfo nextApiLayerInfo = *apiLayerInfo;
+	nextApiLayerInfo.nextInfo = apiLayerInfo->nextInfo->next;
+	PFN_xrGetInstanceProcAddr nextGetInstanceProcAddr = apiLayerInfo->nextInfo->nextGetInstanceProcAddr;
+
+	XrResult result = apiLayerInfo->nextInfo->nextCreateApiLayerInstance(info, &nextApiLayerInfo, instance);
+	if(XR_FAILED(result))
+		return result;
+
+	// fill the dispatch table
+	std::lock_guard<std::mutex> lock(layer_mutex);
+	NextDispatch dispatch;
+	dispatch.getInstanceProcAddr = nextGetInstanceProcAddr;
+	nextGetInstanceProcAddr(*instance, "xrDestroyInstance", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.destroyInstance));
+	nextGetInstanceProcAddr(*instance, "xrWaitFrame", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.waitFrame));
+	nextGetInstanceProcAddr(*instance, "xrBeginFrame", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.beginFrame));
+	nextGetInstanceProcAddr(*instance, "xrEndFrame", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.endFrame));
+	nextGetInstanceProcAddr(*instance, "xrLocateViews", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.locateViews));
+	nextGetInstanceProcAddr(*instance, "xrLocateSpace", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.locateSpace));
+	nextGetInstanceProcAddr(*instance, "xrSyncActions", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.syncActions));
+	nextGetInstanceProcAddr(*instance, "xrAcquireSwapchainImage", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.acquireSwapchainImage));
+	nextGetInstanceProcAddr(*instance, "xrWaitSwapchainImage", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.waitSwapchainImage));
+	nextGetInstanceProcAddr(*instance, "xrReleaseSwapchainImage", reinterpret_cast<PFN_xrVoidFunction*>(&dispatch.releaseSwapchainImage));
+	instance_dispatches[*instance] = dispatch;
+	next_dispatch = dispatch;
+	next_dispatch_instance = *instance;
+
+	// reset the histograms for the new instance
+	if(mapSharedMemory()){
+		if(shared_memory->instanceCount)
+			resetHistograms(shared_memory);
+		__atomic_fetch_add(&shared_memory->instanceCount, 1, __ATOMIC_RELEASE);
+	}
+	return result;
+}
+
+LAYER_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderApiLayerInterface(const XrNegotiateLoaderInfo * loaderInfo, const char * layerName, XrNegotiateApiLayerRequest * apiLayerRequest){
+	if(!loaderInfo || !apiLayerRequest || !layerName || strcmp(layerName, SEMU_TIMING_LAYER_NAME) != 0)
+		return XR_ERROR_INITIALIZATION_FAILED;
+	if(loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+	   loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION ||
+	   loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo))
+		return XR_ERROR_INITIALIZATION_FAILED;
+	if(apiLayerRequest->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST ||
+	   apiLayerRequest->structVersion != XR_API_LAYER_INFO_STRUCT_VERSION ||
+	   apiLayerRequest->structSize != sizeof(XrNegotiateApiLayerRequest))
+		return XR_ERROR_INITIALIZATION_FAILED;
+	if(loaderInfo->minInterfaceVersion > CURRENT_LOADER_API_LAYER_VERSION || loaderInfo->maxInterfaceVersion < CURRENT_LOADER_API_LAYER_VERSION)
+		return XR_ERROR_INITIALIZATION_FAILED;
+
+	apiLayerRequest->layerInterfaceVersion = CURRENT_LOADER_API_LAYER_VERSION;
+	apiLayerRequest->layerApiVersion = XR_CURRENT_API_VERSION;
+	apiLayerRequest->getInstanceProcAddr = layer_xrGetInstanceProcAddr;
+	apiLayerRequest->createApiLayerInstance = layer_xrCreateApiLayerInstance;
+	return XR_SUCCESS;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// Shared memory layout of the XR_APILAYER_semu_timing API layer.
+// The layer publishes one latency histogram per intercepted entry point.
+// External tools map the segment read-only and can read it at any moment without stopping the session
+
+#include <stdint.h>
+
+#define SEMU_TIMING_LAYER_NAME "XR_APILAYER_semu_timing"
+
+// shared memory object name (can be overwritten using the XR_SEMU_TIMING_SHM_NAME environment variable)
+#define SEMU_TIMING_SHM_NAME "/semu_xr_timing"
+#define SEMU_TIMING_SHM_NAME_ENV "XR_SEMU_TIMING_SHM_NAME"
+
+#define SEMU_TIMING_MAGIC 0x474e494d49545853ULL		// "SXTIMING" (little-endian)
+#define SEMU_TIMING_VERSION 1
+
+#define SEMU_TIMING_MAX_NAME_SIZE 32
+#define SEMU_TIMING_BUCKET_COUNT 96
+
+// histogram buckets (latency in nanoseconds)
+//   bucket 0: latency < 1024 ns
+//   bucket i (i > 0): 4 sub-buckets per power of two starting at 2^10 ns (~1 us)
+//   last bucket: overflow (latency >= ~8.6 s)
+#define SEMU_TIMING_MIN_OCTAVE 10
+#define SEMU_TIMING_SUB_BUCKETS 4
+
+enum SemuTimingEntryPoint{
+	SEMU_TIMING_WAIT_FRAME = 0,
+	SEMU_TIMING_BEGIN_FRAME,
+	SEMU_TIMING_END_FRAME,
+	SEMU_TIMING_LOCATE_VIEWS,
+	SEMU_TIMING_LOCATE_SPACE,
+	SEMU_TIMING_SYNC_ACTIONS,
+	SEMU_TIMING_ACQUIRE_SWAPCHAIN_IMAGE,
+	SEMU_TIMING_WAIT_SWAPCHAIN_IMAGE,
+	SEMU_TIMING_RELEASE_SWAPCHAIN_IMAGE,
+	SEMU_TIMING_ENTRY_POINT_COUNT
+};
+
+// all counters are updated with relaxed atomic operations by the layer (readers may observe slightly inconsistent snapshots)
+struct SemuTimingHistogram{
+	char name[SEMU_TIMING_MAX_NAME_SIZE];
+	uint64_t count;
+	uint64_t totalNs;
+	uint64_t minNs;
+	uint64_t maxNs;
+	uint64_t lastNs;
+	uint64_t failures;			// calls that returned an XrResult < 0
+	uint64_t buckets[SEMU_TIMING_BUCKET_COUNT];
+};
+
+struct SemuTimingSharedMemory{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t entryPointCount;
+	uint32_t bucketCount;
+	uint32_t pid;
+	uint64_t startTimeNs;		// CLOCK_MONOTONIC time at which the histograms were reset
+	uint64_t instanceCount;		// number of XrInstance created through the layer
+	SemuTimingHistogram histograms[SEMU_TIMING_ENTRY_POINT_COUNT];
+};
+
+// map a latency (in nanoseconds) to its histogram bucket
+static inline uint32_t semuTimingBucketIndex(uint64_t ns){
+	if(ns < (1ULL << SEMU_TIMING_MIN_OCTAVE))
+		return 0;
+	uint32_t octave = 63 - __builtin_clzll(ns);
+	uint32_t sub = (uint32_t)(ns >> (octave - 2)) & (SEMU_TIMING_SUB_BUCKETS - 1);
+	uint32_t index = 1 + (octave - SEMU_TIMING_MIN_OCTAVE) * SEMU_TIMING_SUB_BUCKETS + sub;
+	return index < SEMU_TIMING_BUCKET_COUNT ? index : SEMU_TIMING_BUCKET_COUNT - 1;
+}
+
+// lower bound (in nanoseconds) of a histogram bucket
+static inline uint64_t semuTimingBucketLowerBound(uint32_t index){
+	if(index == 0)
+		return 0;
+	uint32_t octave = (index - 1) / SEMU_TIMING_SUB_BUCKETS + SEMU_TIMING_MIN_OCTAVE;
+	uint32_t sub = (index - 1) % SEMU_TIMING_SUB_BUCKETS;
+	return (1ULL << octave) + sub * (1ULL << (octave - 2));
+}
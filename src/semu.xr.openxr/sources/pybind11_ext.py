@@ -16,7 +16,7 @@ if not os.path.exists(python_library_dir):
 
 ext_modules = [
     Pybind11Extension("xrlib_p",
-                      ["pybind11_wrapper.cpp"],
+                      ["pybind11_wrapper.cpp", "xr.cpp"],
                       include_dirs=[os.path.join(os.getcwd(), "thirdparty", "openxr", "include"),
                                     os.path.join(os.getcwd(), "thirdparty", "opengl", "include"),
                                     os.path.join(os.getcwd(), "thirdparty", "sdl2")],
@@ -24,7 +24,7 @@ ext_modules = [
                                     os.path.join(os.getcwd(), "thirdparty", "opengl", "lib"),
                                     os.path.join(os.getcwd(), "thirdparty", "sdl2", "lib"),
                                     python_library_dir],
-                      libraries=["openxr_loader", "GL", "SDL2"],
+                      libraries=["openxr_loader", "GL", "EGL", "SDL2"],
                       extra_link_args=["-Wl,-rpath=./bin"],
                       undef_macros=["CTYPES", "APPLICATION"]),
 ]
@@ -5,7 +5,8 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
-#include "xr.cpp"
+#include "xr.h"
+using namespace std;
 
 namespace py = pybind11;
 
@@ -168,6 +169,66 @@ PYBIND11_MODULE(xrlib_p, m){
                 bool returnValue = m.renderViews(XrReferenceSpaceType(referenceSpaceType), actionPoseState);
                 return std::make_tuple(returnValue, actionPoseState); 
             })
+        // performance settings
+        .def("setPerformanceLevel", [](OpenXrApplication &m, int domain, int level){
+                return m.setPerformanceLevel(XrPerfSettingsDomainEXT(domain), XrPerfSettingsLevelEXT(level));
+            })
+        .def("getThermalTemperatureTrend", [](OpenXrApplication &m, int domain){
+                XrPerfSettingsNotificationLevelEXT notificationLevel = XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT;
+                float tempHeadroom = 0, tempSlope = 0;
+                bool returnValue = m.getThermalTemperatureTrend(XrPerfSettingsDomainEXT(domain), &notificationLevel, &tempHeadroom, &tempSlope);
+                return std::make_tuple(returnValue, (int)notificationLevel, tempHeadroom, tempSlope);
+            })
+        .def("setPerfSettingsCallback", &OpenXrApplication::setPerfSettingsCallbackFromFunction)
+        // display refresh rate
+        .def("getDisplayRefreshRates", [](OpenXrApplication &m){
+                std::vector<float> rates;
+                bool returnValue = m.getDisplayRefreshRates(rates);
+                return std::make_tuple(returnValue, rates);
+            })
+        .def("getDisplayRefreshRate", [](OpenXrApplication &m){
+                float rate = 0;
+                bool returnValue = m.getDisplayRefreshRate(&rate);
+                return std::make_tuple(returnValue, rate);
+            })
+        .def("requestDisplayRefreshRate", &OpenXrApplication::requestDisplayRefreshRate)
+        .def("matchDisplayRefreshRate", [](OpenXrApplication &m, float simulationRate){
+                float rate = 0;
+                bool returnValue = m.matchDisplayRefreshRate(simulationRate, &rate);
+                return std::make_tuple(returnValue, rate);
+            })
+        .def("setDisplayRefreshRateCallback", &OpenXrApplication::setDisplayRefreshRateCallbackFromFunction)
+        // logging
+        .def("setLogLevel", &OpenXrApplication::setLogLevel)
+        .def("setLogRateLimit", &OpenXrApplication::setLogRateLimit)
+        .def("setLogCallback", [](OpenXrApplication &m, function<void(int, string)> callback){
+                function<void(int, const char *)> function = nullptr;
+                if(callback)
+                    function = [callback](int level, const char * message){ callback(level, message); };
+                m.setLogCallbackFromFunction(function);
+            })
+        .def("setDebugUtils", &OpenXrApplication::setDebugUtils)
+        .def("setEglContext", &OpenXrApplication::setEglContext)
+        .def("setHeadless", &OpenXrApplication::setHeadless)
+        .def("isHeadless", &OpenXrApplication::isHeadless)
+        .def("setGraphicsBackend", &OpenXrApplication::setGraphicsBackend)
+        .def("getGraphicsBackend", &OpenXrApplication::getGraphicsBackend)
+        .def_static("isGraphicsBackendAvailable", &OpenXrApplication::isGraphicsBackendAvailable)
+        .def("setMirror", &OpenXrApplication::setMirror)
+        .def("setUploadWorker", &OpenXrApplication::setUploadWorker)
+        // startup
+        .def("setVerbose", &OpenXrApplication::setVerbose)
+        .def("getStartupTiming", &OpenXrApplication::getStartupTiming)
+        // session recovery
+        .def("setSessionRecovery", &OpenXrApplication::setSessionRecovery)
+        .def("isRecovering", &OpenXrApplication::isRecovering)
+        .def("getRecoveryTime", &OpenXrApplication::getRecoveryTime)
+        .def("getRecoveryCount", &OpenXrApplication::getRecoveryCount)
+        // session record and replay
+        .def("startRecording", &OpenXrApplication::startRecording)
+        .def("stopRecording", &OpenXrApplication::stopRecording)
+        .def("startReplay", &OpenXrApplication::startReplay)
+        .def("isReplaying", &OpenXrApplication::isReplaying)
         // render utilities
         .def("setRenderCallback", &OpenXrApplication::setRenderCallbackFromFunction)
         .def("setFrames", [](OpenXrApplication &m, py::array_t<uint8_t> left, py::array_t<uint8_t> right, bool rgba){
@@ -180,5 +241,149 @@ PYBIND11_MODULE(xrlib_p, m){
                     return status && m.setFrameByIndex(1, rightInfo.shape[1], rightInfo.shape[0], rightInfo.ptr, rgba);
                 }
                 return false;
+            })
+        // linear depth (meters, numpy.float32) of each view (None: no depth)
+        .def("setDepthFrames", [](OpenXrApplication &m, py::object left, py::object right, float nearZ, float farZ){
+                auto depthData = [](py::object depth, int & width, int & height) -> const float * {
+                    if(depth.is_none())
+                        return nullptr;
+                    py::array_t<float> array = depth.cast<py::array_t<float>>();
+                    height = array.shape(0);
+                    width = array.shape(1);
+                    return array.data();
+                };
+                int leftWidth = 0, leftHeight = 0, rightWidth = 0, rightHeight = 0;
+                const float * leftData = depthData(left, leftWidth, leftHeight);
+                if(m.getViewConfigurationViewsSize() == 1)
+                    return m.setDepthByIndex(0, leftWidth, leftHeight, leftData, nearZ, farZ);
+                else if(m.getViewConfigurationViewsSize() == 2){
+                    const float * rightData = depthData(right, rightWidth, rightHeight);
+                    bool status = m.setDepthByIndex(0, leftWidth, leftHeight, leftData, nearZ, farZ);
+                    return status && m.setDepthByIndex(1, rightWidth, rightHeight, rightData, nearZ, farZ);
+                }
+                return false;
+            })
+        // any view configuration (e.g. quad views): one frame (numpy.uint8) or linear depth (meters, numpy.float32) per view (None: not rendered / no depth)
+        .def("setViewFrames", [](OpenXrApplication &m, std::vector<py::object> frames, bool rgba){
+                if(frames.size() != (size_t)m.getViewConfigurationViewsSize())
+                    return false;
+                bool status = true;
+                for(size_t i = 0; i < frames.size(); i++){
+                    if(frames[i].is_none()){
+                        status = m.setFrameByIndex(i, 0, 0, nullptr, rgba) && status;
+                        continue;
+                    }
+                    py::buffer_info info = frames[i].cast<py::array_t<uint8_t>>().request();
+                    status = m.setFrameByIndex(i, info.shape[1], info.shape[0], info.ptr, rgba) && status;
+                }
+                return status;
+            })
+        .def("setViewDepthFrames", [](OpenXrApplication &m, std::vector<py::object> depths, float nearZ, float farZ){
+                if(depths.size() != (size_t)m.getViewConfigurationViewsSize())
+                    return false;
+                bool status = true;
+                for(size_t i = 0; i < depths.size(); i++){
+                    if(depths[i].is_none()){
+                        status = m.setDepthByIndex(i, 0, 0, nullptr, nearZ, farZ) && status;
+                        continue;
+                    }
+                    py::array_t<float> array = depths[i].cast<py::array_t<float>>();
+                    status = m.setDepthByIndex(i, array.shape(1), array.shape(0), array.data(), nearZ, farZ) && status;
+                }
+                return status;
+            })
+        // application space warp (any view configuration): motion vectors (RGBA, numpy.float32) and linear depth (meters, numpy.float32) per view (None: no space warp)
+        .def("setSpaceWarp", &OpenXrApplication::setSpaceWarp)
+        .def("isSpaceWarpActive", &OpenXrApplication::isSpaceWarpActive)
+        .def("getSpaceWarpResolution", [](OpenXrApplication &m){
+                int width = 0, height = 0;
+                bool returnValue = m.getSpaceWarpResolution(&width, &height);
+                return std::make_tuple(returnValue, width, height);
+            })
+        .def("setViewSpaceWarpFrames", [](OpenXrApplication &m, std::vector<py::object> motionVectors, std::vector<py::object> depths, float nearZ, float farZ){
+                if(motionVectors.size() != (size_t)m.getViewConfigurationViewsSize() || depths.size() != motionVectors.size())
+                    return false;
+                auto floatData = [](py::object frame, int & width, int & height) -> const float * {
+                    if(frame.is_none())
+                        return nullptr;
+                    py::array_t<float> array = frame.cast<py::array_t<float>>();
+                    height = array.shape(0);
+                    width = array.shape(1);
+                    return array.data();
+                };
+                bool status = true;
+                for(size_t i = 0; i < motionVectors.size(); i++){
+                    int width = 0, height = 0, depthWidth = 0, depthHeight = 0;
+                    const float * motionVectorData = floatData(motionVectors[i], width, height);
+                    const float * depthData = floatData(depths[i], depthWidth, depthHeight);
+                    status = m.setSpaceWarpByIndex(i, width, height, motionVectorData, depthWidth, depthHeight, depthData, nearZ, farZ) && status;
+                }
+                return status;
+            })
+        // reprojection hints: mode (0: runtime default) and stabilization plane (position, normal and velocity in the reference space)
+        .def("getReprojectionModes", [](OpenXrApplication &m){
+                std::vector<XrReprojectionModeMSFT> modes;
+                bool returnValue = m.getReprojectionModes(modes);
+                return std::make_tuple(returnValue, std::vector<int>(modes.begin(), modes.end()));
+            })
+        .def("setReprojectionMode", [](OpenXrApplication &m, int mode){
+                return m.setReprojectionMode(XrReprojectionModeMSFT(mode));
+            })
+        .def("setReprojectionPlane", [](OpenXrApplication &m, bool enable, std::array<float, 3> position, std::array<float, 3> normal, std::array<float, 3> velocity){
+                return m.setReprojectionPlane(enable, {position[0], position[1], position[2]}, {normal[0], normal[1], normal[2]}, {velocity[0], velocity[1], velocity[2]});
+            })
+        // composition layers (pose: position (x, y, z) and orientation quaternion (x, y, z, w), size: width and height in meters)
+        .def("addQuadLayer", [](OpenXrApplication &m, int width, int height, int referenceSpaceType, std::array<float, 3> position, std::array<float, 4> orientation, std::array<float, 2> size){
+                XrPosef pose = {{orientation[0], orientation[1], orientation[2], orientation[3]}, {position[0], position[1], position[2]}};
+                return m.addQuadLayer(width, height, XrReferenceSpaceType(referenceSpaceType), pose, {size[0], size[1]});
+            })
+        .def("addCylinderLayer", [](OpenXrApplication &m, int width, int height, int referenceSpaceType, std::array<float, 3> position, std::array<float, 4> orientation, float radius, float centralAngle, float aspectRatio){
+                XrPosef pose = {{orientation[0], orientation[1], orientation[2], orientation[3]}, {position[0], position[1], position[2]}};
+                return m.addCylinderLayer(width, height, XrReferenceSpaceType(referenceSpaceType), pose, radius, centralAngle, aspectRatio);
+            })
+        .def("addEquirectLayer", [](OpenXrApplication &m, int width, int height, int referenceSpaceType, std::array<float, 3> position, std::array<float, 4> orientation, float radius, float centralHorizontalAngle, float upperVerticalAngle, float lowerVerticalAngle){
+                XrPosef pose = {{orientation[0], orientation[1], orientation[2], orientation[3]}, {position[0], position[1], position[2]}};
+                return m.addEquirectLayer(width, height, XrReferenceSpaceType(referenceSpaceType), pose, radius, centralHorizontalAngle, upperVerticalAngle, lowerVerticalAngle);
+            })
+        .def("addCubeLayer", [](OpenXrApplication &m, int size, int referenceSpaceType, std::array<float, 4> orientation){
+                return m.addCubeLayer(size, XrReferenceSpaceType(referenceSpaceType), {orientation[0], orientation[1], orientation[2], orientation[3]});
+            })
+        .def("setLayerImage", [](OpenXrApplication &m, int id, py::array_t<uint8_t, py::array::c_style | py::array::forcecast> image, bool rgba){
+                py::buffer_info info = image.request();
+                if(info.ndim != 3)
+                    return false;
+                return m.setLayerImage(id, info.shape[1], info.shape[0], info.ptr, rgba);
+            })
+        // streamed frame: the array is not copied (the caller keeps it alive until the next renderViews call)
+        .def("setLayerFrame", [](OpenXrApplication &m, int id, py::array_t<uint8_t> frame, bool rgba){
+                py::buffer_info info = frame.request();
+                if(info.ndim != 3)
+                    return false;
+                return m.setLayerFrame(id, info.shape[1], info.shape[0], info.ptr, rgba);
+            })
+        .def("setLayerPose", [](OpenXrApplication &m, int id, int referenceSpaceType, std::array<float, 3> position, std::array<float, 4> orientation){
+                XrPosef pose = {{orientation[0], orientation[1], orientation[2], orientation[3]}, {position[0], position[1], position[2]}};
+                return m.setLayerPose(id, XrReferenceSpaceType(referenceSpaceType), pose);
+            })
+        .def("setQuadLayerPose", [](OpenXrApplication &m, int id, int referenceSpaceType, std::array<float, 3> position, std::array<float, 4> orientation, std::array<float, 2> size){
+                XrPosef pose = {{orientation[0], orientation[1], orientation[2], orientation[3]}, {position[0], position[1], position[2]}};
+                return m.setQuadLayerPose(id, XrReferenceSpaceType(referenceSpaceType), pose, {size[0], size[1]});
+            })
+        .def("setLayerVisible", &OpenXrApplication::setLayerVisible)
+        .def("removeLayer", &OpenXrApplication::removeLayer)
+        .def("setColorScaleBias", [](OpenXrApplication &m, int id, std::array<float, 4> scale, std::array<float, 4> bias, float duration){
+                return m.setColorScaleBias(id, {scale[0], scale[1], scale[2], scale[3]}, {bias[0], bias[1], bias[2], bias[3]}, duration);
+            })
+        .def("getVisibilityMask", [](OpenXrApplication &m, int view, int type){
+                std::vector<XrVector2f> vertices;
+                std::vector<uint32_t> indices;
+                bool returnValue = m.getVisibilityMask(view, XrVisibilityMaskTypeKHR(type), vertices, indices);
+                py::array_t<float> vertexArray({(py::ssize_t)vertices.size(), (py::ssize_t)2});
+                if(!vertices.empty())
+                    std::memcpy(vertexArray.mutable_data(), vertices.data(), vertices.size() * sizeof(XrVector2f));
+                py::array_t<uint32_t> indexArray((py::ssize_t)indices.size());
+                if(!indices.empty())
+                    std::memcpy(indexArray.mutable_data(), indices.data(), indices.size() * sizeof(uint32_t));
+                return std::make_tuple(returnValue, vertexArray, indexArray);
             });
 }
\ No newline at end of file
@@ -0,0 +1,1076 @@
+// semu stub runtime
+// Minimal OpenXR runtime (OpenGL: Xlib or EGL, or no graphics with XR_MND_headless) used to run the application frame loop without a device (e.g. soak benchmark).
+// It reports a stereo head-mounted display, paces xrWaitFrame at the display refresh rate, 
+// returns slowly moving views and neutral action states and backs the swapchains with OpenGL textures
+//
+// Environment variables:
+//   XR_STUB_RUNTIME_DISPLAY_RATE: display refresh rate in Hz (default: 90). If 0, xrWaitFrame does not block
+//   XR_STUB_RUNTIME_VIEW_WIDTH, XR_STUB_RUNTIME_VIEW_HEIGHT: recommended view resolution (default: 1024x1024)
+//   XR_STUB_RUNTIME_SESSION_LOSS: seconds after the instance creation at which the session is lost once (default: 0, never).
+//   The system is unavailable (device disconnected) for XR_STUB_RUNTIME_SESSION_LOSS_DURATION seconds (default: 1)
+
+#define XR_USE_PLATFORM_XLIB
+#define XR_USE_PLATFORM_EGL
+#define XR_USE_GRAPHICS_API_OPENGL
+
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <GL/glx.h>
+#include <X11/Xlib.h>
+#include <EGL/egl.h>
+
+#include <map>
+#include <algorithm>
+#include <set>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_platform.h>
+#include <openxr/openxr_reflection.h>
+
+#if defined(__GNUC__)
+#define RUNTIME_EXPORT extern "C" __attribute__((visibility("default")))
+#else
+#define RUNTIME_EXPORT extern "C"
+#endif
+
+#define STUB_RUNTIME_NAME "semu stub runtime"
+#define STUB_SYSTEM_ID 1
+#define STUB_SWAPCHAIN_LENGTH 3
+
+
+// loader <-> runtime negotiation interface (ABI defined by the OpenXR loader, loader_interfaces.h)
+// the bundled OpenXR headers do not ship it, so the required structures are declared here
+
+typedef enum XrLoaderInterfaceStructs{
+	XR_LOADER_INTERFACE_STRUCT_UNINTIALIZED = 0,
+	XR_LOADER_INTERFACE_STRUCT_LOADER_INFO,
+	XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST,
+	XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST,
+	XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO,
+	XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO,
+} XrLoaderInterfaceStructs;
+
+#define XR_LOADER_INFO_STRUCT_VERSION 1
+#define XR_RUNTIME_INFO_STRUCT_VERSION 1
+#define CURRENT_LOADER_RUNTIME_VERSION 1
+
+typedef struct XrNegotiateLoaderInfo{
+	XrLoaderInterfaceStructs structType;
+	uint32_t structVersion;
+	size_t structSize;
+	uint32_t minInterfaceVersion;
+	uint32_t maxInterfaceVersion;
+	XrVersion minApiVersion;
+	XrVersion maxApiVersion;
+} XrNegotiateLoaderInfo;
+
+typedef struct XrNegotiateRuntimeRequest{
+	XrLoaderInterfaceStructs structType;
+	uint32_t structVersion;
+	size_t structSize;
+	uint32_t runtimeInterfaceVersion;
+	XrVersion runtimeApiVersion;
+	PFN_xrGetInstanceProcAddr getInstanceProcAddr;
+} XrNegotiateRuntimeRequest;
+
+
+// runtime state (single instance and session)
+
+struct StubSwapchain{
+	int64_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t index = 0;
+	bool released = false;			// at least one image released (the swapchain can be submitted)
+	bool cube = false;				// cube map textures (6 faces)
+	bool staticImage = false;		// XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT: a single image, acquired once
+	bool acquired = false;
+	std::vector<GLuint> textures;
+};
+
+struct StubRuntime{
+	std::mutex mutex;
+	uint64_t handleCounter = 0;
+
+	XrInstance instance = XR_NULL_HANDLE;
+	XrSession session = XR_NULL_HANDLE;
+	XrSessionState sessionState = XR_SESSION_STATE_UNKNOWN;
+	bool headless = false;			// XR_MND_headless enabled: sessions may be created without graphics binding
+	bool depth = false;				// XR_KHR_composition_layer_depth enabled: depth information may be chained to the projection views
+	bool cylinder = false;			// XR_KHR_composition_layer_cylinder enabled
+	bool equirect = false;			// XR_KHR_composition_layer_equirect2 enabled
+	bool cube = false;				// XR_KHR_composition_layer_cube enabled
+	bool colorScaleBias = false;	// XR_KHR_composition_layer_color_scale_bias enabled
+	bool visibilityMask = false;	// XR_KHR_visibility_mask enabled
+	bool spaceWarp = false;			// XR_FB_space_warp enabled
+	bool spaceWarpActive = false;	// space warp information in every view of the last frame: the frames are paced at half rate
+	bool quadViews = false;			// XR_VARJO_quad_views enabled: the quad view configuration is enumerated
+	bool displayRefreshRate = false;	// XR_FB_display_refresh_rate enabled: the display rate can be changed by the application
+	bool reprojection = false;		// XR_MSFT_composition_layer_reprojection enabled: reprojection hints may be chained to the projection layer
+	std::deque<XrEventDataBuffer> events;
+
+	std::map<std::string, XrPath> paths;
+	std::vector<std::string> pathStrings;
+	std::map<XrSwapchain, StubSwapchain> swapchains;
+
+	double displayRate = 90;
+	double defaultDisplayRate = 90;	// XR_STUB_RUNTIME_DISPLAY_RATE (restored when the application requests the rate 0)
+	uint32_t viewWidth = 1024;
+	uint32_t viewHeight = 1024;
+	std::chrono::steady_clock::time_point startTime;
+	std::chrono::steady_clock::time_point nextFrameTime;
+	XrTime lastDisplayTime = 0;
+
+	// simulated session loss (device disconnection)
+	double sessionLoss = 0;
+	double sessionLossDuration = 1;
+	bool sessionLost = false;
+	std::chrono::steady_clock::time_point sessionLossTime;
+};
+
+static StubRuntime runtime;
+
+template<typename T> static T newHandle(){
+	return reinterpret_cast<T>((uintptr_t)++runtime.handleCounter);
+}
+
+static XrTime now(){
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - runtime.startTime).count() + 1;
+}
+
+static void pushSessionState(XrSessionState state){
+	XrEventDataBuffer buffer = {XR_TYPE_EVENT_DATA_BUFFER};
+	XrEventDataSessionStateChanged * event = reinterpret_cast<XrEventDataSessionStateChanged*>(&buffer);
+	event->type = XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED;
+	event->next = nullptr;
+	event->session = runtime.session;
+	event->state = state;
+	event->time = now();
+	runtime.events.push_back(buffer);
+	runtime.sessionState = state;
+}
+
+// two-call idiom helper
+template<typename T> static XrResult enumerate(const std::vector<T> & values, uint32_t capacityInput, uint32_t * countOutput, T * output){
+	if(!countOutput)
+		return XR_ERROR_VALIDATION_FAILURE;
+	*countOutput = values.size();
+	if(!capacityInput)
+		return XR_SUCCESS;
+	if(capacityInput < values.size())
+		return XR_ERROR_SIZE_INSUFFICIENT;
+	for(size_t i = 0; i < values.size(); i++)
+		output[i] = values[i];
+	return XR_SUCCESS;
+}
+
+static XrResult copyString(const std::string & value, uint32_t capacityInput, uint32_t * countOutput, char * buffer){
+	if(!countOutput)
+		return XR_ERROR_VALIDATION_FAILURE;
+	*countOutput = value.size() + 1;
+	if(!capacityInput)
+		return XR_SUCCESS;
+	if(capacityInput < value.size() + 1)
+		return XR_ERROR_SIZE_INSUFFICIENT;
+	memcpy(buffer, value.c_str(), value.size() + 1);
+	return XR_SUCCESS;
+}
+
+static XrPosef identityPose(){
+	XrPosef pose;
+	pose.orientation = {0, 0, 0, 1};
+	pose.position = {0, 0, 0};
+	return pose;
+}
+
+
+// instance
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEnumerateInstanceExtensionProperties(const char * layerName, uint32_t propertyCapacityInput, uint32_t * propertyCountOutput, XrExtensionProperties * properties){
+	std::vector<XrExtensionProperties> extensions(13, {XR_TYPE_EXTENSION_PROPERTIES});
+	strncpy(extensions[0].extensionName, XR_KHR_OPENGL_ENABLE_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[0].extensionVersion = XR_KHR_opengl_enable_SPEC_VERSION;
+	strncpy(extensions[1].extensionName, XR_MNDX_EGL_ENABLE_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[1].extensionVersion = XR_MNDX_egl_enable_SPEC_VERSION;
+	strncpy(extensions[2].extensionName, XR_MND_HEADLESS_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[2].extensionVersion = XR_MND_headless_SPEC_VERSION;
+	strncpy(extensions[3].extensionName, XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[3].extensionVersion = XR_KHR_composition_layer_depth_SPEC_VERSION;
+	strncpy(extensions[4].extensionName, XR_KHR_COMPOSITION_LAYER_CYLINDER_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[4].extensionVersion = XR_KHR_composition_layer_cylinder_SPEC_VERSION;
+	strncpy(extensions[5].extensionName, XR_KHR_COMPOSITION_LAYER_EQUIRECT2_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[5].extensionVersion = XR_KHR_composition_layer_equirect2_SPEC_VERSION;
+	strncpy(extensions[6].extensionName, XR_KHR_COMPOSITION_LAYER_CUBE_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[6].extensionVersion = XR_KHR_composition_layer_cube_SPEC_VERSION;
+	strncpy(extensions[7].extensionName, XR_KHR_COMPOSITION_LAYER_COLOR_SCALE_BIAS_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[7].extensionVersion = XR_KHR_composition_layer_color_scale_bias_SPEC_VERSION;
+	strncpy(extensions[8].extensionName, XR_KHR_VISIBILITY_MASK_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[8].extensionVersion = XR_KHR_visibility_mask_SPEC_VERSION;
+	strncpy(extensions[9].extensionName, XR_FB_SPACE_WARP_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[9].extensionVersion = XR_FB_space_warp_SPEC_VERSION;
+	strncpy(extensions[10].extensionName, XR_VARJO_QUAD_VIEWS_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[10].extensionVersion = XR_VARJO_quad_views_SPEC_VERSION;
+	strncpy(extensions[11].extensionName, XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[11].extensionVersion = XR_FB_display_refresh_rate_SPEC_VERSION;
+	strncpy(extensions[12].extensionName, XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME, XR_MAX_EXTENSION_NAME_SIZE - 1);
+	extensions[12].extensionVersion = XR_MSFT_composition_layer_reprojection_SPEC_VERSION;
+	return enumerate(extensions, propertyCapacityInput, propertyCountOutput, properties);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrCreateInstance(const XrInstanceCreateInfo * createInfo, XrInstance * instance){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	if(runtime.instance != XR_NULL_HANDLE)
+		return XR_ERROR_LIMIT_REACHED;
+	runtime.headless = false;
+	runtime.depth = false;
+	runtime.cylinder = false;
+	runtime.equirect = false;
+	runtime.cube = false;
+	runtime.colorScaleBias = false;
+	runtime.visibilityMask = false;
+	runtime.spaceWarp = false;
+	runtime.spaceWarpActive = false;
+	runtime.quadViews = false;
+	runtime.displayRefreshRate = false;
+	runtime.reprojection = false;
+	for(uint32_t i = 0; i < createInfo->enabledExtensionCount; i++){
+		if(!strcmp(createInfo->enabledExtensionNames[i], XR_MND_HEADLESS_EXTENSION_NAME))
+			runtime.headless = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME))
+			runtime.depth = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_KHR_COMPOSITION_LAYER_CYLINDER_EXTENSION_NAME))
+			runtime.cylinder = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_KHR_COMPOSITION_LAYER_EQUIRECT2_EXTENSION_NAME))
+			runtime.equirect = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_KHR_COMPOSITION_LAYER_CUBE_EXTENSION_NAME))
+			runtime.cube = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_KHR_COMPOSITION_LAYER_COLOR_SCALE_BIAS_EXTENSION_NAME))
+			runtime.colorScaleBias = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_KHR_VISIBILITY_MASK_EXTENSION_NAME))
+			runtime.visibilityMask = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_FB_SPACE_WARP_EXTENSION_NAME))
+			runtime.spaceWarp = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_VARJO_QUAD_VIEWS_EXTENSION_NAME))
+			runtime.quadViews = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME))
+			runtime.displayRefreshRate = true;
+		else if(!strcmp(createInfo->enabledExtensionNames[i], XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME))
+			runtime.reprojection = true;
+		else if(strcmp(createInfo->enabledExtensionNames[i], XR_KHR_OPENGL_ENABLE_EXTENSION_NAME) && strcmp(createInfo->enabledExtensionNames[i], XR_MNDX_EGL_ENABLE_EXTENSION_NAME))
+			return XR_ERROR_EXTENSION_NOT_PRESENT;
+	}
+
+	const char * displayRate = getenv("XR_STUB_RUNTIME_DISPLAY_RATE");
+	const char * viewWidth = getenv("XR_STUB_RUNTIME_VIEW_WIDTH");
+	const char * viewHeight = getenv("XR_STUB_RUNTIME_VIEW_HEIGHT");
+	runtime.displayRate = runtime.defaultDisplayRate = displayRate ? atof(displayRate) : 90;
+	runtime.viewWidth = viewWidth ? atoi(viewWidth) : 1024;
+	runtime.viewHeight = viewHeight ? atoi(viewHeight) : 1024;
+	const char * sessionLoss = getenv("XR_STUB_RUNTIME_SESSION_LOSS");
+	const char * sessionLossDuration = getenv("XR_STUB_RUNTIME_SESSION_LOSS_DURATION");
+	runtime.sessionLoss = sessionLoss ? atof(sessionLoss) : 0;
+	runtime.sessionLossDuration = sessionLossDuration ? atof(sessionLossDuration) : 1;
+	runtime.sessionLost = false;
+	runtime.startTime = std::chrono::steady_clock::now();
+	runtime.nextFrameTime = runtime.startTime;
+	runtime.instance = newHandle<XrInstance>();
+	*instance = runtime.instance;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrDestroyInstance(XrInstance instance){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	if(instance != runtime.instance)
+		return XR_ERROR_HANDLE_INVALID;
+	runtime.instance = XR_NULL_HANDLE;
+	runtime.events.clear();
+	runtime.paths.clear();
+	runtime.pathStrings.clear();
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetInstanceProperties(XrInstance instance, XrInstanceProperties * instanceProperties){
+	instanceProperties->runtimeVersion = XR_MAKE_VERSION(0, 1, 0);
+	strncpy(instanceProperties->runtimeName, STUB_RUNTIME_NAME, XR_MAX_RUNTIME_NAME_SIZE - 1);
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrResultToString(XrInstance instance, XrResult value, char buffer[XR_MAX_RESULT_STRING_SIZE]){
+	switch(value){
+#define RESULT_CASE_STR(name, val) case name: strncpy(buffer, #name, XR_MAX_RESULT_STRING_SIZE - 1); buffer[XR_MAX_RESULT_STRING_SIZE - 1] = '\0'; return XR_SUCCESS;
+		XR_LIST_ENUM_XrResult(RESULT_CASE_STR)
+#undef RESULT_CASE_STR
+		default:
+			snprintf(buffer, XR_MAX_RESULT_STRING_SIZE, "XR_UNKNOWN_%s_%d", XR_SUCCEEDED(value) ? "SUCCESS" : "FAILURE", value);
+	}
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrStructureTypeToString(XrInstance instance, XrStructureType value, char buffer[XR_MAX_STRUCTURE_NAME_SIZE]){
+	snprintf(buffer, XR_MAX_STRUCTURE_NAME_SIZE, "XR_UNKNOWN_STRUCTURE_TYPE_%d", value);
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrPollEvent(XrInstance instance, XrEventDataBuffer * eventData){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	if(runtime.events.empty())
+		return XR_EVENT_UNAVAILABLE;
+	*eventData = runtime.events.front();
+	runtime.events.pop_front();
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrStringToPath(XrInstance instance, const char * pathString, XrPath * path){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	auto it = runtime.paths.find(pathString);
+	if(it == runtime.paths.end()){
+		runtime.pathStrings.push_back(pathString);
+		it = runtime.paths.insert({pathString, (XrPath)runtime.pathStrings.size()}).first;
+	}
+	*path = it->second;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrPathToString(XrInstance instance, XrPath path, uint32_t bufferCapacityInput, uint32_t * bufferCountOutput, char * buffer){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	if(path == XR_NULL_PATH || path > runtime.pathStrings.size())
+		return XR_ERROR_PATH_INVALID;
+	return copyString(runtime.pathStrings[path - 1], bufferCapacityInput, bufferCountOutput, buffer);
+}
+
+
+// system
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetSystem(XrInstance instance, const XrSystemGetInfo * getInfo, XrSystemId * systemId){
+	if(getInfo->formFactor != XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY)
+		return XR_ERROR_FORM_FACTOR_UNSUPPORTED;
+	if(runtime.sessionLost && std::chrono::duration<double>(std::chrono::steady_clock::now() - runtime.sessionLossTime).count() < runtime.sessionLossDuration)
+		return XR_ERROR_FORM_FACTOR_UNAVAILABLE;
+	*systemId = STUB_SYSTEM_ID;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetSystemProperties(XrInstance instance, XrSystemId systemId, XrSystemProperties * properties){
+	properties->systemId = systemId;
+	properties->vendorId = 0;
+	strncpy(properties->systemName, STUB_RUNTIME_NAME, XR_MAX_SYSTEM_NAME_SIZE - 1);
+	properties->graphicsProperties.maxLayerCount = XR_MIN_COMPOSITION_LAYERS_SUPPORTED;
+	properties->graphicsProperties.maxSwapchainImageWidth = 4096;
+	properties->graphicsProperties.maxSwapchainImageHeight = 4096;
+	properties->trackingProperties.orientationTracking = XR_TRUE;
+	properties->trackingProperties.positionTracking = XR_TRUE;
+	// recommended motion vector resolution (XR_FB_space_warp): half the view resolution
+	for(XrBaseOutStructure * next = reinterpret_cast<XrBaseOutStructure*>(properties->next); next; next = next->next)
+		if(next->type == XR_TYPE_SYSTEM_SPACE_WARP_PROPERTIES_FB && runtime.spaceWarp){
+			XrSystemSpaceWarpPropertiesFB * spaceWarpProperties = reinterpret_cast<XrSystemSpaceWarpPropertiesFB*>(next);
+			spaceWarpProperties->recommendedMotionVectorImageRectWidth = runtime.viewWidth / 2;
+			spaceWarpProperties->recommendedMotionVectorImageRectHeight = runtime.viewHeight / 2;
+		}
+	return XR_SUCCESS;
+}
+
+static uint32_t stubViewCount(XrViewConfigurationType viewConfigurationType){
+	switch(viewConfigurationType){
+		case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO: return 1;
+		case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO: return 4;
+		default: return 2;
+	}
+}
+
+// half angle of the field of view (radians): the inner views of the quad view configuration cover the center of the context views
+static float stubViewHalfAngle(XrViewConfigurationType viewConfigurationType, uint32_t viewIndex){
+	return viewConfigurationType == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO && viewIndex >= 2 ? 0.35f : 0.8f;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEnumerateViewConfigurations(XrInstance instance, XrSystemId systemId, uint32_t viewConfigurationTypeCapacityInput, uint32_t * viewConfigurationTypeCountOutput, XrViewConfigurationType * viewConfigurationTypes){
+	std::vector<XrViewConfigurationType> types = {XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO};
+	if(runtime.quadViews)
+		types.push_back(XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO);
+	return enumerate(types, viewConfigurationTypeCapacityInput, viewConfigurationTypeCountOutput, viewConfigurationTypes);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetViewConfigurationProperties(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, XrViewConfigurationProperties * configurationProperties){
+	configurationProperties->viewConfigurationType = viewConfigurationType;
+	configurationProperties->fovMutable = XR_FALSE;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEnumerateViewConfigurationViews(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t viewCapacityInput, uint32_t * viewCountOutput, XrViewConfigurationView * views){
+	XrViewConfigurationView view = {XR_TYPE_VIEW_CONFIGURATION_VIEW};
+	view.recommendedImageRectWidth = runtime.viewWidth;
+	view.recommendedImageRectHeight = runtime.viewHeight;
+	view.maxImageRectWidth = 4096;
+	view.maxImageRectHeight = 4096;
+	view.recommendedSwapchainSampleCount = 1;
+	view.maxSwapchainSampleCount = 1;
+	std::vector<XrViewConfigurationView> configurationViews(stubViewCount(viewConfigurationType), view);
+	// quad views: lower resolution context views and inner foveal views of the same size (narrower field of view)
+	if(viewConfigurationType == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO)
+		for(uint32_t i = 0; i < 2; i++){
+			configurationViews[i].recommendedImageRectWidth = runtime.viewWidth / 2;
+			configurationViews[i].recommendedImageRectHeight = runtime.viewHeight / 2;
+		}
+	return enumerate(configurationViews, viewCapacityInput, viewCountOutput, views);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEnumerateEnvironmentBlendModes(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t environmentBlendModeCapacityInput, uint32_t * environmentBlendModeCountOutput, XrEnvironmentBlendMode * environmentBlendModes){
+	std::vector<XrEnvironmentBlendMode> modes = {XR_ENVIRONMENT_BLEND_MODE_OPAQUE};
+	return enumerate(modes, environmentBlendModeCapacityInput, environmentBlendModeCountOutput, environmentBlendModes);
+}
+
+// reprojection modes (XR_MSFT_composition_layer_reprojection): all the modes for every view configuration
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEnumerateReprojectionModesMSFT(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t modeCapacityInput, uint32_t * modeCountOutput, XrReprojectionModeMSFT * modes){
+	if(!runtime.reprojection)
+		return XR_ERROR_FUNCTION_UNSUPPORTED;
+	std::vector<XrReprojectionModeMSFT> reprojectionModes = {XR_REPROJECTION_MODE_DEPTH_MSFT, XR_REPROJECTION_MODE_PLANAR_FROM_DEPTH_MSFT, 
+															 XR_REPROJECTION_MODE_PLANAR_MANUAL_MSFT, XR_REPROJECTION_MODE_ORIENTATION_ONLY_MSFT};
+	return enumerate(reprojectionModes, modeCapacityInput, modeCountOutput, modes);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetOpenGLGraphicsRequirementsKHR(XrInstance instance, XrSystemId systemId, XrGraphicsRequirementsOpenGLKHR * graphicsRequirements){
+	graphicsRequirements->minApiVersionSupported = XR_MAKE_VERSION(3, 2, 0);
+	graphicsRequirements->maxApiVersionSupported = XR_MAKE_VERSION(4, 6, 0);
+	return XR_SUCCESS;
+}
+
+
+// session
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrCreateSession(XrInstance instance, const XrSessionCreateInfo * createInfo, XrSession * session){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	if(runtime.session != XR_NULL_HANDLE)
+		return XR_ERROR_LIMIT_REACHED;
+	// the swapchain textures are created in the application context (Xlib or EGL)
+	XrStructureType bindingType = createInfo->next ? reinterpret_cast<const XrBaseInStructure*>(createInfo->next)->type : XR_TYPE_UNKNOWN;
+	// no graphics binding: only allowed with XR_MND_headless
+	if(bindingType == XR_TYPE_UNKNOWN && !runtime.headless)
+		return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+	if(bindingType != XR_TYPE_UNKNOWN && bindingType != XR_TYPE_GRAPHICS_BINDING_OPENGL_XLIB_KHR && bindingType != XR_TYPE_GRAPHICS_BINDING_EGL_MNDX)
+		return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+	runtime.session = newHandle<XrSession>();
+	*session = runtime.session;
+	pushSessionState(XR_SESSION_STATE_IDLE);
+	pushSessionState(XR_SESSION_STATE_READY);
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrDestroySession(XrSession session){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	if(session != runtime.session)
+		return XR_ERROR_HANDLE_INVALID;
+	runtime.session = XR_NULL_HANDLE;
+	runtime.sessionState = XR_SESSION_STATE_UNKNOWN;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrBeginSession(XrSession session, const XrSessionBeginInfo * beginInfo){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	if(runtime.sessionState != XR_SESSION_STATE_READY)
+		return XR_ERROR_SESSION_NOT_READY;
+	pushSessionState(XR_SESSION_STATE_SYNCHRONIZED);
+	pushSessionState(XR_SESSION_STATE_VISIBLE);
+	pushSessionState(XR_SESSION_STATE_FOCUSED);
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEndSession(XrSession session){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	pushSessionState(XR_SESSION_STATE_IDLE);
+	pushSessionState(XR_SESSION_STATE_EXITING);
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrRequestExitSession(XrSession session){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	pushSessionState(XR_SESSION_STATE_STOPPING);
+	return XR_SUCCESS;
+}
+
+
+// spaces
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEnumerateReferenceSpaces(XrSession session, uint32_t spaceCapacityInput, uint32_t * spaceCountOutput, XrReferenceSpaceType * spaces){
+	std::vector<XrReferenceSpaceType> types = {XR_REFERENCE_SPACE_TYPE_VIEW, XR_REFERENCE_SPACE_TYPE_LOCAL, XR_REFERENCE_SPACE_TYPE_STAGE};
+	return enumerate(types, spaceCapacityInput, spaceCountOutput, spaces);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo * createInfo, XrSpace * space){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	*space = newHandle<XrSpace>();
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetReferenceSpaceBoundsRect(XrSession session, XrReferenceSpaceType referenceSpaceType, XrExtent2Df * bounds){
+	bounds->width = referenceSpaceType == XR_REFERENCE_SPACE_TYPE_STAGE ? 2.0f : 0.0f;
+	bounds->height = referenceSpaceType == XR_REFERENCE_SPACE_TYPE_STAGE ? 2.0f : 0.0f;
+	return referenceSpaceType == XR_REFERENCE_SPACE_TYPE_STAGE ? XR_SUCCESS : XR_SPACE_BOUNDS_UNAVAILABLE;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo * createInfo, XrSpace * space){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	*space = newHandle<XrSpace>();
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation * location){
+	location->locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT | 
+							  XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+	location->pose = identityPose();
+	location->pose.position.y = -0.3f;
+	location->pose.position.z = -0.4f;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrDestroySpace(XrSpace space){
+	return XR_SUCCESS;
+}
+
+
+// views and frames
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrLocateViews(XrSession session, const XrViewLocateInfo * viewLocateInfo, XrViewState * viewState, uint32_t viewCapacityInput, uint32_t * viewCountOutput, XrView * views){
+	uint32_t viewCount = stubViewCount(viewLocateInfo->viewConfigurationType);
+	*viewCountOutput = viewCount;
+	if(!viewCapacityInput)
+		return XR_SUCCESS;
+	if(viewCapacityInput < viewCount)
+		return XR_ERROR_SIZE_INSUFFICIENT;
+
+	viewState->viewStateFlags = XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_VALID_BIT | 
+								XR_VIEW_STATE_ORIENTATION_TRACKED_BIT | XR_VIEW_STATE_POSITION_TRACKED_BIT;
+
+	// slow head rotation about the vertical axis (0.1 Hz, +/- 20 degrees)
+	double t = viewLocateInfo->displayTime * 1e-9;
+	float yaw = 0.35f * sin(2 * M_PI * 0.1 * t);
+	for(uint32_t i = 0; i < viewCount; i++){
+		views[i].pose.orientation = {0, sinf(yaw / 2), 0, cosf(yaw / 2)};
+		// the inner views of the quad view configuration (2 and 3) share the eye positions of the context views (0 and 1)
+		views[i].pose.position = {viewCount == 1 ? 0.0f : (i % 2 ? 0.032f : -0.032f), 1.6f, 0};
+		float angle = stubViewHalfAngle(viewLocateInfo->viewConfigurationType, i);
+		views[i].fov = {-angle, angle, angle, -angle};
+	}
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetVisibilityMaskKHR(XrSession session, XrViewConfigurationType viewConfigurationType, uint32_t viewIndex, XrVisibilityMaskTypeKHR visibilityMaskType, XrVisibilityMaskKHR * visibilityMask){
+	if(!runtime.visibilityMask)
+		return XR_ERROR_FUNCTION_UNSUPPORTED;
+	if(session != runtime.session)
+		return XR_ERROR_HANDLE_INVALID;
+	if(viewIndex >= stubViewCount(viewConfigurationType))
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	// octagonal visible area (the corners of the view, on the z = -1 plane, are hidden) for the located field of view
+	const float t = tanf(stubViewHalfAngle(viewConfigurationType, viewIndex)), c = t / 2;
+	const XrVector2f octagon[8] = {{c, -t}, {t, -c}, {t, c}, {c, t}, {-c, t}, {-t, c}, {-t, -c}, {-c, -t}};
+	std::vector<XrVector2f> vertices;
+	std::vector<uint32_t> indices;
+	switch(visibilityMaskType){
+		case XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR: {
+			const XrVector2f corners[4] = {{t, -t}, {t, t}, {-t, t}, {-t, -t}};
+			for(uint32_t i = 0; i < 4; i++){
+				vertices.push_back(octagon[2 * i]);
+				vertices.push_back(corners[i]);
+				vertices.push_back(octagon[2 * i + 1]);
+				indices.insert(indices.end(), {3 * i, 3 * i + 1, 3 * i + 2});
+			}
+			break;
+		}
+		case XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR:
+			vertices.push_back({0, 0});
+			for(uint32_t i = 0; i < 8; i++){
+				vertices.push_back(octagon[i]);
+				indices.insert(indices.end(), {0, i + 1, (i + 1) % 8 + 1});
+			}
+			break;
+		case XR_VISIBILITY_MASK_TYPE_LINE_LOOP_KHR:
+			for(uint32_t i = 0; i < 8; i++){
+				vertices.push_back(octagon[i]);
+				indices.push_back(i);
+			}
+			break;
+		default:
+			return XR_ERROR_VALIDATION_FAILURE;
+	}
+
+	// two-call idiom for both arrays
+	visibilityMask->vertexCountOutput = vertices.size();
+	visibilityMask->indexCountOutput = indices.size();
+	if(!visibilityMask->vertexCapacityInput && !visibilityMask->indexCapacityInput)
+		return XR_SUCCESS;
+	if(visibilityMask->vertexCapacityInput < vertices.size() || visibilityMask->indexCapacityInput < indices.size())
+		return XR_ERROR_SIZE_INSUFFICIENT;
+	std::copy(vertices.begin(), vertices.end(), visibilityMask->vertices);
+	std::copy(indices.begin(), indices.end(), visibilityMask->indices);
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrWaitFrame(XrSession session, const XrFrameWaitInfo * frameWaitInfo, XrFrameState * frameState){
+	// the lost session remains unusable until it is destroyed
+	if(runtime.sessionState == XR_SESSION_STATE_LOSS_PENDING)
+		return XR_ERROR_SESSION_LOST;
+	if(runtime.sessionLoss > 0 && !runtime.sessionLost && std::chrono::duration<double>(std::chrono::steady_clock::now() - runtime.startTime).count() > runtime.sessionLoss){
+		std::lock_guard<std::mutex> lock(runtime.mutex);
+		runtime.sessionLost = true;
+		runtime.sessionLossTime = std::chrono::steady_clock::now();
+		pushSessionState(XR_SESSION_STATE_LOSS_PENDING);
+		return XR_ERROR_SESSION_LOST;
+	}
+	XrDuration period = runtime.displayRate > 0 ? (XrDuration)(1e9 / runtime.displayRate) : 0;
+	// the runtime synthesizes every other frame from the motion vectors and depth of the last one (XR_FB_space_warp)
+	if(runtime.spaceWarpActive)
+		period *= 2;
+	if(period){
+		std::this_thread::sleep_until(runtime.nextFrameTime);
+		runtime.nextFrameTime += std::chrono::nanoseconds(period);
+		// do not accumulate delay if the application misses frames
+		auto current = std::chrono::steady_clock::now();
+		if(runtime.nextFrameTime < current)
+			runtime.nextFrameTime = current + std::chrono::nanoseconds(period);
+	}
+	frameState->predictedDisplayPeriod = period ? period : 1;
+	frameState->predictedDisplayTime = std::max(now() + period, runtime.lastDisplayTime + 1);
+	frameState->shouldRender = runtime.sessionState == XR_SESSION_STATE_VISIBLE || runtime.sessionState == XR_SESSION_STATE_FOCUSED;
+	runtime.lastDisplayTime = frameState->predictedDisplayTime;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrBeginFrame(XrSession session, const XrFrameBeginInfo * frameBeginInfo){
+	return XR_SUCCESS;
+}
+
+static XrResult validateSubImage(const XrSwapchainSubImage & subImage){
+	auto it = runtime.swapchains.find(subImage.swapchain);
+	if(it == runtime.swapchains.end())
+		return XR_ERROR_HANDLE_INVALID;
+	if(!it->second.released)
+		return XR_ERROR_LAYER_INVALID;
+	if(subImage.imageRect.offset.x < 0 || subImage.imageRect.offset.y < 0 || 
+	   subImage.imageRect.offset.x + subImage.imageRect.extent.width > (int32_t)it->second.width || 
+	   subImage.imageRect.offset.y + subImage.imageRect.extent.height > (int32_t)it->second.height)
+		return XR_ERROR_SWAPCHAIN_RECT_INVALID;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEndFrame(XrSession session, const XrFrameEndInfo * frameEndInfo){
+	if(frameEndInfo->layerCount && !frameEndInfo->layers)
+		return XR_ERROR_VALIDATION_FAILURE;
+	// the submitted layers must reference swapchains with a released image
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	bool spaceWarpActive = false;
+	for(uint32_t i = 0; i < frameEndInfo->layerCount; i++){
+		const XrCompositionLayerBaseHeader * layer = frameEndInfo->layers[i];
+		if(!layer || layer->space == XR_NULL_HANDLE)
+			return XR_ERROR_LAYER_INVALID;
+		// color scale and bias (XR_KHR_composition_layer_color_scale_bias)
+		for(const XrBaseInStructure * next = reinterpret_cast<const XrBaseInStructure*>(layer->next); next; next = next->next){
+			if(next->type == XR_TYPE_COMPOSITION_LAYER_COLOR_SCALE_BIAS_KHR && !runtime.colorScaleBias)
+				return XR_ERROR_VALIDATION_FAILURE;
+			// reprojection mode and plane of the projection layer (XR_MSFT_composition_layer_reprojection)
+			if(next->type == XR_TYPE_COMPOSITION_LAYER_REPROJECTION_INFO_MSFT){
+				XrReprojectionModeMSFT mode = reinterpret_cast<const XrCompositionLayerReprojectionInfoMSFT*>(next)->reprojectionMode;
+				if(!runtime.reprojection || layer->type != XR_TYPE_COMPOSITION_LAYER_PROJECTION || mode < XR_REPROJECTION_MODE_DEPTH_MSFT || mode > XR_REPROJECTION_MODE_ORIENTATION_ONLY_MSFT)
+					return XR_ERROR_VALIDATION_FAILURE;
+			}
+			if(next->type == XR_TYPE_COMPOSITION_LAYER_REPROJECTION_PLANE_OVERRIDE_MSFT){
+				const XrVector3f & normal = reinterpret_cast<const XrCompositionLayerReprojectionPlaneOverrideMSFT*>(next)->normal;
+				if(!runtime.reprojection || layer->type != XR_TYPE_COMPOSITION_LAYER_PROJECTION || 
+				   fabsf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z - 1) > 1e-3f)
+					return XR_ERROR_VALIDATION_FAILURE;
+			}
+		}
+		XrResult result = XR_SUCCESS;
+		if(layer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION){
+			const XrCompositionLayerProjection * projection = reinterpret_cast<const XrCompositionLayerProjection*>(layer);
+			uint32_t spaceWarpViews = 0;
+			for(uint32_t j = 0; j < projection->viewCount && result == XR_SUCCESS; j++){
+				result = validateSubImage(projection->views[j].subImage);
+				const XrBaseInStructure * next = reinterpret_cast<const XrBaseInStructure*>(projection->views[j].next);
+				for(; next && result == XR_SUCCESS; next = next->next){
+					// motion vectors and depth (XR_FB_space_warp)
+					if(next->type == XR_TYPE_COMPOSITION_LAYER_SPACE_WARP_INFO_FB){
+						const XrCompositionLayerSpaceWarpInfoFB * spaceWarpInfo = reinterpret_cast<const XrCompositionLayerSpaceWarpInfoFB*>(next);
+						if(!runtime.spaceWarp || spaceWarpInfo->minDepth < 0 || spaceWarpInfo->maxDepth > 1 || spaceWarpInfo->minDepth > spaceWarpInfo->maxDepth || 
+						   spaceWarpInfo->nearZ == spaceWarpInfo->farZ || 
+						   spaceWarpInfo->motionVectorSubImage.imageRect.extent.width != spaceWarpInfo->depthSubImage.imageRect.extent.width || 
+						   spaceWarpInfo->motionVectorSubImage.imageRect.extent.height != spaceWarpInfo->depthSubImage.imageRect.extent.height)
+							return XR_ERROR_VALIDATION_FAILURE;
+						auto it = runtime.swapchains.find(spaceWarpInfo->motionVectorSubImage.swapchain);
+						if(it != runtime.swapchains.end() && it->second.format != GL_RGBA16F)
+							return XR_ERROR_VALIDATION_FAILURE;
+						result = validateSubImage(spaceWarpInfo->motionVectorSubImage);
+						if(result == XR_SUCCESS)
+							result = validateSubImage(spaceWarpInfo->depthSubImage);
+						spaceWarpViews++;
+						continue;
+					}
+					// depth information (XR_KHR_composition_layer_depth)
+					if(next->type != XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR)
+						continue;
+					const XrCompositionLayerDepthInfoKHR * depthInfo = reinterpret_cast<const XrCompositionLayerDepthInfoKHR*>(next);
+					if(!runtime.depth || depthInfo->minDepth < 0 || depthInfo->maxDepth > 1 || depthInfo->minDepth > depthInfo->maxDepth || 
+					   depthInfo->nearZ == depthInfo->farZ)
+						return XR_ERROR_VALIDATION_FAILURE;
+					result = validateSubImage(depthInfo->subImage);
+				}
+			}
+			spaceWarpActive = projection->viewCount && spaceWarpViews == projection->viewCount;
+		}
+		else if(layer->type == XR_TYPE_COMPOSITION_LAYER_QUAD){
+			const XrCompositionLayerQuad * quad = reinterpret_cast<const XrCompositionLayerQuad*>(layer);
+			if(quad->size.width <= 0 || quad->size.height <= 0)
+				return XR_ERROR_VALIDATION_FAILURE;
+			result = validateSubImage(quad->subImage);
+		}
+		else if(layer->type == XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR && runtime.cylinder){
+			const XrCompositionLayerCylinderKHR * cylinder = reinterpret_cast<const XrCompositionLayerCylinderKHR*>(layer);
+			if(cylinder->radius < 0 || cylinder->centralAngle < 0 || cylinder->centralAngle > 2 * (float)M_PI || cylinder->aspectRatio <= 0)
+				return XR_ERROR_VALIDATION_FAILURE;
+			result = validateSubImage(cylinder->subImage);
+		}
+		else if(layer->type == XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR && runtime.equirect){
+			const XrCompositionLayerEquirect2KHR * equirect = reinterpret_cast<const XrCompositionLayerEquirect2KHR*>(layer);
+			if(equirect->radius < 0 || equirect->centralHorizontalAngle < 0 || equirect->centralHorizontalAngle > 2 * (float)M_PI || 
+			   equirect->upperVerticalAngle > (float)M_PI / 2 || equirect->lowerVerticalAngle < -(float)M_PI / 2)
+				return XR_ERROR_VALIDATION_FAILURE;
+			result = validateSubImage(equirect->subImage);
+		}
+		else if(layer->type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR && runtime.cube){
+			const XrCompositionLayerCubeKHR * cube = reinterpret_cast<const XrCompositionLayerCubeKHR*>(layer);
+			auto it = runtime.swapchains.find(cube->swapchain);
+			if(it == runtime.swapchains.end())
+				return XR_ERROR_HANDLE_INVALID;
+			if(!it->second.cube || !it->second.released)
+				return XR_ERROR_LAYER_INVALID;
+		}
+		else
+			return XR_ERROR_LAYER_INVALID;
+		if(result != XR_SUCCESS)
+			return result;
+	}
+	runtime.spaceWarpActive = spaceWarpActive;
+	return XR_SUCCESS;
+}
+
+
+// swapchains (OpenGL textures created in the application context)
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEnumerateSwapchainFormats(XrSession session, uint32_t formatCapacityInput, uint32_t * formatCountOutput, int64_t * formats){
+	std::vector<int64_t> supportedFormats = {GL_RGBA8, GL_SRGB8_ALPHA8, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT16, GL_RGBA16F};
+	return enumerate(supportedFormats, formatCapacityInput, formatCountOutput, formats);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrCreateSwapchain(XrSession session, const XrSwapchainCreateInfo * createInfo, XrSwapchain * swapchain){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	StubSwapchain stubSwapchain;
+	stubSwapchain.format = createInfo->format;
+	stubSwapchain.width = createInfo->width;
+	stubSwapchain.height = createInfo->height;
+	stubSwapchain.cube = createInfo->faceCount == 6;
+	stubSwapchain.staticImage = (createInfo->createFlags & XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT) != 0;
+	if(createInfo->faceCount != 1 && !stubSwapchain.cube)
+		return XR_ERROR_VALIDATION_FAILURE;
+	if(stubSwapchain.cube && createInfo->width != createInfo->height)
+		return XR_ERROR_VALIDATION_FAILURE;
+	stubSwapchain.textures.resize(stubSwapchain.staticImage ? 1 : STUB_SWAPCHAIN_LENGTH);
+	GLenum target = stubSwapchain.cube ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+	bool depth = createInfo->format == GL_DEPTH_COMPONENT32F || createInfo->format == GL_DEPTH_COMPONENT16;
+	glGenTextures(stubSwapchain.textures.size(), stubSwapchain.textures.data());
+	for(size_t i = 0; i < stubSwapchain.textures.size(); i++){
+		glBindTexture(target, stubSwapchain.textures[i]);
+		for(uint32_t face = 0; face < createInfo->faceCount; face++)
+			glTexImage2D(stubSwapchain.cube ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D, 0, (GLint)createInfo->format, createInfo->width, createInfo->height, 0, 
+						 depth ? GL_DEPTH_COMPONENT : GL_RGBA, depth ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
+	}
+	glBindTexture(target, 0);
+
+	*swapchain = newHandle<XrSwapchain>();
+	runtime.swapchains[*swapchain] = stubSwapchain;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrDestroySwapchain(XrSwapchain swapchain){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	auto it = runtime.swapchains.find(swapchain);
+	if(it == runtime.swapchains.end())
+		return XR_ERROR_HANDLE_INVALID;
+	glDeleteTextures(it->second.textures.size(), it->second.textures.data());
+	runtime.swapchains.erase(it);
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput, uint32_t * imageCountOutput, XrSwapchainImageBaseHeader * images){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	auto it = runtime.swapchains.find(swapchain);
+	if(it == runtime.swapchains.end())
+		return XR_ERROR_HANDLE_INVALID;
+	*imageCountOutput = it->second.textures.size();
+	if(!imageCapacityInput)
+		return XR_SUCCESS;
+	if(imageCapacityInput < it->second.textures.size())
+		return XR_ERROR_SIZE_INSUFFICIENT;
+	XrSwapchainImageOpenGLKHR * glImages = reinterpret_cast<XrSwapchainImageOpenGLKHR*>(images);
+	for(size_t i = 0; i < it->second.textures.size(); i++)
+		glImages[i].image = it->second.textures[i];
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo * acquireInfo, uint32_t * index){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	auto it = runtime.swapchains.find(swapchain);
+	if(it == runtime.swapchains.end())
+		return XR_ERROR_HANDLE_INVALID;
+	// static swapchains are acquired once
+	if(it->second.staticImage && it->second.acquired)
+		return XR_ERROR_CALL_ORDER_INVALID;
+	it->second.acquired = true;
+	*index = it->second.index;
+	it->second.index = (it->second.index + 1) % it->second.textures.size();
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo * waitInfo){
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo * releaseInfo){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	auto it = runtime.swapchains.find(swapchain);
+	if(it == runtime.swapchains.end())
+		return XR_ERROR_HANDLE_INVALID;
+	it->second.released = true;
+	return XR_SUCCESS;
+}
+
+
+// actions (no input device: every action is inactive)
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrCreateActionSet(XrInstance instance, const XrActionSetCreateInfo * createInfo, XrActionSet * actionSet){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	*actionSet = newHandle<XrActionSet>();
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrDestroyActionSet(XrActionSet actionSet){
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrCreateAction(XrActionSet actionSet, const XrActionCreateInfo * createInfo, XrAction * action){
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	*action = newHandle<XrAction>();
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrDestroyAction(XrAction action){
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrSuggestInteractionProfileBindings(XrInstance instance, const XrInteractionProfileSuggestedBinding * suggestedBindings){
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttachInfo * attachInfo){
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrSyncActions(XrSession session, const XrActionsSyncInfo * syncInfo){
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo * getInfo, XrActionStateBoolean * state){
+	state->currentState = XR_FALSE;
+	state->changedSinceLastSync = XR_FALSE;
+	state->lastChangeTime = 0;
+	state->isActive = XR_FALSE;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetActionStateFloat(XrSession session, const XrActionStateGetInfo * getInfo, XrActionStateFloat * state){
+	state->currentState = 0;
+	state->changedSinceLastSync = XR_FALSE;
+	state->lastChangeTime = 0;
+	state->isActive = XR_FALSE;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetActionStateVector2f(XrSession session, const XrActionStateGetInfo * getInfo, XrActionStateVector2f * state){
+	state->currentState = {0, 0};
+	state->changedSinceLastSync = XR_FALSE;
+	state->lastChangeTime = 0;
+	state->isActive = XR_FALSE;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetActionStatePose(XrSession session, const XrActionStateGetInfo * getInfo, XrActionStatePose * state){
+	state->isActive = XR_FALSE;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrApplyHapticFeedback(XrSession session, const XrHapticActionInfo * hapticActionInfo, const XrHapticBaseHeader * hapticFeedback){
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrStopHapticFeedback(XrSession session, const XrHapticActionInfo * hapticActionInfo){
+	return XR_SUCCESS;
+}
+
+
+// display refresh rate (XR_FB_display_refresh_rate)
+
+// common headset rates and the default one
+static std::vector<float> stubDisplayRefreshRates(){
+	std::vector<float> rates = {60, 72, 90, 120};
+	if(runtime.defaultDisplayRate > 0 && std::find(rates.begin(), rates.end(), (float)runtime.defaultDisplayRate) == rates.end()){
+		rates.push_back(runtime.defaultDisplayRate);
+		std::sort(rates.begin(), rates.end());
+	}
+	return rates;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrEnumerateDisplayRefreshRatesFB(XrSession session, uint32_t displayRefreshRateCapacityInput, uint32_t * displayRefreshRateCountOutput, float * displayRefreshRates){
+	if(!runtime.displayRefreshRate)
+		return XR_ERROR_FUNCTION_UNSUPPORTED;
+	if(session != runtime.session)
+		return XR_ERROR_HANDLE_INVALID;
+	return enumerate(stubDisplayRefreshRates(), displayRefreshRateCapacityInput, displayRefreshRateCountOutput, displayRefreshRates);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetDisplayRefreshRateFB(XrSession session, float * displayRefreshRate){
+	if(!runtime.displayRefreshRate)
+		return XR_ERROR_FUNCTION_UNSUPPORTED;
+	if(session != runtime.session)
+		return XR_ERROR_HANDLE_INVALID;
+	*displayRefreshRate = runtime.displayRate;
+	return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrRequestDisplayRefreshRateFB(XrSession session, float displayRefreshRate){
+	if(!runtime.displayRefreshRate)
+		return XR_ERROR_FUNCTION_UNSUPPORTED;
+	if(session != runtime.session)
+		return XR_ERROR_HANDLE_INVALID;
+	// 0: no preference (the default rate)
+	float rate = displayRefreshRate ? displayRefreshRate : runtime.defaultDisplayRate;
+	std::vector<float> rates = stubDisplayRefreshRates();
+	if(std::find(rates.begin(), rates.end(), rate) == rates.end())
+		return XR_ERROR_DISPLAY_REFRESH_RATE_UNSUPPORTED_FB;
+	std::lock_guard<std::mutex> lock(runtime.mutex);
+	if(rate == (float)runtime.displayRate)
+		return XR_SUCCESS;
+	XrEventDataBuffer buffer = {XR_TYPE_EVENT_DATA_BUFFER};
+	XrEventDataDisplayRefreshRateChangedFB * event = reinterpret_cast<XrEventDataDisplayRefreshRateChangedFB*>(&buffer);
+	event->type = XR_TYPE_EVENT_DATA_DISPLAY_REFRESH_RATE_CHANGED_FB;
+	event->next = nullptr;
+	event->fromDisplayRefreshRate = runtime.displayRate;
+	event->toDisplayRefreshRate = rate;
+	runtime.events.push_back(buffer);
+	runtime.displayRate = rate;
+	return XR_SUCCESS;
+}
+
+
+// runtime entry points
+
+#define STUB_FUNCTION(name) {#name, reinterpret_cast<PFN_xrVoidFunction>(stub_##name)}
+
+static XRAPI_ATTR XrResult XRAPI_CALL stub_xrGetInstanceProcAddr(XrInstance instance, const char * name, PFN_xrVoidFunction * function){
+	static const std::map<std::string, PFN_xrVoidFunction> functions = {
+		{"xrGetInstanceProcAddr", reinterpret_cast<PFN_xrVoidFunction>(stub_xrGetInstanceProcAddr)},
+		STUB_FUNCTION(xrEnumerateInstanceExtensionProperties),
+		STUB_FUNCTION(xrCreateInstance),
+		STUB_FUNCTION(xrDestroyInstance),
+		STUB_FUNCTION(xrGetInstanceProperties),
+		STUB_FUNCTION(xrResultToString),
+		STUB_FUNCTION(xrStructureTypeToString),
+		STUB_FUNCTION(xrPollEvent),
+		STUB_FUNCTION(xrStringToPath),
+		STUB_FUNCTION(xrPathToString),
+		STUB_FUNCTION(xrGetSystem),
+		STUB_FUNCTION(xrGetSystemProperties),
+		STUB_FUNCTION(xrEnumerateViewConfigurations),
+		STUB_FUNCTION(xrGetViewConfigurationProperties),
+		STUB_FUNCTION(xrEnumerateViewConfigurationViews),
+		STUB_FUNCTION(xrEnumerateEnvironmentBlendModes),
+		STUB_FUNCTION(xrEnumerateReprojectionModesMSFT),
+		STUB_FUNCTION(xrGetOpenGLGraphicsRequirementsKHR),
+		STUB_FUNCTION(xrCreateSession),
+		STUB_FUNCTION(xrDestroySession),
+		STUB_FUNCTION(xrBeginSession),
+		STUB_FUNCTION(xrEndSession),
+		STUB_FUNCTION(xrRequestExitSession),
+		STUB_FUNCTION(xrEnumerateReferenceSpaces),
+		STUB_FUNCTION(xrCreateReferenceSpace),
+		STUB_FUNCTION(xrGetReferenceSpaceBoundsRect),
+		STUB_FUNCTION(xrCreateActionSpace),
+		STUB_FUNCTION(xrLocateSpace),
+		STUB_FUNCTION(xrDestroySpace),
+		STUB_FUNCTION(xrLocateViews),
+		STUB_FUNCTION(xrGetVisibilityMaskKHR),
+		STUB_FUNCTION(xrEnumerateDisplayRefreshRatesFB),
+		STUB_FUNCTION(xrGetDisplayRefreshRateFB),
+		STUB_FUNCTION(xrRequestDisplayRefreshRateFB),
+		STUB_FUNCTION(xrWaitFrame),
+		STUB_FUNCTION(xrBeginFrame),
+		STUB_FUNCTION(xrEndFrame),
+		STUB_FUNCTION(xrEnumerateSwapchainFormats),
+		STUB_FUNCTION(xrCreateSwapchain),
+		STUB_FUNCTION(xrDestroySwapchain),
+		STUB_FUNCTION(xrEnumerateSwapchainImages),
+		STUB_FUNCTION(xrAcquireSwapchainImage),
+		STUB_FUNCTION(xrWaitSwapchainImage),
+		STUB_FUNCTION(xrReleaseSwapchainImage),
+		STUB_FUNCTION(xrCreateActionSet),
+		STUB_FUNCTION(xrDestroyActionSet),
+		STUB_FUNCTION(xrCreateAction),
+		STUB_FUNCTION(xrDestroyAction),
+		STUB_FUNCTION(xrSuggestInteractionProfileBindings),
+		STUB_FUNCTION(xrAttachSessionActionSets),
+		STUB_FUNCTION(xrSyncActions),
+		STUB_FUNCTION(xrGetActionStateBoolean),
+		STUB_FUNCTION(xrGetActionStateFloat),
+		STUB_FUNCTION(xrGetActionStateVector2f),
+		STUB_FUNCTION(xrGetActionStatePose),
+		STUB_FUNCTION(xrApplyHapticFeedback),
+		STUB_FUNCTION(xrStopHapticFeedback),
+	};
+	if(!name || !function)
+		return XR_ERROR_VALIDATION_FAILURE;
+	auto it = functions.find(name);
+	if(it == functions.end()){
+		*function = nullptr;
+		return XR_ERROR_FUNCTION_UNSUPPORTED;
+	}
+	*function = it->second;
+	return XR_SUCCESS;
+}
+
+RUNTIME_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderRuntimeInterface(const XrNegotiateLoaderInfo * loaderInfo, XrNegotiateRuntimeRequest * runtimeRequest){
+	if(!loaderInfo || !runtimeRequest)
+		return XR_ERROR_INITIALIZATION_FAILED;
+	if(loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+	   loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION ||
+	   loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo))
+		return XR_ERROR_INITIALIZATION_FAILED;
+	if(runtimeRequest->structType != XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST ||
+	   runtimeRequest->structVersion != XR_RUNTIME_INFO_STRUCT_VERSION ||
+	   runtimeRequest->structSize != sizeof(XrNegotiateRuntimeRequest))
+		return XR_ERROR_INITIALIZATION_FAILED;
+	if(loaderInfo->minInterfaceVersion > CURRENT_LOADER_RUNTIME_VERSION || loaderInfo->maxInterfaceVersion < CURRENT_LOADER_RUNTIME_VERSION)
+		return XR_ERROR_INITIALIZATION_FAILED;
+
+	runtimeRequest->runtimeInterfaceVersion = CURRENT_LOADER_RUNTIME_VERSION;
+	runtimeRequest->runtimeApiVersion = XR_CURRENT_API_VERSION;
+	runtimeRequest->getInstanceProcAddr = stub_xrGetInstanceProcAddr;
+	return XR_SUCCESS;
+}
@@ -1,47 +1,23 @@
-#define XR_USE_PLATFORM_XLIB
+#include "xr_graphics.h"
 
-// #define XR_USE_GRAPHICS_API_VULKAN
-#define XR_USE_GRAPHICS_API_OPENGL
-
-// Vulkan libraries
-#ifdef XR_USE_GRAPHICS_API_VULKAN
-#define APP_USE_VULKAN2
-#define STB_IMAGE_IMPLEMENTATION
-#include <vulkan/vulkan.h>
-#include "stb_image.h"
-#endif
-
-// OpenGL libraries
-#ifdef XR_USE_GRAPHICS_API_OPENGL
-#define GL_GLEXT_PROTOTYPES
-#define GL3_PROTOTYPES
-#include <GL/gl.h>
-#include <GL/glext.h>
-#include <GL/glx.h>
-#include <X11/Xlib.h>
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_opengl.h>
 #ifdef APPLICATION_IMAGE
 #include <SDL2/SDL_image.h>
 #endif
-#endif
 
-#include <vector>
+#include <atomic>
+#include <sstream>
+#include <math.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
 #include <string.h>
-#include <iostream>
+#include <unistd.h>
 #include <algorithm>
-#include <functional> 
+#include <sys/mman.h>
+#include <sys/stat.h>
 using namespace std;
 
-#include <openxr/openxr.h>
-#include <openxr/openxr_platform.h>
-#include <openxr/openxr_reflection.h>
-	
-#ifndef _countof
-#define _countof(x) (sizeof(x)/sizeof((x)[0]))
-#endif
-
 // generate stringify functions for OpenXR enumerations
 #define ENUM_CASE_STR(name, val) case name: return #name;
 #define MAKE_TO_STRING_FUNC(enumType)                  \
@@ -58,149 +34,419 @@ MAKE_TO_STRING_FUNC(XrEnvironmentBlendMode);
 MAKE_TO_STRING_FUNC(XrSessionState);
 MAKE_TO_STRING_FUNC(XrResult);
 MAKE_TO_STRING_FUNC(XrFormFactor);
+MAKE_TO_STRING_FUNC(XrPerfSettingsDomainEXT);
+MAKE_TO_STRING_FUNC(XrPerfSettingsSubDomainEXT);
+MAKE_TO_STRING_FUNC(XrPerfSettingsNotificationLevelEXT);
+MAKE_TO_STRING_FUNC(XrReprojectionModeMSFT);
 
 
-struct ActionState{
-  	XrActionType type;
-	const char * path;
-	bool isActive;
-    bool stateBool;			// XR_TYPE_ACTION_STATE_BOOLEAN
-    float stateFloat;		// XR_TYPE_ACTION_STATE_FLOAT
-    float stateVectorX;		// XR_TYPE_ACTION_STATE_VECTOR2F
-    float stateVectorY;		// XR_TYPE_ACTION_STATE_VECTOR2F
-};
+vector<const char*> cast_to_vector_char_p(const vector<string> & input_list){
+	vector<const char*> output_list;
+	for (size_t i = 0; i < input_list.size(); i++)
+		output_list.push_back(input_list[i].data());
+	return output_list;
+}
 
-struct ActionPoseState{
-  	XrActionType type;
-	const char * path;
-	bool isActive;
-	XrPosef pose;			// XR_TYPE_ACTION_STATE_POSE
+// logging
+// producers format the message and push it into a bounded lock-free ring (multiple producers, single consumer).
+// A background thread drains the ring to stdout or to the log callback (e.g. Python/Kit logger), 
+// so hot paths never block on I/O. Each message site is rate limited (the suppressed messages are counted)
+
+#define LOG_RING_SIZE 1024				// must be a power of two
+#define LOG_MESSAGE_SIZE 512
+#define LOG_RATE_LIMIT_INTERVAL 1000	// rate limit window (ms) of each message site (default)
+#define LOG_RATE_LIMIT_BURST 8			// messages per window accepted from the same site
+#define LOG_SITE_TABLE_SIZE 256			// sites identified at runtime (e.g. xrCheckResult messages) share this hashed table
+
+struct LogSite{
+	std::atomic<int64_t> windowStart{INT64_MIN};
+	std::atomic<uint32_t> count{0};
+	std::atomic<uint32_t> suppressed{0};
 };
 
-struct Action{
-	XrAction action;
-	XrPath path;
- 	string stringPath;
+struct LogRecord{
+	int level;
+	uint32_t suppressed;
+	char message[LOG_MESSAGE_SIZE];
 };
 
-struct ActionPose{
-	XrReferenceSpaceType referenceSpaceType;
-	XrSpace space;
-	XrAction action;
-	XrPath path;
- 	string stringPath;
-};
+class Logger{
+private:
+	struct Slot{
+		std::atomic<uint64_t> sequence;
+		LogRecord record;
+	};
+	Slot slots[LOG_RING_SIZE];
+	std::atomic<uint64_t> enqueuePosition{0};
+	uint64_t dequeuePosition = 0;
+
+	std::atomic<int> minimumLevel{LOG_LEVEL_INFO};
+	std::atomic<int64_t> rateLimitInterval{LOG_RATE_LIMIT_INTERVAL * 1000000LL};
+	std::atomic<uint64_t> dropped{0};
+	LogSite sites[LOG_SITE_TABLE_SIZE];
+
+	std::shared_ptr<function<void(int, const char *)>> callback;
+	std::mutex consumerMutex;
+	std::mutex wakeMutex;
+	std::condition_variable wake;
+	std::thread worker;
+	std::once_flag workerStarted;
+	std::atomic<bool> running{false};
+
+	static int64_t now(){
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
 
-struct Actions{
-	vector<Action> aBoolean;
-	vector<Action> aFloat;
-	vector<Action> aVector2f;
-	vector<ActionPose> aPose;
-	vector<Action> aVibration;
-};
+	void write(const LogRecord & record, bool useCallback){
+		char message[LOG_MESSAGE_SIZE + 64];
+		if(record.suppressed)
+			snprintf(message, sizeof(message), "%s (%u similar messages suppressed)", record.message, record.suppressed);
+		else
+			snprintf(message, sizeof(message), "%s", record.message);
 
-struct SwapchainHandler{
-  	XrSwapchain handle;
-    int32_t width;
-    int32_t height;
-	uint32_t length;
-#ifdef XR_USE_GRAPHICS_API_VULKAN
-	vector<XrSwapchainImageVulkan2KHR> images;
-#endif
-#ifdef XR_USE_GRAPHICS_API_OPENGL
-	vector<XrSwapchainImageOpenGLKHR> images;
-#endif
-};
+		std::shared_ptr<function<void(int, const char *)>> currentCallback = useCallback ? std::atomic_load(&callback) : nullptr;
+		if(currentCallback && *currentCallback){
+			(*currentCallback)(record.level, message);
+			return;
+		}
+		const char * prefix = record.level == LOG_LEVEL_ERROR ? "[ERROR] " : record.level == LOG_LEVEL_WARNING ? "[WARNING] " : record.level == LOG_LEVEL_DEBUG ? "[DEBUG] " : "";
+		fprintf(stdout, "%s%s\n", prefix, message);
+	}
 
+	// drain the ring (single consumer: the worker thread or the shutdown path)
+	size_t drain(bool useCallback){
+		size_t count = 0;
+		LogRecord record;
+		while(true){
+			Slot & slot = slots[dequeuePosition & (LOG_RING_SIZE - 1)];
+			if(slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+				break;
+			record.level = slot.record.level;
+			record.suppressed = slot.record.suppressed;
+			memcpy(record.message, slot.record.message, LOG_MESSAGE_SIZE);
+			slot.sequence.store(dequeuePosition + LOG_RING_SIZE, std::memory_order_release);
+			dequeuePosition++;
+			write(record, useCallback);
+			count++;
+		}
+		uint64_t droppedRecords = dropped.exchange(0, std::memory_order_relaxed);
+		if(droppedRecords){
+			record.level = LOG_LEVEL_WARNING;
+			record.suppressed = 0;
+			snprintf(record.message, LOG_MESSAGE_SIZE, "Log ring overflowed (%lu message(s) dropped)", (unsigned long)droppedRecords);
+			write(record, useCallback);
+		}
+		if(count)
+			fflush(stdout);
+		return count;
+	}
 
-vector<const char*> cast_to_vector_char_p(const vector<string> & input_list){
-	vector<const char*> output_list;
-	for (size_t i = 0; i < input_list.size(); i++)
-		output_list.push_back(input_list[i].data());
-	return output_list;
-}
+	void run(){
+		while(running.load(std::memory_order_relaxed)){
+			{
+				std::lock_guard<std::mutex> lock(consumerMutex);
+				drain(true);
+			}
+			// producers notify without locking: a lost wake-up is bounded by the timeout
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			wake.wait_for(lock, std::chrono::milliseconds(10));
+		}
+	}
+
+	void start(){
+		std::call_once(workerStarted, [this](){
+			running = true;
+			worker = std::thread(&Logger::run, this);
+			std::atexit([](){ Logger::instance().shutdown(); });
+		});
+	}
+
+public:
+	Logger(){
+		for(size_t i = 0; i < LOG_RING_SIZE; i++)
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	// never destroyed: the worker may still be running during static destruction
+	static Logger & instance(){
+		static Logger * logger = new Logger();
+		return *logger;
+	}
+
+	void setLevel(int level){ minimumLevel = level; }
+	void setRateLimit(int milliseconds){ rateLimitInterval = milliseconds * 1000000LL; }
+	void setCallback(function<void(int, const char *)> callbackFunction){
+		std::shared_ptr<function<void(int, const char *)>> newCallback = callbackFunction ? std::make_shared<function<void(int, const char *)>>(callbackFunction) : nullptr;
+		std::atomic_store(&callback, newCallback);
+	}
+
+	LogSite & site(const string & key){
+		return sites[std::hash<string>()(key) & (LOG_SITE_TABLE_SIZE - 1)];
+	}
+
+	// level filtering and per-site rate limiting (cheap: called before formatting the message)
+	bool accept(int level, LogSite & site){
+		if(level < minimumLevel.load(std::memory_order_relaxed))
+			return false;
+		int64_t interval = rateLimitInterval.load(std::memory_order_relaxed);
+		if(interval <= 0)
+			return true;
+		// approximate under contention, which is enough for logging
+		int64_t timestamp = now();
+		int64_t windowStart = site.windowStart.load(std::memory_order_relaxed);
+		if(timestamp - windowStart >= interval && site.windowStart.compare_exchange_strong(windowStart, timestamp, std::memory_order_relaxed))
+			site.count.store(0, std::memory_order_relaxed);
+		if(site.count.fetch_add(1, std::memory_order_relaxed) >= LOG_RATE_LIMIT_BURST){
+			site.suppressed.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		return true;
+	}
+
+	void push(int level, LogSite & site, const string & message){
+		start();
+		uint64_t position = enqueuePosition.load(std::memory_order_relaxed);
+		Slot * slot;
+		while(true){
+			slot = &slots[position & (LOG_RING_SIZE - 1)];
+			int64_t difference = (int64_t)slot->sequence.load(std::memory_order_acquire) - (int64_t)position;
+			if(difference == 0){
+				if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if(difference < 0){
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else
+				position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+		slot->record.level = level;
+		slot->record.suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+		strncpy(slot->record.message, message.c_str(), LOG_MESSAGE_SIZE - 1);
+		slot->record.message[LOG_MESSAGE_SIZE - 1] = '\0';
+		slot->sequence.store(position + 1, std::memory_order_release);
+		if(level >= LOG_LEVEL_WARNING)
+			wake.notify_one();
+	}
+
+	// stop the worker and write the pending records to stdout (the callback may not be usable at process exit)
+	void shutdown(){
+		if(!running.exchange(false))
+			return;
+		wake.notify_one();
+		if(worker.joinable())
+			worker.join();
+		drain(false);
+	}
+};
+
+// log a message (stream expression) from a rate limited site identified by the macro call location
+#define XR_LOG(level, stream) do{ \
+	static LogSite _xr_log_site; \
+	if(Logger::instance().accept(level, _xr_log_site)){ \
+		std::ostringstream _xr_log_stream; \
+		_xr_log_stream << stream; \
+		Logger::instance().push(level, _xr_log_site, _xr_log_stream.str()); \
+	} \
+}while(0)
+
+#define XR_LOG_DEBUG(stream) XR_LOG(LOG_LEVEL_DEBUG, stream)
+#define XR_LOG_INFO(stream) XR_LOG(LOG_LEVEL_INFO, stream)
+#define XR_LOG_WARNING(stream) XR_LOG(LOG_LEVEL_WARNING, stream)
+#define XR_LOG_ERROR(stream) XR_LOG(LOG_LEVEL_ERROR, stream)
 
 bool xrCheckResult(const XrInstance & xr_instance, const XrResult & xr_result, const string & message = ""){
 	if(XR_SUCCEEDED(xr_result))
 		return true;
 
+	// rate limited per call site (identified by the message)
+	LogSite & site = Logger::instance().site(message);
+	if(!Logger::instance().accept(LOG_LEVEL_ERROR, site))
+		return false;
+
+	std::ostringstream stream;
 	if(xr_instance != NULL){
 		char xr_result_as_string[XR_MAX_RESULT_STRING_SIZE];
 		xrResultToString(xr_instance, xr_result, xr_result_as_string);
 		if(!message.empty())
-			std::cout << "[ERROR] " << message << " failed with code: " << xr_result << " (" << xr_result_as_string << "). " << message << std::endl;
+			stream << message << " failed with code: " << xr_result << " (" << xr_result_as_string << "). " << message;
 		else
-			std::cout << "[ERROR] code: " << xr_result << " (" << xr_result_as_string << ")" << std::endl;
+			stream << "code: " << xr_result << " (" << xr_result_as_string << ")";
 	}
 	else{
 		if(!message.empty())
-			std::cout << "[ERROR] " << message << " failed with code: " << xr_result << " (" << _enum_to_string(xr_result) << ")" << std::endl;
+			stream << message << " failed with code: " << xr_result << " (" << _enum_to_string(xr_result) << ")";
 		else
-			std::cout << "[ERROR] code: " << xr_result << " (" << _enum_to_string(xr_result) << ")" << std::endl;
+			stream << "code: " << xr_result << " (" << _enum_to_string(xr_result) << ")";
 	}
+	Logger::instance().push(LOG_LEVEL_ERROR, site, stream.str());
 	return false;
 }
 
+// setup information (enumerations, properties, bindings) is only printed on request (setVerbose)
+static bool flagVerboseOutput = false;
+static std::ostream nullOutputStream(nullptr);
 
+std::ostream & verboseOutput(){
+	return flagVerboseOutput ? std::cout : nullOutputStream;
+}
 
+// enumeration results cached per runtime (process-wide: restarting XR from the UI skips the enumeration calls)
+struct SystemEnumeration{
+	vector<XrViewConfigurationType> viewConfigurationTypes;
+	XrViewConfigurationProperties viewConfigurationProperties = {XR_TYPE_VIEW_CONFIGURATION_PROPERTIES};
+	vector<XrEnvironmentBlendMode> environmentBlendModes;
+};
 
-// Vulkan graphics API
-#ifdef XR_USE_GRAPHICS_API_VULKAN
-class VulkanHandler{
+struct RuntimeEnumerationCache{
+	// API layers and instance extensions (key: active runtime manifest and API layer environment)
+	string apiLayersKey;
+	string extensionsKey;
+	vector<string> apiLayers;
+	vector<string> extensions;
+	// view configurations, their properties and blend modes (key: runtime name and version, system name, form factor and view configuration type)
+	map<string, SystemEnumeration> systems;
+	// swapchain formats (key: system key and graphics binding)
+	map<string, vector<int64_t>> swapchainFormats;
+};
 
-private:
-	XrResult xr_result;
-	VkResult vk_result;
-	
-	VkInstance vk_instance;
-	VkPhysicalDevice vk_physicalDevice = VK_NULL_HANDLE;
-	VkDevice vk_logicalDevice;
-	uint32_t vk_queueFamilyIndex;
-	VkQueue vk_graphicsQueue;
-	VkCommandPool vk_cmdPool;
-	VkPipelineCache vk_pipelineCache;
+static RuntimeEnumerationCache runtimeEnumerationCache;
+
+// identify the runtime selected by the loader (XR_RUNTIME_JSON or active_runtime.json) by its manifest path and modification time.
+// Return an empty key (no caching) if the manifest cannot be found
+static string runtimeManifestKey(){
+	vector<string> candidates;
+	const char * value = getenv("XR_RUNTIME_JSON");
+	if(value && *value)
+		candidates.push_back(value);
+	else{
+		value = getenv("XDG_CONFIG_HOME");
+		if(value && *value)
+			candidates.push_back(string(value) + "/openxr/1/active_runtime.json");
+		value = getenv("HOME");
+		if(value && *value)
+			candidates.push_back(string(value) + "/.config/openxr/1/active_runtime.json");
+		value = getenv("XDG_CONFIG_DIRS");
+		std::istringstream directories(value && *value ? value : "/etc/xdg");
+		for(string directory; std::getline(directories, directory, ':');)
+			if(!directory.empty())
+				candidates.push_back(directory + "/openxr/1/active_runtime.json");
+		candidates.push_back("/etc/openxr/1/active_runtime.json");
+	}
+
+	for(size_t i = 0; i < candidates.size(); i++){
+		char path[PATH_MAX];
+		struct stat status;
+		if(!realpath(candidates[i].c_str(), path) || stat(path, &status))
+			continue;
+		std::ostringstream key;
+		key << path << ":" << status.st_mtime << ":" << status.st_size;
+		// API layers are also selected through the environment
+		const char * names[] = {"XR_ENABLE_API_LAYERS", "XR_API_LAYER_PATH"};
+		for(size_t j = 0; j < _countof(names); j++){
+			value = getenv(names[j]);
+			key << ":" << (value ? value : "");
+		}
+		return key.str();
+	}
+	return "";
+}
 
-	bool getRequirements(XrInstance xr_instance, XrSystemId xr_system_id);
-	bool defineLayers(vector<const char*> requestedLayers, vector<const char*> & enabledLayers);
-	bool defineExtensions(vector<const char*> requestedExtensions, vector<const char*> & enabledExtensions);
+// route runtime and API layer messages (XR_EXT_debug_utils) through the logger
+XrBool32 XRAPI_CALL xrDebugUtilsMessengerCallback(XrDebugUtilsMessageSeverityFlagsEXT messageSeverity, XrDebugUtilsMessageTypeFlagsEXT messageTypes, 
+												  const XrDebugUtilsMessengerCallbackDataEXT * callbackData, void * userData){
+	int level = LOG_LEVEL_DEBUG;
+	if(messageSeverity & XR_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT)
+		level = LOG_LEVEL_ERROR;
+	else if(messageSeverity & XR_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
+		level = LOG_LEVEL_WARNING;
+	else if(messageSeverity & XR_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT)
+		level = LOG_LEVEL_INFO;
+
+	LogSite & site = Logger::instance().site(callbackData->messageId ? callbackData->messageId : "");
+	if(Logger::instance().accept(level, site)){
+		std::ostringstream stream;
+		stream << "XR_EXT_debug_utils: " << (callbackData->functionName ? callbackData->functionName : "") << ": " << (callbackData->message ? callbackData->message : "");
+		Logger::instance().push(level, site, stream.str());
+	}
+	return XR_FALSE;
+}
 
+// visible area (XR_KHR_visibility_mask): the frame rows are grouped in bands of VISIBLE_AREA_TILE_SIZE rows, 
+// split in tiles of VISIBLE_AREA_TILE_SIZE columns. A tile is visible if it overlaps a visible triangle
+#define VISIBLE_AREA_TILE_SIZE 32
 
-public:
-	VulkanHandler();
-	~VulkanHandler();
+// triangle and axis-aligned rectangle overlap (separating axis test). Degenerate triangles are not separated (conservative)
+static bool triangleOverlapsRect(const XrVector2f & a, const XrVector2f & b, const XrVector2f & c, float x0, float y0, float x1, float y1){
+	if(std::max({a.x, b.x, c.x}) < x0 || std::min({a.x, b.x, c.x}) > x1 || std::max({a.y, b.y, c.y}) < y0 || std::min({a.y, b.y, c.y}) > y1)
+		return false;
+	const XrVector2f * vertices[3] = {&a, &b, &c};
+	for(int i = 0; i < 3; i++){
+		const XrVector2f & p = *vertices[i], & q = *vertices[(i + 1) % 3], & r = *vertices[(i + 2) % 3];
+		// the rectangle is separated if its corners are all on the other side of the edge than the third vertex
+		float nx = q.y - p.y, ny = p.x - q.x;
+		float side = nx * (r.x - p.x) + ny * (r.y - p.y);
+		float d[4] = {nx * (x0 - p.x) + ny * (y0 - p.y), nx * (x1 - p.x) + ny * (y0 - p.y), nx * (x0 - p.x) + ny * (y1 - p.y), nx * (x1 - p.x) + ny * (y1 - p.y)};
+		if((side > 0 && std::max({d[0], d[1], d[2], d[3]}) < 0) || (side < 0 && std::min({d[0], d[1], d[2], d[3]}) > 0))
+			return false;
+	}
+	return true;
+}
 
-	void createInstance(XrInstance xr_instance, XrSystemId xr_system_id);
-	void getPhysicalDevice(XrInstance xr_instance, XrSystemId xr_system_id);
-	void createLogicalDevice(XrInstance xr_instance, XrSystemId xr_system_id);
+// visible rectangles of the bands for the frame size (computed again only when the mask or the frame size changes).
+// It returns false if the view has no mask (the whole frame is visible)
+static bool updateVisibleRects(VisibleArea & area, int width, int height){
+	if(area.indices.empty())
+		return false;
+	if(area.width == width && area.height == height)
+		return true;
+	area.width = width;
+	area.height = height;
+	area.rects.clear();
+	auto tileVisible = [&area, width, height](int tile, int y, int h){
+		float x0 = tile * VISIBLE_AREA_TILE_SIZE / (float)width, x1 = std::min((tile + 1) * VISIBLE_AREA_TILE_SIZE, width) / (float)width;
+		float y0 = y / (float)height, y1 = (y + h) / (float)height;
+		for(size_t i = 0; i + 2 < area.indices.size(); i += 3)
+			if(triangleOverlapsRect(area.vertices[area.indices[i]], area.vertices[area.indices[i + 1]], area.vertices[area.indices[i + 2]], x0, y0, x1, y1))
+				return true;
+		return false;
+	};
+	int tiles = (width + VISIBLE_AREA_TILE_SIZE - 1) / VISIBLE_AREA_TILE_SIZE;
+	for(int y = 0; y < height; y += VISIBLE_AREA_TILE_SIZE){
+		int h = std::min(VISIBLE_AREA_TILE_SIZE, height - y);
+		int first = 0, last = tiles - 1;
+		while(first < tiles && !tileVisible(first, y, h))
+			first++;
+		if(first == tiles)
+			continue;
+		while(last > first && !tileVisible(last, y, h))
+			last--;
+		int x = first * VISIBLE_AREA_TILE_SIZE;
+		area.rects.push_back({{x, y}, {std::min((last + 1) * VISIBLE_AREA_TILE_SIZE, width) - x, h}});
+	}
+	return true;
+}
 
-	VkInstance getInstance(){ return vk_instance; }
-	VkPhysicalDevice getPhysicalDevice(){ return vk_physicalDevice; }
-	VkDevice getLogicalDevice(){ return vk_logicalDevice; }
-	uint32_t getQueueFamilyIndex(){ return vk_queueFamilyIndex; }
-	void renderView(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *, int64_t);
 
-	uint32_t getSupportedSwapchainSampleCount(XrViewConfigurationView){ return VK_SAMPLE_COUNT_1_BIT; }
 
-	void loadImageFromFile();
-};
+// Vulkan graphics API
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+#define VK_UPLOAD_RING_SIZE 4		// upload slots (two stereo frames in flight)
 
-VulkanHandler::VulkanHandler(){
-	loadImageFromFile();
-}
 
-VulkanHandler::~VulkanHandler(){
-	// vkDestroyInstance(vk_instance, nullptr);
-	// vkDestroyDevice(vk_logicalDevice, nullptr);
+bool vkCheckResult(const VkResult & vk_result, const string & message = ""){
+	if(vk_result == VK_SUCCESS)
+		return true;
+	XR_LOG_ERROR(message << " failed with code: " << vk_result);
+	return false;
 }
 
-void VulkanHandler::loadImageFromFile(){
-    int texWidth, texHeight, texChannels;
-    stbi_uc* pixels = stbi_load("texture.jpg", &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-    VkDeviceSize imageSize = texWidth * texHeight * 4;
+VulkanHandler::VulkanHandler(){
+}
 
-    if (!pixels) {
-        throw std::runtime_error("failed to load texture image!");
-    }
+VulkanHandler::~VulkanHandler(){
+	releaseResources();
 }
 
 bool VulkanHandler::getRequirements(XrInstance xr_instance, XrSystemId xr_system_id){
@@ -211,7 +457,7 @@ bool VulkanHandler::getRequirements(XrInstance xr_instance, XrSystemId xr_system
 	xr_result = pfn_xrGetVulkanGraphicsRequirements2KHR(xr_instance, xr_system_id, &graphicsRequirement);
 	if(!xrCheckResult(NULL, xr_result, "PFN_xrGetVulkanGraphicsRequirementsKHR"))
 		return false;
-	std::cout << "Vulkan (Vulkan2) requirements" << std::endl;
+	verboseOutput() << "Vulkan (Vulkan2) requirements" << std::endl;
 #else
 	PFN_xrGetVulkanGraphicsRequirementsKHR pfn_xrGetVulkanGraphicsRequirementsKHR = nullptr;
 	xrGetInstanceProcAddr(xr_instance, "xrGetVulkanGraphicsRequirementsKHR", reinterpret_cast<PFN_xrVoidFunction*>(&pfn_xrGetVulkanGraphicsRequirementsKHR));
@@ -219,11 +465,11 @@ bool VulkanHandler::getRequirements(XrInstance xr_instance, XrSystemId xr_system
 	xr_result = pfn_xrGetVulkanGraphicsRequirementsKHR(xr_instance, xr_system_id, &graphicsRequirement);
 	if(!xrCheckResult(NULL, xr_result, "PFN_xrGetVulkanGraphicsRequirementsKHR"))
 		return false;
-	std::cout << "Vulkan (Vulkan) requirements" << std::endl;
+	verboseOutput() << "Vulkan (Vulkan) requirements" << std::endl;
 #endif
 
-	std::cout << "  |-- min API version: " << XR_VERSION_MAJOR(graphicsRequirement.minApiVersionSupported) << "." << XR_VERSION_MINOR(graphicsRequirement.minApiVersionSupported) << "." << XR_VERSION_PATCH(graphicsRequirement.minApiVersionSupported) << std::endl;
-	std::cout << "  |-- max API version: " << XR_VERSION_MAJOR(graphicsRequirement.maxApiVersionSupported) << "." << XR_VERSION_MINOR(graphicsRequirement.maxApiVersionSupported) << "." << XR_VERSION_PATCH(graphicsRequirement.maxApiVersionSupported) << std::endl;
+	verboseOutput() << "  |-- min API version: " << XR_VERSION_MAJOR(graphicsRequirement.minApiVersionSupported) << "." << XR_VERSION_MINOR(graphicsRequirement.minApiVersionSupported) << "." << XR_VERSION_PATCH(graphicsRequirement.minApiVersionSupported) << std::endl;
+	verboseOutput() << "  |-- max API version: " << XR_VERSION_MAJOR(graphicsRequirement.maxApiVersionSupported) << "." << XR_VERSION_MINOR(graphicsRequirement.maxApiVersionSupported) << "." << XR_VERSION_PATCH(graphicsRequirement.maxApiVersionSupported) << std::endl;
 	return true;
 }
 
@@ -234,13 +480,13 @@ bool VulkanHandler::defineLayers(vector<const char*> requestedLayers, vector<con
 	std::vector<VkLayerProperties> layerProperties(propertyCount);
 	vkEnumerateInstanceLayerProperties(&propertyCount, layerProperties.data());
 
-	std::cout << "Vulkan layers available (" << layerProperties.size() << ")" << std::endl;
+	verboseOutput() << "Vulkan layers available (" << layerProperties.size() << ")" << std::endl;
 	for (size_t i = 0; i < layerProperties.size(); i++){
-		std::cout << "  |-- " << layerProperties[i].layerName << std::endl;
+		verboseOutput() << "  |-- " << layerProperties[i].layerName << std::endl;
 		for (size_t j = 0; j < requestedLayers.size(); j++)
 			if (strcmp(layerProperties[i].layerName, requestedLayers[j]) == 0){
 				enabledLayers.push_back(requestedLayers[j]);
-				std::cout << "  |   (requested)" << std::endl;
+				verboseOutput() << "  |   (requested)" << std::endl;
 				break;
 			}
 	}
@@ -254,22 +500,23 @@ bool VulkanHandler::defineExtensions(vector<const char*> requestedExtensions, ve
 	vector<VkExtensionProperties> extensionsProperties(propertyCount);
 	vkEnumerateInstanceExtensionProperties(nullptr, &propertyCount, extensionsProperties.data());
 
-	std::cout << "Vulkan extension properties (" << extensionsProperties.size() << ")" << std::endl;
+	verboseOutput() << "Vulkan extension properties (" << extensionsProperties.size() << ")" << std::endl;
 	for (size_t i = 0; i < extensionsProperties.size(); i++){
-		std::cout << "  |-- " << extensionsProperties[i].extensionName << std::endl;
+		verboseOutput() << "  |-- " << extensionsProperties[i].extensionName << std::endl;
 		for (size_t j = 0; j < requestedExtensions.size(); j++)
 			if (strcmp(extensionsProperties[i].extensionName, requestedExtensions[j]) == 0){
 				enabledExtensions.push_back(requestedExtensions[j]);
-				std::cout << "  |   (requested)" << std::endl;
+				verboseOutput() << "  |   (requested)" << std::endl;
 				break;
 			}
 	}
 	return true;
 }
 
-void VulkanHandler::createInstance(XrInstance xr_instance, XrSystemId xr_system_id){
+bool VulkanHandler::createInstance(XrInstance xr_instance, XrSystemId xr_system_id){
 	// requirements
-	getRequirements(xr_instance, xr_system_id);
+	if(!getRequirements(xr_instance, xr_system_id))
+		return false;
 
 	// layers
 	vector<const char*> enabledLayers;
@@ -304,15 +551,22 @@ void VulkanHandler::createInstance(XrInstance xr_instance, XrSystemId xr_system_
 
 	PFN_xrCreateVulkanInstanceKHR pfn_xrCreateVulkanInstanceKHR = nullptr;
 	xr_result = xrGetInstanceProcAddr(xr_instance, "xrCreateVulkanInstanceKHR", reinterpret_cast<PFN_xrVoidFunction*>(&pfn_xrCreateVulkanInstanceKHR));
+	if(!xrCheckResult(xr_instance, xr_result, "xrCreateVulkanInstanceKHR (xrGetInstanceProcAddr)"))
+		return false;
 	xr_result = pfn_xrCreateVulkanInstanceKHR(xr_instance, &createInfo, &vk_instance, &vk_result);
+	if(!xrCheckResult(xr_instance, xr_result, "xrCreateVulkanInstanceKHR"))
+		return false;
+	return vkCheckResult(vk_result, "vkCreateInstance");
 }
 
-void VulkanHandler::getPhysicalDevice(XrInstance xr_instance, XrSystemId xr_system_id){
+bool VulkanHandler::getPhysicalDevice(XrInstance xr_instance, XrSystemId xr_system_id){
 	// enumerate device
 	uint32_t propertyCount = 0;
 	vkEnumeratePhysicalDevices(vk_instance, &propertyCount, nullptr);
-	if(!propertyCount)
-		throw std::runtime_error("Failed to find GPUs with Vulkan support");
+	if(!propertyCount){
+		XR_LOG_ERROR("Failed to find GPUs with Vulkan support");
+		return false;
+	}
 
 	vector<VkPhysicalDevice> devices(propertyCount);
 	vkEnumeratePhysicalDevices(vk_instance, &propertyCount, devices.data());
@@ -325,20 +579,47 @@ void VulkanHandler::getPhysicalDevice(XrInstance xr_instance, XrSystemId xr_syst
 
 	PFN_xrGetVulkanGraphicsDevice2KHR pfn_xrGetVulkanGraphicsDevice2KHR = nullptr;
 	xr_result = xrGetInstanceProcAddr(xr_instance, "xrGetVulkanGraphicsDevice2KHR", reinterpret_cast<PFN_xrVoidFunction*>(&pfn_xrGetVulkanGraphicsDevice2KHR));
+	if(!xrCheckResult(xr_instance, xr_result, "xrGetVulkanGraphicsDevice2KHR (xrGetInstanceProcAddr)"))
+		return false;
 	xr_result = pfn_xrGetVulkanGraphicsDevice2KHR(xr_instance, &deviceGetInfo, &vk_physicalDevice);
+	if(!xrCheckResult(xr_instance, xr_result, "xrGetVulkanGraphicsDevice2KHR"))
+		return false;
 
-	std::cout << "Vulkan physical devices (" << devices.size() << ")" << std::endl;
+	verboseOutput() << "Vulkan physical devices (" << devices.size() << ")" << std::endl;
 	for(const auto& device : devices){
-		if(device == vk_physicalDevice){
-			std::cout << "  |-- handle: " << device << std::endl;
-			std::cout << "  |   (selected)"<< std::endl;
-		}
-		else
-			std::cout << "  |-- handle: " << device << std::endl;
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(device, &properties);
+		verboseOutput() << "  |-- handle: " << device << " (" << properties.deviceName << ")" << std::endl;
+		if(device == vk_physicalDevice)
+			verboseOutput() << "  |   (selected)"<< std::endl;
+	}
+
+	vkGetPhysicalDeviceMemoryProperties(vk_physicalDevice, &vk_memoryProperties);
+	return true;
+}
+
+bool VulkanHandler::defineDeviceExtensions(vector<const char*> requestedExtensions, vector<const char*> & enabledExtensions){
+	uint32_t propertyCount = 0;
+
+	vkEnumerateDeviceExtensionProperties(vk_physicalDevice, nullptr, &propertyCount, nullptr);
+	vector<VkExtensionProperties> extensionsProperties(propertyCount);
+	vkEnumerateDeviceExtensionProperties(vk_physicalDevice, nullptr, &propertyCount, extensionsProperties.data());
+
+	verboseOutput() << "Vulkan device extensions (" << requestedExtensions.size() << " requested)" << std::endl;
+	for (size_t i = 0; i < requestedExtensions.size(); i++){
+		bool available = false;
+		for (size_t j = 0; j < extensionsProperties.size(); j++)
+			if (strcmp(extensionsProperties[j].extensionName, requestedExtensions[i]) == 0){
+				enabledExtensions.push_back(requestedExtensions[i]);
+				available = true;
+				break;
+			}
+		verboseOutput() << "  |-- " << requestedExtensions[i] << (available ? "" : " (unavailable)") << std::endl;
 	}
+	return true;
 }
 
-void VulkanHandler::createLogicalDevice(XrInstance xr_instance, XrSystemId xr_system_id){
+bool VulkanHandler::createLogicalDevice(XrInstance xr_instance, XrSystemId xr_system_id){
 	uint32_t propertyCount = 0;
 	float queuePriorities = 0;
 
@@ -349,24 +630,34 @@ void VulkanHandler::createLogicalDevice(XrInstance xr_instance, XrSystemId xr_sy
 	// queue families index
 	vkGetPhysicalDeviceQueueFamilyProperties(vk_physicalDevice, &propertyCount, nullptr);
 	vector<VkQueueFamilyProperties> queueFamilyProps(propertyCount);
-	vkGetPhysicalDeviceQueueFamilyProperties(vk_physicalDevice, &propertyCount, &queueFamilyProps[0]);
+	vkGetPhysicalDeviceQueueFamilyProperties(vk_physicalDevice, &propertyCount, queueFamilyProps.data());
 
+	bool found = false;
 	for (uint32_t i = 0; i < propertyCount; ++i)
 		if ((queueFamilyProps[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0u){
 			queueInfo.queueFamilyIndex = i;
 			vk_queueFamilyIndex = queueInfo.queueFamilyIndex;
+			found = true;
 			break;
 		}
+	if(!found){
+		XR_LOG_ERROR("Failed to find a Vulkan graphics queue family");
+		return false;
+	}
 
+	// external memory and semaphores are optional (e.g. software implementations such as lavapipe)
 	vector<const char*> deviceExtensions;
-	deviceExtensions.push_back("VK_KHR_external_memory");
-    deviceExtensions.push_back("VK_KHR_external_memory_fd");
-    deviceExtensions.push_back("VK_KHR_external_semaphore");
-    deviceExtensions.push_back("VK_KHR_external_semaphore_fd");
-    deviceExtensions.push_back("VK_KHR_get_memory_requirements2");
-
+	vector<const char*> requestedDeviceExtensions = {"VK_KHR_external_memory", 
+													 "VK_KHR_external_memory_fd", 
+													 "VK_KHR_external_semaphore", 
+													 "VK_KHR_external_semaphore_fd", 
+													 "VK_KHR_get_memory_requirements2"};
+	defineDeviceExtensions(requestedDeviceExtensions, deviceExtensions);
+
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(vk_physicalDevice, &supportedFeatures);
 	VkPhysicalDeviceFeatures features = {};
-	features.samplerAnisotropy = true;
+	features.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
 
 	VkDeviceCreateInfo deviceInfo = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
 	deviceInfo.queueCreateInfoCount = 1;
@@ -388,94 +679,577 @@ void VulkanHandler::createLogicalDevice(XrInstance xr_instance, XrSystemId xr_sy
 
 	PFN_xrCreateVulkanDeviceKHR pfn_xrCreateVulkanDeviceKHR = nullptr;
 	xr_result = xrGetInstanceProcAddr(xr_instance, "xrCreateVulkanDeviceKHR", reinterpret_cast<PFN_xrVoidFunction*>(&pfn_xrCreateVulkanDeviceKHR));
+	if(!xrCheckResult(xr_instance, xr_result, "xrCreateVulkanDeviceKHR (xrGetInstanceProcAddr)"))
+		return false;
 	xr_result = pfn_xrCreateVulkanDeviceKHR(xr_instance, &createInfo, &vk_logicalDevice, &vk_result);
+	if(!xrCheckResult(xr_instance, xr_result, "xrCreateVulkanDeviceKHR") || !vkCheckResult(vk_result, "vkCreateDevice"))
+		return false;
 
 	// get queue
 	vkGetDeviceQueue(vk_logicalDevice, vk_queueFamilyIndex, 0, &vk_graphicsQueue);
-	// m_memAllocator.Init(m_vkPhysicalDevice, m_vkDevice);
 
 	VkPipelineCacheCreateInfo info = {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
-    vkCreatePipelineCache(vk_logicalDevice, &info, nullptr, &vk_pipelineCache);
+	vk_result = vkCreatePipelineCache(vk_logicalDevice, &info, nullptr, &vk_pipelineCache);
+	if(!vkCheckResult(vk_result, "vkCreatePipelineCache"))
+		return false;
 
 	VkCommandPoolCreateInfo cmdPoolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
 	cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 	cmdPoolInfo.queueFamilyIndex = vk_queueFamilyIndex;
-    vk_result =  vkCreateCommandPool(vk_logicalDevice, &cmdPoolInfo, nullptr, &vk_cmdPool);
+	vk_result = vkCreateCommandPool(vk_logicalDevice, &cmdPoolInfo, nullptr, &vk_cmdPool);
+	return vkCheckResult(vk_result, "vkCreateCommandPool");
+}
+
+bool VulkanHandler::findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties, uint32_t * typeIndex){
+	for(uint32_t i = 0; i < vk_memoryProperties.memoryTypeCount; i++)
+		if((typeBits & (1u << i)) && (vk_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties){
+			*typeIndex = i;
+			return true;
+		}
+	return false;
+}
+
+bool VulkanHandler::initResources(XrInstance xr_instance, XrSystemId xr_system_id){
+	vk_uploadRing.resize(VK_UPLOAD_RING_SIZE);
+	vk_uploadIndex = 0;
+
+	vector<VkCommandBuffer> commandBuffers(vk_uploadRing.size());
+	VkCommandBufferAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+	allocateInfo.commandPool = vk_cmdPool;
+	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandBufferCount = (uint32_t)commandBuffers.size();
+	vk_result = vkAllocateCommandBuffers(vk_logicalDevice, &allocateInfo, commandBuffers.data());
+	if(!vkCheckResult(vk_result, "vkAllocateCommandBuffers"))
+		return false;
+
+	// fences are created signaled so the first use of each slot does not wait
+	VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+	for(size_t i = 0; i < vk_uploadRing.size(); i++){
+		vk_uploadRing[i].commandBuffer = commandBuffers[i];
+		vk_result = vkCreateFence(vk_logicalDevice, &fenceInfo, nullptr, &vk_uploadRing[i].fence);
+		if(!vkCheckResult(vk_result, "vkCreateFence"))
+			return false;
+	}
+	return true;
+}
+
+void VulkanHandler::releaseUploadSlot(UploadSlot & slot){
+	if(slot.mapped)
+		vkUnmapMemory(vk_logicalDevice, slot.bufferMemory);
+	if(slot.buffer)
+		vkDestroyBuffer(vk_logicalDevice, slot.buffer, nullptr);
+	if(slot.bufferMemory)
+		vkFreeMemory(vk_logicalDevice, slot.bufferMemory, nullptr);
+	if(slot.image)
+		vkDestroyImage(vk_logicalDevice, slot.image, nullptr);
+	if(slot.imageMemory)
+		vkFreeMemory(vk_logicalDevice, slot.imageMemory, nullptr);
+	slot.mapped = nullptr;
+	slot.buffer = VK_NULL_HANDLE;
+	slot.bufferMemory = VK_NULL_HANDLE;
+	slot.image = VK_NULL_HANDLE;
+	slot.imageMemory = VK_NULL_HANDLE;
+	slot.width = slot.height = 0;
+}
+
+bool VulkanHandler::resizeUploadSlot(UploadSlot & slot, int width, int height, VkFormat format){
+	if(slot.width == width && slot.height == height && slot.format == format)
+		return true;
+	releaseUploadSlot(slot);
+
+	// staging buffer (host visible and coherent, mapped for the whole lifetime of the slot)
+	VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+	bufferInfo.size = (VkDeviceSize)width * height * 4;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	vk_result = vkCreateBuffer(vk_logicalDevice, &bufferInfo, nullptr, &slot.buffer);
+	if(!vkCheckResult(vk_result, "vkCreateBuffer"))
+		return false;
+
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(vk_logicalDevice, slot.buffer, &requirements);
+	VkMemoryAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+	allocateInfo.allocationSize = requirements.size;
+	if(!findMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &allocateInfo.memoryTypeIndex)){
+		XR_LOG_ERROR("No host visible and coherent Vulkan memory type for the staging buffer");
+		return false;
+	}
+	vk_result = vkAllocateMemory(vk_logicalDevice, &allocateInfo, nullptr, &slot.bufferMemory);
+	if(!vkCheckResult(vk_result, "vkAllocateMemory (staging buffer)"))
+		return false;
+	vkBindBufferMemory(vk_logicalDevice, slot.buffer, slot.bufferMemory, 0);
+	vk_result = vkMapMemory(vk_logicalDevice, slot.bufferMemory, 0, VK_WHOLE_SIZE, 0, &slot.mapped);
+	if(!vkCheckResult(vk_result, "vkMapMemory"))
+		return false;
+
+	// intermediate image (frame resolution): the blit into the swapchain image scales and converts the format
+	VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = format;
+	imageInfo.extent = {(uint32_t)width, (uint32_t)height, 1};
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	vk_result = vkCreateImage(vk_logicalDevice, &imageInfo, nullptr, &slot.image);
+	if(!vkCheckResult(vk_result, "vkCreateImage"))
+		return false;
+
+	vkGetImageMemoryRequirements(vk_logicalDevice, slot.image, &requirements);
+	allocateInfo.allocationSize = requirements.size;
+	if(!findMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &allocateInfo.memoryTypeIndex)){
+		XR_LOG_ERROR("No device local Vulkan memory type for the upload image");
+		return false;
+	}
+	vk_result = vkAllocateMemory(vk_logicalDevice, &allocateInfo, nullptr, &slot.imageMemory);
+	if(!vkCheckResult(vk_result, "vkAllocateMemory (upload image)"))
+		return false;
+	vkBindImageMemory(vk_logicalDevice, slot.image, slot.imageMemory, 0);
+
+	slot.format = format;
+	slot.width = width;
+	slot.height = height;
+	return true;
+}
+
+UploadSlot * VulkanHandler::acquireUploadSlot(){
+	if(vk_uploadRing.empty())
+		return nullptr;
+	UploadSlot & slot = vk_uploadRing[vk_uploadIndex];
+	vk_uploadIndex = (vk_uploadIndex + 1) % vk_uploadRing.size();
+
+	// wait until the GPU is done with the previous use of this slot
+	vk_result = vkWaitForFences(vk_logicalDevice, 1, &slot.fence, VK_TRUE, UINT64_MAX);
+	if(!vkCheckResult(vk_result, "vkWaitForFences"))
+		return nullptr;
+	vkResetFences(vk_logicalDevice, 1, &slot.fence);
+
+	VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkResetCommandBuffer(slot.commandBuffer, 0);
+	vk_result = vkBeginCommandBuffer(slot.commandBuffer, &beginInfo);
+	if(!vkCheckResult(vk_result, "vkBeginCommandBuffer"))
+		return nullptr;
+	return &slot;
+}
+
+bool VulkanHandler::submitUploadSlot(UploadSlot & slot){
+	vk_result = vkEndCommandBuffer(slot.commandBuffer);
+	if(!vkCheckResult(vk_result, "vkEndCommandBuffer"))
+		return false;
+	// the work is submitted before xrReleaseSwapchainImage, as required by XR_KHR_vulkan_enable2 (the runtime waits on the queue).
+	// OpenXR swapchains have no acquire/release semaphores: xrWaitSwapchainImage already guarantees that the compositor is done 
+	// with the image and all the submissions go to the same queue, so the fence only guards the reuse of the upload slot
+	VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &slot.commandBuffer;
+	vk_result = vkQueueSubmit(vk_graphicsQueue, 1, &submitInfo, slot.fence);
+	return vkCheckResult(vk_result, "vkQueueSubmit");
+}
+
+static void vkImageBarrier(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, 
+						   VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, 
+						   VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT, uint32_t layerCount = 1){
+	VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+	barrier.srcAccessMask = srcAccess;
+	barrier.dstAccessMask = dstAccess;
+	barrier.oldLayout = oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange = {aspect, 0, 1, 0, layerCount};
+	vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 }
 
 void VulkanHandler::renderView(const XrCompositionLayerProjectionView & layerView, const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat){
-	std::cout << "layerView.subImage.imageArrayIndex: " << layerView.subImage.imageArrayIndex << std::endl;
+	// no frame: clear the swapchain image
+	UploadSlot * slot = acquireUploadSlot();
+	if(!slot)
+		return;
+	VkImage image = reinterpret_cast<const XrSwapchainImageVulkan2KHR*>(swapchainImage)->image;
+	VkClearColorValue color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+	VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+	vkImageBarrier(slot->commandBuffer, image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+				   0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+	vkCmdClearColorImage(slot->commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1, &range);
+	vkImageBarrier(slot->commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 
+				   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+	submitUploadSlot(*slot);
+}
+
+void VulkanHandler::setVisibleArea(int view, const std::vector<XrVector2f> & vertices, const std::vector<uint32_t> & indices){
+	if(view < 0)
+		return;
+	if((size_t)view >= visibleAreas.size())
+		visibleAreas.resize(view + 1);
+	visibleAreas[view] = VisibleArea();
+	visibleAreas[view].vertices = vertices;
+	visibleAreas[view].indices = indices;
+}
+
+void VulkanHandler::renderViewFromImage(const XrCompositionLayerProjectionView & layerView, const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int frameWidth, int frameHeight, void * frameData, bool rgba, int view){
+	UploadSlot * slot = acquireUploadSlot();
+	if(!slot)
+		return;
+	// the upload image matches the gamma encoding of the swapchain (when the runtime only offers sRGB formats), 
+	// so the blit does not encode the already gamma encoded frames a second time
+	bool srgb = swapchainFormat == VK_FORMAT_B8G8R8A8_SRGB || swapchainFormat == VK_FORMAT_R8G8B8A8_SRGB;
+	if(!resizeUploadSlot(*slot, frameWidth, frameHeight, srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM)){
+		vkEndCommandBuffer(slot->commandBuffer);
+		releaseUploadSlot(*slot);
+		// keep the slot usable (its fence must be signaled for the next acquisition)
+		vkQueueSubmit(vk_graphicsQueue, 0, nullptr, slot->fence);
+		return;
+	}
+
+	// visible bands of the view (XR_KHR_visibility_mask) or the whole frame
+	vk_copyRegions.clear();
+	vk_blitRegions.clear();
+	const XrRect2Di & rect = layerView.subImage.imageRect;
+	bool masked = view >= 0 && (size_t)view < visibleAreas.size() && updateVisibleRects(visibleAreas[view], frameWidth, frameHeight);
+	const XrRect2Di fullFrame = {{0, 0}, {frameWidth, frameHeight}};
+	const XrRect2Di * frameRects = masked ? visibleAreas[view].rects.data() : &fullFrame;
+	size_t frameRectCount = masked ? visibleAreas[view].rects.size() : 1;
+
+	for(size_t r = 0; r < frameRectCount; r++){
+		const XrRect2Di & frameRect = frameRects[r];
+		// copy the visible part of the rows into the staging buffer, at the same offsets as the whole frame 
+		// (RGB frames are expanded to RGBA: there is no widely supported 24-bit image format)
+		for(int row = frameRect.offset.y; row < frameRect.offset.y + frameRect.extent.height; row++){
+			size_t offset = (size_t)row * frameWidth + frameRect.offset.x;
+			uint8_t * dst = static_cast<uint8_t*>(slot->mapped) + offset * 4;
+			if(rgba)
+				memcpy(dst, static_cast<const uint8_t*>(frameData) + offset * 4, (size_t)frameRect.extent.width * 4);
+			else{
+				const uint8_t * src = static_cast<const uint8_t*>(frameData) + offset * 3;
+				for(int i = 0; i < frameRect.extent.width; i++, src += 3, dst += 4){
+					dst[0] = src[0];
+					dst[1] = src[1];
+					dst[2] = src[2];
+					dst[3] = 255;
+				}
+			}
+		}
+		VkBufferImageCopy region = {};
+		region.bufferOffset = ((VkDeviceSize)frameRect.offset.y * frameWidth + frameRect.offset.x) * 4;
+		region.bufferRowLength = frameWidth;
+		region.bufferImageHeight = frameHeight;
+		region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+		region.imageOffset = {frameRect.offset.x, frameRect.offset.y, 0};
+		region.imageExtent = {(uint32_t)frameRect.extent.width, (uint32_t)frameRect.extent.height, 1};
+		vk_copyRegions.push_back(region);
+
+		// the band edges are scaled the same way for adjacent bands (no gaps). 
+		// The destination is flipped vertically to match the bottom-left origin of the OpenGL frame path
+		int32_t x0 = rect.offset.x + (int32_t)((int64_t)frameRect.offset.x * rect.extent.width / frameWidth);
+		int32_t x1 = rect.offset.x + (int32_t)((int64_t)(frameRect.offset.x + frameRect.extent.width) * rect.extent.width / frameWidth);
+		int32_t y0 = rect.offset.y + rect.extent.height - (int32_t)((int64_t)frameRect.offset.y * rect.extent.height / frameHeight);
+		int32_t y1 = rect.offset.y + rect.extent.height - (int32_t)((int64_t)(frameRect.offset.y + frameRect.extent.height) * rect.extent.height / frameHeight);
+		VkImageBlit blit = {};
+		blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+		blit.srcOffsets[0] = {frameRect.offset.x, frameRect.offset.y, 0};
+		blit.srcOffsets[1] = {frameRect.offset.x + frameRect.extent.width, frameRect.offset.y + frameRect.extent.height, 1};
+		blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, layerView.subImage.imageArrayIndex, 1};
+		blit.dstOffsets[0] = {x0, y0, 0};
+		blit.dstOffsets[1] = {x1, y1, 1};
+		vk_blitRegions.push_back(blit);
+	}
+
+	VkCommandBuffer commandBuffer = slot->commandBuffer;
+	VkImage image = reinterpret_cast<const XrSwapchainImageVulkan2KHR*>(swapchainImage)->image;
+
+	// staging buffer -> upload image
+	vkImageBarrier(commandBuffer, slot->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+				   0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+	if(!vk_copyRegions.empty())
+		vkCmdCopyBufferToImage(commandBuffer, slot->buffer, slot->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)vk_copyRegions.size(), vk_copyRegions.data());
+	vkImageBarrier(commandBuffer, slot->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, 
+				   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+	// upload image -> swapchain image (the runtime hands over the image in COLOR_ATTACHMENT_OPTIMAL layout and expects it back in it).
+	// Only the visible bands are blitted (the hidden area of the swapchain image is not written)
+	vkImageBarrier(commandBuffer, image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+				   0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+	if(!vk_blitRegions.empty())
+		vkCmdBlitImage(commandBuffer, slot->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+					   (uint32_t)vk_blitRegions.size(), vk_blitRegions.data(), VK_FILTER_LINEAR);
+	vkImageBarrier(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 
+				   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+	submitUploadSlot(*slot);
+}
+
+void VulkanHandler::renderDepthFromImage(const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int width, int height, 
+										 int depthWidth, int depthHeight, const float * depthData, float nearZ, float farZ){
+	UploadSlot * slot = acquireUploadSlot();
+	if(!slot)
+		return;
+	if(!resizeUploadSlot(*slot, width, height)){
+		vkEndCommandBuffer(slot->commandBuffer);
+		releaseUploadSlot(*slot);
+		// keep the slot usable (its fence must be signaled for the next acquisition)
+		vkQueueSubmit(vk_graphicsQueue, 0, nullptr, slot->fence);
+		return;
+	}
+
+	// write the window depth of a perspective projection into the staging buffer, scaled (nearest) to the given size.
+	// Depth images are copied, not blitted (neither scaled nor converted by the transfer), so it is done here in a single pass. 
+	// The rows are flipped to match the bottom-left origin of the OpenGL frame path.
+	// Depths beyond the far plane (and infinite or invalid values, e.g. background) are mapped to 1
+	float a = farZ / (farZ - nearZ);
+	float b = farZ * nearZ / (farZ - nearZ);
+	std::vector<int> columns(width);
+	for(int i = 0; i < width; i++)
+		columns[i] = (int)((int64_t)i * depthWidth / width);
+	for(int row = 0; row < height; row++){
+		const float * src = depthData + (size_t)(depthHeight - 1 - (int)((int64_t)row * depthHeight / height)) * depthWidth;
+		for(int i = 0; i < width; i++){
+			float z = src[columns[i]];
+			float windowDepth = z < farZ ? (z > nearZ ? a - b / z : 0.0f) : 1.0f;
+			if(swapchainFormat == VK_FORMAT_D16_UNORM)
+				static_cast<uint16_t*>(slot->mapped)[(size_t)row * width + i] = (uint16_t)(windowDepth * 65535.0f + 0.5f);
+			else
+				static_cast<float*>(slot->mapped)[(size_t)row * width + i] = windowDepth;
+		}
+	}
+
+	// staging buffer -> swapchain image (the runtime hands over the image in DEPTH_STENCIL_ATTACHMENT_OPTIMAL layout and expects it back in it)
+	VkCommandBuffer commandBuffer = slot->commandBuffer;
+	VkImage image = reinterpret_cast<const XrSwapchainImageVulkan2KHR*>(swapchainImage)->image;
+	vkImageBarrier(commandBuffer, image, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+				   0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+	VkBufferImageCopy region = {};
+	region.imageSubresource = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1};
+	region.imageExtent = {(uint32_t)width, (uint32_t)height, 1};
+	vkCmdCopyBufferToImage(commandBuffer, slot->buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	vkImageBarrier(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, 
+				   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+	submitUploadSlot(*slot);
+}
+
+// IEEE 754 half float (round to nearest even, overflow to infinity, subnormals flushed to zero)
+static uint16_t floatToHalf(float value){
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint16_t sign = (bits >> 16) & 0x8000;
+	int32_t exponent = (int32_t)((bits >> 23) & 0xff) - 127 + 15;
+	uint32_t mantissa = bits & 0x7fffff;
+	if(((bits >> 23) & 0xff) == 0xff)
+		return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+	if(exponent >= 31)
+		return sign | 0x7c00;
+	if(exponent <= 0)
+		return sign;
+	uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+	uint32_t remainder = mantissa & 0x1fff;
+	if(remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+		half++;
+	return sign | (uint16_t)half;
+}
+
+void VulkanHandler::renderMotionVectorsFromImage(const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int motionVectorWidth, int motionVectorHeight, const float * motionVectorData){
+	// the staging buffer holds 8 bytes per pixel (the slot is sized as an RGBA8 image of twice the height)
+	UploadSlot * slot = acquireUploadSlot();
+	if(!slot)
+		return;
+	if(!resizeUploadSlot(*slot, motionVectorWidth, 2 * motionVectorHeight)){
+		vkEndCommandBuffer(slot->commandBuffer);
+		releaseUploadSlot(*slot);
+		// keep the slot usable (its fence must be signaled for the next acquisition)
+		vkQueueSubmit(vk_graphicsQueue, 0, nullptr, slot->fence);
+		return;
+	}
+
+	// convert the motion vectors to half floats in the staging buffer. The rows are flipped as the depth images
+	size_t rowLength = (size_t)motionVectorWidth * 4;
+	for(int row = 0; row < motionVectorHeight; row++){
+		const float * src = motionVectorData + (size_t)(motionVectorHeight - 1 - row) * rowLength;
+		uint16_t * dst = static_cast<uint16_t*>(slot->mapped) + (size_t)row * rowLength;
+		for(size_t i = 0; i < rowLength; i++)
+			dst[i] = floatToHalf(src[i]);
+	}
+
+	// staging buffer -> swapchain image (the runtime hands over the image in COLOR_ATTACHMENT_OPTIMAL layout and expects it back in it)
+	VkCommandBuffer commandBuffer = slot->commandBuffer;
+	VkImage image = reinterpret_cast<const XrSwapchainImageVulkan2KHR*>(swapchainImage)->image;
+	vkImageBarrier(commandBuffer, image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+				   0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+	VkBufferImageCopy region = {};
+	region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+	region.imageExtent = {(uint32_t)motionVectorWidth, (uint32_t)motionVectorHeight, 1};
+	vkCmdCopyBufferToImage(commandBuffer, slot->buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	vkImageBarrier(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 
+				   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+	submitUploadSlot(*slot);
+}
+
+void VulkanHandler::renderCubeFromImages(const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int faceSize, const void * facesData, bool rgba){
+	// the staging buffer holds the 6 faces (the slot is sized as a single image with the faces stacked vertically)
+	UploadSlot * slot = acquireUploadSlot();
+	if(!slot)
+		return;
+	if(!resizeUploadSlot(*slot, faceSize, 6 * faceSize)){
+		vkEndCommandBuffer(slot->commandBuffer);
+		releaseUploadSlot(*slot);
+		// keep the slot usable (its fence must be signaled for the next acquisition)
+		vkQueueSubmit(vk_graphicsQueue, 0, nullptr, slot->fence);
+		return;
+	}
+
+	// copy the faces into the staging buffer (there is no format conversion in a buffer-to-image copy: 
+	// RGB faces are expanded to RGBA and the channels are swapped for BGRA swapchain formats). 
+	// The bytes are stored unchanged for both UNORM and sRGB formats, as the blit of the projection views does
+	bool bgra = swapchainFormat == VK_FORMAT_B8G8R8A8_SRGB || swapchainFormat == VK_FORMAT_B8G8R8A8_UNORM;
+	size_t pixels = (size_t)faceSize * faceSize * 6;
+	const uint8_t * src = static_cast<const uint8_t*>(facesData);
+	uint8_t * dst = static_cast<uint8_t*>(slot->mapped);
+	if(rgba && !bgra)
+		memcpy(dst, src, pixels * 4);
+	else
+		for(size_t i = 0; i < pixels; i++, src += rgba ? 4 : 3, dst += 4){
+			dst[0] = src[bgra ? 2 : 0];
+			dst[1] = src[1];
+			dst[2] = src[bgra ? 0 : 2];
+			dst[3] = rgba ? src[3] : 255;
+		}
+
+	// staging buffer -> swapchain image (6 array layers). The faces are copied with their first row at the top, as cube maps are sampled.
+	// The runtime hands over the image in COLOR_ATTACHMENT_OPTIMAL layout and expects it back in it
+	VkCommandBuffer commandBuffer = slot->commandBuffer;
+	VkImage image = reinterpret_cast<const XrSwapchainImageVulkan2KHR*>(swapchainImage)->image;
+	vkImageBarrier(commandBuffer, image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+				   0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 6);
+	VkBufferImageCopy region = {};
+	region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 6};
+	region.imageExtent = {(uint32_t)faceSize, (uint32_t)faceSize, 1};
+	vkCmdCopyBufferToImage(commandBuffer, slot->buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	vkImageBarrier(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 
+				   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 6);
+
+	submitUploadSlot(*slot);
+}
+
+void VulkanHandler::releaseResources(){
+	if(vk_logicalDevice != VK_NULL_HANDLE){
+		vkDeviceWaitIdle(vk_logicalDevice);
+		for(size_t i = 0; i < vk_uploadRing.size(); i++){
+			releaseUploadSlot(vk_uploadRing[i]);
+			if(vk_uploadRing[i].fence)
+				vkDestroyFence(vk_logicalDevice, vk_uploadRing[i].fence, nullptr);
+			if(vk_uploadRing[i].commandBuffer)
+				vkFreeCommandBuffers(vk_logicalDevice, vk_cmdPool, 1, &vk_uploadRing[i].commandBuffer);
+		}
+		if(vk_cmdPool)
+			vkDestroyCommandPool(vk_logicalDevice, vk_cmdPool, nullptr);
+		if(vk_pipelineCache)
+			vkDestroyPipelineCache(vk_logicalDevice, vk_pipelineCache, nullptr);
+		vkDestroyDevice(vk_logicalDevice, nullptr);
+	}
+	if(vk_instance != VK_NULL_HANDLE)
+		vkDestroyInstance(vk_instance, nullptr);
+
+	vk_uploadRing.clear();
+	visibleAreas.clear();
+	vk_uploadIndex = 0;
+	vk_cmdPool = VK_NULL_HANDLE;
+	vk_pipelineCache = VK_NULL_HANDLE;
+	vk_graphicsQueue = VK_NULL_HANDLE;
+	vk_logicalDevice = VK_NULL_HANDLE;
+	vk_physicalDevice = VK_NULL_HANDLE;
+	vk_instance = VK_NULL_HANDLE;
 }
 
+
 #endif
 
 // OpenGL graphics API
 #ifdef XR_USE_GRAPHICS_API_OPENGL
 
 void GLAPIENTRY MessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam){
-	std::cout << "GL CALLBACK: " << (type == GL_DEBUG_TYPE_ERROR ? "** GL ERROR **" : "") << " type = 0x" << type << ", severity = 0x" << severity << ", message = " << message << std::endl;
+	if(type == GL_DEBUG_TYPE_ERROR)
+		XR_LOG_ERROR("GL CALLBACK: ** GL ERROR ** type = 0x" << std::hex << type << ", severity = 0x" << severity << ", message = " << message);
+	else
+		XR_LOG_DEBUG("GL CALLBACK: type = 0x" << std::hex << type << ", severity = 0x" << severity << ", message = " << message);
 }
 
 static const char* glslShaderVertex = R"_(
-    #version 410
+    #version 450
 	out vec2 v_tex;
 
+	// visible area mesh (XR_KHR_visibility_mask) in texture coordinates, drawn instead of the full-view quad
+	layout(location = 0) in vec2 position;
+	layout(location = 0) uniform bool useMesh;
+
 	const vec2 pos[4]=vec2[4](vec2(-1.0, 1.0),
 								vec2(-1.0,-1.0),
 								vec2( 1.0, 1.0),
 								vec2( 1.0,-1.0));
 
 	void main(){
-		v_tex=0.5*pos[gl_VertexID] + vec2(0.5);
-		gl_Position=vec4(pos[gl_VertexID], 0.0, 1.0);
+		vec2 p=useMesh ? 2.0*position - vec2(1.0) : pos[gl_VertexID];
+		v_tex=0.5*p + vec2(0.5);
+		gl_Position=vec4(p, 0.0, 1.0);
 	}
 )_";
 
 static const char* glslShaderFragment = R"_(
-	#version 410
+	#version 450
 
 	in vec2 v_tex;
-	uniform sampler2D texSampler;
+	layout(binding = 0) uniform sampler2D texSampler;
+
+	// depth (XR_KHR_composition_layer_depth): the linear depth (red channel) is written as the window depth of a perspective projection.
+	// Depths beyond the far plane (and infinite or invalid values, e.g. background) are mapped to 1
+	layout(location = 1) uniform bool depthMode;
+	layout(location = 2) uniform vec4 depthRange;		// near, far, far / (far - near), far * near / (far - near)
 
 	out vec4 color;
 
 	void main(){
 		color=texture(texSampler, v_tex);
+		float z=color.r;
+		gl_FragDepth=depthMode ? (z < depthRange.y ? (z > depthRange.x ? depthRange.z - depthRange.w / z : 0.0) : 1.0) : gl_FragCoord.z;
 	}
 )_";
 
-class OpenGLHandler{
-private:
-	XrResult xr_result;
-
-	SDL_Window * sdl_window;
-	SDL_GLContext gl_context;
-	PFNGLBLITNAMEDFRAMEBUFFERPROC _glBlitNamedFramebuffer;
-
-	GLuint vao;
-	GLuint program;
-	GLuint texture;
-	GLuint swapchainFramebuffer;
-
-	bool checkShader(GLuint);
-	bool checkProgram(GLuint);
-
-	void loadTexture(string, GLuint *);
-
-public:
-	OpenGLHandler();
-	~OpenGLHandler();
+// program binary cache: the linked program is stored (glGetProgramBinary) and reloaded on the next start when
+// the driver (vendor, renderer and version) and the shader sources match. The default path can be overwritten
+// using the SEMU_XR_PROGRAM_CACHE environment variable (an empty value disables the cache)
+#define GL_PROGRAM_CACHE_ENV "SEMU_XR_PROGRAM_CACHE"
+#define GL_PROGRAM_CACHE_MAGIC 0x4d41524750525853ULL		// "SXRPRGAM" (little-endian)
+#define GL_PROGRAM_CACHE_VERSION 1
+
+struct ProgramCacheHeader{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t binaryFormat;
+	uint32_t keySize;
+	uint32_t binarySize;
+};
 
-	bool getRequirements(XrInstance xr_instance, XrSystemId xr_system_id);
-	bool initGraphicsBinding(Display** xDisplay, uint32_t* visualid, GLXFBConfig* glxFBConfig, GLXDrawable* glxDrawable, GLXContext* glxContext, int witdh, int height);
-	bool initResources(XrInstance xr_instance, XrSystemId xr_system_id);
+static string programCachePath(){
+	const char * value = getenv(GL_PROGRAM_CACHE_ENV);
+	if(value)
+		return value;
+	value = getenv("XDG_CACHE_HOME");
+	if(value && *value)
+		return string(value) + "/semu.xr.openxr/program.bin";
+	value = getenv("HOME");
+	if(value && *value)
+		return string(value) + "/.cache/semu.xr.openxr/program.bin";
+	return "";
+}
 
-	void acquireContext(XrGraphicsBindingOpenGLXlibKHR, string);
-	void renderView(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *, int64_t);
-	void renderViewFromImage(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *, int64_t, int, int, void *, bool);
+#define GL_UPLOAD_RING_SIZE 3		// upload textures per view (sampled by the compositor, being uploaded and spare)
 
-	uint32_t getSupportedSwapchainSampleCount(XrViewConfigurationView){ return 1; }
-};
 
 OpenGLHandler::OpenGLHandler()
 {
@@ -483,6 +1257,94 @@ OpenGLHandler::OpenGLHandler()
 
 OpenGLHandler::~OpenGLHandler()
 {
+	releaseResources();
+}
+
+void OpenGLHandler::releaseResources(){
+	stopUploadWorker();
+
+	// make the context current to delete the OpenGL objects
+	bool current = false;
+#ifdef XR_USE_PLATFORM_EGL
+	if(eglContext != EGL_NO_CONTEXT)
+		current = eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext) == EGL_TRUE;
+#endif
+	if(!current && gl_context)
+		current = SDL_GL_MakeCurrent(sdl_window, gl_context) == 0;
+	if(current){
+		if(program)
+			glDeleteProgram(program);
+		if(vao)
+			glDeleteVertexArrays(1, &vao);
+		if(texture)
+			glDeleteTextures(1, &texture);
+		if(depthTexture)
+			glDeleteTextures(1, &depthTexture);
+		for(size_t i = 0; i < visibleAreaVertexBuffers.size(); i++){
+			glDeleteBuffers(1, &visibleAreaVertexBuffers[i]);
+			glDeleteBuffers(1, &visibleAreaIndexBuffers[i]);
+		}
+		for(auto & framebuffer : swapchainFramebuffers)
+			glDeleteFramebuffers(1, &framebuffer.second);
+		// upload textures and fences belong to the share group
+		for(size_t i = 0; i < uploadTextures.size(); i++)
+			for(size_t j = 0; j < uploadTextures[i].size(); j++){
+				if(uploadTextures[i][j].texture)
+					glDeleteTextures(1, &uploadTextures[i][j].texture);
+				if(uploadTextures[i][j].uploadFence)
+					glDeleteSync(uploadTextures[i][j].uploadFence);
+				if(uploadTextures[i][j].drawFence)
+					glDeleteSync(uploadTextures[i][j].drawFence);
+			}
+	}
+	uploadTextures.clear();
+	uploadJobs.clear();
+	uploadPublished.clear();
+	uploadSampling.clear();
+
+#ifdef XR_USE_PLATFORM_EGL
+	if(eglDisplay != EGL_NO_DISPLAY){
+		eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if(eglUploadContext != EGL_NO_CONTEXT)
+			eglDestroyContext(eglDisplay, eglUploadContext);
+		if(eglUploadSurface != EGL_NO_SURFACE)
+			eglDestroySurface(eglDisplay, eglUploadSurface);
+		if(eglContext != EGL_NO_CONTEXT)
+			eglDestroyContext(eglDisplay, eglContext);
+		if(eglSurface != EGL_NO_SURFACE)
+			eglDestroySurface(eglDisplay, eglSurface);
+		eglTerminate(eglDisplay);
+	}
+	eglDisplay = EGL_NO_DISPLAY;
+	eglConfig = nullptr;
+	eglContext = EGL_NO_CONTEXT;
+	eglSurface = EGL_NO_SURFACE;
+	eglUploadContext = EGL_NO_CONTEXT;
+	eglUploadSurface = EGL_NO_SURFACE;
+#endif
+	if(uploadGlContext)
+		SDL_GL_DeleteContext(uploadGlContext);
+	if(gl_context)
+		SDL_GL_DeleteContext(gl_context);
+	if(sdl_window)
+		SDL_DestroyWindow(sdl_window);
+	if(xDisplay)
+		XCloseDisplay(xDisplay);
+
+	xDisplay = nullptr;
+	sdl_window = nullptr;
+	gl_context = nullptr;
+	uploadGlContext = nullptr;
+	program = vao = texture = 0;
+	swapchainFramebuffers.clear();
+	visibleAreas.clear();
+	visibleAreaVertexBuffers.clear();
+	visibleAreaIndexBuffers.clear();
+	contextOwner = std::thread::id();
+	textureWidth = textureHeight = 0;
+	depthTexture = 0;
+	depthTextureWidth = depthTextureHeight = 0;
+	mirrorWindowShown = false;
 }
 
 void OpenGLHandler::loadTexture(string path, GLuint * textureId){
@@ -514,7 +1376,7 @@ bool OpenGLHandler::checkShader(GLuint shader){
 		GLchar msg[4096] = {};
 		GLsizei length;
 		glGetShaderInfoLog(shader, sizeof(msg), &length, msg);
-		std::cout << "GL SHADER: " << msg << std::endl;
+		XR_LOG_ERROR("GL SHADER: " << msg);
 		return false;
 	}
 	return true;
@@ -527,28 +1389,39 @@ bool OpenGLHandler::checkProgram(GLuint prog) {
 		GLchar msg[4096] = {};
 		GLsizei length;
 		glGetProgramInfoLog(prog, sizeof(msg), &length, msg);
-		std::cout << "GL SHADER: " << msg << std::endl;
+		XR_LOG_ERROR("GL SHADER: " << msg);
 		return false;
 	}
 	return true;
 }
 
-void OpenGLHandler::acquireContext(XrGraphicsBindingOpenGLXlibKHR graphicsBinding, string message){
-	GLXContext context = glXGetCurrentContext();
-	if(context != graphicsBinding.glxContext){
-		// std::cout << "glxContext changed (" << context << " != " << graphicsBinding.glxContext << ") in "<< message << std::endl;
-		glXMakeCurrent(graphicsBinding.xDisplay, graphicsBinding.glxDrawable, graphicsBinding.glxContext);
+void OpenGLHandler::acquireContext(){
+	if(contextOwner == std::this_thread::get_id())
+		return;
+	// the frame loop moved to another thread (the context must not be current on the previous one)
+	bool current = false;
+#ifdef XR_USE_PLATFORM_EGL
+	if(eglContext != EGL_NO_CONTEXT)
+		current = eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext) == EGL_TRUE;
+	else
+#endif
+	if(gl_context)
+		current = SDL_GL_MakeCurrent(sdl_window, gl_context) == 0;
+	if(!current){
+		XR_LOG_ERROR("Unable to make the OpenGL context current on the calling thread");
+		return;
 	}
+	contextOwner = std::this_thread::get_id();
 }
 
 bool OpenGLHandler::initGraphicsBinding(Display** xDisplay, uint32_t* visualid, GLXFBConfig* glxFBConfig, GLXDrawable* glxDrawable, GLXContext* glxContext, int witdh, int height){
 	if(SDL_Init(SDL_INIT_VIDEO) < 0){
-		std::cout << "Unable to initialize SDL" << std::endl;
+		XR_LOG_ERROR("Unable to initialize SDL");
 		return false;
 	}
 
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 2);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
 
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 0);
@@ -556,19 +1429,23 @@ bool OpenGLHandler::initGraphicsBinding(Display** xDisplay, uint32_t* visualid,
 	// create our window centered at half the VR resolution
 	sdl_window = SDL_CreateWindow("Omniverse (VR)", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, witdh / 2, height / 2, SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN);
 	if (!sdl_window){
-		std::cout << "Unable to create SDL window" << std::endl;
+		XR_LOG_ERROR("Unable to create SDL window");
 		return false;
 	}
 
 	gl_context = SDL_GL_CreateContext(sdl_window);
+	if(!gl_context){
+		XR_LOG_ERROR("Unable to create OpenGL 4.5 context (" << SDL_GetError() << ")");
+		return false;
+	}
+	contextOwner = std::this_thread::get_id();
 	glEnable(GL_DEBUG_OUTPUT);
 	glDebugMessageCallback(MessageCallback, 0);
 
 	SDL_GL_SetSwapInterval(0);
 
-	_glBlitNamedFramebuffer = (PFNGLBLITNAMEDFRAMEBUFFERPROC)glXGetProcAddressARB((GLubyte*)"glBlitNamedFramebuffer");
-
-	*xDisplay = XOpenDisplay(NULL);
+	this->xDisplay = XOpenDisplay(NULL);
+	*xDisplay = this->xDisplay;
 	*glxContext = glXGetCurrentContext();
 	*glxDrawable = glXGetCurrentDrawable();
 
@@ -576,27 +1453,182 @@ bool OpenGLHandler::initGraphicsBinding(Display** xDisplay, uint32_t* visualid,
 	return true;
 }
 
-bool OpenGLHandler::getRequirements(XrInstance xr_instance, XrSystemId xr_system_id){
-	PFN_xrGetOpenGLGraphicsRequirementsKHR pfn_xrGetOpenGLGraphicsRequirementsKHR = nullptr;
-	xr_result = xrGetInstanceProcAddr(xr_instance, "xrGetOpenGLGraphicsRequirementsKHR", reinterpret_cast<PFN_xrVoidFunction*>(&pfn_xrGetOpenGLGraphicsRequirementsKHR));
-	if(!xrCheckResult(NULL, xr_result, "xrGetOpenGLGraphicsRequirementsKHR (xrGetInstanceProcAddr)"))
+#ifdef XR_USE_PLATFORM_EGL
+bool OpenGLHandler::initEglGraphicsBinding(XrGraphicsBindingEGLMNDX * graphicsBinding){
+	// display: Mesa surfaceless platform (no X server or GPU device node required), if available
+	const char * clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC _eglGetPlatformDisplayEXT = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if(clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless") && _eglGetPlatformDisplayEXT)
+		eglDisplay = _eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	if(eglDisplay == EGL_NO_DISPLAY)
+		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	EGLint major, minor;
+	if(eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)){
+		XR_LOG_ERROR("Unable to initialize EGL display (error: 0x" << std::hex << eglGetError() << std::dec << ")");
+		eglDisplay = EGL_NO_DISPLAY;
 		return false;
-	XrGraphicsRequirementsOpenGLKHR graphicsRequirement = {XR_TYPE_GRAPHICS_REQUIREMENTS_OPENGL_KHR};
-	xr_result = pfn_xrGetOpenGLGraphicsRequirementsKHR(xr_instance, xr_system_id, &graphicsRequirement);
-	if(!xrCheckResult(NULL, xr_result, "xrGetOpenGLGraphicsRequirementsKHR"))
+	}
+	if(!eglBindAPI(EGL_OPENGL_API)){
+		XR_LOG_ERROR("Unable to bind the OpenGL API to EGL");
 		return false;
+	}
 
-	std::cout << "OpenGL requirements" << std::endl;
-	std::cout << "  |-- min API version: " << XR_VERSION_MAJOR(graphicsRequirement.minApiVersionSupported) << "." << XR_VERSION_MINOR(graphicsRequirement.minApiVersionSupported) << "." << XR_VERSION_PATCH(graphicsRequirement.minApiVersionSupported) << std::endl;
-	std::cout << "  |-- max API version: " << XR_VERSION_MAJOR(graphicsRequirement.maxApiVersionSupported) << "." << XR_VERSION_MINOR(graphicsRequirement.maxApiVersionSupported) << "." << XR_VERSION_PATCH(graphicsRequirement.maxApiVersionSupported) << std::endl;
+	EGLint configAttributes[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, 
+								 EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, 
+								 EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8, 
+								 EGL_NONE};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if(!eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || !configCount){
+		XR_LOG_ERROR("Unable to find an EGL config for OpenGL");
+		return false;
+	}
+
+	// same version and profile as the SDL context
+	EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION, 4, 
+								  EGL_CONTEXT_MINOR_VERSION, 5, 
+								  EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, 
+								  EGL_NONE};
+	eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+	if(eglContext == EGL_NO_CONTEXT){
+		XR_LOG_ERROR("Unable to create EGL context (error: 0x" << std::hex << eglGetError() << std::dec << ")");
+		return false;
+	}
+
+	// surfaceless context if supported, otherwise a minimal pbuffer (the swapchain framebuffers are used for rendering)
+	const char * displayExtensions = eglQueryString(eglDisplay, EGL_EXTENSIONS);
+	if(!displayExtensions || !strstr(displayExtensions, "EGL_KHR_surfaceless_context")){
+		EGLint pbufferAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+		eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttributes);
+		if(eglSurface == EGL_NO_SURFACE){
+			XR_LOG_ERROR("Unable to create EGL pbuffer surface (error: 0x" << std::hex << eglGetError() << std::dec << ")");
+			return false;
+		}
+	}
+	if(!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)){
+		XR_LOG_ERROR("Unable to make the EGL context current (error: 0x" << std::hex << eglGetError() << std::dec << ")");
+		return false;
+	}
+
+	contextOwner = std::this_thread::get_id();
+	glEnable(GL_DEBUG_OUTPUT);
+	glDebugMessageCallback(MessageCallback, 0);
+
+	graphicsBinding->getProcAddress = eglGetProcAddress;
+	graphicsBinding->display = eglDisplay;
+	graphicsBinding->config = config;
+	eglConfig = config;
+	graphicsBinding->context = eglContext;
+
+	verboseOutput() << "EGL " << major << "." << minor << " (" << (eglSurface == EGL_NO_SURFACE ? "surfaceless" : "pbuffer") << "): " << glGetString(GL_VERSION) << std::endl;
 	return true;
 }
+#endif
 
-bool OpenGLHandler::initResources(XrInstance xr_instance, XrSystemId xr_system_id){
-	glGenTextures(1, &texture);
-	glGenVertexArrays(1, &vao);
-	glGenFramebuffers(1, &swapchainFramebuffer);
+bool OpenGLHandler::getRequirements(XrInstance xr_instance, XrSystemId xr_system_id){
+	PFN_xrGetOpenGLGraphicsRequirementsKHR pfn_xrGetOpenGLGraphicsRequirementsKHR = nullptr;
+	xr_result = xrGetInstanceProcAddr(xr_instance, "xrGetOpenGLGraphicsRequirementsKHR", reinterpret_cast<PFN_xrVoidFunction*>(&pfn_xrGetOpenGLGraphicsRequirementsKHR));
+	if(!xrCheckResult(NULL, xr_result, "xrGetOpenGLGraphicsRequirementsKHR (xrGetInstanceProcAddr)"))
+		return false;
+	XrGraphicsRequirementsOpenGLKHR graphicsRequirement = {XR_TYPE_GRAPHICS_REQUIREMENTS_OPENGL_KHR};
+	xr_result = pfn_xrGetOpenGLGraphicsRequirementsKHR(xr_instance, xr_system_id, &graphicsRequirement);
+	if(!xrCheckResult(NULL, xr_result, "xrGetOpenGLGraphicsRequirementsKHR"))
+		return false;
+
+	verboseOutput() << "OpenGL requirements" << std::endl;
+	verboseOutput() << "  |-- min API version: " << XR_VERSION_MAJOR(graphicsRequirement.minApiVersionSupported) << "." << XR_VERSION_MINOR(graphicsRequirement.minApiVersionSupported) << "." << XR_VERSION_PATCH(graphicsRequirement.minApiVersionSupported) << std::endl;
+	verboseOutput() << "  |-- max API version: " << XR_VERSION_MAJOR(graphicsRequirement.maxApiVersionSupported) << "." << XR_VERSION_MINOR(graphicsRequirement.maxApiVersionSupported) << "." << XR_VERSION_PATCH(graphicsRequirement.maxApiVersionSupported) << std::endl;
+	return true;
+}
+
+string OpenGLHandler::programCacheKey(){
+	// FNV-1a hash of the shader sources
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for(const char * source : {glslShaderVertex, glslShaderFragment})
+		for(const char * c = source; *c; c++)
+			hash = (hash ^ (uint8_t)*c) * 0x100000001b3ULL;
+
+	std::ostringstream key;
+	key << glGetString(GL_VENDOR) << "\n" << glGetString(GL_RENDERER) << "\n" << glGetString(GL_VERSION) << "\n" << std::hex << hash;
+	return key.str();
+}
+
+bool OpenGLHandler::loadProgramBinary(const string & path, const string & key){
+	FILE * file = fopen(path.c_str(), "rb");
+	if(!file)
+		return false;
+
+	ProgramCacheHeader header;
+	string storedKey;
+	vector<uint8_t> binary;
+	struct stat fileStat;
+	bool status = fread(&header, sizeof(header), 1, file) == 1 && header.magic == GL_PROGRAM_CACHE_MAGIC && header.version == GL_PROGRAM_CACHE_VERSION;
+	// the sizes are read from the file: a truncated or corrupted cache must match its length before anything is allocated
+	status = status && !fstat(fileno(file), &fileStat) && header.keySize == key.size() && 
+			 (uint64_t)fileStat.st_size == sizeof(header) + (uint64_t)header.keySize + (uint64_t)header.binarySize;
+	if(status){
+		storedKey.resize(header.keySize);
+		binary.resize(header.binarySize);
+		status = fread(&storedKey[0], 1, header.keySize, file) == header.keySize && storedKey == key && 
+				 fread(binary.data(), 1, header.binarySize, file) == header.binarySize;
+	}
+	fclose(file);
+	if(!status)
+		return false;
+
+	// the driver may still reject the binary (e.g. after an update that did not change the version string)
+	program = glCreateProgram();
+	glProgramBinary(program, header.binaryFormat, binary.data(), binary.size());
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if(linked == GL_FALSE){
+		glDeleteProgram(program);
+		program = 0;
+		return false;
+	}
+	return true;
+}
 
+void OpenGLHandler::saveProgramBinary(const string & path, const string & key){
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if(length <= 0)
+		return;
+	ProgramCacheHeader header = {GL_PROGRAM_CACHE_MAGIC, GL_PROGRAM_CACHE_VERSION, 0, (uint32_t)key.size(), 0};
+	vector<uint8_t> binary(length);
+	GLenum binaryFormat = 0;
+	glGetProgramBinary(program, length, &length, &binaryFormat, binary.data());
+	header.binaryFormat = binaryFormat;
+	header.binarySize = (uint32_t)length;
+
+	// create the cache directory (and its parent) if necessary
+	size_t separator = path.rfind('/');
+	if(separator != string::npos && separator){
+		string directory = path.substr(0, separator);
+		size_t parent = directory.rfind('/');
+		if(parent != string::npos && parent)
+			mkdir(directory.substr(0, parent).c_str(), 0755);
+		mkdir(directory.c_str(), 0755);
+	}
+
+	// write a temporary file and rename it (concurrent starts never read a partial file)
+	string temporaryPath = path + "." + std::to_string(getpid());
+	FILE * file = fopen(temporaryPath.c_str(), "wb");
+	if(!file){
+		XR_LOG_WARNING("Unable to write the program binary cache: " << path);
+		return;
+	}
+	bool status = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(key.data(), 1, key.size(), file) == key.size() && 
+				  fwrite(binary.data(), 1, header.binarySize, file) == header.binarySize;
+	status = !fclose(file) && status;
+	if(!status || rename(temporaryPath.c_str(), path.c_str())){
+		unlink(temporaryPath.c_str());
+		XR_LOG_WARNING("Unable to write the program binary cache: " << path);
+	}
+}
+
+bool OpenGLHandler::compileProgram(bool retrievable){
 	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
 	glShaderSource(vertexShader, 1, &glslShaderVertex, nullptr);
 	glCompileShader(vertexShader);
@@ -612,6 +1644,8 @@ bool OpenGLHandler::initResources(XrInstance xr_instance, XrSystemId xr_system_i
 	program = glCreateProgram();
 	glAttachShader(program, vertexShader);
 	glAttachShader(program, fragmentShader);
+	if(retrievable)
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(program);
 	if(!checkProgram(program))
 		return false;
@@ -621,245 +1655,1223 @@ bool OpenGLHandler::initResources(XrInstance xr_instance, XrSystemId xr_system_i
 	return true;
 }
 
-void OpenGLHandler::renderView(const XrCompositionLayerProjectionView & layerView, const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat){
-        glBindFramebuffer(GL_FRAMEBUFFER, swapchainFramebuffer);
+bool OpenGLHandler::initResources(XrInstance xr_instance, XrSystemId xr_system_id){
+	glCreateVertexArrays(1, &vao);
+	// visible area mesh attribute (enabled only while a mesh is drawn)
+	glVertexArrayAttribFormat(vao, 0, 2, GL_FLOAT, GL_FALSE, 0);
+	glVertexArrayAttribBinding(vao, 0, 0);
+
+	// reuse the program binary of a previous start (if the driver supports program binaries), otherwise compile and store it
+	GLint binaryFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+	string cachePath = binaryFormats > 0 ? programCachePath() : "";
+	string cacheKey = cachePath.empty() ? "" : programCacheKey();
+	if(!cachePath.empty() && loadProgramBinary(cachePath, cacheKey))
+		verboseOutput() << "OpenGL program: loaded from cache (" << cachePath << ")" << std::endl;
+	else{
+		if(!compileProgram(!cachePath.empty()))
+			return false;
+		if(!cachePath.empty()){
+			saveProgramBinary(cachePath, cacheKey);
+			verboseOutput() << "OpenGL program: compiled and stored in cache (" << cachePath << ")" << std::endl;
+		}
+	}
 
-        const uint32_t colorTexture = reinterpret_cast<const XrSwapchainImageOpenGLKHR*>(swapchainImage)->image;
+	restorePipelineState();
+	return true;
+}
 
-        glViewport(static_cast<GLint>(layerView.subImage.imageRect.offset.x),
-                   static_cast<GLint>(layerView.subImage.imageRect.offset.y),
-                   static_cast<GLsizei>(layerView.subImage.imageRect.extent.width),
-                   static_cast<GLsizei>(layerView.subImage.imageRect.extent.height));
- 		
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+void OpenGLHandler::restorePipelineState(){
+	// pipeline state set once per frame: every view is a full-viewport quad sampling the frame texture (unit 0).
+	// The runtime may change the bindings of the shared context in any OpenXR call (e.g. when creating swapchains),
+	// so the state is restored at the beginning of each frame, and not only once after creating the program
+	glUseProgram(program);
+	glBindVertexArray(vao);
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_BLEND);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+}
 
-        glUseProgram(program);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		glBindVertexArray(vao);
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+bool OpenGLHandler::prepareSwapchainImages(const SwapchainHandler & swapchain, bool depth){
+	for(size_t i = 0; i < swapchain.openglImages.size(); i++){
+		GLuint framebuffer;
+		glCreateFramebuffers(1, &framebuffer);
+		glNamedFramebufferTexture(framebuffer, depth ? GL_DEPTH_ATTACHMENT : GL_COLOR_ATTACHMENT0, swapchain.openglImages[i].image, 0);
+		if(depth)
+			glNamedFramebufferDrawBuffer(framebuffer, GL_NONE);
+		GLenum status = glCheckNamedFramebufferStatus(framebuffer, GL_DRAW_FRAMEBUFFER);
+		if(status != GL_FRAMEBUFFER_COMPLETE){
+			XR_LOG_ERROR("Incomplete framebuffer for swapchain image " << swapchain.openglImages[i].image << " (status: 0x" << std::hex << status << std::dec << ")");
+			glDeleteFramebuffers(1, &framebuffer);
+			return false;
+		}
+		swapchainFramebuffers[swapchain.openglImages[i].image] = framebuffer;
+	}
+	return true;
+}
+
+GLuint OpenGLHandler::getSwapchainFramebuffer(uint32_t image){
+	// framebuffer 0 (the window) must never be drawn into nor blitted from in place of a swapchain image
+	auto framebuffer = swapchainFramebuffers.find(image);
+	if(framebuffer == swapchainFramebuffers.end()){
+		XR_LOG_ERROR("No framebuffer for swapchain image " << image << ". The image is not rendered");
+		return 0;
+	}
+	return framebuffer->second;
+}
 
-		glBindTexture(GL_TEXTURE_2D, 0);
-		glUseProgram(0);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void OpenGLHandler::releaseSwapchainImages(const SwapchainHandler & swapchain){
+	for(size_t i = 0; i < swapchain.openglImages.size(); i++){
+		auto framebuffer = swapchainFramebuffers.find(swapchain.openglImages[i].image);
+		if(framebuffer == swapchainFramebuffers.end())
+			continue;
+		glDeleteFramebuffers(1, &framebuffer->second);
+		swapchainFramebuffers.erase(framebuffer);
+	}
+}
 
-		// render to window
-		int width, height;
-		SDL_GetWindowSize(sdl_window, &width, &height);
-		glViewport(0, 0, width, height);
+void OpenGLHandler::setVisibleArea(int view, const std::vector<XrVector2f> & vertices, const std::vector<uint32_t> & indices){
+	if(view < 0)
+		return;
+	// the upload worker may be reading the area of the view
+	std::unique_lock<std::mutex> lock(uploadMutex);
+	uploadDoneCondition.wait(lock, [this, view]{ return !uploadEnabled || uploadActive != view; });
+	if((size_t)view >= visibleAreas.size()){
+		visibleAreas.resize(view + 1);
+		visibleAreaVertexBuffers.resize(view + 1, 0);
+		visibleAreaIndexBuffers.resize(view + 1, 0);
+	}
+	visibleAreas[view] = VisibleArea();
+	visibleAreas[view].vertices = vertices;
+	visibleAreas[view].indices = indices;
+
+	// immutable buffers, re-created when the mask changes
+	if(visibleAreaVertexBuffers[view]){
+		glDeleteBuffers(1, &visibleAreaVertexBuffers[view]);
+		glDeleteBuffers(1, &visibleAreaIndexBuffers[view]);
+		visibleAreaVertexBuffers[view] = visibleAreaIndexBuffers[view] = 0;
+	}
+	if(indices.empty())
+		return;
+	glCreateBuffers(1, &visibleAreaVertexBuffers[view]);
+	glNamedBufferStorage(visibleAreaVertexBuffers[view], vertices.size() * sizeof(XrVector2f), vertices.data(), 0);
+	glCreateBuffers(1, &visibleAreaIndexBuffers[view]);
+	glNamedBufferStorage(visibleAreaIndexBuffers[view], indices.size() * sizeof(uint32_t), indices.data(), 0);
+}
 
-		glUseProgram(program);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		glBindVertexArray(vao);
+void OpenGLHandler::uploadFrame(GLuint frameTexture, int view, int frameWidth, int frameHeight, void * frameData, bool rgba){
+	GLenum format = rgba ? GL_RGBA : GL_RGB;
+	if(view < 0 || (size_t)view >= visibleAreas.size() || !updateVisibleRects(visibleAreas[view], frameWidth, frameHeight)){
+		glTextureSubImage2D(frameTexture, 0, 0, 0, frameWidth, frameHeight, format, GL_UNSIGNED_BYTE, frameData);
+		return;
+	}
+	// visible bands only (XR_KHR_visibility_mask): the rows of the frame are addressed through the unpack state
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, frameWidth);
+	for(const XrRect2Di & rect : visibleAreas[view].rects){
+		glPixelStorei(GL_UNPACK_SKIP_PIXELS, rect.offset.x);
+		glPixelStorei(GL_UNPACK_SKIP_ROWS, rect.offset.y);
+		glTextureSubImage2D(frameTexture, 0, rect.offset.x, rect.offset.y, rect.extent.width, rect.extent.height, format, GL_UNSIGNED_BYTE, frameData);
+	}
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+}
+
+void OpenGLHandler::renderView(const XrCompositionLayerProjectionView & layerView, const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int view){
+	const uint32_t colorTexture = reinterpret_cast<const XrSwapchainImageOpenGLKHR*>(swapchainImage)->image;
+	const XrRect2Di & rect = layerView.subImage.imageRect;
+	GLuint framebuffer = getSwapchainFramebuffer(colorTexture);
+	if(!framebuffer)
+		return;
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+	glViewport(rect.offset.x, rect.offset.y, rect.extent.width, rect.extent.height);
+	// visible triangles only (XR_KHR_visibility_mask): the hidden area of the swapchain image is not written
+	if(view >= 0 && (size_t)view < visibleAreaIndexBuffers.size() && visibleAreaIndexBuffers[view]){
+		glProgramUniform1i(program, 0, 1);
+		glVertexArrayVertexBuffer(vao, 0, visibleAreaVertexBuffers[view], 0, sizeof(XrVector2f));
+		glVertexArrayElementBuffer(vao, visibleAreaIndexBuffers[view]);
+		glEnableVertexArrayAttrib(vao, 0);
+		glDrawElements(GL_TRIANGLES, (GLsizei)visibleAreas[view].indices.size(), GL_UNSIGNED_INT, nullptr);
+		glDisableVertexArrayAttrib(vao, 0);
+		glProgramUniform1i(program, 0, 0);
+	}
+	else
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
 
-        // swap window every other eye
-        static int everyOther = 0;
-        if((everyOther++ & 1) != 0)
-			SDL_GL_SwapWindow(sdl_window);
+void OpenGLHandler::renderViewFromImage(const XrCompositionLayerProjectionView & layerView, const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int frameWidth, int frameHeight, void * frameData, bool rgba, int view){
+	// load texture: immutable storage, re-created only when the frame size changes
+	if(frameWidth != textureWidth || frameHeight != textureHeight){
+		if(texture)
+			glDeleteTextures(1, &texture);
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+		glTextureStorage2D(texture, 1, GL_RGBA8, frameWidth, frameHeight);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		textureWidth = frameWidth;
+		textureHeight = frameHeight;
+	}
+	uploadFrame(texture, view, frameWidth, frameHeight, frameData, rgba);
+	// the upload worker binds its own textures (e.g. the eye frames are uploaded by the worker and the quad layers here)
+	glBindTextureUnit(0, texture);
 
-		glBindTexture(GL_TEXTURE_2D, 0);
-		glUseProgram(0);
+	// render to hmd
+	renderView(layerView, swapchainImage, swapchainFormat, view);
 }
 
-void OpenGLHandler::renderViewFromImage(const XrCompositionLayerProjectionView & layerView, const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int frameWidth, int frameHeight, void * frameData, bool rgba){
-		// load texture
-		glBindTexture(GL_TEXTURE_2D, texture);
+void OpenGLHandler::renderDepthFromImage(const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int width, int height, 
+										 int depthWidth, int depthHeight, const float * depthData, float nearZ, float farZ){
+	// load the linear depth: immutable storage, re-created only when the depth size changes (nearest sampling: depth is not interpolated across edges)
+	if(depthWidth != depthTextureWidth || depthHeight != depthTextureHeight){
+		if(depthTexture)
+			glDeleteTextures(1, &depthTexture);
+		glCreateTextures(GL_TEXTURE_2D, 1, &depthTexture);
+		glTextureStorage2D(depthTexture, 1, GL_R32F, depthWidth, depthHeight);
+		glTextureParameteri(depthTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(depthTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(depthTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureParameteri(depthTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		depthTextureWidth = depthWidth;
+		depthTextureHeight = depthHeight;
+	}
+	glTextureSubImage2D(depthTexture, 0, 0, 0, depthWidth, depthHeight, GL_RED, GL_FLOAT, depthData);
+
+	const uint32_t depthImage = reinterpret_cast<const XrSwapchainImageOpenGLKHR*>(swapchainImage)->image;
+	GLuint framebuffer = getSwapchainFramebuffer(depthImage);
+	if(!framebuffer)
+		return;
+
+	// the depth is drawn (scaled) over the given rectangle, as the frames drawn by renderView, and converted to window depth by the fragment shader
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+	glViewport(0, 0, width, height);
+	glBindTextureUnit(0, depthTexture);
+	glProgramUniform1i(program, 1, 1);
+	glProgramUniform4f(program, 2, nearZ, farZ, farZ / (farZ - nearZ), farZ * nearZ / (farZ - nearZ));
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_ALWAYS);
+	glDepthMask(GL_TRUE);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glDisable(GL_DEPTH_TEST);
+	glProgramUniform1i(program, 1, 0);
+}
 
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, frameWidth, frameHeight, 0, rgba ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, frameData);
+void OpenGLHandler::renderMotionVectorsFromImage(const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int motionVectorWidth, int motionVectorHeight, const float * motionVectorData){
+	// the first row is uploaded at the bottom of the image, as the depth frames (the driver converts the floats to the swapchain format)
+	const uint32_t motionVectorTexture = reinterpret_cast<const XrSwapchainImageOpenGLKHR*>(swapchainImage)->image;
+	glTextureSubImage2D(motionVectorTexture, 0, 0, 0, motionVectorWidth, motionVectorHeight, GL_RGBA, GL_FLOAT, motionVectorData);
+}
 
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+void OpenGLHandler::renderCubeFromImages(const XrSwapchainImageBaseHeader * swapchainImage, int64_t swapchainFormat, int faceSize, const void * facesData, bool rgba){
+	// the faces (+X, -X, +Y, -Y, +Z, -Z) are the layers of the cube map texture, copied with their first row at the top, as cube maps are sampled
+	const uint32_t cubeTexture = reinterpret_cast<const XrSwapchainImageOpenGLKHR*>(swapchainImage)->image;
+	glTextureSubImage3D(cubeTexture, 0, 0, 0, 0, faceSize, faceSize, 6, rgba ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, facesData);
+}
 
-		// render to hmd
-        glBindFramebuffer(GL_FRAMEBUFFER, swapchainFramebuffer);
+void OpenGLHandler::setMirror(bool enable, float scale, float rate){
+	mirrorEnabled = enable;
+	mirrorScale = scale;
+	mirrorInterval = 1.0 / rate;
+	mirrorLastTime = std::chrono::steady_clock::time_point();
+	if(enable && !sdl_window)
+		XR_LOG_WARNING("Desktop mirror requires the SDL window (not available with EGL or without graphics binding)");
+	// the window is shown (and sized) on the first mirrored frame
+	if(!enable && mirrorWindowShown){
+		SDL_HideWindow(sdl_window);
+		mirrorWindowShown = false;
+	}
+}
 
-        const uint32_t colorTexture = reinterpret_cast<const XrSwapchainImageOpenGLKHR*>(swapchainImage)->image;
+void OpenGLHandler::renderMirror(const XrCompositionLayerProjectionView & layerView, const XrSwapchainImageBaseHeader * swapchainImage){
+	if(!mirrorEnabled || !sdl_window)
+		return;
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if(std::chrono::duration<double>(now - mirrorLastTime).count() < mirrorInterval)
+		return;
+	mirrorLastTime = now;
+
+	const XrRect2Di & rect = layerView.subImage.imageRect;
+	if(!mirrorWindowShown){
+		SDL_SetWindowSize(sdl_window, std::max(1, (int)(rect.extent.width * mirrorScale)), std::max(1, (int)(rect.extent.height * mirrorScale)));
+		SDL_ShowWindow(sdl_window);
+		mirrorWindowShown = true;
+	}
+	// the window may have been resized by the user
+	int width, height;
+	SDL_GetWindowSize(sdl_window, &width, &height);
+
+	// blit (downscale) the swapchain image into the window: no shader or texture upload
+	const uint32_t colorTexture = reinterpret_cast<const XrSwapchainImageOpenGLKHR*>(swapchainImage)->image;
+	GLuint framebuffer = getSwapchainFramebuffer(colorTexture);
+	if(!framebuffer)
+		return;
+	glBlitNamedFramebuffer(framebuffer, 0, rect.offset.x, rect.offset.y, rect.offset.x + rect.extent.width, rect.offset.y + rect.extent.height, 
+						   0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+	// single-buffered window and swap interval 0: the swap does not wait for the desktop vertical sync
+	SDL_GL_SwapWindow(sdl_window);
+}
 
-        glViewport(static_cast<GLint>(layerView.subImage.imageRect.offset.x),
-                   static_cast<GLint>(layerView.subImage.imageRect.offset.y),
-                   static_cast<GLsizei>(layerView.subImage.imageRect.extent.width),
-                   static_cast<GLsizei>(layerView.subImage.imageRect.extent.height));
- 		
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+bool OpenGLHandler::startUploadWorker(int viewCount){
+	if(uploadEnabled)
+		return true;
 
-        glUseProgram(program);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		glBindVertexArray(vao);
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	// shared context: created on the compositor thread and made current on the worker thread
+#ifdef XR_USE_PLATFORM_EGL
+	if(eglContext != EGL_NO_CONTEXT){
+		EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION, 4, 
+									  EGL_CONTEXT_MINOR_VERSION, 5, 
+									  EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, 
+									  EGL_NONE};
+		eglUploadContext = eglCreateContext(eglDisplay, eglConfig, eglContext, contextAttributes);
+		if(eglUploadContext == EGL_NO_CONTEXT){
+			XR_LOG_ERROR("Unable to create the EGL upload context (error: 0x" << std::hex << eglGetError() << std::dec << ")");
+			return false;
+		}
+		// a surface can only be current on one thread
+		if(eglSurface != EGL_NO_SURFACE){
+			EGLint pbufferAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+			eglUploadSurface = eglCreatePbufferSurface(eglDisplay, eglConfig, pbufferAttributes);
+			if(eglUploadSurface == EGL_NO_SURFACE){
+				XR_LOG_ERROR("Unable to create the EGL upload pbuffer surface (error: 0x" << std::hex << eglGetError() << std::dec << ")");
+				return false;
+			}
+		}
+	}
+	else
+#endif
+	if(gl_context){
+		SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+		uploadGlContext = SDL_GL_CreateContext(sdl_window);
+		SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+		// SDL makes the new context current
+		SDL_GL_MakeCurrent(sdl_window, gl_context);
+		if(!uploadGlContext){
+			XR_LOG_ERROR("Unable to create the OpenGL upload context (" << SDL_GetError() << ")");
+			return false;
+		}
+	}
+	else{
+		XR_LOG_ERROR("Unable to create the upload context: no OpenGL context");
+		return false;
+	}
 
-		glBindTexture(GL_TEXTURE_2D, 0);
-		glUseProgram(0);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	uploadJobs.assign(viewCount, UploadJob());
+	uploadTextures.assign(viewCount, vector<UploadTexture>(GL_UPLOAD_RING_SIZE));
+	uploadPublished.assign(viewCount, -1);
+	uploadSampling.assign(viewCount, -1);
+	uploadSubmitted = uploadCompleted = 0;
+	uploadActive = -1;
+	uploadStop = false;
+	uploadEnabled = true;
+	uploadThread = std::thread(&OpenGLHandler::uploadLoop, this);
+	return true;
+}
 
-		// // render to window
-		// int width, height;
-		// SDL_GetWindowSize(sdl_window, &width, &height);
-		// glViewport(0, 0, width, height);
+void OpenGLHandler::stopUploadWorker(){
+	{
+		std::lock_guard<std::mutex> lock(uploadMutex);
+		uploadStop = true;
+		uploadEnabled = false;
+	}
+	uploadCondition.notify_all();
+	uploadDoneCondition.notify_all();
+	if(uploadThread.joinable())
+		uploadThread.join();
+}
 
-		// glUseProgram(program);
-		// glBindTexture(GL_TEXTURE_2D, texture);
-		// glBindVertexArray(vao);
-		// glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+void OpenGLHandler::uploadLoop(){
+	bool current = false;
+#ifdef XR_USE_PLATFORM_EGL
+	if(eglUploadContext != EGL_NO_CONTEXT)
+		current = eglMakeCurrent(eglDisplay, eglUploadSurface, eglUploadSurface, eglUploadContext) == EGL_TRUE;
+	else
+#endif
+	current = SDL_GL_MakeCurrent(sdl_window, uploadGlContext) == 0;
+
+	std::unique_lock<std::mutex> lock(uploadMutex);
+	if(!current){
+		XR_LOG_ERROR("Unable to make the upload context current. Frames are uploaded in the frame loop");
+		uploadEnabled = false;
+		uploadDoneCondition.notify_all();
+		return;
+	}
+	// pixel store state is per context
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-        // // swap window every other eye
-        // static int everyOther = 0;
-        // if((everyOther++ & 1) != 0)
-		// 	SDL_GL_SwapWindow(sdl_window);
+	while(true){
+		int view = -1;
+		uploadCondition.wait(lock, [this, &view]{
+			for(size_t i = 0; i < uploadJobs.size() && view < 0; i++)
+				if(uploadJobs[i].pending)
+					view = i;
+			return uploadStop || view >= 0;
+		});
+		if(uploadStop)
+			break;
+		UploadJob job = uploadJobs[view];
+		uploadJobs[view].pending = false;
+		uploadActive = view;
+
+		// next texture of the ring that is neither published nor being drawn
+		int index = uploadPublished[view];
+		do
+			index = (index + 1) % GL_UPLOAD_RING_SIZE;
+		while(index == uploadPublished[view] || index == uploadSampling[view]);
+		UploadTexture & slot = uploadTextures[view][index];
+		GLsync drawFence = slot.drawFence;
+		GLsync uploadFence = slot.uploadFence;
+		slot.drawFence = slot.uploadFence = nullptr;
+		lock.unlock();
+
+		// the previous draw sampling this texture must complete before overwriting it (GPU-side wait)
+		if(drawFence){
+			glWaitSync(drawFence, 0, GL_TIMEOUT_IGNORED);
+			glDeleteSync(drawFence);
+		}
+		if(uploadFence)
+			glDeleteSync(uploadFence);
+
+		if(slot.width != job.width || slot.height != job.height){
+			if(slot.texture)
+				glDeleteTextures(1, &slot.texture);
+			glCreateTextures(GL_TEXTURE_2D, 1, &slot.texture);
+			glTextureStorage2D(slot.texture, 1, GL_RGBA8, job.width, job.height);
+			glTextureParameteri(slot.texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(slot.texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(slot.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(slot.texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			slot.width = job.width;
+			slot.height = job.height;
+		}
+		// the frame data is copied before glTextureSubImage2D returns
+		uploadFrame(slot.texture, view, job.width, job.height, job.data, job.rgba);
+		GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		// the fence must be flushed to be waited on from the compositor context
+		glFlush();
+
+		lock.lock();
+		slot.uploadFence = fence;
+		uploadPublished[view] = index;
+		uploadActive = -1;
+		uploadCompleted++;
+		uploadDoneCondition.notify_all();
+	}
+	lock.unlock();
+
+#ifdef XR_USE_PLATFORM_EGL
+	if(eglUploadContext != EGL_NO_CONTEXT)
+		eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	else
+#endif
+	SDL_GL_MakeCurrent(sdl_window, nullptr);
+}
+
+void OpenGLHandler::submitFrame(int view, int frameWidth, int frameHeight, void * frameData, bool rgba){
+	std::unique_lock<std::mutex> lock(uploadMutex);
+	if(!uploadEnabled || view < 0 || (size_t)view >= uploadJobs.size())
+		return;
+	// the previous frame of the view must not be read after returning (the caller may release it)
+	uploadDoneCondition.wait(lock, [this, view]{ return !uploadEnabled || uploadActive != view; });
+	// a frame still pending for the same view is replaced (only the latest one is composed)
+	if(!uploadJobs[view].pending)
+		uploadSubmitted++;
+	uploadJobs[view].pending = true;
+	uploadJobs[view].width = frameWidth;
+	uploadJobs[view].height = frameHeight;
+	uploadJobs[view].data = frameData;
+	uploadJobs[view].rgba = rgba;
+	uploadCondition.notify_one();
+}
+
+void OpenGLHandler::waitUploads(){
+	// the frames are set before the swapchain images are acquired, so the uploads are usually complete
+	std::unique_lock<std::mutex> lock(uploadMutex);
+	uploadDoneCondition.wait(lock, [this]{ return !uploadEnabled || uploadCompleted == uploadSubmitted; });
+}
 
-		// glBindTexture(GL_TEXTURE_2D, 0);
-		// glUseProgram(0);
+int OpenGLHandler::getFenceCount(){
+	// the fences are stored in the upload textures (the worker only holds them while deleting them)
+	std::lock_guard<std::mutex> lock(uploadMutex);
+	int count = 0;
+	for(size_t i = 0; i < uploadTextures.size(); i++)
+		for(size_t j = 0; j < uploadTextures[i].size(); j++)
+			count += (uploadTextures[i][j].uploadFence != nullptr) + (uploadTextures[i][j].drawFence != nullptr);
+	return count;
+}
+
+bool OpenGLHandler::renderViewFromUpload(const XrCompositionLayerProjectionView & layerView, const XrSwapchainImageBaseHeader * swapchainImage, int view){
+	GLuint uploadTexture;
+	GLsync uploadFence;
+	{
+		std::lock_guard<std::mutex> lock(uploadMutex);
+		if(!uploadEnabled || view < 0 || (size_t)view >= uploadPublished.size() || uploadPublished[view] < 0)
+			return false;
+		uploadSampling[view] = uploadPublished[view];
+		uploadTexture = uploadTextures[view][uploadSampling[view]].texture;
+		uploadFence = uploadTextures[view][uploadSampling[view]].uploadFence;
+	}
+
+	// GPU-side wait (the fence is usually already signaled)
+	if(uploadFence)
+		glWaitSync(uploadFence, 0, GL_TIMEOUT_IGNORED);
+	glBindTextureUnit(0, uploadTexture);
+	renderView(layerView, swapchainImage, 0, view);
+	GLsync drawFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush();
+
+	std::lock_guard<std::mutex> lock(uploadMutex);
+	UploadTexture & slot = uploadTextures[view][uploadSampling[view]];
+	if(slot.drawFence)
+		glDeleteSync(slot.drawFence);
+	slot.drawFence = drawFence;
+	uploadSampling[view] = -1;
+	return true;
 }
 
 #endif
 
 
 
+// session record and replay
+// append-only binary log: file header followed by records (RecordHeader + payload)
+
+#define SESSION_LOG_MAGIC 0x474f4c5253525853ULL		// "SXRSRLOG" (little-endian)
+#define SESSION_LOG_VERSION 1
+
+enum SessionLogRecordType{
+	SESSION_LOG_RECORD_CONFIGURATION = 1,	// RecordConfiguration + XrViewConfigurationView[viewCount]
+	SESSION_LOG_RECORD_PATH = 2,			// uint32_t id + path characters
+	SESSION_LOG_RECORD_ACTIONS = 3,			// RecordActions + RecordActionState[count]
+	SESSION_LOG_RECORD_FRAME = 4,			// RecordFrame + RecordView[viewCount] + RecordActionPose[poseCount]
+};
+
+#pragma pack(push, 1)
+struct SessionLogHeader{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t reserved;
+};
+
+struct RecordHeader{
+	uint32_t type;
+	uint32_t size;
+};
+
+struct RecordConfiguration{
+	int32_t viewConfigurationType;
+	int32_t environmentBlendMode;
+	uint32_t viewCount;
+};
+
+struct RecordActions{
+	uint64_t timestamp;			// nanoseconds since the recording started
+	uint32_t count;
+};
+
+struct RecordActionState{
+	uint32_t pathId;
+	int32_t type;
+	uint8_t isActive;
+	uint8_t stateBool;
+	float stateFloat;
+	float stateVectorX;
+	float stateVectorY;
+};
+
+struct RecordFrame{
+	uint64_t timestamp;			// nanoseconds since the recording started
+	int64_t predictedDisplayTime;
+	int64_t predictedDisplayPeriod;
+	uint32_t referenceSpaceType;
+	uint8_t shouldRender;
+	uint32_t viewCount;
+	uint32_t poseCount;
+};
+
+struct RecordView{
+	XrPosef pose;
+	XrFovf fov;
+};
+
+struct RecordActionPose{
+	uint32_t pathId;
+	uint8_t isActive;
+	XrPosef pose;
+};
+#pragma pack(pop)
 
-class OpenXrApplication{
+class SessionRecorder{
 private:
-	XrResult xr_result;
+	FILE * file = nullptr;
+	size_t framesSinceFlush = 0;
+	std::chrono::steady_clock::time_point startTime;
+	map<string, uint32_t> pathIds;
 
-	XrInstance xr_instance = {};
-	XrSystemId xr_system_id = XR_NULL_SYSTEM_ID;
-	XrSession xr_session = {};
+	vector<uint8_t> buffer;
 
-	XrSpace xr_space_view = {};
-	XrSpace xr_space_local = {};
-	XrSpace xr_space_stage = {};
+	uint64_t timestamp(){
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+	}
+	uint32_t pathId(const char * path){
+		auto it = pathIds.find(path);
+		if(it != pathIds.end())
+			return it->second;
+		uint32_t id = pathIds.size();
+		pathIds[path] = id;
+		buffer.clear();
+		append(&id, sizeof(id));
+		append(path, strlen(path));
+		write(SESSION_LOG_RECORD_PATH);
+		return id;
+	}
+	void append(const void * data, size_t size){
+		const uint8_t * bytes = (const uint8_t*)data;
+		buffer.insert(buffer.end(), bytes, bytes + size);
+	}
+	void write(uint32_t type){
+		RecordHeader header = {type, (uint32_t)buffer.size()};
+		fwrite(&header, sizeof(header), 1, file);
+		fwrite(buffer.data(), buffer.size(), 1, file);
+	}
 
-	// actions
-	XrActionSet xr_action_set;
-	Actions xr_actions;
+public:
+	~SessionRecorder(){ stop(); }
 
-	vector<SwapchainHandler> xr_swapchains_handlers;
-	vector<XrViewConfigurationView> xr_view_configuration_views;
+	bool isOpen(){ return file != nullptr; }
 
-	bool xr_frames_is_rgba;
-	vector<int> xr_frames_width;
-	vector<int> xr_frames_height;
-	vector<void*> xr_frames_data;
-	void (*renderCallback)(int, XrView*, XrViewConfigurationView*);
-	function<void(int, vector<XrView>, vector<XrViewConfigurationView>)> renderCallbackFunction;
+	bool start(const string & path, XrViewConfigurationType viewConfigurationType, XrEnvironmentBlendMode environmentBlendMode, const vector<XrViewConfigurationView> & views){
+		stop();
+		file = fopen(path.c_str(), "wb");
+		if(!file){
+			XR_LOG_ERROR("Unable to open session log " << path);
+			return false;
+		}
+		// large buffer: records are flushed to disk periodically, not on every write
+		setvbuf(file, nullptr, _IOFBF, 1 << 20);
+		startTime = std::chrono::steady_clock::now();
+		pathIds.clear();
+		buffer.reserve(4096);
+
+		SessionLogHeader header = {SESSION_LOG_MAGIC, SESSION_LOG_VERSION, 0};
+		fwrite(&header, sizeof(header), 1, file);
+
+		RecordConfiguration configuration = {viewConfigurationType, environmentBlendMode, (uint32_t)views.size()};
+		buffer.clear();
+		append(&configuration, sizeof(configuration));
+		append(views.data(), views.size() * sizeof(XrViewConfigurationView));
+		write(SESSION_LOG_RECORD_CONFIGURATION);
+		return true;
+	}
 
-	bool flagSessionRunning = false;
+	void stop(){
+		if(file){
+			fclose(file);
+			file = nullptr;
+		}
+	}
 
-	// config
-	XrEnvironmentBlendMode environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_MAX_ENUM;
-	XrViewConfigurationType configViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_MAX_ENUM;
+	void recordActions(const vector<ActionState> & actionStates){
+		if(!file)
+			return;
+		vector<RecordActionState> states(actionStates.size());
+		for(size_t i = 0; i < actionStates.size(); i++){
+			states[i].pathId = pathId(actionStates[i].path);
+			states[i].type = actionStates[i].type;
+			states[i].isActive = actionStates[i].isActive;
+			states[i].stateBool = actionStates[i].stateBool;
+			states[i].stateFloat = actionStates[i].stateFloat;
+			states[i].stateVectorX = actionStates[i].stateVectorX;
+			states[i].stateVectorY = actionStates[i].stateVectorY;
+		}
+		RecordActions actions = {timestamp(), (uint32_t)states.size()};
+		buffer.clear();
+		append(&actions, sizeof(actions));
+		append(states.data(), states.size() * sizeof(RecordActionState));
+		write(SESSION_LOG_RECORD_ACTIONS);
+	}
 
-#ifdef XR_USE_GRAPHICS_API_VULKAN
-	XrGraphicsBindingVulkan2KHR xr_graphics_binding = {XR_TYPE_GRAPHICS_BINDING_VULKAN2_KHR};
-	VulkanHandler xr_graphics_handler;
-#endif
-#ifdef XR_USE_GRAPHICS_API_OPENGL
-	XrGraphicsBindingOpenGLXlibKHR xr_graphics_binding = {XR_TYPE_GRAPHICS_BINDING_OPENGL_XLIB_KHR};
-	OpenGLHandler xr_graphics_handler;
-#endif
+	void recordFrame(const XrFrameState & frameState, XrReferenceSpaceType referenceSpaceType, const vector<XrView> & views, const vector<ActionPoseState> & actionPoseStates){
+		if(!file)
+			return;
+		vector<RecordActionPose> poses(actionPoseStates.size());
+		for(size_t i = 0; i < actionPoseStates.size(); i++){
+			poses[i].pathId = pathId(actionPoseStates[i].path);
+			poses[i].isActive = actionPoseStates[i].isActive;
+			poses[i].pose = actionPoseStates[i].pose;
+		}
+		RecordFrame frame = {timestamp(), frameState.predictedDisplayTime, frameState.predictedDisplayPeriod, (uint32_t)referenceSpaceType, 
+							 (uint8_t)frameState.shouldRender, (uint32_t)views.size(), (uint32_t)poses.size()};
+		buffer.clear();
+		append(&frame, sizeof(frame));
+		for(size_t i = 0; i < views.size(); i++){
+			RecordView view = {views[i].pose, views[i].fov};
+			append(&view, sizeof(view));
+		}
+		append(poses.data(), poses.size() * sizeof(RecordActionPose));
+		write(SESSION_LOG_RECORD_FRAME);
 
-	bool defineLayers(const vector<string> &, vector<string> &);
-	bool defineExtensions(const vector<string> &, vector<string> &);
-
-	bool acquireInstanceProperties();
-	bool acquireSystemProperties();
-	bool acquireViewConfiguration(XrViewConfigurationType);
-	bool acquireBlendModes(XrEnvironmentBlendMode);
-
-	bool defineReferenceSpaces();
-	void defineInteractionProfileBindings(vector<XrActionSuggestedBinding> &, const vector<string> &);
-	bool suggestInteractionProfileBindings();
-	bool defineSessionSpaces();
-	bool defineSwapchains();
-
-	void cleanFrames(){
-		// for(size_t i = 0; i < xr_frames_data.size(); i++){
-		// 	xr_frames_data[i] = nullptr;
-		// 	xr_frames_width[i] = 0;
-		// 	xr_frames_height[i] = 0;
-		// }
-	};
+		if(++framesSinceFlush >= 64){
+			fflush(file);
+			framesSinceFlush = 0;
+		}
+	}
+};
+
+class SessionReplayer{
+private:
+	const uint8_t * data = nullptr;
+	size_t size = 0;
+	size_t actionsOffset = 0;
+	size_t frameOffset = 0;
+	float speed = 0;
+	std::chrono::steady_clock::time_point startTime;
+	bool finished = false;
+
+	map<uint32_t, string> paths;
+	RecordConfiguration configuration = {};
+	vector<XrViewConfigurationView> viewConfigurationViews;
+
+	// find the next record of the given type starting at offset (path records are always indexed)
+	const RecordHeader * next(uint32_t type, size_t & offset){
+		while(offset + sizeof(RecordHeader) <= size){
+			const RecordHeader * header = (const RecordHeader*)(data + offset);
+			if(offset + sizeof(RecordHeader) + header->size > size)
+				break;
+			offset += sizeof(RecordHeader) + header->size;
+			if(header->type == SESSION_LOG_RECORD_PATH && header->size >= sizeof(uint32_t)){
+				const uint8_t * payload = (const uint8_t*)(header + 1);
+				uint32_t id;
+				memcpy(&id, payload, sizeof(id));
+				if(paths.find(id) == paths.end())
+					paths[id] = string((const char*)payload + sizeof(id), header->size - sizeof(id));
+			}
+			if(header->type == type)
+				return header;
+		}
+		return nullptr;
+	}
+	// truncated or corrupt record: the replay stops as if the log ended (the actions are still replayed without error)
+	bool stop(const char * record){
+		XR_LOG_ERROR("Corrupt session log (" << record << " record). Replay stopped");
+		finished = true;
+		return false;
+	}
+	// path of a recorded identifier (nullptr if the identifier was not recorded)
+	const char * pathString(uint32_t id){
+		auto it = paths.find(id);
+		return it == paths.end() ? nullptr : it->second.c_str();
+	}
+	// throttle the replay (speed > 0) to the recorded timestamps
+	void throttle(uint64_t timestamp){
+		if(speed <= 0)
+			return;
+		auto target = startTime + std::chrono::nanoseconds((uint64_t)(timestamp / speed));
+		std::this_thread::sleep_until(target);
+	}
 
 public:
-	OpenXrApplication();
-	~OpenXrApplication();
+	~SessionReplayer(){ close(); }
+
+	bool isOpen(){ return data != nullptr; }
+	bool isFinished(){ return finished; }
+	XrViewConfigurationType getViewConfigurationType(){ return XrViewConfigurationType(configuration.viewConfigurationType); }
+	XrEnvironmentBlendMode getEnvironmentBlendMode(){ return XrEnvironmentBlendMode(configuration.environmentBlendMode); }
+	vector<XrViewConfigurationView> getViewConfigurationViews(){ return viewConfigurationViews; }
+
+	bool open(const string & path, float replaySpeed){
+		close();
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if(fd < 0){
+			XR_LOG_ERROR("Unable to open session log " << path);
+			return false;
+		}
+		struct stat fileStat;
+		if(fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(SessionLogHeader)){
+			XR_LOG_ERROR("Invalid session log " << path);
+			::close(fd);
+			return false;
+		}
+		void * address = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if(address == MAP_FAILED){
+			XR_LOG_ERROR("Unable to map session log " << path);
+			return false;
+		}
+		data = (const uint8_t*)address;
+		size = fileStat.st_size;
 
-    bool destroy();
+		const SessionLogHeader * header = (const SessionLogHeader*)data;
+		if(header->magic != SESSION_LOG_MAGIC || header->version != SESSION_LOG_VERSION){
+			XR_LOG_ERROR("Invalid session log header (magic or version) " << path);
+			close();
+			return false;
+		}
 
-	bool createInstance(const string &, const string &, const vector<string> &, const vector<string> &);
-	bool getSystem(XrFormFactor, XrEnvironmentBlendMode, XrViewConfigurationType); 
-	bool createSession();
-	bool pollEvents(bool *);
-	bool pollActions(vector<ActionState> &);
-	bool renderViews(XrReferenceSpaceType, vector<ActionPoseState> &);
+		// configuration
+		size_t offset = sizeof(SessionLogHeader);
+		const RecordHeader * record = next(SESSION_LOG_RECORD_CONFIGURATION, offset);
+		if(!record || record->size < sizeof(RecordConfiguration)){
+			XR_LOG_ERROR("Session log without configuration " << path);
+			close();
+			return false;
+		}
+		memcpy(&configuration, record + 1, sizeof(configuration));
+		if(record->size < sizeof(RecordConfiguration) + (uint64_t)configuration.viewCount * sizeof(XrViewConfigurationView)){
+			XR_LOG_ERROR("Session log with truncated configuration " << path);
+			close();
+			return false;
+		}
+		viewConfigurationViews.resize(configuration.viewCount);
+		memcpy(viewConfigurationViews.data(), (const uint8_t*)(record + 1) + sizeof(configuration), configuration.viewCount * sizeof(XrViewConfigurationView));
+		for(size_t i = 0; i < viewConfigurationViews.size(); i++)
+			viewConfigurationViews[i].next = nullptr;
+
+		actionsOffset = offset;
+		frameOffset = offset;
+		speed = replaySpeed;
+		finished = false;
+		startTime = std::chrono::steady_clock::now();
+		return true;
+	}
 
-	bool addAction(string, XrActionType, XrReferenceSpaceType);
-	bool applyHapticFeedback(string, XrHapticBaseHeader *);
-	bool stopHapticFeedback(string);
+	void close(){
+		if(data)
+			munmap((void*)data, size);
+		data = nullptr;
+		size = 0;
+		paths.clear();
+		viewConfigurationViews.clear();
+	}
 
-	bool setFrameByIndex(int, int, int, void *, bool);
-	void setRenderCallbackFromPointer(void (*callback)(int, XrView*, XrViewConfigurationView*)){ renderCallback = callback; };
-	void setRenderCallbackFromFunction(function<void(int, vector<XrView>, vector<XrViewConfigurationView>)> &callback){ renderCallbackFunction = callback; };
+	bool replayActions(vector<ActionState> & actionStates){
+		const RecordHeader * record = next(SESSION_LOG_RECORD_ACTIONS, actionsOffset);
+		if(!record)
+			return true;
+		RecordActions actions;
+		if(record->size < sizeof(actions)){
+			stop("actions");
+			return true;
+		}
+		memcpy(&actions, record + 1, sizeof(actions));
+		if(record->size < sizeof(actions) + (uint64_t)actions.count * sizeof(RecordActionState)){
+			stop("actions");
+			return true;
+		}
+		const uint8_t * payload = (const uint8_t*)(record + 1) + sizeof(actions);
+		for(uint32_t i = 0; i < actions.count; i++){
+			RecordActionState recordState;
+			memcpy(&recordState, payload + i * sizeof(RecordActionState), sizeof(recordState));
+			ActionState state;
+			state.type = XrActionType(recordState.type);
+			state.path = pathString(recordState.pathId);
+			if(!state.path){
+				stop("actions");
+				return true;
+			}
+			state.isActive = recordState.isActive;
+			state.stateBool = recordState.stateBool;
+			state.stateFloat = recordState.stateFloat;
+			state.stateVectorX = recordState.stateVectorX;
+			state.stateVectorY = recordState.stateVectorY;
+			actionStates.push_back(state);
+		}
+		return true;
+	}
 
-	bool isSessionRunning(){ return flagSessionRunning; }
-	int getViewConfigurationViewsSize(){ return xr_view_configuration_views.size(); }
-	vector<XrViewConfigurationView> getViewConfigurationViews(){ return xr_view_configuration_views; }
+	bool replayFrame(XrFrameState & frameState, vector<XrView> & views, vector<ActionPoseState> & actionPoseStates){
+		const RecordHeader * record = next(SESSION_LOG_RECORD_FRAME, frameOffset);
+		if(!record){
+			finished = true;
+			return false;
+		}
+		RecordFrame frame;
+		if(record->size < sizeof(frame))
+			return stop("frame");
+		memcpy(&frame, record + 1, sizeof(frame));
+		if(record->size < sizeof(frame) + (uint64_t)frame.viewCount * sizeof(RecordView) + (uint64_t)frame.poseCount * sizeof(RecordActionPose))
+			return stop("frame");
+		throttle(frame.timestamp);
+
+		frameState.predictedDisplayTime = frame.predictedDisplayTime;
+		frameState.predictedDisplayPeriod = frame.predictedDisplayPeriod;
+		frameState.shouldRender = frame.shouldRender;
+
+		const uint8_t * payload = (const uint8_t*)(record + 1) + sizeof(frame);
+		views.resize(frame.viewCount, {XR_TYPE_VIEW});
+		for(uint32_t i = 0; i < frame.viewCount; i++){
+			RecordView view;
+			memcpy(&view, payload + i * sizeof(RecordView), sizeof(view));
+			views[i].pose = view.pose;
+			views[i].fov = view.fov;
+		}
+		payload += frame.viewCount * sizeof(RecordView);
+		for(uint32_t i = 0; i < frame.poseCount; i++){
+			RecordActionPose recordPose;
+			memcpy(&recordPose, payload + i * sizeof(RecordActionPose), sizeof(recordPose));
+			ActionPoseState state;
+			state.type = XR_ACTION_TYPE_POSE_INPUT;
+			state.path = pathString(recordPose.pathId);
+			if(!state.path)
+				return stop("frame");
+			state.isActive = recordPose.isActive;
+			state.pose = recordPose.pose;
+			actionPoseStates.push_back(state);
+		}
+		return true;
+	}
 };
 
+
+// startup phases (names of the StartupPhase values)
+static const char * startupPhaseNames[STARTUP_PHASE_COUNT] = {"enumeration", "instance", "system", "graphics binding", "graphics resources", 
+															  "session", "reference spaces", "interaction profiles", "action spaces", "swapchains"};
+
+// session recovery: the lost session (or instance) is recreated while the graphics resources are kept
+#define RECOVERY_RETRY_INTERVAL 500		// interval (ms) between attempts to recreate the lost session or instance
+
+
+// color scale and bias of a fade at the given display time. 
+// It returns false when the values are the identity (scale 1, bias 0): the structure does not need to be chained
+static bool updateColorFade(ColorFade & colorFade, XrTime displayTime, XrCompositionLayerColorScaleBiasKHR & colorScaleBias){
+	// the display time restarts if the instance is recreated
+	if(!colorFade.startTime || displayTime < colorFade.startTime)
+		colorFade.startTime = displayTime;
+	float t = 1.0f;
+	if(colorFade.duration > 0)
+		t = (float)std::min(1.0, (displayTime - colorFade.startTime) / (colorFade.duration * 1e9));
+	auto lerp = [t](const XrColor4f & a, const XrColor4f & b){
+		return XrColor4f{a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t, a.a + (b.a - a.a) * t};
+	};
+	colorFade.scale = lerp(colorFade.startScale, colorFade.targetScale);
+	colorFade.bias = lerp(colorFade.startBias, colorFade.targetBias);
+	colorScaleBias = {XR_TYPE_COMPOSITION_LAYER_COLOR_SCALE_BIAS_KHR};
+	colorScaleBias.colorScale = colorFade.scale;
+	colorScaleBias.colorBias = colorFade.bias;
+	return colorFade.scale.r != 1 || colorFade.scale.g != 1 || colorFade.scale.b != 1 || colorFade.scale.a != 1 || 
+		   colorFade.bias.r != 0 || colorFade.bias.g != 0 || colorFade.bias.b != 0 || colorFade.bias.a != 0;
+}
+
 OpenXrApplication::OpenXrApplication(){
+	xr_graphics.reset(new GraphicsBackends());
+#ifndef XR_USE_GRAPHICS_API_OPENGL
+	xr_graphics_backend = GRAPHICS_BACKEND_VULKAN;
+#endif
+	xr_recorder.reset(new SessionRecorder());
+	xr_replayer.reset(new SessionReplayer());
 	renderCallback = nullptr;
 	renderCallbackFunction = nullptr;
+	perfSettingsCallback = nullptr;
+	perfSettingsCallbackFunction = nullptr;
+	displayRefreshRateCallback = nullptr;
+	displayRefreshRateCallbackFunction = nullptr;
+}
+
+OpenXrApplication::~OpenXrApplication(){
+	destroy();
+}
+
+template <typename Function> bool OpenXrApplication::dispatchGraphicsHandler(Function function){
+	switch(xr_graphics_backend){
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+		case GRAPHICS_BACKEND_VULKAN:
+			return function(xr_graphics->vulkanHandler);
+#endif
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+		case GRAPHICS_BACKEND_OPENGL:
+			return function(xr_graphics->openglHandler);
+#endif
+		default:
+			return false;
+	}
+}
+
+bool OpenXrApplication::isGraphicsBackendAvailable(int backend){
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+	if(backend == GRAPHICS_BACKEND_VULKAN)
+		return true;
+#endif
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+	if(backend == GRAPHICS_BACKEND_OPENGL)
+		return true;
+#endif
+	return backend == GRAPHICS_BACKEND_HEADLESS;
+}
+
+const char * OpenXrApplication::getGraphicsExtensionName(int backend){
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+	if(backend == GRAPHICS_BACKEND_VULKAN)
+		return XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME;
+#endif
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+	if(backend == GRAPHICS_BACKEND_OPENGL)
+		return XR_KHR_OPENGL_ENABLE_EXTENSION_NAME;
+#endif
+	return nullptr;
+}
+
+int OpenXrApplication::getGraphicsFenceCount(){
+	int count = 0;
+	dispatchGraphicsHandler([&count](auto & handler){ count = handler.getFenceCount(); return true; });
+	return count;
+}
+
+bool OpenXrApplication::setGraphicsBackend(int backend){
+	if(xr_instance != XR_NULL_HANDLE){
+		XR_LOG_ERROR("Unable to change the graphics backend: an OpenXR instance already exists. Call setGraphicsBackend before createInstance");
+		return false;
+	}
+	if(!isGraphicsBackendAvailable(backend)){
+		XR_LOG_ERROR("Graphics backend " << backend << " is not compiled in");
+		return false;
+	}
+	// tracking-only session: the selected OpenGL or Vulkan backend is kept as fallback (XR_MND_headless not supported)
+	flagHeadless = backend == GRAPHICS_BACKEND_HEADLESS;
+	if(!flagHeadless)
+		xr_graphics_backend = (GraphicsBackend)backend;
+	return true;
+}
+
+bool OpenXrApplication::destroy(){
+	xr_recorder->stop();
+	if(flagReplay){
+		xr_replayer->close();
+		flagReplay = false;
+		flagSessionRunning = false;
+	}
+	if(xr_instance != NULL || xr_recovery_state != RECOVERY_NONE){
+		XR_LOG_INFO("Destroying OpenXR application");
+
+		releaseSession();
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+		xr_graphics->vulkanHandler.releaseResources();
+#endif
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+		xr_graphics->openglHandler.releaseResources();
+#endif
+		releaseInstance();
+		
+		xr_actions = Actions();
+		xr_composition_layers.clear();
+		xr_requested_display_refresh_rate = 0;
+		xr_reprojection_modes.clear();
+		xr_reprojection_mode = XrReprojectionModeMSFT(0);
+		flagReprojectionPlane = false;
+		xr_recovery_state = RECOVERY_NONE;
+		xr_recovery_actions = Actions();
+
+		XR_LOG_INFO("OpenXR application destroyed");
+	}
+	return true;
+}
+
+void OpenXrApplication::releaseSession(){
+	for(size_t i = 0; i < xr_actions.aPose.size(); i++){
+		if(xr_actions.aPose[i].space != XR_NULL_HANDLE)
+			xrDestroySpace(xr_actions.aPose[i].space);
+		xr_actions.aPose[i].space = XR_NULL_HANDLE;
+	}
+
+	// the quad layer definitions (and content) are kept to recreate their swapchains with the session
+	for(size_t i = 0; i < xr_composition_layers.size(); i++)
+		releaseCompositionLayerSwapchain(xr_composition_layers[i]);
+
+	// per-image resources (e.g. OpenGL framebuffers) reference the swapchain images
+	if(xr_swapchains_handlers.size() || xr_depth_swapchains_handlers.size() || xr_motion_vector_swapchains_handlers.size() || xr_space_warp_depth_swapchains_handlers.size())
+		dispatchGraphicsHandler([this](auto & handler){
+			handler.acquireContext();
+			for(auto swapchains : {&xr_swapchains_handlers, &xr_depth_swapchains_handlers, &xr_motion_vector_swapchains_handlers, &xr_space_warp_depth_swapchains_handlers})
+				for(size_t i = 0; i < swapchains->size(); i++)
+					handler.releaseSwapchainImages((*swapchains)[i]);
+			return true;
+		});
+	for(size_t i = 0; i < xr_swapchains_handlers.size(); i++)
+		xrDestroySwapchain(xr_swapchains_handlers[i].handle);
+	xr_swapchains_handlers.clear();
+	for(size_t i = 0; i < xr_depth_swapchains_handlers.size(); i++)
+		xrDestroySwapchain(xr_depth_swapchains_handlers[i].handle);
+	xr_depth_swapchains_handlers.clear();
+	flagDepthUnavailable = false;
+	for(size_t i = 0; i < xr_motion_vector_swapchains_handlers.size(); i++)
+		xrDestroySwapchain(xr_motion_vector_swapchains_handlers[i].handle);
+	xr_motion_vector_swapchains_handlers.clear();
+	for(size_t i = 0; i < xr_space_warp_depth_swapchains_handlers.size(); i++)
+		xrDestroySwapchain(xr_space_warp_depth_swapchains_handlers[i].handle);
+	xr_space_warp_depth_swapchains_handlers.clear();
+	flagSpaceWarpUnavailable = false;
+	flagSpaceWarpActive = false;
+
+	if(xr_space_view != XR_NULL_HANDLE)
+		xrDestroySpace(xr_space_view);
+	if(xr_space_local != XR_NULL_HANDLE)
+		xrDestroySpace(xr_space_local);
+	if(xr_space_stage != XR_NULL_HANDLE)
+		xrDestroySpace(xr_space_stage);
+	if(xr_session != XR_NULL_HANDLE)
+		xrDestroySession(xr_session);
+
+	xr_space_view = xr_space_local = xr_space_stage = XR_NULL_HANDLE;
+	xr_session = XR_NULL_HANDLE;
+	flagSessionRunning = false;
+}
+
+void OpenXrApplication::releaseCompositionLayerSwapchain(CompositionLayer & compositionLayer){
+	if(compositionLayer.swapchain.handle == XR_NULL_HANDLE)
+		return;
+	dispatchGraphicsHandler([&](auto & handler){
+		handler.acquireContext();
+		handler.releaseSwapchainImages(compositionLayer.swapchain);
+		return true;
+	});
+	xrDestroySwapchain(compositionLayer.swapchain.handle);
+	compositionLayer.swapchain = SwapchainHandler();
+	compositionLayer.uploaded = false;
+}
+
+void OpenXrApplication::releaseInstance(){
+	// the action handles are destroyed with the action set (the registered actions are kept to be replayed)
+	if(xr_action_set != XR_NULL_HANDLE)
+		xrDestroyActionSet(xr_action_set);
+	if(xr_debug_utils_messenger != XR_NULL_HANDLE && xrDestroyDebugUtilsMessengerEXT)
+		xrDestroyDebugUtilsMessengerEXT(xr_debug_utils_messenger);
+	if(xr_instance != XR_NULL_HANDLE)
+		xrDestroyInstance(xr_instance);
+
+	xr_action_set = XR_NULL_HANDLE;
+	xr_debug_utils_messenger = XR_NULL_HANDLE;
+	xr_instance = XR_NULL_HANDLE;
+	xr_system_id = XR_NULL_SYSTEM_ID;
+	flagBindingsSuggested = false;
+}
+
+bool OpenXrApplication::beginRecovery(RecoveryState state){
+	if(!flagSessionRecovery)
+		return false;
+	// the Vulkan instance and device are created through the OpenXR instance (XR_KHR_vulkan_enable2)
+	if(state == RECOVERY_INSTANCE && !flagHeadlessSession && xr_graphics_backend == GRAPHICS_BACKEND_VULKAN){
+		XR_LOG_WARNING("Instance recovery is not supported by the Vulkan backend");
+		return false;
+	}
+	// an instance loss while recovering the session restarts the recovery from the instance
+	if(xr_recovery_state == RECOVERY_NONE)
+		xr_recovery_start = std::chrono::steady_clock::now();
+	// snapshot of the registered actions, taken once: a failed attempt may leave them partially replayed
+	if(state == RECOVERY_INSTANCE && (xr_recovery_state == RECOVERY_NONE || xr_recovery_state == RECOVERY_SESSION))
+		xr_recovery_actions = xr_actions;
+	if(xr_recovery_state == RECOVERY_NONE || state == RECOVERY_INSTANCE)
+		xr_recovery_state = state;
+
+	releaseSession();
+	if(state == RECOVERY_INSTANCE)
+		releaseInstance();
+	xr_recovery_attempt = std::chrono::steady_clock::now();
+	XR_LOG_WARNING((state == RECOVERY_INSTANCE ? "Instance" : "Session") << " lost. Recreating it (the graphics resources are kept)");
+	return true;
 }
 
-OpenXrApplication::~OpenXrApplication(){
-	destroy();
+bool OpenXrApplication::handleLoss(XrResult result){
+	if(result == XR_ERROR_SESSION_LOST)
+		return beginRecovery(RECOVERY_SESSION);
+	if(result == XR_ERROR_INSTANCE_LOST)
+		return beginRecovery(RECOVERY_INSTANCE);
+	return false;
 }
 
-bool OpenXrApplication::destroy(){
-	if(xr_instance != NULL){
-		std::cout << "Destroying OpenXR application" << std::endl;
-		
-		for(size_t i = 0; i < xr_actions.aPose.size(); i++)
-			xrDestroySpace(xr_actions.aPose[i].space);
-
-		xrDestroyActionSet(xr_action_set);
+void OpenXrApplication::attemptRecovery(){
+	auto now = std::chrono::steady_clock::now();
+	if(std::chrono::duration<double, std::milli>(now - xr_recovery_attempt).count() < RECOVERY_RETRY_INTERVAL)
+		return;
+	xr_recovery_attempt = now;
+
+	// the runtime is not available until the instance can be created
+	if(xr_recovery_state == RECOVERY_INSTANCE){
+		if(!createInstance(xr_application_name, xr_engine_name, xr_requested_api_layers, xr_requested_extensions)){
+			releaseInstance();
+			return;
+		}
+		xr_recovery_state = RECOVERY_SYSTEM;
+	}
 
-		for(size_t i = 0; i < xr_swapchains_handlers.size(); i++)
-			xrDestroySwapchain(xr_swapchains_handlers[i].handle);
+	// the system is not available until the device is connected again
+	XrSystemGetInfo systemInfo = {XR_TYPE_SYSTEM_GET_INFO};
+	systemInfo.formFactor = xr_form_factor;
+	XrSystemId systemId = XR_NULL_SYSTEM_ID;
+	if(XR_FAILED(xrGetSystem(xr_instance, &systemInfo, &systemId)))
+		return;
+
+	if(xr_recovery_state == RECOVERY_SYSTEM){
+		if(!getSystem(xr_form_factor, xr_requested_blend_mode, xr_requested_configuration_type))
+			return;
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+		// the graphics requirements must be queried for each instance before creating a session (the context is kept)
+		if(!flagHeadlessSession && xr_graphics_backend == GRAPHICS_BACKEND_OPENGL && !xr_graphics->openglHandler.getRequirements(xr_instance, xr_system_id))
+			return;
+#endif
+		// replay the registered actions (in the same order, so the action names are kept) on the new action set.
+		// It is the last step of the attempt: the actions are never added twice to the same action set
+		const Actions & actions = xr_recovery_actions;
+		xr_actions = Actions();
+		for(size_t i = 0; i < actions.aBoolean.size(); i++)
+			addAction(actions.aBoolean[i].stringPath, XR_ACTION_TYPE_BOOLEAN_INPUT, XR_REFERENCE_SPACE_TYPE_LOCAL);
+		for(size_t i = 0; i < actions.aFloat.size(); i++)
+			addAction(actions.aFloat[i].stringPath, XR_ACTION_TYPE_FLOAT_INPUT, XR_REFERENCE_SPACE_TYPE_LOCAL);
+		for(size_t i = 0; i < actions.aVector2f.size(); i++)
+			addAction(actions.aVector2f[i].stringPath, XR_ACTION_TYPE_VECTOR2F_INPUT, XR_REFERENCE_SPACE_TYPE_LOCAL);
+		for(size_t i = 0; i < actions.aPose.size(); i++)
+			addAction(actions.aPose[i].stringPath, XR_ACTION_TYPE_POSE_INPUT, actions.aPose[i].referenceSpaceType);
+		for(size_t i = 0; i < actions.aVibration.size(); i++)
+			addAction(actions.aVibration[i].stringPath, XR_ACTION_TYPE_VIBRATION_OUTPUT, XR_REFERENCE_SPACE_TYPE_LOCAL);
+		xr_recovery_actions = Actions();
+		xr_recovery_state = RECOVERY_SESSION;
+	}
 
-		xrDestroySpace(xr_space_view);
-		xrDestroySpace(xr_space_local);
-		xrDestroySpace(xr_space_stage);
+	beginStartupPhase();
+	if(!createSessionObjects()){
+		releaseSession();
+		return;
+	}
 
-		xrDestroySession(xr_session);
-		xrDestroyInstance(xr_instance);
-		
-		xr_instance = {};
-		xr_system_id = XR_NULL_SYSTEM_ID;
-		xr_session = {};
+	xr_recovery_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - xr_recovery_start).count();
+	xr_recovery_count++;
+	xr_recovery_state = RECOVERY_NONE;
+	XR_LOG_INFO("Session recovered in " << xr_recovery_time << " ms");
+}
 
-		std::cout << "OpenXR application destroyed" << std::endl;
-	}
-	return true;
+void OpenXrApplication::endStartupPhase(StartupPhase phase){
+	auto now = std::chrono::steady_clock::now();
+	xr_startup_timing[phase] += std::chrono::duration<double, std::milli>(now - xr_startup_phase_start).count();
+	xr_startup_phase_start = now;
 }
 
 bool OpenXrApplication::defineLayers(const vector<string> & requestedApiLayers, vector<string> & enabledApiLayers){
-	uint32_t propertyCountOutput;
-	xr_result = xrEnumerateApiLayerProperties(0, &propertyCountOutput, nullptr);
-	if(!xrCheckResult(NULL, xr_result, "xrEnumerateApiLayerProperties"))
-		return false;
-	vector<XrApiLayerProperties> apiLayerProperties(propertyCountOutput, {XR_TYPE_API_LAYER_PROPERTIES});
-	xr_result = xrEnumerateApiLayerProperties(propertyCountOutput, &propertyCountOutput, apiLayerProperties.data());
-	if(!xrCheckResult(NULL, xr_result, "xrEnumerateApiLayerProperties"))
-		return false;
+	// enumerate (or reuse the cached enumeration of the same runtime)
+	string key = runtimeManifestKey();
+	bool cached = !key.empty() && key == runtimeEnumerationCache.apiLayersKey;
+	if(!cached){
+		uint32_t propertyCountOutput;
+		xr_result = xrEnumerateApiLayerProperties(0, &propertyCountOutput, nullptr);
+		if(!xrCheckResult(NULL, xr_result, "xrEnumerateApiLayerProperties"))
+			return false;
+		vector<XrApiLayerProperties> apiLayerProperties(propertyCountOutput, {XR_TYPE_API_LAYER_PROPERTIES});
+		xr_result = xrEnumerateApiLayerProperties(propertyCountOutput, &propertyCountOutput, apiLayerProperties.data());
+		if(!xrCheckResult(NULL, xr_result, "xrEnumerateApiLayerProperties"))
+			return false;
+		runtimeEnumerationCache.apiLayers.clear();
+		for(size_t i = 0; i < apiLayerProperties.size(); i++)
+			runtimeEnumerationCache.apiLayers.push_back(apiLayerProperties[i].layerName);
+		runtimeEnumerationCache.apiLayersKey = key;
+	}
+	const vector<string> & apiLayers = runtimeEnumerationCache.apiLayers;
 
-	std::cout << "OpenXR API layers (" << apiLayerProperties.size() << ")" << std::endl;
-	for(size_t i = 0; i < apiLayerProperties.size(); i++){
-		std::cout << "  |-- " << apiLayerProperties[i].layerName << std::endl;
+	verboseOutput() << "OpenXR API layers (" << apiLayers.size() << ")" << (cached ? " (cached)" : "") << std::endl;
+	for(size_t i = 0; i < apiLayers.size(); i++){
+		verboseOutput() << "  |-- " << apiLayers[i] << std::endl;
 		for(size_t j = 0; j < requestedApiLayers.size(); j++)
-			if(!requestedApiLayers[j].compare(apiLayerProperties[i].layerName)){
+			if(!requestedApiLayers[j].compare(apiLayers[i])){
 				enabledApiLayers.push_back(requestedApiLayers[j]);
-				std::cout << "  |   (requested)" << std::endl;
+				verboseOutput() << "  |   (requested)" << std::endl;
 				break;
 			}
 	}
@@ -867,7 +2879,6 @@ bool OpenXrApplication::defineLayers(const vector<string> & requestedApiLayers,
 	// check for unavailable layers
 	if(requestedApiLayers.size() != enabledApiLayers.size()){
 		bool used = false;
-		std::cout << "Unavailable OpenXR API layers" << std::endl;
 		for(size_t i = 0; i < requestedApiLayers.size(); i++){
 			used = false;
 			for(size_t j = 0; j < enabledApiLayers.size(); j++)
@@ -876,38 +2887,48 @@ bool OpenXrApplication::defineLayers(const vector<string> & requestedApiLayers,
 					break;
 				}
 			if(!used)
-				std::cout << "  |-- " << requestedApiLayers[i] << std::endl;
+				XR_LOG_ERROR("Unavailable OpenXR API layer: " << requestedApiLayers[i]);
 		}
 		return false;
 	}
 	return true;
 }
 
-bool OpenXrApplication::defineExtensions(const vector<string> & requestedExtensions, vector<string> & enabledExtensions){
-	uint32_t propertyCountOutput;
-	xr_result = xrEnumerateInstanceExtensionProperties(nullptr, 0, &propertyCountOutput, nullptr);
-	if(!xrCheckResult(NULL, xr_result, "xrEnumerateInstanceExtensionProperties"))
-		return false;
-	vector<XrExtensionProperties> extensionProperties(propertyCountOutput, {XR_TYPE_EXTENSION_PROPERTIES});
-	xr_result = xrEnumerateInstanceExtensionProperties(nullptr, propertyCountOutput, &propertyCountOutput, extensionProperties.data());
-	if(!xrCheckResult(NULL, xr_result, "xrEnumerateInstanceExtensionProperties"))
-		return false;
+bool OpenXrApplication::defineExtensions(const vector<string> & requestedExtensions, const vector<string> & optionalExtensions, vector<string> & enabledExtensions){
+	// enumerate (or reuse the cached enumeration of the same runtime)
+	string key = runtimeManifestKey();
+	bool cached = !key.empty() && key == runtimeEnumerationCache.extensionsKey;
+	if(!cached){
+		uint32_t propertyCountOutput;
+		xr_result = xrEnumerateInstanceExtensionProperties(nullptr, 0, &propertyCountOutput, nullptr);
+		if(!xrCheckResult(NULL, xr_result, "xrEnumerateInstanceExtensionProperties"))
+			return false;
+		vector<XrExtensionProperties> extensionProperties(propertyCountOutput, {XR_TYPE_EXTENSION_PROPERTIES});
+		xr_result = xrEnumerateInstanceExtensionProperties(nullptr, propertyCountOutput, &propertyCountOutput, extensionProperties.data());
+		if(!xrCheckResult(NULL, xr_result, "xrEnumerateInstanceExtensionProperties"))
+			return false;
+		runtimeEnumerationCache.extensions.clear();
+		for(size_t i = 0; i < extensionProperties.size(); i++)
+			runtimeEnumerationCache.extensions.push_back(extensionProperties[i].extensionName);
+		runtimeEnumerationCache.extensionsKey = key;
+	}
+	const vector<string> & extensions = runtimeEnumerationCache.extensions;
 	
-	std::cout << "OpenXR extensions (" << extensionProperties.size() << ")" << std::endl;
-	for(size_t i = 0; i < extensionProperties.size(); i++){
-		std::cout << "  |-- " << extensionProperties[i].extensionName << std::endl;
+	verboseOutput() << "OpenXR extensions (" << extensions.size() << ")" << (cached ? " (cached)" : "") << std::endl;
+	for(size_t i = 0; i < extensions.size(); i++){
+		verboseOutput() << "  |-- " << extensions[i] << std::endl;
 		for(size_t j = 0; j < requestedExtensions.size(); j++)
-			if(!requestedExtensions[j].compare(extensionProperties[i].extensionName)){
+			if(!requestedExtensions[j].compare(extensions[i])){
 				enabledExtensions.push_back(requestedExtensions[j]);
-				std::cout << "  |   (requested)" << std::endl;
+				verboseOutput() << "  |   (requested)" << std::endl;
 				break;
 			}
 	}
 
 	// check for unavailable extensions
-	if(requestedExtensions.size() != enabledExtensions.size()){
+	size_t requestedExtensionsCount = enabledExtensions.size();
+	if(requestedExtensions.size() != requestedExtensionsCount){
 		bool used = false;
-		std::cout << "Unavailable OpenXR extensions" << std::endl;
 		for(size_t i = 0; i < requestedExtensions.size(); i++){
 			used = false;
 			for(size_t j = 0; j < enabledExtensions.size(); j++)
@@ -916,123 +2937,222 @@ bool OpenXrApplication::defineExtensions(const vector<string> & requestedExtensi
 					break;
 				}
 			if(!used)
-				std::cout << "  |-- " << requestedExtensions[i] << std::endl;
+				XR_LOG_ERROR("Unavailable OpenXR extension: " << requestedExtensions[i]);
 		}
 		return false;
 	}
+
+	// enable optional extensions (if available and not requested)
+	for(size_t i = 0; i < optionalExtensions.size(); i++){
+		if(std::find(enabledExtensions.begin(), enabledExtensions.end(), optionalExtensions[i]) != enabledExtensions.end())
+			continue;
+		for(size_t j = 0; j < extensions.size(); j++)
+			if(!optionalExtensions[i].compare(extensions[j])){
+				enabledExtensions.push_back(optionalExtensions[i]);
+				break;
+			}
+	}
+	if(enabledExtensions.size() != requestedExtensionsCount){
+		verboseOutput() << "Optional OpenXR extensions" << std::endl;
+		for(size_t i = requestedExtensionsCount; i < enabledExtensions.size(); i++)
+			verboseOutput() << "  |-- " << enabledExtensions[i] << std::endl;
+	}
 	return true;
 }
 
+void OpenXrApplication::loadExtensionFunctions(){
+	if(isExtensionEnabled(XR_EXT_PERFORMANCE_SETTINGS_EXTENSION_NAME)){
+		xr_result = xrGetInstanceProcAddr(xr_instance, "xrPerfSettingsSetPerformanceLevelEXT", reinterpret_cast<PFN_xrVoidFunction*>(&xrPerfSettingsSetPerformanceLevelEXT));
+		if(!xrCheckResult(xr_instance, xr_result, "xrPerfSettingsSetPerformanceLevelEXT (xrGetInstanceProcAddr)"))
+			xrPerfSettingsSetPerformanceLevelEXT = nullptr;
+	}
+	if(isExtensionEnabled(XR_EXT_THERMAL_QUERY_EXTENSION_NAME)){
+		xr_result = xrGetInstanceProcAddr(xr_instance, "xrThermalGetTemperatureTrendEXT", reinterpret_cast<PFN_xrVoidFunction*>(&xrThermalGetTemperatureTrendEXT));
+		if(!xrCheckResult(xr_instance, xr_result, "xrThermalGetTemperatureTrendEXT (xrGetInstanceProcAddr)"))
+			xrThermalGetTemperatureTrendEXT = nullptr;
+	}
+	if(isExtensionEnabled(XR_KHR_VISIBILITY_MASK_EXTENSION_NAME)){
+		xr_result = xrGetInstanceProcAddr(xr_instance, "xrGetVisibilityMaskKHR", reinterpret_cast<PFN_xrVoidFunction*>(&xrGetVisibilityMaskKHR));
+		if(!xrCheckResult(xr_instance, xr_result, "xrGetVisibilityMaskKHR (xrGetInstanceProcAddr)"))
+			xrGetVisibilityMaskKHR = nullptr;
+	}
+	if(isExtensionEnabled(XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME)){
+		xr_result = xrGetInstanceProcAddr(xr_instance, "xrEnumerateDisplayRefreshRatesFB", reinterpret_cast<PFN_xrVoidFunction*>(&xrEnumerateDisplayRefreshRatesFB));
+		if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateDisplayRefreshRatesFB (xrGetInstanceProcAddr)"))
+			xrEnumerateDisplayRefreshRatesFB = nullptr;
+		xr_result = xrGetInstanceProcAddr(xr_instance, "xrGetDisplayRefreshRateFB", reinterpret_cast<PFN_xrVoidFunction*>(&xrGetDisplayRefreshRateFB));
+		if(!xrCheckResult(xr_instance, xr_result, "xrGetDisplayRefreshRateFB (xrGetInstanceProcAddr)"))
+			xrGetDisplayRefreshRateFB = nullptr;
+		xr_result = xrGetInstanceProcAddr(xr_instance, "xrRequestDisplayRefreshRateFB", reinterpret_cast<PFN_xrVoidFunction*>(&xrRequestDisplayRefreshRateFB));
+		if(!xrCheckResult(xr_instance, xr_result, "xrRequestDisplayRefreshRateFB (xrGetInstanceProcAddr)"))
+			xrRequestDisplayRefreshRateFB = nullptr;
+	}
+	if(isExtensionEnabled(XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME)){
+		xr_result = xrGetInstanceProcAddr(xr_instance, "xrEnumerateReprojectionModesMSFT", reinterpret_cast<PFN_xrVoidFunction*>(&xrEnumerateReprojectionModesMSFT));
+		if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateReprojectionModesMSFT (xrGetInstanceProcAddr)"))
+			xrEnumerateReprojectionModesMSFT = nullptr;
+	}
+	if(isExtensionEnabled(XR_EXT_DEBUG_UTILS_EXTENSION_NAME)){
+		PFN_xrCreateDebugUtilsMessengerEXT xrCreateDebugUtilsMessengerEXT = nullptr;
+		xr_result = xrGetInstanceProcAddr(xr_instance, "xrCreateDebugUtilsMessengerEXT", reinterpret_cast<PFN_xrVoidFunction*>(&xrCreateDebugUtilsMessengerEXT));
+		if(!xrCheckResult(xr_instance, xr_result, "xrCreateDebugUtilsMessengerEXT (xrGetInstanceProcAddr)"))
+			return;
+		xr_result = xrGetInstanceProcAddr(xr_instance, "xrDestroyDebugUtilsMessengerEXT", reinterpret_cast<PFN_xrVoidFunction*>(&xrDestroyDebugUtilsMessengerEXT));
+		if(!xrCheckResult(xr_instance, xr_result, "xrDestroyDebugUtilsMessengerEXT (xrGetInstanceProcAddr)"))
+			return;
+
+		XrDebugUtilsMessengerCreateInfoEXT messengerInfo = {XR_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT};
+		messengerInfo.messageSeverities = XR_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | XR_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT | 
+										  XR_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | XR_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+		messengerInfo.messageTypes = XR_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | XR_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | 
+									 XR_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT | XR_DEBUG_UTILS_MESSAGE_TYPE_CONFORMANCE_BIT_EXT;
+		messengerInfo.userCallback = xrDebugUtilsMessengerCallback;
+		xr_result = xrCreateDebugUtilsMessengerEXT(xr_instance, &messengerInfo, &xr_debug_utils_messenger);
+		if(!xrCheckResult(xr_instance, xr_result, "xrCreateDebugUtilsMessengerEXT"))
+			xr_debug_utils_messenger = XR_NULL_HANDLE;
+	}
+}
+
 bool OpenXrApplication::acquireInstanceProperties(){
 	XrInstanceProperties instanceProperties = {XR_TYPE_INSTANCE_PROPERTIES};
 	xr_result = xrGetInstanceProperties(xr_instance, &instanceProperties);
 	if(!xrCheckResult(xr_instance, xr_result, "xrGetInstanceProperties"))
 		return false;
 
-	std::cout << "Runtime" << std::endl;
-	std::cout << "  |-- name: " << instanceProperties.runtimeName << std::endl;
-	std::cout << "  |-- version: " << XR_VERSION_MAJOR(instanceProperties.runtimeVersion) << "." << XR_VERSION_MINOR(instanceProperties.runtimeVersion) << "." << XR_VERSION_PATCH(instanceProperties.runtimeVersion) << std::endl;
+	verboseOutput() << "Runtime" << std::endl;
+	verboseOutput() << "  |-- name: " << instanceProperties.runtimeName << std::endl;
+	verboseOutput() << "  |-- version: " << XR_VERSION_MAJOR(instanceProperties.runtimeVersion) << "." << XR_VERSION_MINOR(instanceProperties.runtimeVersion) << "." << XR_VERSION_PATCH(instanceProperties.runtimeVersion) << std::endl;
+
+	xr_system_key = string(instanceProperties.runtimeName) + ":" + std::to_string(instanceProperties.runtimeVersion);
 	return true;
 }
 
 bool OpenXrApplication::acquireSystemProperties(){
 	XrSystemProperties systemProperties = {XR_TYPE_SYSTEM_PROPERTIES};
+	// recommended motion vector resolution (XR_FB_space_warp)
+	xr_space_warp_properties = {XR_TYPE_SYSTEM_SPACE_WARP_PROPERTIES_FB};
+	if(isExtensionEnabled(XR_FB_SPACE_WARP_EXTENSION_NAME))
+		systemProperties.next = &xr_space_warp_properties;
 	xr_result = xrGetSystemProperties(xr_instance, xr_system_id, &systemProperties);
 	if(!xrCheckResult(xr_instance, xr_result, "xrGetSystemProperties"))
 		return false;
 
-	std::cout << "System" << std::endl;
-	std::cout << "  |-- system id: " << systemProperties.systemId << std::endl;
-	std::cout << "  |-- system name: " << systemProperties.systemName << std::endl;
-	std::cout << "  |-- vendor id: " << systemProperties.vendorId << std::endl;
-	std::cout << "  |-- max layers: " << systemProperties.graphicsProperties.maxLayerCount << std::endl;
-	std::cout << "  |-- max swapchain height: " << systemProperties.graphicsProperties.maxSwapchainImageHeight << std::endl;
-	std::cout << "  |-- max swapchain width: " << systemProperties.graphicsProperties.maxSwapchainImageWidth << std::endl;
-	std::cout << "  |-- orientation tracking: " << systemProperties.trackingProperties.orientationTracking << std::endl;
-	std::cout << "  |-- position tracking: " << systemProperties.trackingProperties.positionTracking << std::endl;
+	verboseOutput() << "System" << std::endl;
+	verboseOutput() << "  |-- system id: " << systemProperties.systemId << std::endl;
+	verboseOutput() << "  |-- system name: " << systemProperties.systemName << std::endl;
+	verboseOutput() << "  |-- vendor id: " << systemProperties.vendorId << std::endl;
+	verboseOutput() << "  |-- max layers: " << systemProperties.graphicsProperties.maxLayerCount << std::endl;
+	verboseOutput() << "  |-- max swapchain height: " << systemProperties.graphicsProperties.maxSwapchainImageHeight << std::endl;
+	verboseOutput() << "  |-- max swapchain width: " << systemProperties.graphicsProperties.maxSwapchainImageWidth << std::endl;
+	verboseOutput() << "  |-- orientation tracking: " << systemProperties.trackingProperties.orientationTracking << std::endl;
+	verboseOutput() << "  |-- position tracking: " << systemProperties.trackingProperties.positionTracking << std::endl;
+	if(systemProperties.next)
+		verboseOutput() << "  |-- motion vector resolution: " << xr_space_warp_properties.recommendedMotionVectorImageRectWidth << " x " << xr_space_warp_properties.recommendedMotionVectorImageRectHeight << std::endl;
+
+	xr_system_key += ":" + string(systemProperties.systemName) + ":" + std::to_string(systemProperties.vendorId);
 	return true;
 }
 
 bool OpenXrApplication::acquireViewConfiguration(XrViewConfigurationType configurationType){
-	uint32_t propertyCountOutput;
-	xr_result = xrEnumerateViewConfigurations(xr_instance, xr_system_id, 0, &propertyCountOutput, nullptr);
-	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateViewConfigurations"))
-		return false;
-	vector<XrViewConfigurationType> viewConfigurationTypes(propertyCountOutput);
-	xr_result = xrEnumerateViewConfigurations(xr_instance, xr_system_id, propertyCountOutput, &propertyCountOutput, viewConfigurationTypes.data());
-	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateViewConfigurations"))
-		return false;
+	// enumerate (or reuse the cached enumeration of the same runtime, system and view configuration type)
+	string key = xr_system_key + ":" + std::to_string(configurationType);
+	auto cachedSystem = runtimeEnumerationCache.systems.find(key);
+	bool cached = cachedSystem != runtimeEnumerationCache.systems.end();
+	SystemEnumeration system = cached ? cachedSystem->second : SystemEnumeration();
+
+	if(!cached){
+		uint32_t propertyCountOutput;
+		xr_result = xrEnumerateViewConfigurations(xr_instance, xr_system_id, 0, &propertyCountOutput, nullptr);
+		if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateViewConfigurations"))
+			return false;
+		system.viewConfigurationTypes.resize(propertyCountOutput);
+		xr_result = xrEnumerateViewConfigurations(xr_instance, xr_system_id, propertyCountOutput, &propertyCountOutput, system.viewConfigurationTypes.data());
+		if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateViewConfigurations"))
+			return false;
+	}
 
-	std::cout << "View configurations (" << viewConfigurationTypes.size() << ")" << std::endl;
-	for(size_t i = 0; i < viewConfigurationTypes.size(); i++){
-		std::cout << "  |-- type " << viewConfigurationTypes[i] << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrViewConfigurationType)" << std::endl;
-		if(viewConfigurationTypes[i] == configurationType){
-			std::cout << "  |   (requested)" << std::endl;
+	verboseOutput() << "View configurations (" << system.viewConfigurationTypes.size() << ")" << (cached ? " (cached)" : "") << std::endl;
+	for(size_t i = 0; i < system.viewConfigurationTypes.size(); i++){
+		verboseOutput() << "  |-- type " << system.viewConfigurationTypes[i] << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrViewConfigurationType)" << std::endl;
+		if(system.viewConfigurationTypes[i] == configurationType){
+			verboseOutput() << "  |   (requested)" << std::endl;
 			configViewConfigurationType = configurationType;
 		}
 	}
 	if(configViewConfigurationType == XR_VIEW_CONFIGURATION_TYPE_MAX_ENUM){
-		std::cout << "Unavailable view configuration type: " << configurationType << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrViewConfigurationType)" << std::endl;
+		XR_LOG_ERROR("Unavailable view configuration type: " << configurationType << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrViewConfigurationType)");
 		return false;
 	}
 	
-	// view configuration properties
-	XrViewConfigurationProperties viewConfigurationProperties = {XR_TYPE_VIEW_CONFIGURATION_PROPERTIES};
-	xr_result = xrGetViewConfigurationProperties(xr_instance, xr_system_id, configViewConfigurationType, &viewConfigurationProperties);
-	if(!xrCheckResult(xr_instance, xr_result, "xrGetViewConfigurationProperties"))
-		return false;
+	if(!cached){
+		// view configuration properties
+		xr_result = xrGetViewConfigurationProperties(xr_instance, xr_system_id, configViewConfigurationType, &system.viewConfigurationProperties);
+		if(!xrCheckResult(xr_instance, xr_result, "xrGetViewConfigurationProperties"))
+			return false;
 
-	std::cout << "View configuration properties" << std::endl;
-		std::cout << "  |-- configuration type: " << viewConfigurationProperties.viewConfigurationType << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrViewConfigurationType)" << std::endl;
-		std::cout << "  |-- fov mutable (bool): " << viewConfigurationProperties.fovMutable << std::endl;
-	
-	// view configuration views
-	xr_result = xrEnumerateViewConfigurationViews(xr_instance, xr_system_id, configViewConfigurationType, 0, &propertyCountOutput, nullptr);
+		runtimeEnumerationCache.systems[key] = system;
+	}
+
+	// view configuration views (never cached: the recommended resolution can change without a new runtime version, e.g. a render scale or a headset change)
+	uint32_t viewCountOutput;
+	xr_result = xrEnumerateViewConfigurationViews(xr_instance, xr_system_id, configViewConfigurationType, 0, &viewCountOutput, nullptr);
 	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateViewConfigurationViews"))
 		return false;
-	xr_view_configuration_views.resize(propertyCountOutput, {XR_TYPE_VIEW_CONFIGURATION_VIEW});
-	xr_result = xrEnumerateViewConfigurationViews(xr_instance, xr_system_id, configViewConfigurationType, propertyCountOutput, &propertyCountOutput, xr_view_configuration_views.data());
+	xr_view_configuration_views.assign(viewCountOutput, {XR_TYPE_VIEW_CONFIGURATION_VIEW});
+	xr_result = xrEnumerateViewConfigurationViews(xr_instance, xr_system_id, configViewConfigurationType, viewCountOutput, &viewCountOutput, xr_view_configuration_views.data());
 	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateViewConfigurationViews"))
 		return false;
+
+	verboseOutput() << "View configuration properties" << std::endl;
+		verboseOutput() << "  |-- configuration type: " << system.viewConfigurationProperties.viewConfigurationType << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrViewConfigurationType)" << std::endl;
+		verboseOutput() << "  |-- fov mutable (bool): " << system.viewConfigurationProperties.fovMutable << std::endl;
 	
-	std::cout << "View configuration views (" << xr_view_configuration_views.size() << ")" << std::endl;
+	verboseOutput() << "View configuration views (" << xr_view_configuration_views.size() << ")" << std::endl;
 	for(size_t i = 0; i < xr_view_configuration_views.size(); i++){
-		std::cout << "  |-- view " << i << std::endl;
-		std::cout << "  |     |-- recommended resolution: " << xr_view_configuration_views[i].recommendedImageRectWidth << " x " << xr_view_configuration_views[i].recommendedImageRectHeight << std::endl;
-		std::cout << "  |     |-- max resolution: " << xr_view_configuration_views[i].maxImageRectWidth << " x " << xr_view_configuration_views[i].maxImageRectHeight << std::endl;
-		std::cout << "  |     |-- recommended swapchain samples: " << xr_view_configuration_views[i].recommendedSwapchainSampleCount << std::endl;
-		std::cout << "  |     |-- max swapchain samples: " << xr_view_configuration_views[i].maxSwapchainSampleCount << std::endl;
+		verboseOutput() << "  |-- view " << i << std::endl;
+		verboseOutput() << "  |     |-- recommended resolution: " << xr_view_configuration_views[i].recommendedImageRectWidth << " x " << xr_view_configuration_views[i].recommendedImageRectHeight << std::endl;
+		verboseOutput() << "  |     |-- max resolution: " << xr_view_configuration_views[i].maxImageRectWidth << " x " << xr_view_configuration_views[i].maxImageRectHeight << std::endl;
+		verboseOutput() << "  |     |-- recommended swapchain samples: " << xr_view_configuration_views[i].recommendedSwapchainSampleCount << std::endl;
+		verboseOutput() << "  |     |-- max swapchain samples: " << xr_view_configuration_views[i].maxSwapchainSampleCount << std::endl;
 	}
 
 	// resize frame buffers
 	xr_frames_data.resize(xr_view_configuration_views.size());
 	xr_frames_width.resize(xr_view_configuration_views.size());
 	xr_frames_height.resize(xr_view_configuration_views.size());
+	xr_depth_frames.resize(xr_view_configuration_views.size());
+	xr_space_warp_frames.resize(xr_view_configuration_views.size());
 	cleanFrames();
 
 	return true;
 }
 
 bool OpenXrApplication::acquireBlendModes(XrEnvironmentBlendMode blendMode){
-	uint32_t propertyCountOutput;
-	xr_result = xrEnumerateEnvironmentBlendModes(xr_instance, xr_system_id, configViewConfigurationType, 0, &propertyCountOutput, nullptr);
-	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateEnvironmentBlendModes"))
-		return false;
-	vector<XrEnvironmentBlendMode> environmentBlendModes(propertyCountOutput);
-	xr_result = xrEnumerateEnvironmentBlendModes(xr_instance, xr_system_id, configViewConfigurationType, propertyCountOutput, &propertyCountOutput, environmentBlendModes.data());
-	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateEnvironmentBlendModes"))
-		return false;
+	// enumerate (or reuse the cached enumeration: see acquireViewConfiguration)
+	SystemEnumeration & system = runtimeEnumerationCache.systems[xr_system_key + ":" + std::to_string(configViewConfigurationType)];
+	bool cached = !system.environmentBlendModes.empty();
+	if(!cached){
+		uint32_t propertyCountOutput;
+		xr_result = xrEnumerateEnvironmentBlendModes(xr_instance, xr_system_id, configViewConfigurationType, 0, &propertyCountOutput, nullptr);
+		if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateEnvironmentBlendModes"))
+			return false;
+		vector<XrEnvironmentBlendMode> environmentBlendModes(propertyCountOutput);
+		xr_result = xrEnumerateEnvironmentBlendModes(xr_instance, xr_system_id, configViewConfigurationType, propertyCountOutput, &propertyCountOutput, environmentBlendModes.data());
+		if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateEnvironmentBlendModes"))
+			return false;
+		system.environmentBlendModes = environmentBlendModes;
+	}
 
-	std::cout << "Environment blend modes (" << environmentBlendModes.size() << ")" << std::endl;
-	for (size_t i = 0; i < environmentBlendModes.size(); i++){
-		std::cout << "  |-- mode: " << environmentBlendModes[i] << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrEnvironmentBlendMode)" << std::endl;
-		if(environmentBlendModes[i] == blendMode){
-			std::cout << "  |   (requested)" << std::endl;
+	verboseOutput() << "Environment blend modes (" << system.environmentBlendModes.size() << ")" << (cached ? " (cached)" : "") << std::endl;
+	for (size_t i = 0; i < system.environmentBlendModes.size(); i++){
+		verboseOutput() << "  |-- mode: " << system.environmentBlendModes[i] << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrEnvironmentBlendMode)" << std::endl;
+		if(system.environmentBlendModes[i] == blendMode){
+			verboseOutput() << "  |   (requested)" << std::endl;
 			environmentBlendMode = blendMode;
 		}
 	}
 	if(environmentBlendMode == XR_ENVIRONMENT_BLEND_MODE_MAX_ENUM){
-		std::cout << "Unavailable blend mode: " << blendMode << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrEnvironmentBlendMode)" << std::endl;
+		XR_LOG_ERROR("Unavailable blend mode: " << blendMode << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrEnvironmentBlendMode)");
 		return false;
 	}
 	return true;
@@ -1059,10 +3179,10 @@ bool OpenXrApplication::defineReferenceSpaces(){
 	
 	XrExtent2Df spaceBounds;
 	
-	std::cout << "Reference spaces (" << referenceSpaces.size() << ")" << std::endl;
+	verboseOutput() << "Reference spaces (" << referenceSpaces.size() << ")" << std::endl;
 	for (size_t i = 0; i < referenceSpaces.size(); i++){
 		referenceSpaceCreateInfo.referenceSpaceType = referenceSpaces[i];
-		std::cout << "  |-- type: " << referenceSpaces[i] << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrReferenceSpaceType)" << std::endl;
+		verboseOutput() << "  |-- type: " << referenceSpaces[i] << " (https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XrReferenceSpaceType)" << std::endl;
 		// view
 		if(referenceSpaces[i] == XR_REFERENCE_SPACE_TYPE_VIEW){
 			xr_result = xrCreateReferenceSpace(xr_session, &referenceSpaceCreateInfo, &xr_space_view);
@@ -1074,9 +3194,9 @@ bool OpenXrApplication::defineReferenceSpaces(){
 			if(!xrCheckResult(xr_instance, xr_result, "xrGetReferenceSpaceBoundsRect (XR_REFERENCE_SPACE_TYPE_VIEW)"))
 				return false;
 			
-			std::cout << "  |     |-- reference space bounds" << std::endl;
-			std::cout << "  |     |     |-- width: " << spaceBounds.width << std::endl;
-			std::cout << "  |     |     |-- height: " << spaceBounds.height << std::endl;
+			verboseOutput() << "  |     |-- reference space bounds" << std::endl;
+			verboseOutput() << "  |     |     |-- width: " << spaceBounds.width << std::endl;
+			verboseOutput() << "  |     |     |-- height: " << spaceBounds.height << std::endl;
 		}
 		// local
 		else if(referenceSpaces[i] == XR_REFERENCE_SPACE_TYPE_LOCAL){
@@ -1089,9 +3209,9 @@ bool OpenXrApplication::defineReferenceSpaces(){
 			if(!xrCheckResult(xr_instance, xr_result, "xrGetReferenceSpaceBoundsRect (XR_REFERENCE_SPACE_TYPE_LOCAL)"))
 				return false;
 			
-			std::cout << "  |     |-- reference space bounds" << std::endl;
-			std::cout << "  |     |     |-- width: " << spaceBounds.width << std::endl;
-			std::cout << "  |     |     |-- height: " << spaceBounds.height << std::endl;
+			verboseOutput() << "  |     |-- reference space bounds" << std::endl;
+			verboseOutput() << "  |     |     |-- width: " << spaceBounds.width << std::endl;
+			verboseOutput() << "  |     |     |-- height: " << spaceBounds.height << std::endl;
 		}
 		// stage
 		else if(referenceSpaces[i] == XR_REFERENCE_SPACE_TYPE_STAGE){
@@ -1104,9 +3224,9 @@ bool OpenXrApplication::defineReferenceSpaces(){
 			if(!xrCheckResult(xr_instance, xr_result, "xrGetReferenceSpaceBoundsRect (XR_REFERENCE_SPACE_TYPE_STAGE)"))
 				return false;
 			
-			std::cout << "  |     |-- reference space bounds" << std::endl;
-			std::cout << "  |     |     |-- width: " << spaceBounds.width << std::endl;
-			std::cout << "  |     |     |-- height: " << spaceBounds.height << std::endl;
+			verboseOutput() << "  |     |-- reference space bounds" << std::endl;
+			verboseOutput() << "  |     |     |-- width: " << spaceBounds.width << std::endl;
+			verboseOutput() << "  |     |     |-- height: " << spaceBounds.height << std::endl;
 		}
 	}
 	return true;
@@ -1359,7 +3479,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 	XrPath interactionProfilePath;
 	vector<XrActionSuggestedBinding> bindings;
 	XrInteractionProfileSuggestedBinding suggestedBindings = {XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING};
-	std::cout << "Suggested interaction bindings by profiles" << std::endl;
+	verboseOutput() << "Suggested interaction bindings by profiles" << std::endl;
 
 	// Khronos Simple Controller
 	bindings.clear();
@@ -1373,7 +3493,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 		if(!xrCheckResult(xr_instance, xr_result, "xrSuggestInteractionProfileBindings /interaction_profiles/khr/simple_controller"))
 			return false;
 	}
-	std::cout << "  |-- /interaction_profiles/khr/simple_controller (" << bindings.size() << ")" << std::endl;
+	verboseOutput() << "  |-- /interaction_profiles/khr/simple_controller (" << bindings.size() << ")" << std::endl;
 	
 	// Google Daydream Controller
 	bindings.clear();
@@ -1387,7 +3507,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 		if(!xrCheckResult(xr_instance, xr_result, "xrSuggestInteractionProfileBindings /interaction_profiles/google/daydream_controller"))
 			return false;
 	}
-	std::cout << "  |-- /interaction_profiles/google/daydream_controller (" << bindings.size() << ")" << std::endl;
+	verboseOutput() << "  |-- /interaction_profiles/google/daydream_controller (" << bindings.size() << ")" << std::endl;
 
 	// HTC Vive Controller
 	bindings.clear();
@@ -1401,7 +3521,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 		if(!xrCheckResult(xr_instance, xr_result, "xrSuggestInteractionProfileBindings /interaction_profiles/htc/vive_controller"))
 			return false;
 	}
-	std::cout << "  |-- /interaction_profiles/htc/vive_controller (" << bindings.size() << ")" << std::endl;
+	verboseOutput() << "  |-- /interaction_profiles/htc/vive_controller (" << bindings.size() << ")" << std::endl;
 
 	// HTC Vive Pro
 	bindings.clear();
@@ -1415,7 +3535,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 		if(!xrCheckResult(xr_instance, xr_result, "xrSuggestInteractionProfileBindings /interaction_profiles/htc/vive_pro"))
 			return false;
 	}
-	std::cout << "  |-- /interaction_profiles/htc/vive_pro (" << bindings.size() << ")" << std::endl;
+	verboseOutput() << "  |-- /interaction_profiles/htc/vive_pro (" << bindings.size() << ")" << std::endl;
 
 	// Microsoft Mixed Reality Motion Controller
 	bindings.clear();
@@ -1429,7 +3549,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 		if(!xrCheckResult(xr_instance, xr_result, "xrSuggestInteractionProfileBindings /interaction_profiles/microsoft/motion_controller"))
 			return false;
 	}
-	std::cout << "  |-- /interaction_profiles/microsoft/motion_controller (" << bindings.size() << ")" << std::endl;
+	verboseOutput() << "  |-- /interaction_profiles/microsoft/motion_controller (" << bindings.size() << ")" << std::endl;
 
 	// Microsoft Xbox Controller
 	bindings.clear();
@@ -1443,7 +3563,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 		if(!xrCheckResult(xr_instance, xr_result, "xrSuggestInteractionProfileBindings /interaction_profiles/microsoft/xbox_controller"))
 			return false;
 	}
-	std::cout << "  |-- /interaction_profiles/microsoft/xbox_controller (" << bindings.size() << ")" << std::endl;
+	verboseOutput() << "  |-- /interaction_profiles/microsoft/xbox_controller (" << bindings.size() << ")" << std::endl;
 
 	// Oculus Go Controller
 	bindings.clear();
@@ -1457,7 +3577,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 		if(!xrCheckResult(xr_instance, xr_result, "xrSuggestInteractionProfileBindings /interaction_profiles/oculus/go_controller"))
 			return false;
 	}
-	std::cout << "  |-- /interaction_profiles/oculus/go_controller (" << bindings.size() << ")" << std::endl;
+	verboseOutput() << "  |-- /interaction_profiles/oculus/go_controller (" << bindings.size() << ")" << std::endl;
 
 	// Oculus Touch Controller
 	bindings.clear();
@@ -1471,7 +3591,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 		if(!xrCheckResult(xr_instance, xr_result, "xrSuggestInteractionProfileBindings /interaction_profiles/oculus/touch_controller"))
 			return false;
 	}
-	std::cout << "  |-- /interaction_profiles/oculus/touch_controller (" << bindings.size() << ")" << std::endl;
+	verboseOutput() << "  |-- /interaction_profiles/oculus/touch_controller (" << bindings.size() << ")" << std::endl;
 
 	// Valve Index Controller
 	bindings.clear();
@@ -1485,7 +3605,7 @@ bool OpenXrApplication::suggestInteractionProfileBindings(){
 		if(!xrCheckResult(xr_instance, xr_result, "xrSuggestInteractionProfileBindings /interaction_profiles/valve/index_controller"))
 			return false;
 	}
-	std::cout << "  |-- /interaction_profiles/valve/index_controller (" << bindings.size() << ")" << std::endl;
+	verboseOutput() << "  |-- /interaction_profiles/valve/index_controller (" << bindings.size() << ")" << std::endl;
 	
 	return true;
 }
@@ -1513,28 +3633,55 @@ bool OpenXrApplication::defineSessionSpaces(){
 	return true;
 }
 
-bool OpenXrApplication::defineSwapchains(){
-	// get swapchain Formats
-	uint32_t propertyCountOutput;
-	xr_result = xrEnumerateSwapchainFormats(xr_session, 0, &propertyCountOutput, nullptr);
-	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateSwapchainFormats"))
+template <typename GraphicsHandler> bool OpenXrApplication::createSwapchain(GraphicsHandler & graphicsHandler, const XrSwapchainCreateInfo & swapchainCreateInfo, SwapchainHandler & swapchain){
+	xr_result = xrCreateSwapchain(xr_session, &swapchainCreateInfo, &swapchain.handle);
+	if(!xrCheckResult(xr_instance, xr_result, "xrCreateSwapchain"))
 		return false;
-	vector<int64_t> swapchainFormats(propertyCountOutput);
-	xr_result = xrEnumerateSwapchainFormats(xr_session, propertyCountOutput, &propertyCountOutput, swapchainFormats.data());
-	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateSwapchainFormats"))
+
+	swapchain.width = swapchainCreateInfo.width;
+	swapchain.height = swapchainCreateInfo.height;
+
+	// enumerate swapchain images
+	uint32_t propertyCountOutput;
+	xr_result = xrEnumerateSwapchainImages(swapchain.handle, 0, &propertyCountOutput, nullptr);
+	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateSwapchainImages"))
 		return false;
 
+	swapchain.length = propertyCountOutput;
+	xrEnumerateSwapchainImages(swapchain.handle, propertyCountOutput, &propertyCountOutput, graphicsHandler.allocateSwapchainImages(swapchain, propertyCountOutput));
+
+	// per-image resources of the color and depth swapchains (OpenGL: framebuffer with the image attached)
+	if(!(swapchainCreateInfo.usageFlags & (XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)))
+		return true;
+	graphicsHandler.acquireContext();
+	return graphicsHandler.prepareSwapchainImages(swapchain, swapchainCreateInfo.usageFlags & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+}
+
+template <typename GraphicsHandler> bool OpenXrApplication::defineSwapchains(GraphicsHandler & graphicsHandler){
+	// get swapchain Formats (or reuse the cached enumeration of the same runtime, system and graphics binding)
+	uint32_t propertyCountOutput;
+	string key = xr_system_key + ":" + graphicsHandler.getExtensionName() + (flagEglBinding ? ":egl" : ":default");
+	auto cachedFormats = runtimeEnumerationCache.swapchainFormats.find(key);
+	bool cached = cachedFormats != runtimeEnumerationCache.swapchainFormats.end();
+	vector<int64_t> swapchainFormats = cached ? cachedFormats->second : vector<int64_t>();
+	if(!cached){
+		xr_result = xrEnumerateSwapchainFormats(xr_session, 0, &propertyCountOutput, nullptr);
+		if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateSwapchainFormats"))
+			return false;
+		swapchainFormats.resize(propertyCountOutput);
+		xr_result = xrEnumerateSwapchainFormats(xr_session, propertyCountOutput, &propertyCountOutput, swapchainFormats.data());
+		if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateSwapchainFormats"))
+			return false;
+		runtimeEnumerationCache.swapchainFormats[key] = swapchainFormats;
+	}
+	xr_swapchain_formats = swapchainFormats;
+
 	// select swapchain format
-#ifdef XR_USE_GRAPHICS_API_VULKAN
-	int64_t supportedSwapchainFormats[] = {VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM};
-#endif
-#ifdef XR_USE_GRAPHICS_API_OPENGL
-	int64_t supportedSwapchainFormats[] = {GL_RGB10_A2, GL_RGBA16F, GL_RGBA8, GL_RGBA8_SNORM};
-#endif
+	vector<int64_t> supportedSwapchainFormats = graphicsHandler.getSupportedSwapchainFormats();
 
 	int64_t selectedSwapchainFormats = -1;
 	for(size_t i = 0; i < swapchainFormats.size(); i++){
-		for (size_t j = 0; j < _countof(supportedSwapchainFormats); j++)
+		for (size_t j = 0; j < supportedSwapchainFormats.size(); j++)
 			if(swapchainFormats[i] == supportedSwapchainFormats[j]){
 				selectedSwapchainFormats = swapchainFormats[i];
 				break;
@@ -1545,16 +3692,17 @@ bool OpenXrApplication::defineSwapchains(){
 
 	if((selectedSwapchainFormats == -1) && swapchainFormats.size())
 		selectedSwapchainFormats = swapchainFormats[0];
+	xr_swapchain_format = selectedSwapchainFormats;
 
-	std::cout << "Swapchain formats (" << swapchainFormats.size() << ")" << std::endl;
+	verboseOutput() << "Swapchain formats (" << swapchainFormats.size() << ")" << (cached ? " (cached)" : "") << std::endl;
 	for (size_t i = 0; i < swapchainFormats.size(); i++){
-		std::cout << "  |-- format: " << swapchainFormats[i] << std::endl;
+		verboseOutput() << "  |-- format: " << swapchainFormats[i] << std::endl;
 		if (swapchainFormats[i] == selectedSwapchainFormats)
-			std::cout << "  |   (selected)" << std::endl;
+			verboseOutput() << "  |   (selected)" << std::endl;
 	}
 
 	// create swapchain per view
-	std::cout << "Created swapchain (" << xr_view_configuration_views.size() << ")" << std::endl;
+	verboseOutput() << "Created swapchain (" << xr_view_configuration_views.size() << ")" << std::endl;
 
 	for(uint32_t i = 0; i < xr_view_configuration_views.size(); i++){
 		XrSwapchainCreateInfo swapchainCreateInfo = {XR_TYPE_SWAPCHAIN_CREATE_INFO};
@@ -1564,59 +3712,162 @@ bool OpenXrApplication::defineSwapchains(){
 		swapchainCreateInfo.height = xr_view_configuration_views[i].recommendedImageRectHeight;
 		swapchainCreateInfo.mipCount = 1;
 		swapchainCreateInfo.faceCount = 1;
-		swapchainCreateInfo.sampleCount = xr_graphics_handler.getSupportedSwapchainSampleCount(xr_view_configuration_views[i]);
-		swapchainCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+		swapchainCreateInfo.sampleCount = graphicsHandler.getSupportedSwapchainSampleCount(xr_view_configuration_views[i]);
+		swapchainCreateInfo.usageFlags = graphicsHandler.getSwapchainUsageFlags();
 		
 		SwapchainHandler swapchain;
-		xr_result = xrCreateSwapchain(xr_session, &swapchainCreateInfo, &swapchain.handle);
-		if(!xrCheckResult(xr_instance, xr_result, "xrCreateSwapchain"))
+		if(!createSwapchain(graphicsHandler, swapchainCreateInfo, swapchain))
 			return false;
 
-		swapchain.width = swapchainCreateInfo.width;
-		swapchain.height = swapchainCreateInfo.height;
+		verboseOutput() << "  |-- swapchain: " << i << std::endl;
+		verboseOutput() << "  |     |-- width: " << swapchainCreateInfo.width << std::endl;
+		verboseOutput() << "  |     |-- height: " << swapchainCreateInfo.height << std::endl;
+		verboseOutput() << "  |     |-- sample count: " << swapchainCreateInfo.sampleCount << std::endl;
+		verboseOutput() << "  |     |-- swapchain images: " << swapchain.length << std::endl;
 
-		std::cout << "  |-- swapchain: " << i << std::endl;
-		std::cout << "  |     |-- width: " << swapchainCreateInfo.width << std::endl;
-		std::cout << "  |     |-- height: " << swapchainCreateInfo.height << std::endl;
-		std::cout << "  |     |-- sample count: " << swapchainCreateInfo.sampleCount << std::endl;
-	
-		// enumerate swapchain images
-		xr_result = xrEnumerateSwapchainImages(swapchain.handle, 0, &propertyCountOutput, nullptr);
-		if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateSwapchainImages"))
-			return false;
+		xr_swapchains_handlers.push_back(swapchain);
+	}
+	return true;
+}
 
-		swapchain.length = propertyCountOutput;
-#ifdef XR_USE_GRAPHICS_API_VULKAN
-		swapchain.images.resize(propertyCountOutput, {XR_TYPE_SWAPCHAIN_IMAGE_VULKAN2_KHR});
-#endif
-#ifdef XR_USE_GRAPHICS_API_OPENGL
-		swapchain.images.resize(propertyCountOutput, {XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR});
-#endif
-		xrEnumerateSwapchainImages(swapchain.handle, propertyCountOutput, &propertyCountOutput, (XrSwapchainImageBaseHeader*)swapchain.images.data());
-		std::cout << "  |     |-- swapchain images: " << propertyCountOutput << std::endl;
+// first format (runtime order) supported by the graphics backend, or -1
+static int64_t selectSwapchainFormat(const vector<int64_t> & runtimeFormats, const vector<int64_t> & supportedFormats){
+	for(size_t i = 0; i < runtimeFormats.size(); i++)
+		if(std::find(supportedFormats.begin(), supportedFormats.end(), runtimeFormats[i]) != supportedFormats.end())
+			return runtimeFormats[i];
+	return -1;
+}
 
-		xr_swapchains_handlers.push_back(swapchain);
+template <typename GraphicsHandler> bool OpenXrApplication::defineDepthSwapchains(GraphicsHandler & graphicsHandler){
+	xr_depth_swapchain_format = selectSwapchainFormat(xr_swapchain_formats, graphicsHandler.getSupportedDepthSwapchainFormats());
+	if(xr_depth_swapchain_format == -1){
+		XR_LOG_WARNING("No depth swapchain format is supported by both the runtime and the graphics backend. The depth is not submitted");
+		return false;
 	}
 
-#ifdef XR_USE_GRAPHICS_API_OPENGL
-	// acquire GL context
-	glXMakeCurrent(xr_graphics_binding.xDisplay, xr_graphics_binding.glxDrawable, xr_graphics_binding.glxContext);
-#endif
+	verboseOutput() << "Created depth swapchain (" << xr_view_configuration_views.size() << ", format: " << xr_depth_swapchain_format << ")" << std::endl;
+	for(uint32_t i = 0; i < xr_view_configuration_views.size(); i++){
+		XrSwapchainCreateInfo swapchainCreateInfo = {XR_TYPE_SWAPCHAIN_CREATE_INFO};
+		swapchainCreateInfo.arraySize = 1;
+		swapchainCreateInfo.format = xr_depth_swapchain_format;
+		swapchainCreateInfo.width = xr_view_configuration_views[i].recommendedImageRectWidth;
+		swapchainCreateInfo.height = xr_view_configuration_views[i].recommendedImageRectHeight;
+		swapchainCreateInfo.mipCount = 1;
+		swapchainCreateInfo.faceCount = 1;
+		swapchainCreateInfo.sampleCount = 1;
+		swapchainCreateInfo.usageFlags = graphicsHandler.getDepthSwapchainUsageFlags();
+
+		SwapchainHandler swapchain;
+		if(!createSwapchain(graphicsHandler, swapchainCreateInfo, swapchain))
+			return false;
+		verboseOutput() << "  |-- depth swapchain: " << i << " (" << swapchain.width << " x " << swapchain.height << ", images: " << swapchain.length << ")" << std::endl;
+		xr_depth_swapchains_handlers.push_back(swapchain);
+	}
+	return true;
+}
+
+template <typename GraphicsHandler> bool OpenXrApplication::defineSpaceWarpSwapchains(GraphicsHandler & graphicsHandler){
+	xr_motion_vector_swapchain_format = selectSwapchainFormat(xr_swapchain_formats, graphicsHandler.getSupportedMotionVectorSwapchainFormats());
+	int64_t depthSwapchainFormat = selectSwapchainFormat(xr_swapchain_formats, graphicsHandler.getSupportedDepthSwapchainFormats());
+	if(xr_motion_vector_swapchain_format == -1 || depthSwapchainFormat == -1){
+		XR_LOG_WARNING("No motion vector or depth swapchain format is supported by both the runtime and the graphics backend. Space warp is not used");
+		return false;
+	}
+	// same selection as the depth swapchains of XR_KHR_composition_layer_depth
+	xr_depth_swapchain_format = depthSwapchainFormat;
+
+	verboseOutput() << "Created space warp swapchains (" << xr_view_configuration_views.size() << ", formats: " << xr_motion_vector_swapchain_format << ", " << xr_depth_swapchain_format << ")" << std::endl;
+	for(uint32_t i = 0; i < xr_view_configuration_views.size(); i++){
+		XrSwapchainCreateInfo swapchainCreateInfo = {XR_TYPE_SWAPCHAIN_CREATE_INFO};
+		swapchainCreateInfo.arraySize = 1;
+		swapchainCreateInfo.width = xr_space_warp_properties.recommendedMotionVectorImageRectWidth;
+		swapchainCreateInfo.height = xr_space_warp_properties.recommendedMotionVectorImageRectHeight;
+		swapchainCreateInfo.mipCount = 1;
+		swapchainCreateInfo.faceCount = 1;
+		swapchainCreateInfo.sampleCount = 1;
+
+		SwapchainHandler motionVectorSwapchain, depthSwapchain;
+		swapchainCreateInfo.format = xr_motion_vector_swapchain_format;
+		swapchainCreateInfo.usageFlags = graphicsHandler.getMotionVectorSwapchainUsageFlags();
+		if(!createSwapchain(graphicsHandler, swapchainCreateInfo, motionVectorSwapchain))
+			return false;
+		xr_motion_vector_swapchains_handlers.push_back(motionVectorSwapchain);
+		swapchainCreateInfo.format = xr_depth_swapchain_format;
+		swapchainCreateInfo.usageFlags = graphicsHandler.getDepthSwapchainUsageFlags();
+		if(!createSwapchain(graphicsHandler, swapchainCreateInfo, depthSwapchain))
+			return false;
+		xr_space_warp_depth_swapchains_handlers.push_back(depthSwapchain);
+		verboseOutput() << "  |-- space warp swapchains: " << i << " (" << motionVectorSwapchain.width << " x " << motionVectorSwapchain.height << ", images: " << motionVectorSwapchain.length << ")" << std::endl;
+	}
 	return true;
 }
 
+template <typename GraphicsHandler> bool OpenXrApplication::defineCompositionLayerSwapchain(GraphicsHandler & graphicsHandler, CompositionLayer & compositionLayer){
+	XrSwapchainCreateInfo swapchainCreateInfo = {XR_TYPE_SWAPCHAIN_CREATE_INFO};
+	swapchainCreateInfo.arraySize = 1;
+	swapchainCreateInfo.format = xr_swapchain_format;
+	swapchainCreateInfo.width = compositionLayer.width;
+	swapchainCreateInfo.height = compositionLayer.height;
+	swapchainCreateInfo.mipCount = 1;
+	swapchainCreateInfo.faceCount = 1;
+	swapchainCreateInfo.sampleCount = 1;
+	swapchainCreateInfo.usageFlags = graphicsHandler.getSwapchainUsageFlags();
+	// cube map (XR_KHR_composition_layer_cube): the faces are copied once into a static swapchain
+	if(compositionLayer.type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR){
+		swapchainCreateInfo.createFlags = XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT;
+		swapchainCreateInfo.faceCount = 6;
+		swapchainCreateInfo.usageFlags = graphicsHandler.getCubeSwapchainUsageFlags();
+	}
+
+	// the content (if any) is uploaded in the next frame
+	compositionLayer.uploaded = false;
+	compositionLayer.dirty = !compositionLayer.frameData.empty();
+	return createSwapchain(graphicsHandler, swapchainCreateInfo, compositionLayer.swapchain);
+}
 
 bool OpenXrApplication::createInstance(const string & applicationName, const string & engineName, const vector<string> & requestedApiLayers, const vector<string> & requestedExtensions){
+	// replay mode: no runtime is required
+	if(flagReplay)
+		return true;
+
 	vector<string> enabledApiLayers;
 	vector<string> enabledExtensions;
 
+	xr_application_name = applicationName;
+	xr_engine_name = engineName;
+	xr_requested_api_layers = requestedApiLayers;
+	xr_requested_extensions = requestedExtensions;
+
+	xr_startup_timing.assign(STARTUP_PHASE_COUNT, 0);
+	beginStartupPhase();
+
 	// layers
 	if(!defineLayers(requestedApiLayers, enabledApiLayers))
 		return false;
 
 	// extensions
-	if(!defineExtensions(requestedExtensions, enabledExtensions))
+	vector<string> optionalExtensions = {XR_EXT_PERFORMANCE_SETTINGS_EXTENSION_NAME, XR_EXT_THERMAL_QUERY_EXTENSION_NAME, XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME, 
+										  XR_KHR_COMPOSITION_LAYER_CYLINDER_EXTENSION_NAME, XR_KHR_COMPOSITION_LAYER_EQUIRECT2_EXTENSION_NAME, XR_KHR_COMPOSITION_LAYER_CUBE_EXTENSION_NAME, 
+										  XR_KHR_COMPOSITION_LAYER_COLOR_SCALE_BIAS_EXTENSION_NAME, XR_KHR_VISIBILITY_MASK_EXTENSION_NAME, 
+										  XR_FB_SPACE_WARP_EXTENSION_NAME, XR_VARJO_QUAD_VIEWS_EXTENSION_NAME, 
+										  XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME, XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME};
+	if(flagDebugUtils)
+		optionalExtensions.push_back(XR_EXT_DEBUG_UTILS_EXTENSION_NAME);
+#ifdef XR_USE_PLATFORM_EGL
+	if(flagEgl)
+		optionalExtensions.push_back(XR_MNDX_EGL_ENABLE_EXTENSION_NAME);
+#endif
+	// tracking-only session: the graphics extension of the fallback backend is only enabled if supported
+	if(flagHeadless){
+		optionalExtensions.push_back(XR_MND_HEADLESS_EXTENSION_NAME);
+		dispatchGraphicsHandler([&optionalExtensions](auto & handler){
+			optionalExtensions.push_back(handler.getExtensionName());
+			return true;
+		});
+	}
+	if(!defineExtensions(requestedExtensions, optionalExtensions, enabledExtensions))
 		return false;
+	endStartupPhase(STARTUP_PHASE_ENUMERATION);
 
 	vector<const char*> enabledApiLayerNames = cast_to_vector_char_p(enabledApiLayers);
 	vector<const char*> enabledExtensionNames = cast_to_vector_char_p(enabledExtensions);
@@ -1639,10 +3890,40 @@ bool OpenXrApplication::createInstance(const string & applicationName, const str
 	xr_result = xrCreateInstance(&createInfo, &xr_instance);
 	if(!xrCheckResult(NULL, xr_result, "xrCreateInstance"))
 		return false;
+
+	xr_enabled_extensions = enabledExtensions;
+	loadExtensionFunctions();
+	endStartupPhase(STARTUP_PHASE_INSTANCE);
 	return true;
 }
 
 bool OpenXrApplication::getSystem(XrFormFactor formFactor, XrEnvironmentBlendMode blendMode, XrViewConfigurationType configurationType){
+	// replay mode: use the recorded view configuration
+	if(flagReplay){
+		configViewConfigurationType = xr_replayer->getViewConfigurationType();
+		environmentBlendMode = xr_replayer->getEnvironmentBlendMode();
+		xr_view_configuration_views = xr_replayer->getViewConfigurationViews();
+		xr_frames_data.resize(xr_view_configuration_views.size());
+		xr_frames_width.resize(xr_view_configuration_views.size());
+		xr_frames_height.resize(xr_view_configuration_views.size());
+		xr_depth_frames.resize(xr_view_configuration_views.size());
+		xr_space_warp_frames.resize(xr_view_configuration_views.size());
+		XR_LOG_INFO("Replay view configuration: " << _enum_to_string(configViewConfigurationType) << " (" << xr_view_configuration_views.size() << " views)");
+		return true;
+	}
+
+	// the quad view configuration (two context and two inner foveal views) is only enumerated with its extension
+	if(configurationType == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO && !isExtensionEnabled(XR_VARJO_QUAD_VIEWS_EXTENSION_NAME)){
+		XR_LOG_ERROR(XR_VARJO_QUAD_VIEWS_EXTENSION_NAME << " is not supported by the runtime. Use a stereo or mono view configuration");
+		return false;
+	}
+
+	xr_form_factor = formFactor;
+	xr_requested_blend_mode = blendMode;
+	xr_requested_configuration_type = configurationType;
+
+	beginStartupPhase();
+
 	XrSystemGetInfo systemInfo = {XR_TYPE_SYSTEM_GET_INFO};
 	systemInfo.formFactor = formFactor;
 
@@ -1654,6 +3935,7 @@ bool OpenXrApplication::getSystem(XrFormFactor formFactor, XrEnvironmentBlendMod
 		return false;
 	if(!acquireSystemProperties())
 		return false;
+	xr_system_key += ":" + std::to_string(formFactor);
 	if(!acquireViewConfiguration(configurationType))
 		return false;
  	if(!acquireBlendModes(blendMode))
@@ -1668,79 +3950,244 @@ bool OpenXrApplication::getSystem(XrFormFactor formFactor, XrEnvironmentBlendMod
 	xr_result = xrCreateActionSet(xr_instance, &actionSetInfo, &xr_action_set);
 	if(!xrCheckResult(xr_instance, xr_result, "xrCreateActionSet"))
 		return false;
+	endStartupPhase(STARTUP_PHASE_SYSTEM);
 	return true;
 }
 
-bool OpenXrApplication::createSession(){
+bool OpenXrApplication::defineGraphicsBinding(){
+	bool status = false;
 #ifdef XR_USE_GRAPHICS_API_VULKAN
-	xr_graphics_handler.createInstance(xr_instance, xr_system_id);
-	xr_graphics_handler.getPhysicalDevice(xr_instance, xr_system_id);
-	xr_graphics_handler.createLogicalDevice(xr_instance, xr_system_id);
-
-    xr_graphics_binding.instance = xr_graphics_handler.getInstance();
-    xr_graphics_binding.physicalDevice = xr_graphics_handler.getPhysicalDevice();
-    xr_graphics_binding.device = xr_graphics_handler.getLogicalDevice();
-    xr_graphics_binding.queueFamilyIndex = xr_graphics_handler.getQueueFamilyIndex();
-    xr_graphics_binding.queueIndex = 0;
-
-	std::cout << "Graphics binding: Vulkan" << std::endl;
-	std::cout << "  |-- instance: " << xr_graphics_binding.instance << std::endl;
-	std::cout << "  |-- physical device: " << xr_graphics_binding.physicalDevice << std::endl;
-	std::cout << "  |-- device: " << xr_graphics_binding.device << std::endl;
-	std::cout << "  |-- queue family index: " << xr_graphics_binding.queueFamilyIndex << std::endl;
-	std::cout << "  |-- queue index: " << xr_graphics_binding.queueIndex << std::endl;
+	if(xr_graphics_backend == GRAPHICS_BACKEND_VULKAN)
+		status = defineVulkanGraphicsBinding();
 #endif
 #ifdef XR_USE_GRAPHICS_API_OPENGL
-	if(!xr_graphics_handler.getRequirements(xr_instance, xr_system_id))
+	if(xr_graphics_backend == GRAPHICS_BACKEND_OPENGL)
+		status = defineOpenGLGraphicsBinding();
+#endif
+	if(!status)
+		return false;
+
+	// upload worker (frames are uploaded as soon as they are set, outside the swapchain image acquire/release interval)
+	if(flagUploadWorker){
+		if(dispatchGraphicsHandler([this](auto & handler){ return handler.startUploadWorker(xr_view_configuration_views.size()); }))
+			verboseOutput() << "Upload worker: started" << std::endl;
+		else
+			XR_LOG_WARNING("Unable to start the upload worker. Frames are uploaded in the frame loop");
+	}
+	endStartupPhase(STARTUP_PHASE_GRAPHICS_RESOURCES);
+	return true;
+}
+
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+bool OpenXrApplication::defineVulkanGraphicsBinding(){
+	if(!xr_graphics->vulkanHandler.createInstance(xr_instance, xr_system_id))
 		return false;
-	if(!xr_graphics_handler.initGraphicsBinding(&xr_graphics_binding.xDisplay, 
-												&xr_graphics_binding.visualid,
-												&xr_graphics_binding.glxFBConfig, 
-												&xr_graphics_binding.glxDrawable,
-												&xr_graphics_binding.glxContext,
-												xr_view_configuration_views[0].recommendedImageRectWidth,
-												xr_view_configuration_views[0].recommendedImageRectHeight))
+	if(!xr_graphics->vulkanHandler.getPhysicalDevice(xr_instance, xr_system_id))
 		return false;
-	if(!xr_graphics_handler.initResources(xr_instance, xr_system_id))
+	if(!xr_graphics->vulkanHandler.createLogicalDevice(xr_instance, xr_system_id))
+		return false;
+	endStartupPhase(STARTUP_PHASE_GRAPHICS_BINDING);
+	if(!xr_graphics->vulkanHandler.initResources(xr_instance, xr_system_id))
+		return false;
+
+    xr_graphics->vulkanBinding.instance = xr_graphics->vulkanHandler.getInstance();
+    xr_graphics->vulkanBinding.physicalDevice = xr_graphics->vulkanHandler.getPhysicalDevice();
+    xr_graphics->vulkanBinding.device = xr_graphics->vulkanHandler.getLogicalDevice();
+    xr_graphics->vulkanBinding.queueFamilyIndex = xr_graphics->vulkanHandler.getQueueFamilyIndex();
+    xr_graphics->vulkanBinding.queueIndex = 0;
+
+	verboseOutput() << "Graphics binding: Vulkan" << std::endl;
+	verboseOutput() << "  |-- instance: " << xr_graphics->vulkanBinding.instance << std::endl;
+	verboseOutput() << "  |-- physical device: " << xr_graphics->vulkanBinding.physicalDevice << std::endl;
+	verboseOutput() << "  |-- device: " << xr_graphics->vulkanBinding.device << std::endl;
+	verboseOutput() << "  |-- queue family index: " << xr_graphics->vulkanBinding.queueFamilyIndex << std::endl;
+	verboseOutput() << "  |-- queue index: " << xr_graphics->vulkanBinding.queueIndex << std::endl;
+	return true;
+}
+#endif
+
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+bool OpenXrApplication::defineOpenGLGraphicsBinding(){
+	if(!xr_graphics->openglHandler.getRequirements(xr_instance, xr_system_id))
 		return false;
 
-	std::cout << "Graphics binding: OpenGL" << std::endl;
-	std::cout << "  |-- xDisplay: " << xr_graphics_binding.xDisplay << std::endl;
-	std::cout << "  |-- visualid: " << xr_graphics_binding.visualid << std::endl;
-	std::cout << "  |-- glxFBConfig: " << xr_graphics_binding.glxFBConfig << std::endl;
-	std::cout << "  |-- glxDrawable: " << xr_graphics_binding.glxDrawable << std::endl;
-	std::cout << "  |-- glxContext: " << xr_graphics_binding.glxContext << std::endl;
+	// EGL (if requested and supported by the runtime), otherwise SDL window and GLX
+	flagEglBinding = false;
+#ifdef XR_USE_PLATFORM_EGL
+	if(flagEgl){
+		if(!isExtensionEnabled(XR_MNDX_EGL_ENABLE_EXTENSION_NAME))
+			XR_LOG_WARNING(XR_MNDX_EGL_ENABLE_EXTENSION_NAME << " is not supported by the runtime. Using GLX");
+		else if(!xr_graphics->openglHandler.initEglGraphicsBinding(&xr_graphics->eglBinding)){
+			XR_LOG_WARNING("Unable to create the EGL context. Using GLX");
+			xr_graphics->openglHandler.releaseResources();
+		}
+		else
+			flagEglBinding = true;
+	}
+	if(flagEglBinding){
+		verboseOutput() << "Graphics binding: OpenGL (EGL)" << std::endl;
+		verboseOutput() << "  |-- display: " << xr_graphics->eglBinding.display << std::endl;
+		verboseOutput() << "  |-- config: " << xr_graphics->eglBinding.config << std::endl;
+		verboseOutput() << "  |-- context: " << xr_graphics->eglBinding.context << std::endl;
+	}
+#endif
+	if(!flagEglBinding){
+		if(!xr_graphics->openglHandler.initGraphicsBinding(&xr_graphics->openglBinding.xDisplay, 
+												  &xr_graphics->openglBinding.visualid,
+												  &xr_graphics->openglBinding.glxFBConfig, 
+												  &xr_graphics->openglBinding.glxDrawable,
+												  &xr_graphics->openglBinding.glxContext,
+												  xr_view_configuration_views[0].recommendedImageRectWidth,
+												  xr_view_configuration_views[0].recommendedImageRectHeight))
+			return false;
+
+		verboseOutput() << "Graphics binding: OpenGL" << std::endl;
+		verboseOutput() << "  |-- xDisplay: " << xr_graphics->openglBinding.xDisplay << std::endl;
+		verboseOutput() << "  |-- visualid: " << xr_graphics->openglBinding.visualid << std::endl;
+		verboseOutput() << "  |-- glxFBConfig: " << xr_graphics->openglBinding.glxFBConfig << std::endl;
+		verboseOutput() << "  |-- glxDrawable: " << xr_graphics->openglBinding.glxDrawable << std::endl;
+		verboseOutput() << "  |-- glxContext: " << xr_graphics->openglBinding.glxContext << std::endl;
+	}
+	endStartupPhase(STARTUP_PHASE_GRAPHICS_BINDING);
+	return xr_graphics->openglHandler.initResources(xr_instance, xr_system_id);
+}
 #endif
 
+bool OpenXrApplication::createSession(){
+	// replay mode: the session runs until the end of the log
+	if(flagReplay){
+		flagSessionRunning = true;
+		return true;
+	}
+
+	beginStartupPhase();
+
+	// tracking-only mode (if requested and supported by the runtime): no graphics binding and no swapchains
+	flagHeadlessSession = false;
+	if(flagHeadless){
+		if(!isExtensionEnabled(XR_MND_HEADLESS_EXTENSION_NAME))
+			XR_LOG_WARNING(XR_MND_HEADLESS_EXTENSION_NAME << " is not supported by the runtime. Using graphics binding");
+		else
+			flagHeadlessSession = true;
+	}
+	if(flagHeadlessSession)
+		verboseOutput() << "Graphics binding: none (" << XR_MND_HEADLESS_EXTENSION_NAME << ")" << std::endl;
+	else if(!defineGraphicsBinding())
+		return false;
+	return createSessionObjects();
+}
+
+bool OpenXrApplication::createSessionObjects(){
 	// create session
 	XrSessionCreateInfo sessionInfo = {XR_TYPE_SESSION_CREATE_INFO};
-	sessionInfo.next = &xr_graphics_binding;
+	sessionInfo.next = nullptr;
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+	if(xr_graphics_backend == GRAPHICS_BACKEND_VULKAN)
+		sessionInfo.next = &xr_graphics->vulkanBinding;
+#endif
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+	if(xr_graphics_backend == GRAPHICS_BACKEND_OPENGL)
+		sessionInfo.next = &xr_graphics->openglBinding;
+#endif
+#ifdef XR_USE_PLATFORM_EGL
+	if(flagEglBinding)
+		sessionInfo.next = &xr_graphics->eglBinding;
+#endif
+	if(flagHeadlessSession)
+		sessionInfo.next = nullptr;
 	sessionInfo.systemId = xr_system_id;
 
 	xr_result = xrCreateSession(xr_instance, &sessionInfo, &xr_session);
 	if(!xrCheckResult(xr_instance, xr_result, "xrCreateSession"))
 		return false;
+	endStartupPhase(STARTUP_PHASE_SESSION);
+
+	// visibility masks are fetched on first use (XR_KHR_visibility_mask)
+	xr_visibility_masks.assign(xr_view_configuration_views.size(), VisibilityMask());
+
+	// display refresh rate requested for the previous session, if any (XR_FB_display_refresh_rate)
+	if(xr_requested_display_refresh_rate && xrRequestDisplayRefreshRateFB){
+		xr_result = xrRequestDisplayRefreshRateFB(xr_session, xr_requested_display_refresh_rate);
+		xrCheckResult(xr_instance, xr_result, "xrRequestDisplayRefreshRateFB");
+	}
+
+	// reprojection modes supported for the view configuration (XR_MSFT_composition_layer_reprojection)
+	xr_reprojection_modes.clear();
+	if(xrEnumerateReprojectionModesMSFT){
+		uint32_t modeCountOutput;
+		xr_result = xrEnumerateReprojectionModesMSFT(xr_instance, xr_system_id, configViewConfigurationType, 0, &modeCountOutput, nullptr);
+		if(xrCheckResult(xr_instance, xr_result, "xrEnumerateReprojectionModesMSFT")){
+			xr_reprojection_modes.resize(modeCountOutput);
+			xr_result = xrEnumerateReprojectionModesMSFT(xr_instance, xr_system_id, configViewConfigurationType, modeCountOutput, &modeCountOutput, xr_reprojection_modes.data());
+			if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateReprojectionModesMSFT"))
+				xr_reprojection_modes.clear();
+		}
+		verboseOutput() << "Reprojection modes (" << xr_reprojection_modes.size() << ")" << std::endl;
+		for(size_t i = 0; i < xr_reprojection_modes.size(); i++)
+			verboseOutput() << "  |-- mode: " << _enum_to_string(xr_reprojection_modes[i]) << std::endl;
+	}
+	// mode requested for the previous session (or before the session was created), if any
+	if(xr_reprojection_mode && std::find(xr_reprojection_modes.begin(), xr_reprojection_modes.end(), xr_reprojection_mode) == xr_reprojection_modes.end()){
+		XR_LOG_WARNING("Unsupported reprojection mode: " << _enum_to_string(xr_reprojection_mode) << ". The runtime default is used");
+		xr_reprojection_mode = XrReprojectionModeMSFT(0);
+	}
 
 	// reference spaces
 	if(!defineReferenceSpaces())
 		return false;
+	endStartupPhase(STARTUP_PHASE_REFERENCE_SPACES);
 
-	// suggest interaction profile bindings
-	if(!suggestInteractionProfileBindings())
-		return false;
+	// suggest interaction profile bindings (once per instance: they are kept when the session is recreated)
+	if(!flagBindingsSuggested){
+		if(!suggestInteractionProfileBindings())
+			return false;
+		flagBindingsSuggested = true;
+	}
+	endStartupPhase(STARTUP_PHASE_INTERACTION_PROFILES);
 
 	// action spaces / attach session action sets
 	if(!defineSessionSpaces())
 		return false;
+	endStartupPhase(STARTUP_PHASE_ACTION_SPACES);
 
-	// swapchains
-	if(!defineSwapchains())
+	// swapchains (views and quad layers)
+	if(!flagHeadlessSession && !dispatchGraphicsHandler([this](auto & handler){
+			if(!defineSwapchains(handler))
+				return false;
+			for(size_t i = 0; i < xr_composition_layers.size(); i++)
+				if(xr_composition_layers[i].active && !defineCompositionLayerSwapchain(handler, xr_composition_layers[i]))
+					return false;
+			return true;
+		}))
 		return false;
+	endStartupPhase(STARTUP_PHASE_SWAPCHAINS);
+
+	double total = 0;
+	verboseOutput() << "Startup timing (ms)" << std::endl;
+	for(size_t i = 0; i < xr_startup_timing.size(); i++){
+		verboseOutput() << "  |-- " << startupPhaseNames[i] << ": " << xr_startup_timing[i] << std::endl;
+		total += xr_startup_timing[i];
+	}
+	verboseOutput() << "  |-- total: " << total << std::endl;
 	return true;
 }
 
 bool OpenXrApplication::pollEvents(bool * exitLoop){
 	*exitLoop = false;
+	if(flagReplay){
+		if(xr_replayer->isFinished()){
+			XR_LOG_INFO("Replay finished");
+			flagSessionRunning = false;
+			*exitLoop = true;
+		}
+		return true;
+	}
+	// lost session or instance: no events are polled until they are recreated
+	if(xr_recovery_state != RECOVERY_NONE){
+		attemptRecovery();
+		if(xr_recovery_state != RECOVERY_NONE)
+			return true;
+	}
 	XrEventDataBuffer event;
 
 	while(true){
@@ -1750,7 +4197,7 @@ bool OpenXrApplication::pollEvents(bool * exitLoop){
 
 		xr_result = xrPollEvent(xr_instance, &event);
 		if(!xrCheckResult(xr_instance, xr_result, "xrPollEvent"))
-			return false;
+			return handleLoss(xr_result);
 
 		// process messages
 		switch(event.type){
@@ -1765,18 +4212,21 @@ bool OpenXrApplication::pollEvents(bool * exitLoop){
 			// event queue overflowed (some events were removed)
 			case XR_TYPE_EVENT_DATA_EVENTS_LOST: {
                 const XrEventDataEventsLost & eventsLost = *reinterpret_cast<XrEventDataEventsLost*>(&event);
-				std::cout << "Event queue has overflowed (" << eventsLost.lostEventCount << " overflowed event(s))" << std::endl;
+				XR_LOG_INFO("Event queue has overflowed (" << eventsLost.lostEventCount << " overflowed event(s))");
 				break;
             }
 			// session state changed
 			case XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED: {
 				const XrEventDataSessionStateChanged & sessionStateChangedEvent = *reinterpret_cast<XrEventDataSessionStateChanged*>(&event);
 
-				std::cout << "XrEventDataSessionStateChanged to " << _enum_to_string(sessionStateChangedEvent.state) << " (" << sessionStateChangedEvent.state << ")" << std::endl;
+				XR_LOG_INFO("XrEventDataSessionStateChanged to " << _enum_to_string(sessionStateChangedEvent.state) << " (" << sessionStateChangedEvent.state << ")");
 				
 				// check session
 				if((sessionStateChangedEvent.session != XR_NULL_HANDLE) && (sessionStateChangedEvent.session != xr_session)){
-					std::cout << "XrEventDataSessionStateChanged for unknown session " << sessionStateChangedEvent.session << std::endl;
+					XR_LOG_INFO("XrEventDataSessionStateChanged for unknown session " << sessionStateChangedEvent.session);
+					// events queued for a session destroyed by the recovery
+					if(flagSessionRecovery)
+						break;
 					return false;
 				}
 				
@@ -1790,7 +4240,7 @@ bool OpenXrApplication::pollEvents(bool * exitLoop){
 							return false;
 
 						flagSessionRunning = true;
-						std::cout << "Event: XR_SESSION_STATE_READY (xrBeginSession)" << std::endl;
+						XR_LOG_INFO("Event: XR_SESSION_STATE_READY (xrBeginSession)");
 						break;
 					}
 					case XR_SESSION_STATE_STOPPING: {
@@ -1799,17 +4249,19 @@ bool OpenXrApplication::pollEvents(bool * exitLoop){
 							return false;
 
 						flagSessionRunning = false;
-						std::cout << "Event: XR_SESSION_STATE_STOPPING (xrEndSession)" << std::endl;
+						XR_LOG_INFO("Event: XR_SESSION_STATE_STOPPING (xrEndSession)");
 						break;
 					}
 					case XR_SESSION_STATE_EXITING: {
 						*exitLoop = true;
-						std::cout << "Event: XR_SESSION_STATE_EXITING" << std::endl;
+						XR_LOG_INFO("Event: XR_SESSION_STATE_EXITING");
 						break;
 					}
 					case XR_SESSION_STATE_LOSS_PENDING: {
+						XR_LOG_INFO("Event: XR_SESSION_STATE_LOSS_PENDING");
+						if(beginRecovery(RECOVERY_SESSION))
+							return true;
 						*exitLoop = true;
-						std::cout << "Event: XR_SESSION_STATE_LOSS_PENDING" << std::endl;
 						break;
 					}
 					default:
@@ -1820,20 +4272,50 @@ bool OpenXrApplication::pollEvents(bool * exitLoop){
 			// application is about to lose the XrInstance 
 			case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING: {
 				const XrEventDataInstanceLossPending & instanceLossPending = *reinterpret_cast<XrEventDataInstanceLossPending*>(&event);				
-				*exitLoop = true;
-				std::cout << "XrEventDataInstanceLossPending by " << instanceLossPending.lossTime << std::endl;
+				XR_LOG_INFO("XrEventDataInstanceLossPending by " << instanceLossPending.lossTime);
+				if(!beginRecovery(RECOVERY_INSTANCE))
+					*exitLoop = true;
 				return true;
 				break;
 			}
 			case XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED: {
 				// TODO: implement
-				std::cout << "XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED" << std::endl;
+				XR_LOG_INFO("XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED");
 				break;
 			}
 			// reference space is changing
 			case XR_TYPE_EVENT_DATA_REFERENCE_SPACE_CHANGE_PENDING: {
 				const XrEventDataReferenceSpaceChangePending & referenceSpaceChangePending = *reinterpret_cast<XrEventDataReferenceSpaceChangePending*>(&event);
-				std::cout << "XrEventDataReferenceSpaceChangePending for " << _enum_to_string(referenceSpaceChangePending.referenceSpaceType) << std::endl;
+				XR_LOG_INFO("XrEventDataReferenceSpaceChangePending for " << _enum_to_string(referenceSpaceChangePending.referenceSpaceType));
+				break;
+			}
+			// visibility mask changed (XR_KHR_visibility_mask): fetched again on the next use
+			case XR_TYPE_EVENT_DATA_VISIBILITY_MASK_CHANGED_KHR: {
+				const XrEventDataVisibilityMaskChangedKHR & visibilityMaskChanged = *reinterpret_cast<XrEventDataVisibilityMaskChangedKHR*>(&event);
+				XR_LOG_INFO("XrEventDataVisibilityMaskChangedKHR for view " << visibilityMaskChanged.viewIndex);
+				if(visibilityMaskChanged.viewConfigurationType == configViewConfigurationType && visibilityMaskChanged.viewIndex < xr_visibility_masks.size())
+					xr_visibility_masks[visibilityMaskChanged.viewIndex].outdated = true;
+				break;
+			}
+			// performance settings notification (XR_EXT_performance_settings)
+			case XR_TYPE_EVENT_DATA_PERF_SETTINGS_EXT: {
+				const XrEventDataPerfSettingsEXT & perfSettings = *reinterpret_cast<XrEventDataPerfSettingsEXT*>(&event);
+				XR_LOG_INFO("XrEventDataPerfSettingsEXT for " << _enum_to_string(perfSettings.domain) << " (" << _enum_to_string(perfSettings.subDomain) << "): " 
+							<< _enum_to_string(perfSettings.fromLevel) << " -> " << _enum_to_string(perfSettings.toLevel));
+				if(perfSettingsCallback)
+					perfSettingsCallback(perfSettings.domain, perfSettings.subDomain, perfSettings.fromLevel, perfSettings.toLevel);
+				else if(perfSettingsCallbackFunction)
+					perfSettingsCallbackFunction(perfSettings.domain, perfSettings.subDomain, perfSettings.fromLevel, perfSettings.toLevel);
+				break;
+			}
+			// display refresh rate changed (XR_FB_display_refresh_rate): requested by the application or changed by the runtime
+			case XR_TYPE_EVENT_DATA_DISPLAY_REFRESH_RATE_CHANGED_FB: {
+				const XrEventDataDisplayRefreshRateChangedFB & displayRefreshRateChanged = *reinterpret_cast<XrEventDataDisplayRefreshRateChangedFB*>(&event);
+				XR_LOG_INFO("XrEventDataDisplayRefreshRateChangedFB: " << displayRefreshRateChanged.fromDisplayRefreshRate << " Hz -> " << displayRefreshRateChanged.toDisplayRefreshRate << " Hz");
+				if(displayRefreshRateCallback)
+					displayRefreshRateCallback(displayRefreshRateChanged.fromDisplayRefreshRate, displayRefreshRateChanged.toDisplayRefreshRate);
+				else if(displayRefreshRateCallbackFunction)
+					displayRefreshRateCallbackFunction(displayRefreshRateChanged.fromDisplayRefreshRate, displayRefreshRateChanged.toDisplayRefreshRate);
 				break;
 			}
 			default:
@@ -1844,6 +4326,9 @@ bool OpenXrApplication::pollEvents(bool * exitLoop){
 }
 
 bool OpenXrApplication::pollActions(vector<ActionState> & actionStates){
+	if(flagReplay)
+		return xr_replayer->replayActions(actionStates);
+
 	// sync actions
 	XrActiveActionSet activeActionSet = {xr_action_set, XR_NULL_PATH};
 	XrActionsSyncInfo syncInfo = {XR_TYPE_ACTIONS_SYNC_INFO};
@@ -1851,7 +4336,7 @@ bool OpenXrApplication::pollActions(vector<ActionState> & actionStates){
 	syncInfo.activeActionSets = &activeActionSet;
 	xr_result = xrSyncActions(xr_session, &syncInfo);
 	if(!xrCheckResult(xr_instance, xr_result, "xrSyncActions"))
-		return false;
+		return handleLoss(xr_result);
 
 	XrActionStateGetInfo getInfo = {XR_TYPE_ACTION_STATE_GET_INFO};
 	getInfo.next = nullptr;
@@ -1925,22 +4410,45 @@ bool OpenXrApplication::pollActions(vector<ActionState> & actionStates){
 		}
 	}
 
+	xr_recorder->recordActions(actionStates);
 	return true;
 }
 
 bool OpenXrApplication::renderViews(XrReferenceSpaceType referenceSpaceType, vector<ActionPoseState> & actionPoseStates){
-	xr_graphics_handler.acquireContext(xr_graphics_binding, "xrWaitFrame");
+	// replay mode: feed the recorded frame to the render callback (no frame pacing, unless a replay speed is given)
+	if(flagReplay){
+		XrFrameState frameState = {XR_TYPE_FRAME_STATE};
+		vector<XrView> views;
+		if(!xr_replayer->replayFrame(frameState, views, actionPoseStates))
+			return true;
+		if(frameState.shouldRender == XR_TRUE && views.size()){
+			if(renderCallback)
+				renderCallback(views.size(), views.data(), xr_view_configuration_views.data());
+			else if(renderCallbackFunction)
+				renderCallbackFunction(views.size(), views, xr_view_configuration_views);
+		}
+		return true;
+	}
+
+	// the frame loop is instantiated per graphics backend (the backend is only dispatched once per frame)
+	if(flagHeadlessSession)
+		return renderFrame(xr_graphics->headlessHandler, referenceSpaceType, actionPoseStates);
+	return dispatchGraphicsHandler([&](auto & handler){ return renderFrame(handler, referenceSpaceType, actionPoseStates); });
+}
+
+template <typename GraphicsHandler> bool OpenXrApplication::renderFrame(GraphicsHandler & graphicsHandler, XrReferenceSpaceType referenceSpaceType, vector<ActionPoseState> & actionPoseStates){
+	graphicsHandler.acquireContext();
 
 	XrFrameWaitInfo frameWaitInfo = {XR_TYPE_FRAME_WAIT_INFO};
 	XrFrameState frameState = {XR_TYPE_FRAME_STATE};
 	xr_result = xrWaitFrame(xr_session, &frameWaitInfo, &frameState);
 	if(!xrCheckResult(xr_instance, xr_result, "xrWaitFrame"))
-		return false;
+		return handleLoss(xr_result);
 
 	XrFrameBeginInfo frameBeginInfo = {XR_TYPE_FRAME_BEGIN_INFO};
 	xr_result = xrBeginFrame(xr_session, &frameBeginInfo);
 	if(!xrCheckResult(xr_instance, xr_result, "xrBeginFrame"))
-		return false;
+		return handleLoss(xr_result);
 
 	// locate actions
 	XrSpaceLocation spaceLocation = {XR_TYPE_SPACE_LOCATION};
@@ -1953,7 +4461,7 @@ bool OpenXrApplication::renderViews(XrReferenceSpaceType referenceSpaceType, vec
 		else if(xr_actions.aPose[i].referenceSpaceType == XR_REFERENCE_SPACE_TYPE_STAGE)
 			actionPoseSpace = xr_space_stage;
 		else{
-			std::cout << "[WARNING] Invalid reference space (" << xr_actions.aPose[i].referenceSpaceType << ") for " << xr_actions.aPose[i].stringPath << std::endl;
+			XR_LOG_WARNING("Invalid reference space (" << xr_actions.aPose[i].referenceSpaceType << ") for " << xr_actions.aPose[i].stringPath);
 			continue;
 		}
 
@@ -1972,16 +4480,19 @@ bool OpenXrApplication::renderViews(XrReferenceSpaceType referenceSpaceType, vec
 		actionPoseStates.push_back(state);
 	}
 
-	vector<XrCompositionLayerBaseHeader*> layers;
+	vector<XrCompositionLayerBaseHeader*> & layers = xr_layers;
 	XrCompositionLayerProjection layer = {XR_TYPE_COMPOSITION_LAYER_PROJECTION};
-	vector<XrCompositionLayerProjectionView> projectionLayerViews;
+	vector<XrCompositionLayerProjectionView> & projectionLayerViews = xr_projection_views;
+	vector<XrView> & views = xr_views;
+	layers.clear();
+	views.clear();
+	uint32_t viewCountOutput = 0;
 
 	if(frameState.shouldRender == XR_TRUE){
 		// locate views
-		vector<XrView> views(xr_view_configuration_views.size(), {XR_TYPE_VIEW});
+		views.resize(xr_view_configuration_views.size(), {XR_TYPE_VIEW});
 
 		XrViewState viewState = {XR_TYPE_VIEW_STATE};
-		uint32_t viewCountOutput;
 
 		XrViewLocateInfo viewLocateInfo = {XR_TYPE_VIEW_LOCATE_INFO};
 		viewLocateInfo.viewConfigurationType = configViewConfigurationType;
@@ -1993,7 +4504,7 @@ bool OpenXrApplication::renderViews(XrReferenceSpaceType referenceSpaceType, vec
 			if(!xrCheckResult(xr_instance, xr_result, "xrLocateViews (XR_REFERENCE_SPACE_TYPE_VIEW)"))
 				return false;
 			if((viewState.viewStateFlags & XR_VIEW_STATE_POSITION_VALID_BIT) == 0 || (viewState.viewStateFlags & XR_VIEW_STATE_ORIENTATION_VALID_BIT) == 0)
-				std::cout << "Invalid location view for XR_REFERENCE_SPACE_TYPE_VIEW" << std::endl;
+				XR_LOG_WARNING("Invalid location view for XR_REFERENCE_SPACE_TYPE_VIEW");
 		}
 		else if(referenceSpaceType == XR_REFERENCE_SPACE_TYPE_LOCAL){
 			viewLocateInfo.space = xr_space_local;
@@ -2001,7 +4512,7 @@ bool OpenXrApplication::renderViews(XrReferenceSpaceType referenceSpaceType, vec
 			if(!xrCheckResult(xr_instance, xr_result, "xrLocateViews (XR_REFERENCE_SPACE_TYPE_LOCAL)"))
 				return false;
 			if((viewState.viewStateFlags & XR_VIEW_STATE_POSITION_VALID_BIT) == 0 || (viewState.viewStateFlags & XR_VIEW_STATE_ORIENTATION_VALID_BIT) == 0)
-				std::cout << "Invalid location view for XR_REFERENCE_SPACE_TYPE_LOCAL" << std::endl;
+				XR_LOG_WARNING("Invalid location view for XR_REFERENCE_SPACE_TYPE_LOCAL");
 		}
 		else if(referenceSpaceType == XR_REFERENCE_SPACE_TYPE_STAGE){
 			viewLocateInfo.space = xr_space_stage;
@@ -2009,73 +4520,252 @@ bool OpenXrApplication::renderViews(XrReferenceSpaceType referenceSpaceType, vec
 			if(!xrCheckResult(xr_instance, xr_result, "xrLocateViews (XR_REFERENCE_SPACE_TYPE_STAGE)"))
 				return false;
 			if((viewState.viewStateFlags & XR_VIEW_STATE_POSITION_VALID_BIT) == 0 || (viewState.viewStateFlags & XR_VIEW_STATE_ORIENTATION_VALID_BIT) == 0)
-				std::cout << "Invalid location view for XR_REFERENCE_SPACE_TYPE_STAGE" << std::endl;
+				XR_LOG_WARNING("Invalid location view for XR_REFERENCE_SPACE_TYPE_STAGE");
 		}
 		else{
-			std::cout << "Invalid reference space type (" << referenceSpaceType << ")" << std::endl;
+			XR_LOG_WARNING("Invalid reference space type (" << referenceSpaceType << ")");
 			return false;
 		}
 
-		// call render callback to get frames
+		// visible area of the views (XR_KHR_visibility_mask), set before the frames are uploaded
+		if constexpr(GraphicsHandler::hasSwapchains)
+			for(uint32_t i = 0; i < viewCountOutput; i++)
+				updateVisibleArea(graphicsHandler, i, views[i].fov);
+
+		// call render callback to get frames (tracking-only mode: the callback only receives the view poses, no frames are uploaded)
 		if(renderCallback)
 			renderCallback(views.size(), views.data(), xr_view_configuration_views.data());
 		else if(renderCallbackFunction)
 			renderCallbackFunction(views.size(), views, xr_view_configuration_views);
 		// TODO: render if there are images
+	}
+
+	// tracking-only mode: the frame loop only provides the predicted display time (no layers are submitted)
+	if constexpr(GraphicsHandler::hasSwapchains){
+		if(frameState.shouldRender == XR_TRUE){
+			// upload worker: wait for the frames set in the render callback before holding any swapchain image
+			graphicsHandler.waitUploads();
+			graphicsHandler.restorePipelineState();
+
+			// depth swapchains are created with the first depth frame (XR_KHR_composition_layer_depth)
+			if(xr_depth_swapchains_handlers.empty() && !flagDepthUnavailable)
+				for(uint32_t i = 0; i < viewCountOutput; i++)
+					if(xr_depth_frames[i].data){
+						flagDepthUnavailable = !defineDepthSwapchains(graphicsHandler);
+						break;
+					}
+			xr_depth_infos.resize(viewCountOutput);
 
-		// render view to the appropriate part of the swapchain image
-		projectionLayerViews.resize(viewCountOutput);
-		for(uint32_t i = 0; i < viewCountOutput; i++){
-			// Each view has a separate swapchain which is acquired, rendered to, and released
-			const SwapchainHandler viewSwapchain = xr_swapchains_handlers[i];
+			// space warp swapchains are created with the first space warp frame (XR_FB_space_warp)
+			if(flagSpaceWarp && xr_motion_vector_swapchains_handlers.empty() && !flagSpaceWarpUnavailable)
+				for(uint32_t i = 0; i < viewCountOutput; i++)
+					if(xr_space_warp_frames[i].motionVectors){
+						flagSpaceWarpUnavailable = !defineSpaceWarpSwapchains(graphicsHandler);
+						break;
+					}
+			xr_space_warp_infos.resize(viewCountOutput);
+			// the runtime only synthesizes the next frame if every view has motion vectors and depth
+			bool spaceWarpActive = flagSpaceWarp && !flagSpaceWarpUnavailable && viewCountOutput;
 
-			XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+			// render view to the appropriate part of the swapchain image
+			projectionLayerViews.resize(viewCountOutput);
+			for(uint32_t i = 0; i < viewCountOutput; i++){
+				// Each view has a separate swapchain which is acquired, rendered to, and released
+				const SwapchainHandler & viewSwapchain = xr_swapchains_handlers[i];
 
-			uint32_t swapchainImageIndex;
-			xr_result = xrAcquireSwapchainImage(viewSwapchain.handle, &acquireInfo, &swapchainImageIndex);
-			if(!xrCheckResult(xr_instance, xr_result, "xrAcquireSwapchainImage"))
-				return false;
-			xr_graphics_handler.acquireContext(xr_graphics_binding, "xrAcquireSwapchainImage");
+				XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+
+				uint32_t swapchainImageIndex;
+				xr_result = xrAcquireSwapchainImage(viewSwapchain.handle, &acquireInfo, &swapchainImageIndex);
+				if(!xrCheckResult(xr_instance, xr_result, "xrAcquireSwapchainImage"))
+					return false;
+
+				XrSwapchainImageWaitInfo waitInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+				waitInfo.timeout = XR_INFINITE_DURATION;
+				xr_result = xrWaitSwapchainImage(viewSwapchain.handle, &waitInfo);
+				if(!xrCheckResult(xr_instance, xr_result, "xrWaitSwapchainImage"))
+					return false;
+
+				projectionLayerViews[i] = {XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW};
+				projectionLayerViews[i].pose = views[i].pose;
+				projectionLayerViews[i].fov = views[i].fov;
+				projectionLayerViews[i].subImage.swapchain = viewSwapchain.handle;
+				projectionLayerViews[i].subImage.imageRect.offset = {0, 0};
+				projectionLayerViews[i].subImage.imageRect.extent = {viewSwapchain.width, viewSwapchain.height};
+
+				// render frame
+				if((renderCallback || renderCallbackFunction) && (xr_frames_width[i] && xr_frames_height[i])){
+					const XrSwapchainImageBaseHeader* const swapchainImage = graphicsHandler.getSwapchainImage(viewSwapchain, swapchainImageIndex);
+					// FIXME: use format (vulkan: 43, opengl: 34842)
+					// graphicsHandler.renderView(projectionLayerViews[i], swapchainImage, 43);
+					if(graphicsHandler.isUploadWorkerRunning())
+						graphicsHandler.renderViewFromUpload(projectionLayerViews[i], swapchainImage, i);
+					else
+						graphicsHandler.renderViewFromImage(projectionLayerViews[i], swapchainImage, 43, xr_frames_width[i], xr_frames_height[i], xr_frames_data[i], xr_frames_is_rgba, i);
+					cleanFrames();
+				}
+
+				// desktop mirror (throttled, the eye frame is not re-rendered)
+				if(i == (uint32_t)xr_mirror_view)
+					graphicsHandler.renderMirror(projectionLayerViews[i], graphicsHandler.getSwapchainImage(viewSwapchain, swapchainImageIndex));
+
+				XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
+				xr_result = xrReleaseSwapchainImage(viewSwapchain.handle, &releaseInfo);
+				if(!xrCheckResult(xr_instance, xr_result, "xrReleaseSwapchainImage"))
+					return false;
+
+				// depth (chained to the projection view) for the positional reprojection of the runtime
+				if(xr_depth_frames[i].data && !flagDepthUnavailable && i < xr_depth_swapchains_handlers.size()){
+					if(!renderDepth(graphicsHandler, i))
+						return false;
+					projectionLayerViews[i].next = &xr_depth_infos[i];
+				}
+
+				// motion vectors and depth (chained to the projection view) for the frame synthesis of the runtime
+				if(spaceWarpActive && xr_space_warp_frames[i].motionVectors && i < xr_motion_vector_swapchains_handlers.size() && i < xr_space_warp_depth_swapchains_handlers.size()){
+					if(!renderSpaceWarp(graphicsHandler, i))
+						return false;
+					xr_space_warp_infos[i].next = projectionLayerViews[i].next;
+					projectionLayerViews[i].next = &xr_space_warp_infos[i];
+				}
+				else
+					spaceWarpActive = false;
+			}
+			flagSpaceWarpActive = spaceWarpActive;
+
+			layer.space = getReferenceSpace(referenceSpaceType);
+			layer.viewCount = (uint32_t)projectionLayerViews.size();
+			layer.views = projectionLayerViews.data();
+
+			// composition layers: only the layers whose content changed (or streamed frames) are uploaded, the others resubmit their last released image.
+			// The header containers are reserved so that the pointers stay valid while the layers are appended in creation order
+			xr_quad_layer_headers.clear();
+			xr_cylinder_layer_headers.clear();
+			xr_equirect_layer_headers.clear();
+			xr_cube_layer_headers.clear();
+			xr_quad_layer_headers.reserve(xr_composition_layers.size());
+			xr_cylinder_layer_headers.reserve(xr_composition_layers.size());
+			xr_equirect_layer_headers.reserve(xr_composition_layers.size());
+			xr_cube_layer_headers.reserve(xr_composition_layers.size());
+			xr_color_scale_bias_infos.clear();
+			xr_color_scale_bias_infos.reserve(xr_composition_layers.size());
+			// fades (color scale and bias) are evaluated at the display time of each frame submitted by renderViews: they stay smooth without new simulator frames,
+			// but they are not advanced while renderViews is not called (e.g. the simulator is blocked): the compositor keeps the last submitted values
+			auto chainColorFade = [&](ColorFade & colorFade) -> const void * {
+				XrCompositionLayerColorScaleBiasKHR colorScaleBias;
+				if(!updateColorFade(colorFade, frameState.predictedDisplayTime, colorScaleBias))
+					return nullptr;
+				xr_color_scale_bias_infos.push_back(colorScaleBias);
+				return &xr_color_scale_bias_infos.back();
+			};
+			auto submitCompositionLayers = [&](bool background){
+				for(size_t i = 0; i < xr_composition_layers.size(); i++){
+					CompositionLayer & compositionLayer = xr_composition_layers[i];
+					if(!compositionLayer.active || compositionLayer.swapchain.handle == XR_NULL_HANDLE)
+						continue;
+					if((compositionLayer.type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR) != background)
+						continue;
+					// static swapchains (XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT) can only be acquired once: new content needs a new swapchain
+					if(compositionLayer.dirty && compositionLayer.uploaded && compositionLayer.type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR){
+						releaseCompositionLayerSwapchain(compositionLayer);
+						if(!defineCompositionLayerSwapchain(graphicsHandler, compositionLayer))
+							return false;
+					}
+					if(compositionLayer.dirty && !renderCompositionLayer(graphicsHandler, compositionLayer))
+						return false;
+					if(!compositionLayer.visible || !compositionLayer.uploaded)
+						continue;
+
+					XrSwapchainSubImage subImage;
+					subImage.swapchain = compositionLayer.swapchain.handle;
+					subImage.imageRect.offset = {0, 0};
+					subImage.imageRect.extent = {compositionLayer.swapchain.width, compositionLayer.swapchain.height};
+					subImage.imageArrayIndex = 0;
+					XrCompositionLayerFlags layerFlags = compositionLayer.rgba ? XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT : 0;
+					XrSpace space = getReferenceSpace(compositionLayer.referenceSpaceType);
+
+					if(compositionLayer.type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR){
+						XrCompositionLayerCubeKHR cubeLayerHeader = {XR_TYPE_COMPOSITION_LAYER_CUBE_KHR};
+						cubeLayerHeader.layerFlags = layerFlags;
+						cubeLayerHeader.space = space;
+						cubeLayerHeader.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+						cubeLayerHeader.swapchain = compositionLayer.swapchain.handle;
+						cubeLayerHeader.imageArrayIndex = 0;
+						cubeLayerHeader.orientation = compositionLayer.pose.orientation;
+						cubeLayerHeader.next = chainColorFade(compositionLayer.colorFade);
+						xr_cube_layer_headers.push_back(cubeLayerHeader);
+						layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&xr_cube_layer_headers.back()));
+					}
+					else if(compositionLayer.type == XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR){
+						XrCompositionLayerCylinderKHR cylinderLayerHeader = {XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR};
+						cylinderLayerHeader.layerFlags = layerFlags;
+						cylinderLayerHeader.space = space;
+						cylinderLayerHeader.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+						cylinderLayerHeader.subImage = subImage;
+						cylinderLayerHeader.pose = compositionLayer.pose;
+						cylinderLayerHeader.radius = compositionLayer.radius;
+						cylinderLayerHeader.centralAngle = compositionLayer.centralAngle;
+						cylinderLayerHeader.aspectRatio = compositionLayer.aspectRatio;
+						cylinderLayerHeader.next = chainColorFade(compositionLayer.colorFade);
+						xr_cylinder_layer_headers.push_back(cylinderLayerHeader);
+						layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&xr_cylinder_layer_headers.back()));
+					}
+					else if(compositionLayer.type == XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR){
+						XrCompositionLayerEquirect2KHR equirectLayerHeader = {XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR};
+						equirectLayerHeader.layerFlags = layerFlags;
+						equirectLayerHeader.space = space;
+						equirectLayerHeader.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+						equirectLayerHeader.subImage = subImage;
+						equirectLayerHeader.pose = compositionLayer.pose;
+						equirectLayerHeader.radius = compositionLayer.radius;
+						equirectLayerHeader.centralHorizontalAngle = compositionLayer.centralAngle;
+						equirectLayerHeader.upperVerticalAngle = compositionLayer.upperVerticalAngle;
+						equirectLayerHeader.lowerVerticalAngle = compositionLayer.lowerVerticalAngle;
+						equirectLayerHeader.next = chainColorFade(compositionLayer.colorFade);
+						xr_equirect_layer_headers.push_back(equirectLayerHeader);
+						layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&xr_equirect_layer_headers.back()));
+					}
+					else{
+						XrCompositionLayerQuad quadLayerHeader = {XR_TYPE_COMPOSITION_LAYER_QUAD};
+						quadLayerHeader.layerFlags = layerFlags;
+						quadLayerHeader.space = space;
+						quadLayerHeader.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+						quadLayerHeader.subImage = subImage;
+						quadLayerHeader.pose = compositionLayer.pose;
+						quadLayerHeader.size = compositionLayer.size;
+						quadLayerHeader.next = chainColorFade(compositionLayer.colorFade);
+						xr_quad_layer_headers.push_back(quadLayerHeader);
+						layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&xr_quad_layer_headers.back()));
+					}
+				}
+				return true;
+			};
 
-			XrSwapchainImageWaitInfo waitInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
-			waitInfo.timeout = XR_INFINITE_DURATION;
-			xr_result = xrWaitSwapchainImage(viewSwapchain.handle, &waitInfo);
-			if(!xrCheckResult(xr_instance, xr_result, "xrWaitSwapchainImage"))
+			// background layers (static cube map environment) are submitted behind the projection layer, which is then blended using the frames' alpha channel
+			if(!submitCompositionLayers(true))
 				return false;
-			xr_graphics_handler.acquireContext(xr_graphics_binding, "xrWaitSwapchainImage");
-
-			projectionLayerViews[i] = {XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW};
-			projectionLayerViews[i].pose = views[i].pose;
-			projectionLayerViews[i].fov = views[i].fov;
-			projectionLayerViews[i].subImage.swapchain = viewSwapchain.handle;
-			projectionLayerViews[i].subImage.imageRect.offset = {0, 0};
-			projectionLayerViews[i].subImage.imageRect.extent = {viewSwapchain.width, viewSwapchain.height};
-
-			// render frame
-			if((renderCallback || renderCallbackFunction) && (xr_frames_width[i] && xr_frames_height[i])){
-				const XrSwapchainImageBaseHeader* const swapchainImage = (XrSwapchainImageBaseHeader*)&viewSwapchain.images[swapchainImageIndex];
-				// FIXME: use format (vulkan: 43, opengl: 34842)
-				// xr_graphics_handler.renderView(projectionLayerViews[i], swapchainImage, 43);
-				xr_graphics_handler.renderViewFromImage(projectionLayerViews[i], swapchainImage, 43, xr_frames_width[i], xr_frames_height[i], xr_frames_data[i], xr_frames_is_rgba);
-				cleanFrames();
+			if(!layers.empty())
+				layer.layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT | XR_COMPOSITION_LAYER_UNPREMULTIPLIED_ALPHA_BIT;
+			// reprojection hints (XR_MSFT_composition_layer_reprojection) and color scale and bias, chained in that order
+			const void ** layerNext = &layer.next;
+			if(xr_reprojection_mode){
+				xr_reprojection_info.reprojectionMode = xr_reprojection_mode;
+				xr_reprojection_info.next = nullptr;
+				*layerNext = &xr_reprojection_info;
+				layerNext = &xr_reprojection_info.next;
 			}
-
-			XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
-			xr_result = xrReleaseSwapchainImage(viewSwapchain.handle, &releaseInfo);
-			if(!xrCheckResult(xr_instance, xr_result, "xrReleaseSwapchainImage"))
+			// the plane is also chained without a mode: the runtime uses it if its default reprojection is planar
+			if(flagReprojectionPlane && xr_reprojection_mode != XR_REPROJECTION_MODE_ORIENTATION_ONLY_MSFT){
+				xr_reprojection_plane.next = nullptr;
+				*layerNext = &xr_reprojection_plane;
+				layerNext = &xr_reprojection_plane.next;
+			}
+			if(updateColorFade(xr_projection_color_fade, frameState.predictedDisplayTime, xr_projection_color_scale_bias))
+				*layerNext = &xr_projection_color_scale_bias;
+			layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&layer));
+			if(!submitCompositionLayers(false))
 				return false;
 		}
-
-		if(referenceSpaceType == XR_REFERENCE_SPACE_TYPE_VIEW)
-			layer.space = xr_space_view;
-		else if(referenceSpaceType == XR_REFERENCE_SPACE_TYPE_LOCAL)
-			layer.space = xr_space_local;
-		else if(referenceSpaceType == XR_REFERENCE_SPACE_TYPE_STAGE)
-			layer.space = xr_space_stage;
-		layer.viewCount = (uint32_t)projectionLayerViews.size();
-		layer.views = projectionLayerViews.data();
-
-		layers.push_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&layer));
 	}
 
 	// end frame
@@ -2087,13 +4777,206 @@ bool OpenXrApplication::renderViews(XrReferenceSpaceType referenceSpaceType, vec
 
 	xr_result = xrEndFrame(xr_session, &frameEndInfo);
 	if(!xrCheckResult(xr_instance, xr_result, "xrEndFrame"))
+		return handleLoss(xr_result);
+
+	// the space warp information only applies to the submitted frame: the buffers are set again in the next render callback
+	for(size_t i = 0; i < xr_space_warp_frames.size(); i++)
+		xr_space_warp_frames[i] = SpaceWarpFrame();
+
+	xr_recorder->recordFrame(frameState, referenceSpaceType, views, actionPoseStates);
+	return true;
+}
+
+bool OpenXrApplication::updateVisibilityMask(uint32_t view){
+	VisibilityMask & mask = xr_visibility_masks[view];
+	mask.outdated = false;
+	// the visible area is set again in the graphics handler
+	mask.fov = {0, 0, 0, 0};
+	for(uint32_t type = 0; type < 3; type++){
+		XrVisibilityMaskKHR visibilityMask = {XR_TYPE_VISIBILITY_MASK_KHR};
+		xr_result = xrGetVisibilityMaskKHR(xr_session, configViewConfigurationType, view, XrVisibilityMaskTypeKHR(type + 1), &visibilityMask);
+		if(xr_result == XR_SUCCESS){
+			mask.vertices[type].resize(visibilityMask.vertexCountOutput);
+			mask.indices[type].resize(visibilityMask.indexCountOutput);
+			visibilityMask.vertexCapacityInput = visibilityMask.vertexCountOutput;
+			visibilityMask.vertices = mask.vertices[type].data();
+			visibilityMask.indexCapacityInput = visibilityMask.indexCountOutput;
+			visibilityMask.indices = mask.indices[type].data();
+			xr_result = xrGetVisibilityMaskKHR(xr_session, configViewConfigurationType, view, XrVisibilityMaskTypeKHR(type + 1), &visibilityMask);
+		}
+		if(!xrCheckResult(xr_instance, xr_result, "xrGetVisibilityMaskKHR")){
+			for(uint32_t i = 0; i < 3; i++){
+				mask.vertices[i].clear();
+				mask.indices[i].clear();
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename GraphicsHandler> void OpenXrApplication::updateVisibleArea(GraphicsHandler & graphicsHandler, uint32_t view, const XrFovf & fov){
+	if(!xrGetVisibilityMaskKHR || flagReplay || view >= xr_visibility_masks.size())
+		return;
+	VisibilityMask & mask = xr_visibility_masks[view];
+	if(mask.outdated)
+		updateVisibilityMask(view);
+	// the area is converted to frame texture coordinates with the field of view of the frames
+	if(mask.fov.angleLeft == fov.angleLeft && mask.fov.angleRight == fov.angleRight && mask.fov.angleUp == fov.angleUp && mask.fov.angleDown == fov.angleDown)
+		return;
+	mask.fov = fov;
+	const std::vector<XrVector2f> & maskVertices = mask.vertices[XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR - 1];
+	float left = tanf(fov.angleLeft), right = tanf(fov.angleRight), up = tanf(fov.angleUp), down = tanf(fov.angleDown);
+	std::vector<XrVector2f> vertices(maskVertices.size());
+	for(size_t i = 0; i < maskVertices.size(); i++)
+		vertices[i] = {(maskVertices[i].x - left) / (right - left), (maskVertices[i].y - down) / (up - down)};
+	graphicsHandler.setVisibleArea(view, vertices, mask.indices[XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR - 1]);
+	verboseOutput() << "Visible area of view " << view << ": " << mask.indices[XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR - 1].size() / 3 << " triangles" << std::endl;
+}
+
+template <typename GraphicsHandler> bool OpenXrApplication::renderDepth(GraphicsHandler & graphicsHandler, uint32_t view){
+	const SwapchainHandler & depthSwapchain = xr_depth_swapchains_handlers[view];
+	const DepthFrame & depthFrame = xr_depth_frames[view];
+
+	XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+	uint32_t swapchainImageIndex;
+	xr_result = xrAcquireSwapchainImage(depthSwapchain.handle, &acquireInfo, &swapchainImageIndex);
+	if(!xrCheckResult(xr_instance, xr_result, "xrAcquireSwapchainImage"))
+		return false;
+
+	XrSwapchainImageWaitInfo waitInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+	waitInfo.timeout = XR_INFINITE_DURATION;
+	xr_result = xrWaitSwapchainImage(depthSwapchain.handle, &waitInfo);
+	if(!xrCheckResult(xr_instance, xr_result, "xrWaitSwapchainImage"))
+		return false;
+
+	// the depth frame (linear depth) is scaled to the whole swapchain image, as the color frames (e.g. lower render resolution), 
+	// so the depth and color image rectangles match. The handler converts it to window depth (OpenGL: in the fragment shader)
+	graphicsHandler.renderDepthFromImage(graphicsHandler.getSwapchainImage(depthSwapchain, swapchainImageIndex), xr_depth_swapchain_format, 
+										 depthSwapchain.width, depthSwapchain.height, depthFrame.width, depthFrame.height, depthFrame.data, depthFrame.nearZ, depthFrame.farZ);
+
+	XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
+	xr_result = xrReleaseSwapchainImage(depthSwapchain.handle, &releaseInfo);
+	if(!xrCheckResult(xr_instance, xr_result, "xrReleaseSwapchainImage"))
+		return false;
+
+	XrCompositionLayerDepthInfoKHR & depthInfo = xr_depth_infos[view];
+	depthInfo = {XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR};
+	depthInfo.subImage.swapchain = depthSwapchain.handle;
+	depthInfo.subImage.imageRect.offset = {0, 0};
+	depthInfo.subImage.imageRect.extent = {depthSwapchain.width, depthSwapchain.height};
+	depthInfo.minDepth = 0.0f;
+	depthInfo.maxDepth = 1.0f;
+	depthInfo.nearZ = depthFrame.nearZ;
+	depthInfo.farZ = depthFrame.farZ;
+	return true;
+}
+
+template <typename GraphicsHandler> bool OpenXrApplication::renderSpaceWarp(GraphicsHandler & graphicsHandler, uint32_t view){
+	const SpaceWarpFrame & spaceWarpFrame = xr_space_warp_frames[view];
+	const SwapchainHandler * swapchains[2] = {&xr_motion_vector_swapchains_handlers[view], &xr_space_warp_depth_swapchains_handlers[view]};
+
+	for(int k = 0; k < 2; k++){
+		XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+		uint32_t swapchainImageIndex;
+		xr_result = xrAcquireSwapchainImage(swapchains[k]->handle, &acquireInfo, &swapchainImageIndex);
+		if(!xrCheckResult(xr_instance, xr_result, "xrAcquireSwapchainImage"))
+			return false;
+
+		XrSwapchainImageWaitInfo waitInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+		waitInfo.timeout = XR_INFINITE_DURATION;
+		xr_result = xrWaitSwapchainImage(swapchains[k]->handle, &waitInfo);
+		if(!xrCheckResult(xr_instance, xr_result, "xrWaitSwapchainImage"))
+			return false;
+
+		// the images are uploaded at the origin, as the depth frames (XR_KHR_composition_layer_depth)
+		const XrSwapchainImageBaseHeader * swapchainImage = graphicsHandler.getSwapchainImage(*swapchains[k], swapchainImageIndex);
+		if(!k)
+			graphicsHandler.renderMotionVectorsFromImage(swapchainImage, xr_motion_vector_swapchain_format, spaceWarpFrame.width, spaceWarpFrame.height, spaceWarpFrame.motionVectors);
+		else
+			graphicsHandler.renderDepthFromImage(swapchainImage, xr_depth_swapchain_format, spaceWarpFrame.width, spaceWarpFrame.height, 
+												 spaceWarpFrame.width, spaceWarpFrame.height, spaceWarpFrame.depth, spaceWarpFrame.nearZ, spaceWarpFrame.farZ);
+
+		XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
+		xr_result = xrReleaseSwapchainImage(swapchains[k]->handle, &releaseInfo);
+		if(!xrCheckResult(xr_instance, xr_result, "xrReleaseSwapchainImage"))
+			return false;
+	}
+
+	// the reference spaces do not move between frames (the motion of the simulated scene is in the motion vectors)
+	XrCompositionLayerSpaceWarpInfoFB & spaceWarpInfo = xr_space_warp_infos[view];
+	spaceWarpInfo = {XR_TYPE_COMPOSITION_LAYER_SPACE_WARP_INFO_FB};
+	spaceWarpInfo.motionVectorSubImage.swapchain = swapchains[0]->handle;
+	spaceWarpInfo.motionVectorSubImage.imageRect.offset = {0, 0};
+	spaceWarpInfo.motionVectorSubImage.imageRect.extent = {spaceWarpFrame.width, spaceWarpFrame.height};
+	spaceWarpInfo.appSpaceDeltaPose = {{0, 0, 0, 1}, {0, 0, 0}};
+	spaceWarpInfo.depthSubImage.swapchain = swapchains[1]->handle;
+	spaceWarpInfo.depthSubImage.imageRect.offset = {0, 0};
+	spaceWarpInfo.depthSubImage.imageRect.extent = {spaceWarpFrame.width, spaceWarpFrame.height};
+	spaceWarpInfo.minDepth = 0.0f;
+	spaceWarpInfo.maxDepth = 1.0f;
+	spaceWarpInfo.nearZ = spaceWarpFrame.nearZ;
+	spaceWarpInfo.farZ = spaceWarpFrame.farZ;
+	return true;
+}
+
+template <typename GraphicsHandler> bool OpenXrApplication::renderCompositionLayer(GraphicsHandler & graphicsHandler, CompositionLayer & compositionLayer){
+	const SwapchainHandler & swapchain = compositionLayer.swapchain;
+
+	XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+	uint32_t swapchainImageIndex;
+	xr_result = xrAcquireSwapchainImage(swapchain.handle, &acquireInfo, &swapchainImageIndex);
+	if(!xrCheckResult(xr_instance, xr_result, "xrAcquireSwapchainImage"))
+		return false;
+
+	XrSwapchainImageWaitInfo waitInfo = {XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+	waitInfo.timeout = XR_INFINITE_DURATION;
+	xr_result = xrWaitSwapchainImage(swapchain.handle, &waitInfo);
+	if(!xrCheckResult(xr_instance, xr_result, "xrWaitSwapchainImage"))
+		return false;
+
+	// cube map faces are copied as they are (same size as the swapchain), other content is scaled to the whole swapchain image 
+	// (the handlers only use the sub-image of the view)
+	if(compositionLayer.type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR)
+		graphicsHandler.renderCubeFromImages(graphicsHandler.getSwapchainImage(swapchain, swapchainImageIndex), xr_swapchain_format, 
+											 compositionLayer.width, compositionLayer.frameData.data(), compositionLayer.rgba);
+	else{
+		XrCompositionLayerProjectionView layerView = {XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW};
+		layerView.subImage.swapchain = swapchain.handle;
+		layerView.subImage.imageRect.offset = {0, 0};
+		layerView.subImage.imageRect.extent = {swapchain.width, swapchain.height};
+		graphicsHandler.renderViewFromImage(layerView, graphicsHandler.getSwapchainImage(swapchain, swapchainImageIndex), xr_swapchain_format, 
+											compositionLayer.frameWidth, compositionLayer.frameHeight, 
+											compositionLayer.streamData ? compositionLayer.streamData : compositionLayer.frameData.data(), compositionLayer.rgba);
+	}
+
+	XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
+	xr_result = xrReleaseSwapchainImage(swapchain.handle, &releaseInfo);
+	if(!xrCheckResult(xr_instance, xr_result, "xrReleaseSwapchainImage"))
 		return false;
 
+	compositionLayer.dirty = false;
+	compositionLayer.uploaded = true;
+	compositionLayer.streamData = nullptr;
 	return true;
 }
 
+XrSpace OpenXrApplication::getReferenceSpace(XrReferenceSpaceType referenceSpaceType){
+	if(referenceSpaceType == XR_REFERENCE_SPACE_TYPE_VIEW)
+		return xr_space_view;
+	else if(referenceSpaceType == XR_REFERENCE_SPACE_TYPE_LOCAL)
+		return xr_space_local;
+	else if(referenceSpaceType == XR_REFERENCE_SPACE_TYPE_STAGE)
+		return xr_space_stage;
+	return XR_NULL_HANDLE;
+}
+
 
 bool OpenXrApplication::addAction(string stringPath, XrActionType actionType, XrReferenceSpaceType referenceSpaceType){
+	// replay mode: action states are identified by the recorded paths
+	if(flagReplay)
+		return true;
+
 	XrPath path;
 	XrAction action;
 	xrStringToPath(xr_instance, stringPath.c_str(), &path);
@@ -2164,6 +5047,8 @@ bool OpenXrApplication::addAction(string stringPath, XrActionType actionType, Xr
 }
 
 bool OpenXrApplication::applyHapticFeedback(string stringPath, XrHapticBaseHeader * hapticFeedback){
+	if(flagReplay)
+		return true;
 	for(size_t i = 0; i < xr_actions.aVibration.size(); i++)
 		if(!xr_actions.aVibration[i].stringPath.compare(stringPath)){
 			XrHapticActionInfo hapticActionInfo = {XR_TYPE_HAPTIC_ACTION_INFO};
@@ -2178,6 +5063,8 @@ bool OpenXrApplication::applyHapticFeedback(string stringPath, XrHapticBaseHeade
 }
 
 bool OpenXrApplication::stopHapticFeedback(string stringPath){
+	if(flagReplay)
+		return true;
 	for(size_t i = 0; i < xr_actions.aVibration.size(); i++)
 		if(!xr_actions.aVibration[i].stringPath.compare(stringPath)){
 			XrHapticActionInfo hapticActionInfo = {XR_TYPE_HAPTIC_ACTION_INFO};
@@ -2198,165 +5085,565 @@ bool OpenXrApplication::stopHapticFeedback(string stringPath){
 bool OpenXrApplication::setFrameByIndex(int index, int width, int height, void * frame, bool rgba){
 	if(index < 0 || (size_t)index >= xr_frames_data.size())
 		return false;
+	// no frame: the view is not rendered
+	if(!frame || width <= 0 || height <= 0){
+		xr_frames_width[index] = 0;
+		xr_frames_height[index] = 0;
+		xr_frames_data[index] = nullptr;
+		return true;
+	}
 	xr_frames_width[index] = width;
 	xr_frames_height[index] = height;
 	xr_frames_data[index] = frame;
 	xr_frames_is_rgba = rgba;
+	dispatchGraphicsHandler([&](auto & handler){
+		handler.submitFrame(index, width, height, frame, rgba);
+		return true;
+	});
 	return true;
 }
 
+bool OpenXrApplication::setFrameByIndex(int index, int width, int height, void * frame, bool rgba, const float * depth, float nearZ, float farZ){
+	if(!setFrameByIndex(index, width, height, frame, rgba))
+		return false;
+	return setDepthByIndex(index, width, height, depth, nearZ, farZ);
+}
 
-#ifdef APPLICATION
-int main(){
-	OpenXrApplication * app = new OpenXrApplication();
-	vector<ActionPoseState> requestedActionPoseStates;
+bool OpenXrApplication::setDepthByIndex(int index, int width, int height, const float * depth, float nearZ, float farZ){
+	if(index < 0 || (size_t)index >= xr_depth_frames.size())
+		return false;
+	DepthFrame & depthFrame = xr_depth_frames[index];
+	// no depth: the projection view is submitted without depth information
+	if(!depth){
+		depthFrame = DepthFrame();
+		return true;
+	}
+	if(!isExtensionEnabled(XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME)){
+		XR_LOG_WARNING(XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME << " is not supported by the runtime. The depth is not submitted");
+		return false;
+	}
+	// the depth swapchains have the recommended size
+	if(width <= 0 || height <= 0 || (uint32_t)width > xr_view_configuration_views[index].recommendedImageRectWidth || (uint32_t)height > xr_view_configuration_views[index].recommendedImageRectHeight){
+		XR_LOG_WARNING("Invalid depth size (" << width << " x " << height << ") for view " << index);
+		return false;
+	}
+	if(nearZ <= 0 || farZ <= nearZ){
+		XR_LOG_WARNING("Invalid depth clipping planes (near: " << nearZ << ", far: " << farZ << ")");
+		return false;
+	}
+	depthFrame.width = width;
+	depthFrame.height = height;
+	depthFrame.data = depth;
+	depthFrame.nearZ = nearZ;
+	depthFrame.farZ = farZ;
+	return true;
+}
 
-	// create instance
-	string applicationName = "Omniverse (VR)";
-	string engineName = "OpenXR Engine";
-	vector<string> requestedApiLayers = { "XR_APILAYER_LUNARG_core_validation" };
-	vector<string> requestedExtensions = {
-#ifdef XR_USE_GRAPHICS_API_VULKAN
-	#ifdef APP_USE_VULKAN2
-		XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME,
-	#else
-		XR_KHR_VULKAN_ENABLE_EXTENSION_NAME,
-	#endif
-#endif
-#ifdef XR_USE_GRAPHICS_API_OPENGL
-		XR_KHR_OPENGL_ENABLE_EXTENSION_NAME,
-#endif
-	};
-	app->createInstance(applicationName, engineName, requestedApiLayers, requestedExtensions);
-	
-	app->getSystem(XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY, XR_ENVIRONMENT_BLEND_MODE_OPAQUE, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO);
-	app->createSession();
+bool OpenXrApplication::setSpaceWarpByIndex(int index, int width, int height, const float * motionVectors, int depthWidth, int depthHeight, const float * depth, float nearZ, float farZ){
+	if(index < 0 || (size_t)index >= xr_space_warp_frames.size())
+		return false;
+	SpaceWarpFrame & spaceWarpFrame = xr_space_warp_frames[index];
+	// no motion vectors: the frame is submitted without space warp information (the runtime does not synthesize the next frame)
+	if(!motionVectors){
+		spaceWarpFrame = SpaceWarpFrame();
+		return true;
+	}
+	if(!flagSpaceWarp){
+		XR_LOG_WARNING("Space warp is not enabled. The motion vectors are not submitted");
+		return false;
+	}
+	// the space warp swapchains have the recommended motion vector size
+	if(width <= 0 || height <= 0 || (uint32_t)width > xr_space_warp_properties.recommendedMotionVectorImageRectWidth || (uint32_t)height > xr_space_warp_properties.recommendedMotionVectorImageRectHeight){
+		XR_LOG_WARNING("Invalid motion vector size (" << width << " x " << height << ") for view " << index);
+		return false;
+	}
+	if(!depth){
+		XR_LOG_WARNING("Space warp requires the depth of view " << index);
+		return false;
+	}
+	// the depth is uploaded at the motion vector size
+	if(depthWidth != width || depthHeight != height){
+		XR_LOG_WARNING("Space warp depth size (" << depthWidth << " x " << depthHeight << ") differs from the motion vector size (" << width << " x " << height << ") for view " << index);
+		return false;
+	}
+	if(nearZ <= 0 || farZ <= nearZ){
+		XR_LOG_WARNING("Invalid depth clipping planes (near: " << nearZ << ", far: " << farZ << ")");
+		return false;
+	}
+	spaceWarpFrame.width = width;
+	spaceWarpFrame.height = height;
+	spaceWarpFrame.motionVectors = motionVectors;
+	spaceWarpFrame.depth = depth;
+	spaceWarpFrame.nearZ = nearZ;
+	spaceWarpFrame.farZ = farZ;
+	return true;
+}
 
-	bool exitRenderLoop = false;
+CompositionLayer * OpenXrApplication::getCompositionLayer(int id){
+	if(id < 0 || (size_t)id >= xr_composition_layers.size() || !xr_composition_layers[id].active){
+		XR_LOG_WARNING("Invalid composition layer: " << id);
+		return nullptr;
+	}
+	return &xr_composition_layers[id];
+}
 
-#ifdef XR_USE_GRAPHICS_API_OPENGL
-	SDL_Event sdl_event;
-#endif
+int OpenXrApplication::addCompositionLayer(const CompositionLayer & definition){
+	if(definition.width <= 0 || definition.height <= 0){
+		XR_LOG_ERROR("Invalid composition layer size (" << definition.width << "x" << definition.height << " pixels)");
+		return -1;
+	}
+	if(definition.referenceSpaceType != XR_REFERENCE_SPACE_TYPE_VIEW && definition.referenceSpaceType != XR_REFERENCE_SPACE_TYPE_LOCAL && definition.referenceSpaceType != XR_REFERENCE_SPACE_TYPE_STAGE){
+		XR_LOG_ERROR("Invalid reference space type (" << definition.referenceSpaceType << ") for the composition layer");
+		return -1;
+	}
+	if(flagHeadlessSession)
+		XR_LOG_WARNING("Composition layers are not submitted in tracking-only sessions");
+
+	// the identifier of a removed layer is reused
+	size_t index = 0;
+	while(index < xr_composition_layers.size() && xr_composition_layers[index].active)
+		index++;
+	if(index == xr_composition_layers.size())
+		xr_composition_layers.emplace_back();
+
+	CompositionLayer & compositionLayer = xr_composition_layers[index];
+	compositionLayer = definition;
+	compositionLayer.active = true;
+
+	// the swapchain is created with the session (or now, if the session already exists)
+	if(xr_session != XR_NULL_HANDLE && !flagHeadlessSession && !dispatchGraphicsHandler([&](auto & handler){ return defineCompositionLayerSwapchain(handler, compositionLayer); })){
+		releaseCompositionLayerSwapchain(compositionLayer);
+		compositionLayer = CompositionLayer();
+		return -1;
+	}
+	return (int)index;
+}
 
-	while(true){
-#ifdef XR_USE_GRAPHICS_API_OPENGL
-		while(SDL_PollEvent(&sdl_event))
-			if (sdl_event.type == SDL_QUIT || (sdl_event.type == SDL_KEYDOWN && sdl_event.key.keysym.sym == SDLK_ESCAPE))
-				return 0;
-#endif
+int OpenXrApplication::addQuadLayer(int width, int height, XrReferenceSpaceType referenceSpaceType, const XrPosef & pose, const XrExtent2Df & size){
+	if(size.width <= 0 || size.height <= 0){
+		XR_LOG_ERROR("Invalid quad layer size (" << size.width << "x" << size.height << " meters)");
+		return -1;
+	}
+	CompositionLayer definition;
+	definition.type = XR_TYPE_COMPOSITION_LAYER_QUAD;
+	definition.referenceSpaceType = referenceSpaceType;
+	definition.pose = pose;
+	definition.size = size;
+	definition.width = width;
+	definition.height = height;
+	return addCompositionLayer(definition);
+}
 
-		app->pollEvents(&exitRenderLoop);
-		if(exitRenderLoop)
-			break;
+int OpenXrApplication::addCylinderLayer(int width, int height, XrReferenceSpaceType referenceSpaceType, const XrPosef & pose, float radius, float centralAngle, float aspectRatio){
+	if(!isExtensionEnabled(XR_KHR_COMPOSITION_LAYER_CYLINDER_EXTENSION_NAME)){
+		XR_LOG_ERROR(XR_KHR_COMPOSITION_LAYER_CYLINDER_EXTENSION_NAME << " is not supported by the runtime (or the instance is not created)");
+		return -1;
+	}
+	if(radius < 0 || centralAngle <= 0 || centralAngle > 2 * (float)M_PI || aspectRatio <= 0){
+		XR_LOG_ERROR("Invalid cylinder layer geometry (radius: " << radius << ", central angle: " << centralAngle << ", aspect ratio: " << aspectRatio << ")");
+		return -1;
+	}
+	CompositionLayer definition;
+	definition.type = XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR;
+	definition.referenceSpaceType = referenceSpaceType;
+	definition.pose = pose;
+	definition.radius = radius;
+	definition.centralAngle = centralAngle;
+	definition.aspectRatio = aspectRatio;
+	definition.width = width;
+	definition.height = height;
+	return addCompositionLayer(definition);
+}
 
-		if(app->isSessionRunning()){
-			vector<ActionState> requestedActionStates;
-			app->pollActions(requestedActionStates);
-			app->renderViews(XR_REFERENCE_SPACE_TYPE_LOCAL, requestedActionPoseStates);
-		}
-		else{
-			// Throttle loop since xrWaitFrame won't be called.
-			// std::this_thread::sleep_for(std::chrono::milliseconds(250));
-		}
+int OpenXrApplication::addEquirectLayer(int width, int height, XrReferenceSpaceType referenceSpaceType, const XrPosef & pose, float radius, float centralHorizontalAngle, float upperVerticalAngle, float lowerVerticalAngle){
+	if(!isExtensionEnabled(XR_KHR_COMPOSITION_LAYER_EQUIRECT2_EXTENSION_NAME)){
+		XR_LOG_ERROR(XR_KHR_COMPOSITION_LAYER_EQUIRECT2_EXTENSION_NAME << " is not supported by the runtime (or the instance is not created)");
+		return -1;
+	}
+	if(radius < 0 || centralHorizontalAngle <= 0 || centralHorizontalAngle > 2 * (float)M_PI || 
+	   upperVerticalAngle > (float)M_PI / 2 || lowerVerticalAngle < -(float)M_PI / 2 || upperVerticalAngle <= lowerVerticalAngle){
+		XR_LOG_ERROR("Invalid equirect layer geometry (radius: " << radius << ", central horizontal angle: " << centralHorizontalAngle 
+				  << ", vertical angles: " << upperVerticalAngle << ", " << lowerVerticalAngle << ")");
+		return -1;
 	}
-	return 0;
+	CompositionLayer definition;
+	definition.type = XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR;
+	definition.referenceSpaceType = referenceSpaceType;
+	definition.pose = pose;
+	definition.radius = radius;
+	definition.centralAngle = centralHorizontalAngle;
+	definition.upperVerticalAngle = upperVerticalAngle;
+	definition.lowerVerticalAngle = lowerVerticalAngle;
+	definition.width = width;
+	definition.height = height;
+	return addCompositionLayer(definition);
 }
-#endif
 
+int OpenXrApplication::addCubeLayer(int size, XrReferenceSpaceType referenceSpaceType, const XrQuaternionf & orientation){
+	if(!isExtensionEnabled(XR_KHR_COMPOSITION_LAYER_CUBE_EXTENSION_NAME)){
+		XR_LOG_ERROR(XR_KHR_COMPOSITION_LAYER_CUBE_EXTENSION_NAME << " is not supported by the runtime (or the instance is not created)");
+		return -1;
+	}
+	CompositionLayer definition;
+	definition.type = XR_TYPE_COMPOSITION_LAYER_CUBE_KHR;
+	definition.referenceSpaceType = referenceSpaceType;
+	definition.pose = {orientation, {0, 0, 0}};
+	definition.width = size;
+	definition.height = size;
+	return addCompositionLayer(definition);
+}
 
-#ifdef CTYPES
-extern "C"
-{
-    OpenXrApplication * openXrApplication(){ 
-		return new OpenXrApplication(); 
+bool OpenXrApplication::setLayerImage(int id, int width, int height, void * data, bool rgba){
+	CompositionLayer * compositionLayer = getCompositionLayer(id);
+	if(!compositionLayer || width <= 0 || height <= 0 || !data)
+		return false;
+	// cube map: the 6 faces (+X, -X, +Y, -Y, +Z, -Z) are stacked vertically and are not scaled
+	if(compositionLayer->type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR && (width != compositionLayer->width || height != 6 * compositionLayer->width)){
+		XR_LOG_ERROR("Invalid cube layer image size (" << width << "x" << height << "). Expected: " << compositionLayer->width << "x" << 6 * compositionLayer->width);
+		return false;
+	}
+	// the content is copied: the caller doesn't need to keep the buffer alive
+	const uint8_t * bytes = static_cast<const uint8_t*>(data);
+	compositionLayer->frameData.assign(bytes, bytes + (size_t)width * height * (rgba ? 4 : 3));
+	compositionLayer->frameWidth = width;
+	compositionLayer->frameHeight = height;
+	compositionLayer->rgba = rgba;
+	compositionLayer->streamData = nullptr;
+	compositionLayer->dirty = true;
+	return true;
+}
+
+bool OpenXrApplication::setLayerFrame(int id, int width, int height, void * data, bool rgba){
+	CompositionLayer * compositionLayer = getCompositionLayer(id);
+	if(!compositionLayer || width <= 0 || height <= 0 || !data)
+		return false;
+	if(compositionLayer->type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR){
+		XR_LOG_WARNING("Frames cannot be streamed into the static swapchain of the cube layer " << id);
+		return false;
+	}
+	// streamed frames (e.g. video) are not copied: the frame is uploaded directly from the caller's buffer in the next frame.
+	// The copied content (if any) is released, so the layer is shown again only after the next frame when the session is recreated
+	compositionLayer->frameData.clear();
+	compositionLayer->frameData.shrink_to_fit();
+	compositionLayer->streamData = data;
+	compositionLayer->frameWidth = width;
+	compositionLayer->frameHeight = height;
+	compositionLayer->rgba = rgba;
+	compositionLayer->dirty = true;
+	return true;
+}
+
+bool OpenXrApplication::setLayerPose(int id, XrReferenceSpaceType referenceSpaceType, const XrPosef & pose){
+	CompositionLayer * compositionLayer = getCompositionLayer(id);
+	if(!compositionLayer)
+		return false;
+	if(referenceSpaceType != XR_REFERENCE_SPACE_TYPE_VIEW && referenceSpaceType != XR_REFERENCE_SPACE_TYPE_LOCAL && referenceSpaceType != XR_REFERENCE_SPACE_TYPE_STAGE){
+		XR_LOG_ERROR("Invalid reference space type (" << referenceSpaceType << ") for the composition layer");
+		return false;
+	}
+	// no upload: only the layer placement changes
+	compositionLayer->referenceSpaceType = referenceSpaceType;
+	compositionLayer->pose = pose;
+	return true;
+}
+
+bool OpenXrApplication::setQuadLayerPose(int id, XrReferenceSpaceType referenceSpaceType, const XrPosef & pose, const XrExtent2Df & size){
+	CompositionLayer * compositionLayer = getCompositionLayer(id);
+	if(!compositionLayer)
+		return false;
+	if(compositionLayer->type != XR_TYPE_COMPOSITION_LAYER_QUAD){
+		XR_LOG_ERROR("The composition layer " << id << " is not a quad layer");
+		return false;
 	}
-    bool destroy(OpenXrApplication * app){ 
-		return app->destroy(); 
+	if(size.width <= 0 || size.height <= 0){
+		XR_LOG_ERROR("Invalid quad layer size (" << size.width << "x" << size.height << " meters)");
+		return false;
 	}
+	if(!setLayerPose(id, referenceSpaceType, pose))
+		return false;
+	compositionLayer->size = size;
+	return true;
+}
+
+bool OpenXrApplication::setLayerVisible(int id, bool visible){
+	CompositionLayer * compositionLayer = getCompositionLayer(id);
+	if(!compositionLayer)
+		return false;
+	compositionLayer->visible = visible;
+	return true;
+}
 
-	// utils
-    bool isSessionRunning(OpenXrApplication * app){ 
-		return app->isSessionRunning(); 
+bool OpenXrApplication::removeLayer(int id){
+	CompositionLayer * compositionLayer = getCompositionLayer(id);
+	if(!compositionLayer)
+		return false;
+	releaseCompositionLayerSwapchain(*compositionLayer);
+	*compositionLayer = CompositionLayer();
+	return true;
+}
+
+bool OpenXrApplication::setColorScaleBias(int id, const XrColor4f & scale, const XrColor4f & bias, float duration){
+	if(!isExtensionEnabled(XR_KHR_COMPOSITION_LAYER_COLOR_SCALE_BIAS_EXTENSION_NAME)){
+		XR_LOG_ERROR(XR_KHR_COMPOSITION_LAYER_COLOR_SCALE_BIAS_EXTENSION_NAME << " is not supported by the runtime (or the instance is not created)");
+		return false;
 	}
-	bool getViewConfigurationViews(OpenXrApplication * app, XrViewConfigurationView * views, int viewsLength){
-		if((size_t)viewsLength != app->getViewConfigurationViewsSize())
+	// -1: projection layer (simulator views)
+	ColorFade * colorFade = &xr_projection_color_fade;
+	if(id != -1){
+		CompositionLayer * compositionLayer = getCompositionLayer(id);
+		if(!compositionLayer)
 			return false;
-		vector<XrViewConfigurationView> viewConfigurationView = app->getViewConfigurationViews();
-		for(size_t i = 0; i < viewConfigurationView.size(); i++)
-			views[i] = viewConfigurationView[i];
-		return true;
+		colorFade = &compositionLayer->colorFade;
+	}
+	// the fade starts from the last submitted values (an interrupted fade continues smoothly)
+	colorFade->startScale = colorFade->scale;
+	colorFade->startBias = colorFade->bias;
+	colorFade->targetScale = scale;
+	colorFade->targetBias = bias;
+	colorFade->duration = std::max(0.0f, duration);
+	colorFade->startTime = 0;
+	return true;
+}
+
+bool OpenXrApplication::getVisibilityMask(int view, XrVisibilityMaskTypeKHR type, vector<XrVector2f> & vertices, vector<uint32_t> & indices){
+	if(!xrGetVisibilityMaskKHR){
+		XR_LOG_ERROR(XR_KHR_VISIBILITY_MASK_EXTENSION_NAME << " is not supported by the runtime (or the instance is not created)");
+		return false;
+	}
+	if(view < 0 || (size_t)view >= xr_visibility_masks.size()){
+		XR_LOG_ERROR("Invalid view (" << view << ") or session not created");
+		return false;
+	}
+	if(type < XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR || type > XR_VISIBILITY_MASK_TYPE_LINE_LOOP_KHR){
+		XR_LOG_ERROR("Invalid visibility mask type (" << type << ")");
+		return false;
+	}
+	if(xr_visibility_masks[view].outdated && !updateVisibilityMask(view))
+		return false;
+	vertices = xr_visibility_masks[view].vertices[type - 1];
+	indices = xr_visibility_masks[view].indices[type - 1];
+	return true;
+}
+
+bool OpenXrApplication::setSpaceWarp(bool enable){
+	if(enable && !isExtensionEnabled(XR_FB_SPACE_WARP_EXTENSION_NAME)){
+		XR_LOG_ERROR(XR_FB_SPACE_WARP_EXTENSION_NAME << " is not supported by the runtime (or the instance is not created)");
+		return false;
+	}
+	flagSpaceWarp = enable;
+	if(!enable){
+		flagSpaceWarpActive = false;
+		for(size_t i = 0; i < xr_space_warp_frames.size(); i++)
+			xr_space_warp_frames[i] = SpaceWarpFrame();
+	}
+	return true;
+}
+
+bool OpenXrApplication::getSpaceWarpResolution(int * width, int * height){
+	if(!isExtensionEnabled(XR_FB_SPACE_WARP_EXTENSION_NAME)){
+		XR_LOG_ERROR(XR_FB_SPACE_WARP_EXTENSION_NAME << " is not supported by the runtime (or the instance is not created)");
+		return false;
+	}
+	*width = xr_space_warp_properties.recommendedMotionVectorImageRectWidth;
+	*height = xr_space_warp_properties.recommendedMotionVectorImageRectHeight;
+	return true;
+}
+
+bool OpenXrApplication::getReprojectionModes(vector<XrReprojectionModeMSFT> & modes){
+	modes.clear();
+	if(!isExtensionEnabled(XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME)){
+		XR_LOG_WARNING(XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME << " is not enabled");
+		return false;
 	}
-	int getViewConfigurationViewsSize(OpenXrApplication * app){ 
-		return app->getViewConfigurationViewsSize(); 
+	if(xr_session == XR_NULL_HANDLE){
+		XR_LOG_WARNING("The reprojection modes are negotiated when the session is created");
+		return false;
 	}
+	modes = xr_reprojection_modes;
+	return true;
+}
 
-    // setup app
-	bool createInstance(OpenXrApplication * app, const char * applicationName, const char * engineName, const char ** apiLayers, int apiLayersLength, const char ** extensions, int extensionsLength){
-		vector<string> requestedApiLayers;
-		for(int i = 0; i < apiLayersLength; i++)
-			requestedApiLayers.push_back(apiLayers[i]);
-		vector<string> requestedExtensions;
-		for(int i = 0; i < extensionsLength; i++)
-			requestedExtensions.push_back(extensions[i]);
-		return app->createInstance(applicationName, engineName, requestedApiLayers, requestedExtensions); 
+bool OpenXrApplication::setReprojectionMode(XrReprojectionModeMSFT mode){
+	if(mode && !isExtensionEnabled(XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME)){
+		XR_LOG_ERROR(XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME << " is not supported by the runtime (or the instance is not created)");
+		return false;
 	}
-    bool getSystem(OpenXrApplication * app, int formFactor, int blendMode, int configurationType){ 
-		return app->getSystem(XrFormFactor(formFactor), XrEnvironmentBlendMode(blendMode), XrViewConfigurationType(configurationType)); 
+	// the mode is validated when the session is created if it does not exist yet
+	if(mode && xr_session != XR_NULL_HANDLE && std::find(xr_reprojection_modes.begin(), xr_reprojection_modes.end(), mode) == xr_reprojection_modes.end()){
+		XR_LOG_WARNING("Unsupported reprojection mode: " << _enum_to_string(mode));
+		return false;
+	}
+	xr_reprojection_mode = mode;
+	return true;
+}
+
+bool OpenXrApplication::setReprojectionPlane(bool enable, const XrVector3f & position, const XrVector3f & normal, const XrVector3f & velocity){
+	if(enable && !isExtensionEnabled(XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME)){
+		XR_LOG_ERROR(XR_MSFT_COMPOSITION_LAYER_REPROJECTION_EXTENSION_NAME << " is not supported by the runtime (or the instance is not created)");
+		return false;
 	}
-    bool createSession(OpenXrApplication * app){ 
-		return app->createSession(); 
+	if(enable){
+		// the runtime requires a unit normal
+		float length = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		if(length < 1e-6f){
+			XR_LOG_WARNING("Invalid reprojection plane normal (zero length)");
+			return false;
+		}
+		xr_reprojection_plane.position = position;
+		xr_reprojection_plane.normal = {normal.x / length, normal.y / length, normal.z / length};
+		xr_reprojection_plane.velocity = velocity;
 	}
+	flagReprojectionPlane = enable;
+	return true;
+}
 
-	// actions
-	bool addAction(OpenXrApplication * app, const char * stringPath, int actionType, int referenceSpaceType){ 
-		return app->addAction(stringPath, XrActionType(actionType), XrReferenceSpaceType(referenceSpaceType)); 
+bool OpenXrApplication::startRecording(const string & path){
+	if(flagReplay){
+		XR_LOG_WARNING("Unable to record a session in replay mode");
+		return false;
+	}
+	if(xr_view_configuration_views.empty()){
+		XR_LOG_ERROR("The view configuration is not available. Call getSystem before startRecording");
+		return false;
 	}
-	bool applyHapticFeedback(OpenXrApplication * app, const char * stringPath, float amplitude, int64_t duration, float frequency){ 
-		XrHapticVibration vibration = {XR_TYPE_HAPTIC_VIBRATION};
-		vibration.amplitude = amplitude;
-		vibration.duration = XrDuration(duration);
-		vibration.frequency = frequency;
-		return app->applyHapticFeedback(stringPath, (XrHapticBaseHeader*)&vibration); 
+	if(!xr_recorder->start(path, configViewConfigurationType, environmentBlendMode, xr_view_configuration_views))
+		return false;
+	XR_LOG_INFO("Recording session to " << path);
+	return true;
+}
+
+void OpenXrApplication::stopRecording(){
+	xr_recorder->stop();
+}
+
+bool OpenXrApplication::startReplay(const string & path, float speed){
+	if(xr_instance != NULL){
+		XR_LOG_ERROR("Unable to replay a session: an OpenXR instance already exists. Call startReplay before createInstance");
+		return false;
 	}
-	bool stopHapticFeedback(OpenXrApplication * app, const char * stringPath){ 
-		return app->stopHapticFeedback(stringPath); 
+	if(!xr_replayer->open(path, speed))
+		return false;
+	flagReplay = true;
+	XR_LOG_INFO("Replaying session from " << path << " (speed: " << speed << ")");
+	return true;
+}
+
+void OpenXrApplication::setLogLevel(int level){
+	Logger::instance().setLevel(level);
+}
+
+void OpenXrApplication::setLogRateLimit(int milliseconds){
+	Logger::instance().setRateLimit(milliseconds);
+}
+
+void OpenXrApplication::setLogCallbackFromPointer(void (*callback)(int, const char *)){
+	Logger::instance().setCallback(callback);
+}
+
+void OpenXrApplication::setLogCallbackFromFunction(function<void(int, const char *)> &callback){
+	Logger::instance().setCallback(callback);
+}
+
+void OpenXrApplication::setVerbose(bool enable){
+	flagVerboseOutput = enable;
+}
+
+bool OpenXrApplication::setMirror(bool enable, int view, float scale, float rate){
+	if(enable && (view < 0 || scale <= 0 || scale > 1 || rate <= 0)){
+		XR_LOG_WARNING("Invalid desktop mirror settings (view: " << view << ", scale: " << scale << ", rate: " << rate << ")");
+		return false;
 	}
+	xr_mirror_view = view;
+	dispatchGraphicsHandler([&](auto & handler){
+		handler.setMirror(enable, scale, rate);
+		return true;
+	});
+	return true;
+}
+
+bool OpenXrApplication::isExtensionEnabled(const string & extensionName){
+	return std::find(xr_enabled_extensions.begin(), xr_enabled_extensions.end(), extensionName) != xr_enabled_extensions.end();
+}
 
-    // poll data
-	bool pollEvents(OpenXrApplication * app, bool * exitLoop){ 
-		return app->pollEvents(exitLoop); 
+bool OpenXrApplication::setPerformanceLevel(XrPerfSettingsDomainEXT domain, XrPerfSettingsLevelEXT level){
+	if(!xrPerfSettingsSetPerformanceLevelEXT){
+		XR_LOG_WARNING(XR_EXT_PERFORMANCE_SETTINGS_EXTENSION_NAME << " is not enabled");
+		return false;
 	}
-    bool pollActions(OpenXrApplication * app, ActionState * actionStates, int actionStatesLength){
-		vector<ActionState> requestedActionStates;
-		bool status = app->pollActions(requestedActionStates);
-		if(requestedActionStates.size() <= actionStatesLength)
-			for(size_t i = 0; i < requestedActionStates.size(); i++)
-				actionStates[i] = requestedActionStates[i];
-		return status;
+	xr_result = xrPerfSettingsSetPerformanceLevelEXT(xr_session, domain, level);
+	if(!xrCheckResult(xr_instance, xr_result, "xrPerfSettingsSetPerformanceLevelEXT"))
+		return false;
+	return true;
+}
+
+bool OpenXrApplication::getDisplayRefreshRates(vector<float> & rates){
+	rates.clear();
+	if(!xrEnumerateDisplayRefreshRatesFB){
+		XR_LOG_WARNING(XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME << " is not enabled");
+		return false;
 	}
+	uint32_t rateCountOutput;
+	xr_result = xrEnumerateDisplayRefreshRatesFB(xr_session, 0, &rateCountOutput, nullptr);
+	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateDisplayRefreshRatesFB"))
+		return false;
+	rates.resize(rateCountOutput);
+	xr_result = xrEnumerateDisplayRefreshRatesFB(xr_session, rateCountOutput, &rateCountOutput, rates.data());
+	if(!xrCheckResult(xr_instance, xr_result, "xrEnumerateDisplayRefreshRatesFB"))
+		return false;
+	return true;
+}
 
-	// render
-    bool renderViews(OpenXrApplication * app, int referenceSpaceType, ActionPoseState * actionPoseStates, int actionPoseStatesLength){ 
-		vector<ActionPoseState> requestedActionPoseStates;
-		bool status = app->renderViews(XrReferenceSpaceType(referenceSpaceType), requestedActionPoseStates);
-		if(requestedActionPoseStates.size() <= actionPoseStatesLength)
-			for(size_t i = 0; i < requestedActionPoseStates.size(); i++)
-				actionPoseStates[i] = requestedActionPoseStates[i];
-		return status;
+bool OpenXrApplication::getDisplayRefreshRate(float * rate){
+	if(!xrGetDisplayRefreshRateFB){
+		XR_LOG_WARNING(XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME << " is not enabled");
+		return false;
 	}
+	xr_result = xrGetDisplayRefreshRateFB(xr_session, rate);
+	if(!xrCheckResult(xr_instance, xr_result, "xrGetDisplayRefreshRateFB"))
+		return false;
+	return true;
+}
 
-	// render utilities
-	void setRenderCallback(OpenXrApplication * app, void (*callback)(int, XrView*, XrViewConfigurationView*)){ 
-		app->setRenderCallbackFromPointer(callback); 
+bool OpenXrApplication::requestDisplayRefreshRate(float rate){
+	if(!xrRequestDisplayRefreshRateFB){
+		XR_LOG_WARNING(XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME << " is not enabled");
+		return false;
 	}
-	bool setFrames(OpenXrApplication * app, int leftWidth, int leftHeight, void * leftData, int rightWidth, int rightHeight, void * rightData, bool rgba){
-		if(app->getViewConfigurationViewsSize() == 1)
-			return app->setFrameByIndex(0, leftWidth, leftHeight, leftData, rgba);
-		else if(app->getViewConfigurationViewsSize() == 2){
-			bool status = app->setFrameByIndex(0, leftWidth, leftHeight, leftData, rgba);
-			return status && app->setFrameByIndex(1, rightWidth, rightHeight, rightData, rgba);
+	// the change is notified by XrEventDataDisplayRefreshRateChangedFB
+	xr_result = xrRequestDisplayRefreshRateFB(xr_session, rate);
+	if(!xrCheckResult(xr_instance, xr_result, "xrRequestDisplayRefreshRateFB"))
+		return false;
+	xr_requested_display_refresh_rate = rate;
+	return true;
+}
+
+bool OpenXrApplication::matchDisplayRefreshRate(float simulationRate, float * rate){
+	if(simulationRate <= 0)
+		return false;
+	vector<float> rates;
+	if(!getDisplayRefreshRates(rates))
+		return false;
+	// lowest rate that is an integer multiple of the simulation rate: every simulation step is displayed the same number of frames
+	std::sort(rates.begin(), rates.end());
+	for(float candidate : rates){
+		float ratio = candidate / simulationRate;
+		if(ratio >= 1 && std::fabs(ratio - std::round(ratio)) < 0.01f){
+			verboseOutput() << "Display refresh rate for a simulation rate of " << simulationRate << " Hz: " << candidate << " Hz" << std::endl;
+			*rate = candidate;
+			return requestDisplayRefreshRate(candidate);
 		}
+	}
+	XR_LOG_WARNING("No display refresh rate is a multiple of the simulation rate (" << simulationRate << " Hz)");
+	return false;
+}
+
+bool OpenXrApplication::getThermalTemperatureTrend(XrPerfSettingsDomainEXT domain, XrPerfSettingsNotificationLevelEXT * notificationLevel, float * tempHeadroom, float * tempSlope){
+	if(!xrThermalGetTemperatureTrendEXT){
+		XR_LOG_WARNING(XR_EXT_THERMAL_QUERY_EXTENSION_NAME << " is not enabled");
 		return false;
 	}
+	xr_result = xrThermalGetTemperatureTrendEXT(xr_session, domain, notificationLevel, tempHeadroom, tempSlope);
+	if(!xrCheckResult(xr_instance, xr_result, "xrThermalGetTemperatureTrendEXT"))
+		return false;
+	return true;
 }
-#endif
\ No newline at end of file
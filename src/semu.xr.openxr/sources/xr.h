@@ -0,0 +1,457 @@
+#pragma once
+
+// public interface of the OpenXR application library (OpenXrApplication). The implementation lives in xr.cpp and the
+// graphics handlers in xr_graphics.h, so this header does not depend on the compiled graphics APIs or their headers. The Python bindings (pybind11_wrapper.cpp, xr_ctypes.cpp) and the
+// standalone application (xr_app.cpp) are thin layers on top of this header
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include <functional>
+#include <condition_variable>
+#include <stdint.h>
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_reflection.h>
+
+#ifndef _countof
+#define _countof(x) (sizeof(x)/sizeof((x)[0]))
+#endif
+
+struct ActionState{
+  	XrActionType type;
+	const char * path;
+	bool isActive;
+    bool stateBool;			// XR_TYPE_ACTION_STATE_BOOLEAN
+    float stateFloat;		// XR_TYPE_ACTION_STATE_FLOAT
+    float stateVectorX;		// XR_TYPE_ACTION_STATE_VECTOR2F
+    float stateVectorY;		// XR_TYPE_ACTION_STATE_VECTOR2F
+};
+
+struct ActionPoseState{
+  	XrActionType type;
+	const char * path;
+	bool isActive;
+	XrPosef pose;			// XR_TYPE_ACTION_STATE_POSE
+};
+
+struct Action{
+	XrAction action;
+	XrPath path;
+ 	std::string stringPath;
+};
+
+struct ActionPose{
+	XrReferenceSpaceType referenceSpaceType;
+	XrSpace space = XR_NULL_HANDLE;
+	XrAction action;
+	XrPath path;
+ 	std::string stringPath;
+};
+
+struct Actions{
+	std::vector<Action> aBoolean;
+	std::vector<Action> aFloat;
+	std::vector<Action> aVector2f;
+	std::vector<ActionPose> aPose;
+	std::vector<Action> aVibration;
+};
+
+// swapchains, composition layers and graphics handlers (defined in xr_graphics.h, private to xr.cpp)
+struct SwapchainHandler;
+struct CompositionLayer;
+struct GraphicsBackends;
+
+// color scale and bias of a layer (XR_KHR_composition_layer_color_scale_bias), interpolated linearly by the frame loop over the fade duration
+struct ColorFade{
+	XrColor4f startScale = {1, 1, 1, 1};
+	XrColor4f startBias = {0, 0, 0, 0};
+	XrColor4f targetScale = {1, 1, 1, 1};
+	XrColor4f targetBias = {0, 0, 0, 0};
+	XrColor4f scale = {1, 1, 1, 1};		// last submitted values
+	XrColor4f bias = {0, 0, 0, 0};
+	double duration = 0;				// seconds
+	XrTime startTime = 0;				// display time of the first frame of the fade (0: the next frame)
+};
+
+// depth frame of a view (XR_KHR_composition_layer_depth): linear depth (distance to the image plane) and clipping planes, in meters
+struct DepthFrame{
+	int width = 0;
+	int height = 0;
+	const float * data = nullptr;		// not owned: the caller keeps the buffer alive until the next renderViews call
+	float nearZ = 0;
+	float farZ = 0;
+};
+
+// space warp frame of a view (XR_FB_space_warp): motion vectors (RGBA, xyz motion in normalized device coordinates from the previous frame) 
+// and linear depth (distance to the image plane, in meters) at the motion vector resolution
+struct SpaceWarpFrame{
+	int width = 0;
+	int height = 0;
+	const float * motionVectors = nullptr;	// not owned: the caller keeps the buffers alive until the next renderViews call (cleared once submitted)
+	const float * depth = nullptr;
+	float nearZ = 0;
+	float farZ = 0;
+};
+
+// visibility mask of a view (XR_KHR_visibility_mask): meshes indexed by XrVisibilityMaskTypeKHR - 1 (hidden triangles, visible triangles and line loop),
+// in view space (the vertices lie on the plane at z = -1)
+struct VisibilityMask{
+	bool outdated = true;				// fetched (xrGetVisibilityMaskKHR) on the next use
+	XrFovf fov = {0, 0, 0, 0};			// field of view of the visible area set in the graphics handler
+	std::vector<XrVector2f> vertices[3];
+	std::vector<uint32_t> indices[3];
+};
+
+// visible area of a view in the graphics handlers: visible triangles in frame texture coordinates ([0, 1], origin at the bottom-left as the frames are drawn).
+// The frame rows are grouped in bands and only the tiles of each band from the first to the last visible one are uploaded and drawn
+struct VisibleArea{
+	std::vector<XrVector2f> vertices;
+	std::vector<uint32_t> indices;		// empty: no mask (the whole frame is visible)
+	int width = 0;						// frame size of the rectangles
+	int height = 0;
+	std::vector<XrRect2Di> rects;		// visible part of the bands (frame pixels). Fully hidden bands are skipped
+};
+
+// graphics backends (selected at runtime, before creating the instance)
+enum GraphicsBackend{
+	GRAPHICS_BACKEND_OPENGL = 0,
+	GRAPHICS_BACKEND_VULKAN = 1,
+	GRAPHICS_BACKEND_HEADLESS = 2		// tracking-only session (XR_MND_headless), no graphics binding and no swapchains
+};
+
+// log levels (setLogLevel and log callback)
+enum LogLevel{
+	LOG_LEVEL_DEBUG = 0,
+	LOG_LEVEL_INFO = 1,
+	LOG_LEVEL_WARNING = 2,
+	LOG_LEVEL_ERROR = 3
+};
+
+// session record and replay (defined in xr.cpp)
+class SessionRecorder;
+class SessionReplayer;
+
+// startup phases (timing breakdown of createInstance, getSystem and createSession)
+enum StartupPhase{
+	STARTUP_PHASE_ENUMERATION = 0,			// API layers and extensions
+	STARTUP_PHASE_INSTANCE,
+	STARTUP_PHASE_SYSTEM,					// system, view configurations, blend modes and action set
+	STARTUP_PHASE_GRAPHICS_BINDING,			// graphics requirements and context (or device)
+	STARTUP_PHASE_GRAPHICS_RESOURCES,		// programs (or pipelines) and upload worker
+	STARTUP_PHASE_SESSION,
+	STARTUP_PHASE_REFERENCE_SPACES,
+	STARTUP_PHASE_INTERACTION_PROFILES,
+	STARTUP_PHASE_ACTION_SPACES,
+	STARTUP_PHASE_SWAPCHAINS,
+	STARTUP_PHASE_COUNT
+};
+
+// session recovery: the lost session (or instance) is recreated while the graphics resources are kept
+enum RecoveryState{
+	RECOVERY_NONE = 0,
+	RECOVERY_INSTANCE,		// instance lost: create the instance
+	RECOVERY_SYSTEM,		// instance created: get the system, replay the registered actions and query the graphics requirements
+	RECOVERY_SESSION		// session lost: wait for the system and create the session, spaces, action attachments and swapchains
+};
+
+class OpenXrApplication{
+private:
+	XrResult xr_result;
+
+	XrInstance xr_instance = {};
+	XrSystemId xr_system_id = XR_NULL_SYSTEM_ID;
+	XrSession xr_session = {};
+
+	XrSpace xr_space_view = {};
+	XrSpace xr_space_local = {};
+	XrSpace xr_space_stage = {};
+
+	// actions
+	XrActionSet xr_action_set = XR_NULL_HANDLE;
+	Actions xr_actions;
+
+	std::vector<SwapchainHandler> xr_swapchains_handlers;
+	std::vector<XrViewConfigurationView> xr_view_configuration_views;
+
+	bool xr_frames_is_rgba;
+	std::vector<int> xr_frames_width;
+	std::vector<int> xr_frames_height;
+	std::vector<void*> xr_frames_data;		// not owned: the caller keeps the frame buffers alive until the next renderViews call
+	void (*renderCallback)(int, XrView*, XrViewConfigurationView*);
+	std::function<void(int, std::vector<XrView>, std::vector<XrViewConfigurationView>)> renderCallbackFunction;
+
+	// performance settings and thermal query (XR_EXT_performance_settings, XR_EXT_thermal_query)
+	std::vector<std::string> xr_enabled_extensions;
+	PFN_xrPerfSettingsSetPerformanceLevelEXT xrPerfSettingsSetPerformanceLevelEXT = nullptr;
+	PFN_xrThermalGetTemperatureTrendEXT xrThermalGetTemperatureTrendEXT = nullptr;
+
+	// visibility mask per view (XR_KHR_visibility_mask), fetched on first use and when the runtime notifies a change
+	PFN_xrGetVisibilityMaskKHR xrGetVisibilityMaskKHR = nullptr;
+	std::vector<VisibilityMask> xr_visibility_masks;
+	void (*perfSettingsCallback)(int, int, int, int);
+	std::function<void(int, int, int, int)> perfSettingsCallbackFunction;
+
+	// display refresh rate (XR_FB_display_refresh_rate): the requested rate (0: runtime default) is requested again when the session is recreated
+	PFN_xrEnumerateDisplayRefreshRatesFB xrEnumerateDisplayRefreshRatesFB = nullptr;
+	PFN_xrGetDisplayRefreshRateFB xrGetDisplayRefreshRateFB = nullptr;
+	PFN_xrRequestDisplayRefreshRateFB xrRequestDisplayRefreshRateFB = nullptr;
+	float xr_requested_display_refresh_rate = 0;
+	void (*displayRefreshRateCallback)(float, float);
+	std::function<void(float, float)> displayRefreshRateCallbackFunction;
+
+	// runtime messages (XR_EXT_debug_utils)
+	bool flagDebugUtils = false;
+
+	// surfaceless EGL context instead of the SDL window and GLX (XR_MNDX_egl_enable)
+	bool flagEgl = false;
+	bool flagEglBinding = false;
+	// tracking-only session without graphics binding and swapchains (XR_MND_headless)
+	bool flagHeadless = false;
+	bool flagHeadlessSession = false;
+
+	XrDebugUtilsMessengerEXT xr_debug_utils_messenger = XR_NULL_HANDLE;
+	PFN_xrDestroyDebugUtilsMessengerEXT xrDestroyDebugUtilsMessengerEXT = nullptr;
+
+	bool flagSessionRunning = false;
+
+	// desktop mirror (view index whose swapchain image is blitted into the window)
+	int xr_mirror_view = 0;
+
+	// frame uploads on a worker thread with a shared context (OpenGL)
+	bool flagUploadWorker = false;
+
+	// enumeration cache key (runtime name and version, system name, vendor and form factor)
+	std::string xr_system_key;
+
+	// session recovery (XR_SESSION_STATE_LOSS_PENDING and instance loss)
+	bool flagSessionRecovery = false;
+	bool flagBindingsSuggested = false;		// interaction profile bindings can only be suggested before the first attachment
+	RecoveryState xr_recovery_state = RECOVERY_NONE;
+	Actions xr_recovery_actions;			// registered actions when the instance was lost, replayed on the new action set
+	std::chrono::steady_clock::time_point xr_recovery_start;
+	std::chrono::steady_clock::time_point xr_recovery_attempt;
+	double xr_recovery_time = -1;			// time-to-recovery (ms) of the last recovery
+	int xr_recovery_count = 0;
+
+	// instance and system parameters (used to recreate them)
+	std::string xr_application_name;
+	std::string xr_engine_name;
+	std::vector<std::string> xr_requested_api_layers;
+	std::vector<std::string> xr_requested_extensions;
+	XrFormFactor xr_form_factor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
+	XrEnvironmentBlendMode xr_requested_blend_mode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+	XrViewConfigurationType xr_requested_configuration_type = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+
+	// startup timing (milliseconds per phase)
+	std::vector<double> xr_startup_timing = std::vector<double>(STARTUP_PHASE_COUNT, 0);
+	std::chrono::steady_clock::time_point xr_startup_phase_start;
+
+	// per-frame containers (reused across frames to avoid reallocations in the render loop)
+	std::vector<XrView> xr_views;
+	std::vector<XrCompositionLayerProjectionView> xr_projection_views;
+	std::vector<XrCompositionLayerBaseHeader*> xr_layers;
+	std::vector<XrCompositionLayerQuad> xr_quad_layer_headers;
+	std::vector<XrCompositionLayerCylinderKHR> xr_cylinder_layer_headers;
+	std::vector<XrCompositionLayerEquirect2KHR> xr_equirect_layer_headers;
+	std::vector<XrCompositionLayerCubeKHR> xr_cube_layer_headers;
+	std::vector<XrCompositionLayerColorScaleBiasKHR> xr_color_scale_bias_infos;
+	XrCompositionLayerColorScaleBiasKHR xr_projection_color_scale_bias = {XR_TYPE_COMPOSITION_LAYER_COLOR_SCALE_BIAS_KHR};
+
+	// color scale and bias of the projection layer (the composition layers keep their own)
+	ColorFade xr_projection_color_fade;
+
+	// depth submission (XR_KHR_composition_layer_depth): the depth swapchains are created with the first depth frame
+	bool flagDepthUnavailable = false;		// no depth format supported by both the runtime and the graphics backend
+	std::vector<DepthFrame> xr_depth_frames;
+	std::vector<SwapchainHandler> xr_depth_swapchains_handlers;
+	std::vector<XrCompositionLayerDepthInfoKHR> xr_depth_infos;
+	std::vector<int64_t> xr_swapchain_formats;		// formats supported by the runtime
+	int64_t xr_depth_swapchain_format = -1;
+
+	// application space warp (XR_FB_space_warp): the runtime synthesizes every other frame from the motion vectors and depth.
+	// The swapchains (recommended motion vector resolution) are created with the first space warp frame
+	bool flagSpaceWarp = false;
+	bool flagSpaceWarpUnavailable = false;		// no motion vector or depth format supported by both the runtime and the graphics backend
+	bool flagSpaceWarpActive = false;			// space warp information chained to the last submitted frame
+	XrSystemSpaceWarpPropertiesFB xr_space_warp_properties = {XR_TYPE_SYSTEM_SPACE_WARP_PROPERTIES_FB};
+	std::vector<SpaceWarpFrame> xr_space_warp_frames;
+	std::vector<SwapchainHandler> xr_motion_vector_swapchains_handlers;
+	std::vector<SwapchainHandler> xr_space_warp_depth_swapchains_handlers;
+	std::vector<XrCompositionLayerSpaceWarpInfoFB> xr_space_warp_infos;
+	int64_t xr_motion_vector_swapchain_format = -1;
+
+	// reprojection hints of the projection layer (XR_MSFT_composition_layer_reprojection): the modes are negotiated with the runtime 
+	// when the session is created. The plane override is ignored by the orientation-only reprojection
+	PFN_xrEnumerateReprojectionModesMSFT xrEnumerateReprojectionModesMSFT = nullptr;
+	std::vector<XrReprojectionModeMSFT> xr_reprojection_modes;		// modes supported for the view configuration
+	XrReprojectionModeMSFT xr_reprojection_mode = XrReprojectionModeMSFT(0);	// 0: runtime default (nothing chained)
+	XrCompositionLayerReprojectionInfoMSFT xr_reprojection_info = {XR_TYPE_COMPOSITION_LAYER_REPROJECTION_INFO_MSFT};
+	XrCompositionLayerReprojectionPlaneOverrideMSFT xr_reprojection_plane = {XR_TYPE_COMPOSITION_LAYER_REPROJECTION_PLANE_OVERRIDE_MSFT};
+	bool flagReprojectionPlane = false;
+
+	// composition layers (identifier: index, submitted in creation order after the projection layer)
+	std::vector<CompositionLayer> xr_composition_layers;
+	int64_t xr_swapchain_format = -1;		// format selected for the view swapchains (also used by the layer swapchains)
+
+	// session record and replay
+	std::unique_ptr<SessionRecorder> xr_recorder;
+	std::unique_ptr<SessionReplayer> xr_replayer;
+	bool flagReplay = false;
+
+	// config
+	XrEnvironmentBlendMode environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_MAX_ENUM;
+	XrViewConfigurationType configViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_MAX_ENUM;
+
+	// graphics backend selected at runtime (the handlers of all the compiled graphics APIs are available)
+	GraphicsBackend xr_graphics_backend = GRAPHICS_BACKEND_OPENGL;		// Vulkan if OpenGL is not compiled in (constructor)
+	std::unique_ptr<GraphicsBackends> xr_graphics;
+
+	bool defineLayers(const std::vector<std::string> &, std::vector<std::string> &);
+	bool defineExtensions(const std::vector<std::string> &, const std::vector<std::string> &, std::vector<std::string> &);
+	void loadExtensionFunctions();
+
+	bool acquireInstanceProperties();
+	bool acquireSystemProperties();
+	bool acquireViewConfiguration(XrViewConfigurationType);
+	bool acquireBlendModes(XrEnvironmentBlendMode);
+
+	bool defineReferenceSpaces();
+	void defineInteractionProfileBindings(std::vector<XrActionSuggestedBinding> &, const std::vector<std::string> &);
+	bool suggestInteractionProfileBindings();
+	bool defineSessionSpaces();
+	template <typename GraphicsHandler> bool createSwapchain(GraphicsHandler &, const XrSwapchainCreateInfo &, SwapchainHandler &);
+	template <typename GraphicsHandler> bool defineSwapchains(GraphicsHandler &);
+	template <typename GraphicsHandler> bool defineDepthSwapchains(GraphicsHandler &);
+	template <typename GraphicsHandler> bool defineSpaceWarpSwapchains(GraphicsHandler &);
+	template <typename GraphicsHandler> bool defineCompositionLayerSwapchain(GraphicsHandler &, CompositionLayer &);
+	template <typename GraphicsHandler> bool renderDepth(GraphicsHandler &, uint32_t);
+	template <typename GraphicsHandler> bool renderSpaceWarp(GraphicsHandler &, uint32_t);
+	template <typename GraphicsHandler> void updateVisibleArea(GraphicsHandler &, uint32_t, const XrFovf &);
+	bool updateVisibilityMask(uint32_t);
+	template <typename GraphicsHandler> bool renderCompositionLayer(GraphicsHandler &, CompositionLayer &);
+	void releaseCompositionLayerSwapchain(CompositionLayer &);
+	CompositionLayer * getCompositionLayer(int);
+	int addCompositionLayer(const CompositionLayer &);
+	XrSpace getReferenceSpace(XrReferenceSpaceType);
+	bool defineGraphicsBinding();
+	bool defineVulkanGraphicsBinding();
+	bool defineOpenGLGraphicsBinding();
+	bool createSessionObjects();
+
+	void releaseSession();
+	void releaseInstance();
+	bool beginRecovery(RecoveryState);
+	bool handleLoss(XrResult);
+	void attemptRecovery();
+
+	// call the function with the handler of the selected graphics backend (OpenGL or Vulkan)
+	template <typename Function> bool dispatchGraphicsHandler(Function);
+	template <typename GraphicsHandler> bool renderFrame(GraphicsHandler &, XrReferenceSpaceType, std::vector<ActionPoseState> &);
+
+	void beginStartupPhase(){ xr_startup_phase_start = std::chrono::steady_clock::now(); };
+	void endStartupPhase(StartupPhase);
+
+	void cleanFrames(){
+		// for(size_t i = 0; i < xr_frames_data.size(); i++){
+		// 	xr_frames_data[i] = nullptr;
+		// 	xr_frames_width[i] = 0;
+		// 	xr_frames_height[i] = 0;
+		// }
+	};
+
+public:
+	OpenXrApplication();
+	~OpenXrApplication();
+
+    bool destroy();
+
+	bool createInstance(const std::string &, const std::string &, const std::vector<std::string> &, const std::vector<std::string> &);
+	bool getSystem(XrFormFactor, XrEnvironmentBlendMode, XrViewConfigurationType); 
+	bool createSession();
+	bool pollEvents(bool *);
+	bool pollActions(std::vector<ActionState> &);
+	bool renderViews(XrReferenceSpaceType, std::vector<ActionPoseState> &);
+
+	bool addAction(std::string, XrActionType, XrReferenceSpaceType);
+	bool applyHapticFeedback(std::string, XrHapticBaseHeader *);
+	bool stopHapticFeedback(std::string);
+
+	bool setFrameByIndex(int, int, int, void *, bool);
+	bool setFrameByIndex(int, int, int, void *, bool, const float *, float, float);
+	bool setDepthByIndex(int, int, int, const float *, float, float);
+	bool setSpaceWarpByIndex(int, int, int, const float *, int, int, const float *, float, float);
+	void setRenderCallbackFromPointer(void (*callback)(int, XrView*, XrViewConfigurationView*)){ renderCallback = callback; };
+	void setRenderCallbackFromFunction(std::function<void(int, std::vector<XrView>, std::vector<XrViewConfigurationView>)> &callback){ renderCallbackFunction = callback; };
+
+	int addQuadLayer(int, int, XrReferenceSpaceType, const XrPosef &, const XrExtent2Df &);
+	int addCylinderLayer(int, int, XrReferenceSpaceType, const XrPosef &, float, float, float);
+	int addEquirectLayer(int, int, XrReferenceSpaceType, const XrPosef &, float, float, float, float);
+	int addCubeLayer(int, XrReferenceSpaceType, const XrQuaternionf &);
+	bool setLayerImage(int, int, int, void *, bool);
+	bool setLayerFrame(int, int, int, void *, bool);
+	bool setLayerPose(int, XrReferenceSpaceType, const XrPosef &);
+	bool setQuadLayerPose(int, XrReferenceSpaceType, const XrPosef &, const XrExtent2Df &);
+	bool setLayerVisible(int, bool);
+	bool removeLayer(int);
+	bool setColorScaleBias(int, const XrColor4f &, const XrColor4f &, float);
+
+	bool getVisibilityMask(int, XrVisibilityMaskTypeKHR, std::vector<XrVector2f> &, std::vector<uint32_t> &);
+
+	bool setSpaceWarp(bool);
+	bool isSpaceWarpActive(){ return flagSpaceWarpActive; }
+	bool getSpaceWarpResolution(int *, int *);
+
+	bool getReprojectionModes(std::vector<XrReprojectionModeMSFT> &);
+	bool setReprojectionMode(XrReprojectionModeMSFT);
+	bool setReprojectionPlane(bool, const XrVector3f &, const XrVector3f &, const XrVector3f &);
+
+	bool isExtensionEnabled(const std::string &);
+	bool setPerformanceLevel(XrPerfSettingsDomainEXT, XrPerfSettingsLevelEXT);
+	bool getThermalTemperatureTrend(XrPerfSettingsDomainEXT, XrPerfSettingsNotificationLevelEXT *, float *, float *);
+	void setPerfSettingsCallbackFromPointer(void (*callback)(int, int, int, int)){ perfSettingsCallback = callback; };
+	void setPerfSettingsCallbackFromFunction(std::function<void(int, int, int, int)> &callback){ perfSettingsCallbackFunction = callback; };
+
+	bool getDisplayRefreshRates(std::vector<float> &);
+	bool getDisplayRefreshRate(float *);
+	bool requestDisplayRefreshRate(float);
+	bool matchDisplayRefreshRate(float, float *);
+	void setDisplayRefreshRateCallbackFromPointer(void (*callback)(float, float)){ displayRefreshRateCallback = callback; };
+	void setDisplayRefreshRateCallbackFromFunction(std::function<void(float, float)> &callback){ displayRefreshRateCallbackFunction = callback; };
+
+	void setLogLevel(int);
+	void setLogRateLimit(int);
+	void setLogCallbackFromPointer(void (*callback)(int, const char *));
+	void setLogCallbackFromFunction(std::function<void(int, const char *)> &);
+	void setDebugUtils(bool enable){ flagDebugUtils = enable; };
+	void setEglContext(bool enable){ flagEgl = enable; };
+	void setHeadless(bool enable){ flagHeadless = enable; };
+	bool setGraphicsBackend(int);
+	int getGraphicsBackend(){ return flagHeadlessSession ? GRAPHICS_BACKEND_HEADLESS : xr_graphics_backend; }
+	static bool isGraphicsBackendAvailable(int);
+	static const char * getGraphicsExtensionName(int);		// nullptr: headless or not compiled in
+	int getGraphicsFenceCount();		// live fences of the graphics backend (e.g. OpenGL upload worker sync objects)
+	bool setMirror(bool, int, float, float);
+	void setUploadWorker(bool enable){ flagUploadWorker = enable; };
+	void setVerbose(bool);
+	std::vector<double> getStartupTiming(){ return xr_startup_timing; }
+	void setSessionRecovery(bool enable){ flagSessionRecovery = enable; };
+	bool isRecovering(){ return xr_recovery_state != RECOVERY_NONE; }
+	double getRecoveryTime(){ return xr_recovery_time; }
+	int getRecoveryCount(){ return xr_recovery_count; }
+
+	bool startRecording(const std::string &);
+	void stopRecording();
+	bool startReplay(const std::string &, float);
+	bool isReplaying(){ return flagReplay; }
+
+	bool isSessionRunning(){ return flagSessionRunning; }
+	bool isHeadless(){ return flagHeadlessSession; }
+	int getViewConfigurationViewsSize(){ return xr_view_configuration_views.size(); }
+	std::vector<XrViewConfigurationView> getViewConfigurationViews(){ return xr_view_configuration_views; }
+};
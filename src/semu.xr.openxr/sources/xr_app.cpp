@@ -0,0 +1,464 @@
+// standalone application (and soak benchmark, APPLICATION_SOAK) built on top of the OpenXR application library
+
+#include "xr.h"
+
+// the window events are polled with SDL and the live OpenGL objects are counted by the soak benchmark
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <SDL2/SDL.h>
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+using namespace std;
+
+#ifdef APPLICATION_SOAK
+// soak benchmark: run the frame loop for a long time and fail if memory, OpenGL objects or frame time drift
+// (compared to a baseline sample taken after the warmup period)
+
+#define SOAK_GL_PROBE_RANGE 4096		// OpenGL names probed (1 .. SOAK_GL_PROBE_RANGE) when counting live objects
+
+struct SoakOptions{
+	double duration = 3600;				// seconds
+	double sampleInterval = 10;			// seconds
+	double warmup = 30;					// seconds
+	double maxRssGrowth = 16;			// MB
+	int maxGlObjectGrowth = 0;			// objects
+	double maxFrameTimeDrift = 0.25;	// relative p99 increase
+};
+
+struct SoakSample{
+	double time;
+	double rss;
+	int glObjects;
+	double p50;
+	double p99;
+	size_t frames;
+};
+
+class SoakMonitor{
+private:
+	SoakOptions options;
+	std::chrono::steady_clock::time_point startTime;
+	std::chrono::steady_clock::time_point windowTime;
+	vector<double> frameTimes;
+	vector<SoakSample> samples;
+	bool hasBaseline = false;
+	size_t baselineIndex = 0;
+	OpenXrApplication * application = nullptr;
+
+	static double readRss(){
+		long pages = 0, residentPages = 0;
+		FILE * file = fopen("/proc/self/statm", "r");
+		if(!file)
+			return 0;
+		if(fscanf(file, "%ld %ld", &pages, &residentPages) != 2)
+			residentPages = 0;
+		fclose(file);
+		return residentPages * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+	}
+
+	// sync objects are pointers, not names (they cannot be probed): the live fences are counted by the graphics handler
+	int countGlObjects(){
+		int count = application->getGraphicsFenceCount();
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+		for(GLuint name = 1; name <= SOAK_GL_PROBE_RANGE; name++)
+			count += glIsTexture(name) + glIsBuffer(name) + glIsFramebuffer(name) + glIsRenderbuffer(name) + 
+					 glIsVertexArray(name) + glIsProgram(name) + glIsShader(name);
+#endif
+		return count;
+	}
+
+	double percentile(double p){
+		if(frameTimes.empty())
+			return 0;
+		size_t index = std::min(frameTimes.size() - 1, (size_t)(p * frameTimes.size()));
+		std::nth_element(frameTimes.begin(), frameTimes.begin() + index, frameTimes.end());
+		return frameTimes[index];
+	}
+
+public:
+	bool parseArguments(int argc, char ** argv){
+		for(int i = 1; i < argc - 1; i++){
+			if(!strcmp(argv[i], "--duration"))
+				options.duration = atof(argv[i + 1]);
+			else if(!strcmp(argv[i], "--sample-interval"))
+				options.sampleInterval = atof(argv[i + 1]);
+			else if(!strcmp(argv[i], "--warmup"))
+				options.warmup = atof(argv[i + 1]);
+			else if(!strcmp(argv[i], "--max-rss-growth"))
+				options.maxRssGrowth = atof(argv[i + 1]);
+			else if(!strcmp(argv[i], "--max-gl-object-growth"))
+				options.maxGlObjectGrowth = atoi(argv[i + 1]);
+			else if(!strcmp(argv[i], "--max-frame-time-drift"))
+				options.maxFrameTimeDrift = atof(argv[i + 1]);
+		}
+		if(options.sampleInterval <= 0 || options.duration <= options.warmup){
+			std::cout << "[ERROR] Invalid soak options (sample interval must be positive and duration greater than warmup)" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	void start(OpenXrApplication * app){
+		application = app;
+		startTime = std::chrono::steady_clock::now();
+		windowTime = startTime;
+		// enough capacity for a sample window at 1 kHz (no reallocations while sampling)
+		frameTimes.reserve((size_t)(options.sampleInterval * 1000) + 1);
+		samples.reserve((size_t)(options.duration / options.sampleInterval) + 2);
+		std::cout << "Soak benchmark: " << options.duration << " s (warmup: " << options.warmup << " s, sample interval: " << options.sampleInterval << " s)" << std::endl;
+		std::cout << "  |-- limits: RSS growth " << options.maxRssGrowth << " MB, OpenGL object growth " << options.maxGlObjectGrowth << ", p99 frame time drift " << options.maxFrameTimeDrift * 100 << " %" << std::endl;
+	}
+
+	// record a loop iteration and sample the resources at the end of each window. Return false when the soak is over
+	bool update(double frameTime){
+		if(frameTimes.size() < frameTimes.capacity())
+			frameTimes.push_back(frameTime);
+
+		auto now = std::chrono::steady_clock::now();
+		double elapsed = std::chrono::duration<double>(now - startTime).count();
+		if(std::chrono::duration<double>(now - windowTime).count() < options.sampleInterval)
+			return true;
+
+		SoakSample sample;
+		sample.time = elapsed;
+		sample.rss = readRss();
+		sample.glObjects = countGlObjects();
+		sample.frames = frameTimes.size();
+		sample.p50 = percentile(0.50);
+		sample.p99 = percentile(0.99);
+		samples.push_back(sample);
+
+		std::cout << "  |-- t: " << (int)sample.time << " s, frames: " << sample.frames << ", RSS: " << sample.rss << " MB, GL objects: " << sample.glObjects 
+				  << ", frame time p50: " << sample.p50 << " ms, p99: " << sample.p99 << " ms" << (hasBaseline ? "" : (elapsed >= options.warmup ? " (baseline)" : " (warmup)")) << std::endl;
+		if(!hasBaseline && elapsed >= options.warmup){
+			baselineIndex = samples.size() - 1;
+			hasBaseline = true;
+		}
+
+		frameTimes.clear();
+		windowTime = now;
+		return elapsed < options.duration;
+	}
+
+	// compare the last sample with the baseline. Return false if any drift exceeds its limit
+	bool report(){
+		if(!hasBaseline || samples.size() < baselineIndex + 2){
+			std::cout << "[ERROR] Soak benchmark: not enough samples after warmup" << std::endl;
+			return false;
+		}
+		const SoakSample & baseline = samples[baselineIndex];
+		const SoakSample & last = samples.back();
+		double rssGrowth = last.rss - baseline.rss;
+		int glObjectGrowth = last.glObjects - baseline.glObjects;
+		double frameTimeDrift = baseline.p99 > 0 ? (last.p99 - baseline.p99) / baseline.p99 : 0;
+
+		bool status = true;
+		std::cout << "Soak benchmark result" << std::endl;
+		std::cout << "  |-- RSS growth: " << rssGrowth << " MB" << std::endl;
+		std::cout << "  |-- OpenGL object growth: " << glObjectGrowth << std::endl;
+		std::cout << "  |-- p99 frame time drift: " << frameTimeDrift * 100 << " % (" << baseline.p99 << " ms -> " << last.p99 << " ms)" << std::endl;
+		if(rssGrowth > options.maxRssGrowth){
+			std::cout << "[ERROR] RSS growth exceeds the limit (" << options.maxRssGrowth << " MB)" << std::endl;
+			status = false;
+		}
+		if(glObjectGrowth > options.maxGlObjectGrowth){
+			std::cout << "[ERROR] OpenGL object growth exceeds the limit (" << options.maxGlObjectGrowth << ")" << std::endl;
+			status = false;
+		}
+		if(frameTimeDrift > options.maxFrameTimeDrift){
+			std::cout << "[ERROR] p99 frame time drift exceeds the limit (" << options.maxFrameTimeDrift * 100 << " %)" << std::endl;
+			status = false;
+		}
+		std::cout << "  |-- status: " << (status ? "PASSED" : "FAILED") << std::endl;
+		return status;
+	}
+};
+
+// synthetic frames (persistent buffers, only the first row changes every frame)
+static OpenXrApplication * soakApplication = nullptr;
+static vector<vector<uint8_t>> soakFrames;
+static int soakOverlay = -1;
+static vector<uint8_t> soakOverlayFrame;
+static int soakVideo = -1;
+static vector<uint8_t> soakVideoFrame;
+static bool soakDepth = false;
+static bool soakFade = false;
+static vector<vector<float>> soakDepthFrames;
+static int soakSpaceWarpWidth = 0;
+static int soakSpaceWarpHeight = 0;
+static vector<float> soakMotionVectors;
+static vector<float> soakSpaceWarpDepth;
+
+static void soakRenderCallback(int numViews, XrView * views, XrViewConfigurationView * viewConfigurationViews){
+	static uint8_t counter = 0;
+	counter++;
+	// tracking-only session: there are no swapchains to fill
+	if(soakApplication->isHeadless())
+		return;
+	soakFrames.resize(numViews);
+	for(int i = 0; i < numViews; i++){
+		int width = viewConfigurationViews[i].recommendedImageRectWidth;
+		int height = viewConfigurationViews[i].recommendedImageRectHeight;
+		soakFrames[i].resize((size_t)width * height * 3);
+		memset(soakFrames[i].data(), counter, (size_t)width * 3);
+		// constant linear depth (2 meters) submitted with the frame
+		if(soakDepth){
+			soakDepthFrames.resize(numViews);
+			soakDepthFrames[i].resize((size_t)width * height, 2.0f);
+			soakApplication->setFrameByIndex(i, width, height, soakFrames[i].data(), false, soakDepthFrames[i].data(), 0.1f, 100.0f);
+		}
+		else
+			soakApplication->setFrameByIndex(i, width, height, soakFrames[i].data(), false);
+		// static scene (no motion) at 2 meters: the runtime synthesizes every other frame
+		if(soakSpaceWarpWidth)
+			soakApplication->setSpaceWarpByIndex(i, soakSpaceWarpWidth, soakSpaceWarpHeight, soakMotionVectors.data(), soakSpaceWarpWidth, soakSpaceWarpHeight, soakSpaceWarpDepth.data(), 0.1f, 100.0f);
+	}
+	// overlay content changes once every 90 frames (the other frames resubmit the uploaded image)
+	if(soakOverlay >= 0 && counter % 90 == 0){
+		std::fill(soakOverlayFrame.begin(), soakOverlayFrame.end(), counter);
+		soakApplication->setLayerImage(soakOverlay, 256, 64, soakOverlayFrame.data(), true);
+	}
+	// the views (and the overlay) are dimmed and restored by the compositor every 180 frames (no new content is uploaded for the fade)
+	static int fadeCounter = 0;
+	if(soakFade && fadeCounter++ % 180 == 0){
+		XrColor4f scale = (fadeCounter / 180) % 2 ? XrColor4f{1, 1, 1, 1} : XrColor4f{0.2f, 0.2f, 0.2f, 1};
+		soakApplication->setColorScaleBias(-1, scale, {0, 0, 0, 0}, 0.5f);
+		if(soakOverlay >= 0)
+			soakApplication->setColorScaleBias(soakOverlay, scale, {0, 0, 0, 0}, 0.5f);
+	}
+	// video frames are streamed (not copied) every frame
+	if(soakVideo >= 0){
+		memset(soakVideoFrame.data(), counter, 1024 * 3);
+		soakApplication->setLayerFrame(soakVideo, 1024, 512, soakVideoFrame.data(), false);
+	}
+}
+#endif
+
+int main(int argc, char ** argv){
+	OpenXrApplication * app = new OpenXrApplication();
+	vector<ActionState> requestedActionStates;
+	vector<ActionPoseState> requestedActionPoseStates;
+
+#ifdef APPLICATION_SOAK
+	SoakMonitor soak;
+	if(!soak.parseArguments(argc, argv))
+		return 2;
+#endif
+
+	// session record and replay: --record <path> / --replay <path> [speed]
+	string recordPath = "";
+	for(int i = 1; i < argc - 1; i++){
+		if(!strcmp(argv[i], "--record"))
+			recordPath = argv[i + 1];
+		else if(!strcmp(argv[i], "--replay"))
+			app->startReplay(argv[i + 1], i + 2 < argc ? atof(argv[i + 2]) : 0);
+	}
+	// surfaceless EGL context: --egl
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--egl"))
+			app->setEglContext(true);
+	// tracking-only session (no graphics binding): --headless
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--headless"))
+			app->setHeadless(true);
+	// desktop mirror of the first view at 15 Hz: --mirror
+	bool mirror = false;
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--mirror"))
+			mirror = true;
+	// head-locked quad layer (HUD) below the view center: --overlay
+	bool overlay = false;
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--overlay"))
+			overlay = true;
+	// 360 video (equirect layer) around the user: --video
+	bool video = false;
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--video"))
+			video = true;
+	// static cube map environment (skybox) behind the views: --cube
+	bool cube = false;
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--cube"))
+			cube = true;
+	// two context and two inner foveal views (XR_VARJO_quad_views): --quad-views
+	XrViewConfigurationType viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--quad-views"))
+			viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO;
+	// frame uploads on a worker thread: --upload-worker
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--upload-worker"))
+			app->setUploadWorker(true);
+	// setup information and startup timing: --verbose
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--verbose"))
+			app->setVerbose(true);
+	// recreate the session (or instance) when it is lost instead of exiting: --recover
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--recover"))
+			app->setSessionRecovery(true);
+	// graphics backend: --graphics <opengl|vulkan|headless>
+	int graphicsBackend = app->getGraphicsBackend();
+	for(int i = 1; i < argc - 1; i++)
+		if(!strcmp(argv[i], "--graphics")){
+			if(!strcmp(argv[i + 1], "opengl"))
+				graphicsBackend = GRAPHICS_BACKEND_OPENGL;
+			else if(!strcmp(argv[i + 1], "vulkan"))
+				graphicsBackend = GRAPHICS_BACKEND_VULKAN;
+			else if(!strcmp(argv[i + 1], "headless"))
+				graphicsBackend = GRAPHICS_BACKEND_HEADLESS;
+			if(!app->setGraphicsBackend(graphicsBackend))
+				return 2;
+		}
+
+	// create instance
+	string applicationName = "Omniverse (VR)";
+	string engineName = "OpenXR Engine";
+#ifdef APPLICATION_SOAK
+	// no validation layer: it would dominate the measured frame time
+	vector<string> requestedApiLayers = {};
+#else
+	vector<string> requestedApiLayers = { "XR_APILAYER_LUNARG_core_validation" };
+#endif
+	// the graphics extension of the fallback backend is enabled by the application in tracking-only mode
+	vector<string> requestedExtensions;
+	if(OpenXrApplication::getGraphicsExtensionName(graphicsBackend))
+		requestedExtensions.push_back(OpenXrApplication::getGraphicsExtensionName(graphicsBackend));
+	if(!app->createInstance(applicationName, engineName, requestedApiLayers, requestedExtensions))
+		return 1;
+	
+	if(!app->getSystem(XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY, XR_ENVIRONMENT_BLEND_MODE_OPAQUE, viewConfigurationType))
+		return 1;
+	if(!recordPath.empty())
+		app->startRecording(recordPath);
+	if(!app->createSession())
+		return 1;
+	if(mirror)
+		app->setMirror(true, 0, 0.5, 15);
+	int overlayLayer = -1;
+	vector<uint8_t> overlayFrame(256 * 64 * 4, 128);
+	if(overlay){
+		XrPosef pose = {{0, 0, 0, 1}, {0, -0.3f, -1}};
+		overlayLayer = app->addQuadLayer(256, 64, XR_REFERENCE_SPACE_TYPE_VIEW, pose, {0.5f, 0.125f});
+		if(overlayLayer >= 0)
+			app->setLayerImage(overlayLayer, 256, 64, overlayFrame.data(), true);
+	}
+	int videoLayer = -1;
+	vector<uint8_t> videoFrame(1024 * 512 * 3, 64);
+	if(video){
+		XrPosef pose = {{0, 0, 0, 1}, {0, 0, 0}};
+		videoLayer = app->addEquirectLayer(1024, 512, XR_REFERENCE_SPACE_TYPE_LOCAL, pose, 0, 2 * M_PI, M_PI / 2, -M_PI / 2);
+		if(videoLayer >= 0)
+			app->setLayerImage(videoLayer, 1024, 512, videoFrame.data(), false);
+	}
+	// the environment is uploaded once (the faces +X, -X, +Y, -Y, +Z, -Z are stacked vertically)
+	if(cube){
+		int cubeLayer = app->addCubeLayer(256, XR_REFERENCE_SPACE_TYPE_LOCAL, {0, 0, 0, 1});
+		vector<uint8_t> cubeFaces(256 * 256 * 6 * 3);
+		for(size_t face = 0; face < 6; face++)
+			std::fill(cubeFaces.begin() + face * 256 * 256 * 3, cubeFaces.begin() + (face + 1) * 256 * 256 * 3, 40 * (face + 1));
+		if(cubeLayer >= 0)
+			app->setLayerImage(cubeLayer, 256, 256 * 6, cubeFaces.data(), false);
+	}
+
+	bool exitRenderLoop = false;
+
+#ifdef APPLICATION_SOAK
+	soakApplication = app;
+	soakOverlay = overlayLayer;
+	soakOverlayFrame = overlayFrame;
+	soakVideo = videoLayer;
+	soakVideoFrame = videoFrame;
+	// per-view depth submitted with the frames (XR_KHR_composition_layer_depth): --depth
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--depth"))
+			soakDepth = true;
+	// compositor-side dimming (XR_KHR_composition_layer_color_scale_bias): --fade
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--fade"))
+			soakFade = true;
+	// application space warp (XR_FB_space_warp): --space-warp
+	for(int i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "--space-warp") && app->setSpaceWarp(true) && app->getSpaceWarpResolution(&soakSpaceWarpWidth, &soakSpaceWarpHeight)){
+			soakMotionVectors.resize((size_t)soakSpaceWarpWidth * soakSpaceWarpHeight * 4, 0.0f);
+			soakSpaceWarpDepth.resize((size_t)soakSpaceWarpWidth * soakSpaceWarpHeight, 2.0f);
+		}
+	// display refresh rate that is a multiple of the simulation rate (XR_FB_display_refresh_rate): --simulation-rate <Hz>
+	for(int i = 1; i < argc - 1; i++)
+		if(!strcmp(argv[i], "--simulation-rate")){
+			float displayRefreshRate = 0;
+			if(app->matchDisplayRefreshRate(atof(argv[i + 1]), &displayRefreshRate))
+				std::cout << "Display refresh rate: " << displayRefreshRate << " Hz" << std::endl;
+		}
+	// reprojection mode hint (XR_MSFT_composition_layer_reprojection): --reprojection <depth|planar|plane|orientation>
+	// (planar: stabilization plane facing the views 2 meters ahead, the distance of the soak scene. plane: the same plane with the runtime default mode)
+	for(int i = 1; i < argc - 1; i++)
+		if(!strcmp(argv[i], "--reprojection")){
+			if(!strcmp(argv[i + 1], "depth"))
+				app->setReprojectionMode(XR_REPROJECTION_MODE_DEPTH_MSFT);
+			else if(!strcmp(argv[i + 1], "planar") && app->setReprojectionMode(XR_REPROJECTION_MODE_PLANAR_MANUAL_MSFT))
+				app->setReprojectionPlane(true, {0, 0, -2}, {0, 0, 1}, {0, 0, 0});
+			else if(!strcmp(argv[i + 1], "plane"))
+				app->setReprojectionPlane(true, {0, 0, -2}, {0, 0, 1}, {0, 0, 0});
+			else if(!strcmp(argv[i + 1], "orientation"))
+				app->setReprojectionMode(XR_REPROJECTION_MODE_ORIENTATION_ONLY_MSFT);
+		}
+	app->setRenderCallbackFromPointer(soakRenderCallback);
+	soak.start(app);
+	auto frameStart = std::chrono::steady_clock::now();
+#endif
+
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+	SDL_Event sdl_event;
+#endif
+
+	while(!exitRenderLoop){
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+		while(SDL_PollEvent(&sdl_event))
+			if (sdl_event.type == SDL_QUIT || (sdl_event.type == SDL_KEYDOWN && sdl_event.key.keysym.sym == SDLK_ESCAPE))
+				exitRenderLoop = true;
+#endif
+
+		app->pollEvents(&exitRenderLoop);
+		if(exitRenderLoop)
+			break;
+
+		if(app->isSessionRunning()){
+			requestedActionStates.clear();
+			requestedActionPoseStates.clear();
+			app->pollActions(requestedActionStates);
+			app->renderViews(XR_REFERENCE_SPACE_TYPE_LOCAL, requestedActionPoseStates);
+		}
+		else{
+			// Throttle loop since xrWaitFrame won't be called.
+			// std::this_thread::sleep_for(std::chrono::milliseconds(250));
+		}
+
+#ifdef APPLICATION_SOAK
+		auto frameEnd = std::chrono::steady_clock::now();
+		if(!soak.update(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count()))
+			break;
+		frameStart = frameEnd;
+#endif
+	}
+
+#ifdef APPLICATION_SOAK
+	bool soakStatus = soak.report();
+	app->destroy();
+	delete app;
+	return soakStatus ? 0 : 1;
+#else
+	app->destroy();
+	delete app;
+	return 0;
+#endif
+}
@@ -0,0 +1,228 @@
+// graphics backend comparison benchmark: the same frame loop (synthetic frames) is run for each selected graphics backend
+// (one OpenXR application per backend, created and destroyed in sequence) and the frame loop iteration and CPU times are reported
+
+#include "xr.h"
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+using namespace std;
+
+struct BenchmarkOptions{
+	vector<int> backends;
+	double duration = 10;			// seconds (per backend)
+	double warmup = 2;				// seconds (per backend, not measured)
+	double startTimeout = 10;		// seconds to wait for the session to run
+	bool egl = false;
+	bool uploadWorker = false;
+};
+
+struct BenchmarkResult{
+	int requestedBackend;
+	int backend = -1;				// backend actually used (e.g. tracking-only session not supported by the runtime)
+	bool status = false;
+	size_t frames = 0;
+	double mean = 0;				// ms
+	double p50 = 0;					// ms
+	double p99 = 0;					// ms
+	double cpu = 0;					// CPU time per frame (ms, all threads)
+};
+
+static const char * backendName(int backend){
+	if(backend == GRAPHICS_BACKEND_OPENGL)
+		return "opengl";
+	if(backend == GRAPHICS_BACKEND_VULKAN)
+		return "vulkan";
+	if(backend == GRAPHICS_BACKEND_HEADLESS)
+		return "headless";
+	return "none";
+}
+
+static double processCpuTime(){
+	timespec time;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+	return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+static double percentile(vector<double> values, double p){
+	if(values.empty())
+		return 0;
+	size_t index = std::min(values.size() - 1, (size_t)(p * values.size()));
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+// synthetic frames (persistent buffers, only the first row changes every frame)
+static OpenXrApplication * benchmarkApplication = nullptr;
+static vector<vector<uint8_t>> benchmarkFrames;
+
+static void benchmarkRenderCallback(int numViews, XrView * views, XrViewConfigurationView * viewConfigurationViews){
+	static uint8_t counter = 0;
+	counter++;
+	benchmarkFrames.resize(numViews);
+	for(int i = 0; i < numViews; i++){
+		int width = viewConfigurationViews[i].recommendedImageRectWidth;
+		int height = viewConfigurationViews[i].recommendedImageRectHeight;
+		benchmarkFrames[i].resize((size_t)width * height * 3);
+		memset(benchmarkFrames[i].data(), counter, (size_t)width * 3);
+		benchmarkApplication->setFrameByIndex(i, width, height, benchmarkFrames[i].data(), false);
+	}
+}
+
+static bool parseArguments(int argc, char ** argv, BenchmarkOptions & options){
+	for(int i = 1; i < argc; i++){
+		if(!strcmp(argv[i], "--egl"))
+			options.egl = true;
+		else if(!strcmp(argv[i], "--upload-worker"))
+			options.uploadWorker = true;
+		else if(i + 1 < argc && !strcmp(argv[i], "--duration"))
+			options.duration = atof(argv[++i]);
+		else if(i + 1 < argc && !strcmp(argv[i], "--warmup"))
+			options.warmup = atof(argv[++i]);
+		else if(i + 1 < argc && !strcmp(argv[i], "--graphics")){
+			// comma-separated list of backends (e.g. opengl,vulkan,headless)
+			string list = argv[++i];
+			size_t start = 0;
+			while(start <= list.size()){
+				size_t end = list.find(',', start);
+				string name = list.substr(start, end == string::npos ? string::npos : end - start);
+				if(name == "opengl")
+					options.backends.push_back(GRAPHICS_BACKEND_OPENGL);
+				else if(name == "vulkan")
+					options.backends.push_back(GRAPHICS_BACKEND_VULKAN);
+				else if(name == "headless")
+					options.backends.push_back(GRAPHICS_BACKEND_HEADLESS);
+				else{
+					std::cout << "[ERROR] Invalid graphics backend: " << name << std::endl;
+					return false;
+				}
+				if(end == string::npos)
+					break;
+				start = end + 1;
+			}
+		}
+	}
+	// all the backends compiled in the library
+	if(options.backends.empty())
+		for(int backend = GRAPHICS_BACKEND_OPENGL; backend <= GRAPHICS_BACKEND_HEADLESS; backend++)
+			if(OpenXrApplication::isGraphicsBackendAvailable(backend))
+				options.backends.push_back(backend);
+	return options.duration > 0 && options.warmup >= 0;
+}
+
+static BenchmarkResult runBackend(const BenchmarkOptions & options, int backend){
+	BenchmarkResult result;
+	result.requestedBackend = backend;
+
+	OpenXrApplication * app = new OpenXrApplication();
+	benchmarkApplication = app;
+	app->setEglContext(options.egl);
+	app->setUploadWorker(options.uploadWorker);
+	if(!app->setGraphicsBackend(backend)){
+		delete app;
+		return result;
+	}
+
+	vector<string> requestedExtensions;
+	if(OpenXrApplication::getGraphicsExtensionName(backend))
+		requestedExtensions.push_back(OpenXrApplication::getGraphicsExtensionName(backend));
+
+	if(!app->createInstance("Omniverse (benchmark)", "OpenXR Engine", {}, requestedExtensions) ||
+	   !app->getSystem(XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY, XR_ENVIRONMENT_BLEND_MODE_OPAQUE, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) ||
+	   !app->createSession()){
+		app->destroy();
+		delete app;
+		return result;
+	}
+	result.backend = app->getGraphicsBackend();
+	app->setRenderCallbackFromPointer(benchmarkRenderCallback);
+
+	vector<ActionState> actionStates;
+	vector<ActionPoseState> actionPoseStates;
+	vector<double> frameTimes;
+	bool exitLoop = false;
+	bool measuring = false;
+	double cpuStart = 0;
+
+	auto created = std::chrono::steady_clock::now();
+	auto start = created;
+	auto frameStart = start;
+	while(!exitLoop){
+		app->pollEvents(&exitLoop);
+		if(exitLoop)
+			break;
+
+		auto now = std::chrono::steady_clock::now();
+		if(!app->isSessionRunning()){
+			if(std::chrono::duration<double>(now - created).count() > options.startTimeout){
+				std::cout << "[ERROR] The session is not running (" << backendName(backend) << ")" << std::endl;
+				break;
+			}
+			start = frameStart = now;
+			continue;
+		}
+
+		actionStates.clear();
+		actionPoseStates.clear();
+		app->pollActions(actionStates);
+		if(!app->renderViews(XR_REFERENCE_SPACE_TYPE_LOCAL, actionPoseStates))
+			break;
+
+		auto frameEnd = std::chrono::steady_clock::now();
+		double elapsed = std::chrono::duration<double>(frameEnd - start).count();
+		if(!measuring && elapsed >= options.warmup){
+			measuring = true;
+			cpuStart = processCpuTime();
+		}
+		else if(measuring)
+			frameTimes.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+		frameStart = frameEnd;
+		if(elapsed >= options.warmup + options.duration)
+			break;
+	}
+
+	if(frameTimes.size()){
+		double total = 0;
+		for(size_t i = 0; i < frameTimes.size(); i++)
+			total += frameTimes[i];
+		result.status = true;
+		result.frames = frameTimes.size();
+		result.mean = total / frameTimes.size();
+		result.p50 = percentile(frameTimes, 0.50);
+		result.p99 = percentile(frameTimes, 0.99);
+		result.cpu = (processCpuTime() - cpuStart) / frameTimes.size();
+	}
+
+	app->destroy();
+	delete app;
+	benchmarkApplication = nullptr;
+	return result;
+}
+
+int main(int argc, char ** argv){
+	BenchmarkOptions options;
+	if(!parseArguments(argc, argv, options))
+		return 2;
+
+	vector<BenchmarkResult> results;
+	for(size_t i = 0; i < options.backends.size(); i++){
+		std::cout << "Benchmarking graphics backend: " << backendName(options.backends[i]) << std::endl;
+		results.push_back(runBackend(options, options.backends[i]));
+	}
+
+	bool status = true;
+	printf("\n%-10s %-10s %10s %10s %10s %10s %12s\n", "backend", "used", "frames", "mean (ms)", "p50 (ms)", "p99 (ms)", "cpu (ms/fr)");
+	for(size_t i = 0; i < results.size(); i++){
+		const BenchmarkResult & result = results[i];
+		if(!result.status){
+			printf("%-10s %-10s %10s\n", backendName(result.requestedBackend), backendName(result.backend), "failed");
+			status = false;
+			continue;
+		}
+		printf("%-10s %-10s %10zu %10.3f %10.3f %10.3f %12.3f\n", backendName(result.requestedBackend), backendName(result.backend),
+			   result.frames, result.mean, result.p50, result.p99, result.cpu);
+	}
+	return status ? 0 : 1;
+}
@@ -0,0 +1,324 @@
+// C interface of the OpenXR application library (loaded from Python using ctypes)
+
+#include "xr.h"
+using namespace std;
+
+extern "C"
+{
+    OpenXrApplication * openXrApplication(){ 
+		return new OpenXrApplication(); 
+	}
+    bool destroy(OpenXrApplication * app){ 
+		return app->destroy(); 
+	}
+
+	// utils
+    bool isSessionRunning(OpenXrApplication * app){ 
+		return app->isSessionRunning(); 
+	}
+	bool getViewConfigurationViews(OpenXrApplication * app, XrViewConfigurationView * views, int viewsLength){
+		if((size_t)viewsLength != app->getViewConfigurationViewsSize())
+			return false;
+		vector<XrViewConfigurationView> viewConfigurationView = app->getViewConfigurationViews();
+		for(size_t i = 0; i < viewConfigurationView.size(); i++)
+			views[i] = viewConfigurationView[i];
+		return true;
+	}
+	int getViewConfigurationViewsSize(OpenXrApplication * app){ 
+		return app->getViewConfigurationViewsSize(); 
+	}
+
+	// logging
+	void setLogLevel(OpenXrApplication * app, int level){
+		app->setLogLevel(level);
+	}
+	void setLogRateLimit(OpenXrApplication * app, int milliseconds){
+		app->setLogRateLimit(milliseconds);
+	}
+	void setLogCallback(OpenXrApplication * app, void (*callback)(int, const char *)){
+		app->setLogCallbackFromPointer(callback);
+	}
+	void setDebugUtils(OpenXrApplication * app, bool enable){
+		app->setDebugUtils(enable);
+	}
+	void setEglContext(OpenXrApplication * app, bool enable){
+		app->setEglContext(enable);
+	}
+	void setHeadless(OpenXrApplication * app, bool enable){
+		app->setHeadless(enable);
+	}
+	bool isHeadless(OpenXrApplication * app){
+		return app->isHeadless();
+	}
+	bool setGraphicsBackend(OpenXrApplication * app, int backend){
+		return app->setGraphicsBackend(backend);
+	}
+	int getGraphicsBackend(OpenXrApplication * app){
+		return app->getGraphicsBackend();
+	}
+	bool isGraphicsBackendAvailable(int backend){
+		return OpenXrApplication::isGraphicsBackendAvailable(backend);
+	}
+	bool setMirror(OpenXrApplication * app, bool enable, int view, float scale, float rate){
+		return app->setMirror(enable, view, scale, rate);
+	}
+	void setUploadWorker(OpenXrApplication * app, bool enable){
+		app->setUploadWorker(enable);
+	}
+
+	// startup
+	void setVerbose(OpenXrApplication * app, bool enable){
+		app->setVerbose(enable);
+	}
+	int getStartupTiming(OpenXrApplication * app, double * timing, int timingLength){
+		vector<double> startupTiming = app->getStartupTiming();
+		int length = std::min((int)startupTiming.size(), timingLength);
+		for(int i = 0; i < length; i++)
+			timing[i] = startupTiming[i];
+		return length;
+	}
+
+	// session recovery
+	void setSessionRecovery(OpenXrApplication * app, bool enable){
+		app->setSessionRecovery(enable);
+	}
+	bool isRecovering(OpenXrApplication * app){
+		return app->isRecovering();
+	}
+	void getRecoveryMetrics(OpenXrApplication * app, double * time, int * count){
+		*time = app->getRecoveryTime();
+		*count = app->getRecoveryCount();
+	}
+
+	// session record and replay
+	bool startRecording(OpenXrApplication * app, const char * path){
+		return app->startRecording(path);
+	}
+	void stopRecording(OpenXrApplication * app){
+		app->stopRecording();
+	}
+	bool startReplay(OpenXrApplication * app, const char * path, float speed){
+		return app->startReplay(path, speed);
+	}
+	bool isReplaying(OpenXrApplication * app){
+		return app->isReplaying();
+	}
+
+    // setup app
+	bool createInstance(OpenXrApplication * app, const char * applicationName, const char * engineName, const char ** apiLayers, int apiLayersLength, const char ** extensions, int extensionsLength){
+		vector<string> requestedApiLayers;
+		for(int i = 0; i < apiLayersLength; i++)
+			requestedApiLayers.push_back(apiLayers[i]);
+		vector<string> requestedExtensions;
+		for(int i = 0; i < extensionsLength; i++)
+			requestedExtensions.push_back(extensions[i]);
+		return app->createInstance(applicationName, engineName, requestedApiLayers, requestedExtensions); 
+	}
+    bool getSystem(OpenXrApplication * app, int formFactor, int blendMode, int configurationType){ 
+		return app->getSystem(XrFormFactor(formFactor), XrEnvironmentBlendMode(blendMode), XrViewConfigurationType(configurationType)); 
+	}
+    bool createSession(OpenXrApplication * app){ 
+		return app->createSession(); 
+	}
+
+	// actions
+	bool addAction(OpenXrApplication * app, const char * stringPath, int actionType, int referenceSpaceType){ 
+		return app->addAction(stringPath, XrActionType(actionType), XrReferenceSpaceType(referenceSpaceType)); 
+	}
+	bool applyHapticFeedback(OpenXrApplication * app, const char * stringPath, float amplitude, int64_t duration, float frequency){ 
+		XrHapticVibration vibration = {XR_TYPE_HAPTIC_VIBRATION};
+		vibration.amplitude = amplitude;
+		vibration.duration = XrDuration(duration);
+		vibration.frequency = frequency;
+		return app->applyHapticFeedback(stringPath, (XrHapticBaseHeader*)&vibration); 
+	}
+	bool stopHapticFeedback(OpenXrApplication * app, const char * stringPath){ 
+		return app->stopHapticFeedback(stringPath); 
+	}
+
+    // poll data
+	bool pollEvents(OpenXrApplication * app, bool * exitLoop){ 
+		return app->pollEvents(exitLoop); 
+	}
+    bool pollActions(OpenXrApplication * app, ActionState * actionStates, int actionStatesLength){
+		vector<ActionState> requestedActionStates;
+		bool status = app->pollActions(requestedActionStates);
+		if(requestedActionStates.size() <= actionStatesLength)
+			for(size_t i = 0; i < requestedActionStates.size(); i++)
+				actionStates[i] = requestedActionStates[i];
+		return status;
+	}
+
+	// render
+    bool renderViews(OpenXrApplication * app, int referenceSpaceType, ActionPoseState * actionPoseStates, int actionPoseStatesLength){ 
+		vector<ActionPoseState> requestedActionPoseStates;
+		bool status = app->renderViews(XrReferenceSpaceType(referenceSpaceType), requestedActionPoseStates);
+		if(requestedActionPoseStates.size() <= actionPoseStatesLength)
+			for(size_t i = 0; i < requestedActionPoseStates.size(); i++)
+				actionPoseStates[i] = requestedActionPoseStates[i];
+		return status;
+	}
+
+	// performance settings
+	bool setPerformanceLevel(OpenXrApplication * app, int domain, int level){
+		return app->setPerformanceLevel(XrPerfSettingsDomainEXT(domain), XrPerfSettingsLevelEXT(level));
+	}
+	bool getThermalTemperatureTrend(OpenXrApplication * app, int domain, int * notificationLevel, float * tempHeadroom, float * tempSlope){
+		XrPerfSettingsNotificationLevelEXT level = XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT;
+		bool status = app->getThermalTemperatureTrend(XrPerfSettingsDomainEXT(domain), &level, tempHeadroom, tempSlope);
+		*notificationLevel = level;
+		return status;
+	}
+	void setPerfSettingsCallback(OpenXrApplication * app, void (*callback)(int, int, int, int)){
+		app->setPerfSettingsCallbackFromPointer(callback);
+	}
+
+	// display refresh rate
+	bool getDisplayRefreshRates(OpenXrApplication * app, float * rates, int capacity, int * count){
+		std::vector<float> displayRefreshRates;
+		bool status = app->getDisplayRefreshRates(displayRefreshRates);
+		*count = displayRefreshRates.size();
+		// two-call idiom: the rates are only copied when the buffer is big enough
+		if(status && rates && capacity >= *count)
+			std::copy(displayRefreshRates.begin(), displayRefreshRates.end(), rates);
+		return status;
+	}
+	bool getDisplayRefreshRate(OpenXrApplication * app, float * rate){
+		return app->getDisplayRefreshRate(rate);
+	}
+	bool requestDisplayRefreshRate(OpenXrApplication * app, float rate){
+		return app->requestDisplayRefreshRate(rate);
+	}
+	bool matchDisplayRefreshRate(OpenXrApplication * app, float simulationRate, float * rate){
+		return app->matchDisplayRefreshRate(simulationRate, rate);
+	}
+	void setDisplayRefreshRateCallback(OpenXrApplication * app, void (*callback)(float, float)){
+		app->setDisplayRefreshRateCallbackFromPointer(callback);
+	}
+
+	// render utilities
+	void setRenderCallback(OpenXrApplication * app, void (*callback)(int, XrView*, XrViewConfigurationView*)){ 
+		app->setRenderCallbackFromPointer(callback); 
+	}
+	bool setFrames(OpenXrApplication * app, int leftWidth, int leftHeight, void * leftData, int rightWidth, int rightHeight, void * rightData, bool rgba){
+		if(app->getViewConfigurationViewsSize() == 1)
+			return app->setFrameByIndex(0, leftWidth, leftHeight, leftData, rgba);
+		else if(app->getViewConfigurationViewsSize() == 2){
+			bool status = app->setFrameByIndex(0, leftWidth, leftHeight, leftData, rgba);
+			return status && app->setFrameByIndex(1, rightWidth, rightHeight, rightData, rgba);
+		}
+		return false;
+	}
+	bool setDepthFrames(OpenXrApplication * app, int leftWidth, int leftHeight, float * leftData, int rightWidth, int rightHeight, float * rightData, float nearZ, float farZ){
+		if(app->getViewConfigurationViewsSize() == 1)
+			return app->setDepthByIndex(0, leftWidth, leftHeight, leftData, nearZ, farZ);
+		else if(app->getViewConfigurationViewsSize() == 2){
+			bool status = app->setDepthByIndex(0, leftWidth, leftHeight, leftData, nearZ, farZ);
+			return status && app->setDepthByIndex(1, rightWidth, rightHeight, rightData, nearZ, farZ);
+		}
+		return false;
+	}
+	// any view configuration (e.g. quad views): one frame (nullptr: not rendered) or depth (nullptr: no depth) per view
+	bool setViewFrames(OpenXrApplication * app, int count, int * widths, int * heights, void ** data, bool rgba){
+		if(count != app->getViewConfigurationViewsSize())
+			return false;
+		bool status = true;
+		for(int i = 0; i < count; i++)
+			status = app->setFrameByIndex(i, widths[i], heights[i], data[i], rgba) && status;
+		return status;
+	}
+	bool setViewDepthFrames(OpenXrApplication * app, int count, int * widths, int * heights, float ** data, float nearZ, float farZ){
+		if(count != app->getViewConfigurationViewsSize())
+			return false;
+		bool status = true;
+		for(int i = 0; i < count; i++)
+			status = app->setDepthByIndex(i, widths[i], heights[i], data[i], nearZ, farZ) && status;
+		return status;
+	}
+
+
+	// application space warp
+	bool setSpaceWarp(OpenXrApplication * app, bool enable){
+		return app->setSpaceWarp(enable);
+	}
+	bool isSpaceWarpActive(OpenXrApplication * app){
+		return app->isSpaceWarpActive();
+	}
+	bool getSpaceWarpResolution(OpenXrApplication * app, int * width, int * height){
+		return app->getSpaceWarpResolution(width, height);
+	}
+	// any view configuration: motion vectors and depth per view (nullptr: no space warp)
+	bool setViewSpaceWarpFrames(OpenXrApplication * app, int count, int * widths, int * heights, float ** motionVectors, int * depthWidths, int * depthHeights, float ** depths, float nearZ, float farZ){
+		if(count != app->getViewConfigurationViewsSize())
+			return false;
+		bool status = true;
+		for(int i = 0; i < count; i++)
+			status = app->setSpaceWarpByIndex(i, widths[i], heights[i], motionVectors[i], depthWidths[i], depthHeights[i], depths[i], nearZ, farZ) && status;
+		return status;
+	}
+
+	// reprojection hints
+	bool getReprojectionModes(OpenXrApplication * app, int * modes, int capacity, int * count){
+		std::vector<XrReprojectionModeMSFT> reprojectionModes;
+		bool status = app->getReprojectionModes(reprojectionModes);
+		*count = reprojectionModes.size();
+		// two-call idiom: the modes are only copied when the buffer is big enough
+		if(status && modes && capacity >= *count)
+			std::copy(reprojectionModes.begin(), reprojectionModes.end(), modes);
+		return status;
+	}
+	bool setReprojectionMode(OpenXrApplication * app, int mode){
+		return app->setReprojectionMode(XrReprojectionModeMSFT(mode));
+	}
+	bool setReprojectionPlane(OpenXrApplication * app, bool enable, XrVector3f * position, XrVector3f * normal, XrVector3f * velocity){
+		return app->setReprojectionPlane(enable, *position, *normal, *velocity);
+	}
+
+	// composition layers
+	int addQuadLayer(OpenXrApplication * app, int width, int height, int referenceSpaceType, XrPosef * pose, float sizeWidth, float sizeHeight){
+		return app->addQuadLayer(width, height, XrReferenceSpaceType(referenceSpaceType), *pose, {sizeWidth, sizeHeight});
+	}
+	int addCylinderLayer(OpenXrApplication * app, int width, int height, int referenceSpaceType, XrPosef * pose, float radius, float centralAngle, float aspectRatio){
+		return app->addCylinderLayer(width, height, XrReferenceSpaceType(referenceSpaceType), *pose, radius, centralAngle, aspectRatio);
+	}
+	int addEquirectLayer(OpenXrApplication * app, int width, int height, int referenceSpaceType, XrPosef * pose, float radius, float centralHorizontalAngle, float upperVerticalAngle, float lowerVerticalAngle){
+		return app->addEquirectLayer(width, height, XrReferenceSpaceType(referenceSpaceType), *pose, radius, centralHorizontalAngle, upperVerticalAngle, lowerVerticalAngle);
+	}
+	int addCubeLayer(OpenXrApplication * app, int size, int referenceSpaceType, XrQuaternionf * orientation){
+		return app->addCubeLayer(size, XrReferenceSpaceType(referenceSpaceType), *orientation);
+	}
+	bool setLayerImage(OpenXrApplication * app, int id, int width, int height, void * data, bool rgba){
+		return app->setLayerImage(id, width, height, data, rgba);
+	}
+	bool setLayerFrame(OpenXrApplication * app, int id, int width, int height, void * data, bool rgba){
+		return app->setLayerFrame(id, width, height, data, rgba);
+	}
+	bool setLayerPose(OpenXrApplication * app, int id, int referenceSpaceType, XrPosef * pose){
+		return app->setLayerPose(id, XrReferenceSpaceType(referenceSpaceType), *pose);
+	}
+	bool setQuadLayerPose(OpenXrApplication * app, int id, int referenceSpaceType, XrPosef * pose, float sizeWidth, float sizeHeight){
+		return app->setQuadLayerPose(id, XrReferenceSpaceType(referenceSpaceType), *pose, {sizeWidth, sizeHeight});
+	}
+	bool setLayerVisible(OpenXrApplication * app, int id, bool visible){
+		return app->setLayerVisible(id, visible);
+	}
+	bool removeLayer(OpenXrApplication * app, int id){
+		return app->removeLayer(id);
+	}
+	bool setColorScaleBias(OpenXrApplication * app, int id, XrColor4f * scale, XrColor4f * bias, float duration){
+		return app->setColorScaleBias(id, *scale, *bias, duration);
+	}
+	bool getVisibilityMask(OpenXrApplication * app, int view, int type, XrVector2f * vertices, int vertexCapacity, uint32_t * indices, int indexCapacity, int * vertexCount, int * indexCount){
+		std::vector<XrVector2f> maskVertices;
+		std::vector<uint32_t> maskIndices;
+		bool status = app->getVisibilityMask(view, XrVisibilityMaskTypeKHR(type), maskVertices, maskIndices);
+		*vertexCount = maskVertices.size();
+		*indexCount = maskIndices.size();
+		// two-call idiom: the mesh is only copied when the buffers are big enough
+		if(status && vertices && indices && vertexCapacity >= *vertexCount && indexCapacity >= *indexCount){
+			std::copy(maskVertices.begin(), maskVertices.end(), vertices);
+			std::copy(maskIndices.begin(), maskIndices.end(), indices);
+		}
+		return status;
+	}
+}
@@ -0,0 +1,388 @@
+#pragma once
+
+// graphics backends of the OpenXR application library (private to xr.cpp): platform and graphics API headers, swapchains,
+// composition layers and the Vulkan, OpenGL and headless handlers. The public interface (xr.h) only forward declares them,
+// so the layout of OpenXrApplication is the same whatever graphics APIs are compiled in
+
+#define XR_USE_PLATFORM_XLIB
+
+// graphics APIs compiled in: OpenGL (unless XR_NO_GRAPHICS_API_OPENGL is given at compile time) and Vulkan 
+// (if XR_USE_GRAPHICS_API_VULKAN is given). The backend is selected at runtime among them (setGraphicsBackend)
+#ifndef XR_NO_GRAPHICS_API_OPENGL
+#ifndef XR_USE_GRAPHICS_API_OPENGL
+#define XR_USE_GRAPHICS_API_OPENGL
+#endif
+#define XR_USE_PLATFORM_EGL
+#endif
+
+// Vulkan libraries
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+#define APP_USE_VULKAN2
+#include <vulkan/vulkan.h>
+#endif
+
+// OpenGL libraries
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+#define GL_GLEXT_PROTOTYPES
+#define GL3_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <GL/glx.h>
+#include <X11/Xlib.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#ifdef XR_USE_PLATFORM_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#endif
+
+#include "xr.h"
+
+#include <openxr/openxr_platform.h>
+
+struct SwapchainHandler{
+  	XrSwapchain handle = XR_NULL_HANDLE;
+    int32_t width;
+    int32_t height;
+	uint32_t length;
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+	std::vector<XrSwapchainImageVulkan2KHR> vulkanImages;
+#endif
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+	std::vector<XrSwapchainImageOpenGLKHR> openglImages;
+#endif
+};
+
+// composition layer with its own swapchain, placed in a reference space and submitted after the projection layer: 
+// quad (overlay such as HUD or UI), cylinder (XR_KHR_composition_layer_cylinder), equirect (XR_KHR_composition_layer_equirect2, 360 video) 
+// or cube (XR_KHR_composition_layer_cube, static environment submitted behind the projection layer).
+// Images are copied when they are set and uploaded once (static content only resubmits the last released swapchain image).
+// Streamed frames (e.g. video) are not copied: they are uploaded directly from the caller's buffer in the next frame
+struct CompositionLayer{
+	XrStructureType type = XR_TYPE_COMPOSITION_LAYER_QUAD;
+	bool active = false;			// the identifier (index) is in use
+	bool visible = true;
+	bool dirty = false;				// content set and not uploaded yet
+	bool uploaded = false;			// the swapchain has a released image (the layer can be submitted)
+	XrReferenceSpaceType referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+	XrPosef pose;
+	XrExtent2Df size;				// quad: meters
+	float radius = 0;				// cylinder and equirect: meters (0: infinite)
+	float centralAngle = 0;			// cylinder and equirect: horizontal angle (radians)
+	float aspectRatio = 1;			// cylinder: width / height
+	float upperVerticalAngle = 0;	// equirect: radians
+	float lowerVerticalAngle = 0;
+	int width = 0;					// swapchain size (pixels)
+	int height = 0;
+	int frameWidth = 0;				// content size (pixels, scaled to the swapchain size)
+	int frameHeight = 0;
+	bool rgba = false;
+	std::vector<uint8_t> frameData;	// kept to upload the content again if the session is recreated
+	void * streamData = nullptr;		// streamed frame (not owned): the caller keeps the buffer alive until the next renderViews call
+	ColorFade colorFade;
+	SwapchainHandler swapchain;
+};
+
+// Vulkan graphics API
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+struct UploadSlot{
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkFence fence = VK_NULL_HANDLE;
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VkDeviceMemory bufferMemory = VK_NULL_HANDLE;
+	void * mapped = nullptr;
+	VkImage image = VK_NULL_HANDLE;
+	VkDeviceMemory imageMemory = VK_NULL_HANDLE;
+	VkFormat format = VK_FORMAT_UNDEFINED;
+	int width = 0;
+	int height = 0;
+};
+
+class VulkanHandler{
+
+private:
+	XrResult xr_result;
+	VkResult vk_result;
+	
+	VkInstance vk_instance = VK_NULL_HANDLE;
+	VkPhysicalDevice vk_physicalDevice = VK_NULL_HANDLE;
+	VkDevice vk_logicalDevice = VK_NULL_HANDLE;
+	uint32_t vk_queueFamilyIndex = 0;
+	VkQueue vk_graphicsQueue = VK_NULL_HANDLE;
+	VkCommandPool vk_cmdPool = VK_NULL_HANDLE;
+	VkPipelineCache vk_pipelineCache = VK_NULL_HANDLE;
+	VkPhysicalDeviceMemoryProperties vk_memoryProperties;
+
+	// upload ring: each slot owns a persistently mapped staging buffer, an intermediate image and a command buffer.
+	// Its fence is only waited when the slot is reused, so uploads of consecutive views and frames overlap on the GPU
+	std::vector<UploadSlot> vk_uploadRing;
+	uint32_t vk_uploadIndex = 0;
+
+	// visible area per view (XR_KHR_visibility_mask): only the visible bands are staged, copied and blitted
+	std::vector<VisibleArea> visibleAreas;
+	std::vector<VkBufferImageCopy> vk_copyRegions;
+	std::vector<VkImageBlit> vk_blitRegions;
+
+	bool getRequirements(XrInstance xr_instance, XrSystemId xr_system_id);
+	bool defineLayers(std::vector<const char*> requestedLayers, std::vector<const char*> & enabledLayers);
+	bool defineExtensions(std::vector<const char*> requestedExtensions, std::vector<const char*> & enabledExtensions);
+	bool defineDeviceExtensions(std::vector<const char*> requestedExtensions, std::vector<const char*> & enabledExtensions);
+
+	bool findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties, uint32_t * typeIndex);
+	bool resizeUploadSlot(UploadSlot &, int, int, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
+	void releaseUploadSlot(UploadSlot &);
+	UploadSlot * acquireUploadSlot();
+	bool submitUploadSlot(UploadSlot &);
+
+public:
+	VulkanHandler();
+	~VulkanHandler();
+
+	bool createInstance(XrInstance xr_instance, XrSystemId xr_system_id);
+	bool getPhysicalDevice(XrInstance xr_instance, XrSystemId xr_system_id);
+	bool createLogicalDevice(XrInstance xr_instance, XrSystemId xr_system_id);
+	bool initResources(XrInstance xr_instance, XrSystemId xr_system_id);
+	void releaseResources();
+
+	VkInstance getInstance(){ return vk_instance; }
+	VkPhysicalDevice getPhysicalDevice(){ return vk_physicalDevice; }
+	VkDevice getLogicalDevice(){ return vk_logicalDevice; }
+	uint32_t getQueueFamilyIndex(){ return vk_queueFamilyIndex; }
+
+	// no context to make current nor pipeline state to restore (kept for parity with the OpenGL frame loop)
+	void acquireContext(){};
+	void restorePipelineState(){};
+	// swapchain images are blitted directly (no per-image resources)
+	bool prepareSwapchainImages(const SwapchainHandler &, bool){ return true; };
+	void releaseSwapchainImages(const SwapchainHandler &){};
+	void renderView(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *, int64_t);
+	void renderViewFromImage(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *, int64_t, int, int, void *, bool, int view = -1);
+	void setVisibleArea(int, const std::vector<XrVector2f> &, const std::vector<uint32_t> &);
+
+	// no desktop window (kept for parity with the OpenGL frame loop)
+	void setMirror(bool enable, float, float){ if(enable) std::cout << "[WARNING] Desktop mirror is not supported by the Vulkan backend" << std::endl; };
+	void renderMirror(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *){};
+
+	// frames are already staged through the upload ring (kept for parity with the OpenGL frame loop)
+	bool startUploadWorker(int){ std::cout << "[WARNING] Upload worker is not supported by the Vulkan backend" << std::endl; return false; };
+	bool isUploadWorkerRunning(){ return false; };
+	void submitFrame(int, int, int, void *, bool){};
+	void waitUploads(){};
+	bool renderViewFromUpload(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *, int){ return false; };
+	int getFenceCount(){ return (int)vk_uploadRing.size(); };		// one fence per upload slot
+
+	uint32_t getSupportedSwapchainSampleCount(XrViewConfigurationView){ return VK_SAMPLE_COUNT_1_BIT; }
+
+	// swapchains (the frame loop is instantiated per handler)
+	static constexpr bool hasSwapchains = true;
+	const char * getExtensionName(){ return XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME; }
+	// the frames are already gamma encoded: UNORM formats store them unchanged, as the OpenGL path does
+	std::vector<int64_t> getSupportedSwapchainFormats(){ return {VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_B8G8R8A8_UNORM}; }
+	// frames are blitted into the swapchain images
+	XrSwapchainUsageFlags getSwapchainUsageFlags(){ return XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT; }
+	XrSwapchainImageBaseHeader * allocateSwapchainImages(SwapchainHandler & swapchain, uint32_t count){
+		swapchain.vulkanImages.resize(count, {XR_TYPE_SWAPCHAIN_IMAGE_VULKAN2_KHR});
+		return (XrSwapchainImageBaseHeader*)swapchain.vulkanImages.data();
+	}
+	const XrSwapchainImageBaseHeader * getSwapchainImage(const SwapchainHandler & swapchain, uint32_t index){ return (const XrSwapchainImageBaseHeader*)&swapchain.vulkanImages[index]; }
+
+	// depth swapchains (XR_KHR_composition_layer_depth): the window depth is copied into the swapchain image (depth formats are not blitted)
+	std::vector<int64_t> getSupportedDepthSwapchainFormats(){ return {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM}; }
+	XrSwapchainUsageFlags getDepthSwapchainUsageFlags(){ return XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT; }
+	void renderDepthFromImage(const XrSwapchainImageBaseHeader *, int64_t, int, int, int, int, const float *, float, float);
+
+	// motion vector swapchains (XR_FB_space_warp): the motion vectors are converted to half floats and copied into the swapchain image
+	std::vector<int64_t> getSupportedMotionVectorSwapchainFormats(){ return {VK_FORMAT_R16G16B16A16_SFLOAT}; }
+	XrSwapchainUsageFlags getMotionVectorSwapchainUsageFlags(){ return XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT; }
+	void renderMotionVectorsFromImage(const XrSwapchainImageBaseHeader *, int64_t, int, int, const float *);
+
+	// cube map swapchains (XR_KHR_composition_layer_cube): the 6 faces are copied once into the static swapchain image
+	// (the color attachment usage keeps the image layout handed over by the runtime the same as the other swapchains)
+	XrSwapchainUsageFlags getCubeSwapchainUsageFlags(){ return XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT; }
+	void renderCubeFromImages(const XrSwapchainImageBaseHeader *, int64_t, int, const void *, bool);
+};
+#endif
+
+// OpenGL graphics API
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+struct UploadTexture{
+	GLuint texture = 0;
+	int width = 0;
+	int height = 0;
+	GLsync uploadFence = nullptr;		// signaled when the upload (worker context) is complete
+	GLsync drawFence = nullptr;			// signaled when the compositor no longer samples the texture
+};
+
+struct UploadJob{
+	bool pending = false;
+	int width = 0;
+	int height = 0;
+	void * data = nullptr;
+	bool rgba = false;
+};
+
+class OpenGLHandler{
+private:
+	XrResult xr_result;
+
+	Display * xDisplay = nullptr;
+	SDL_Window * sdl_window = nullptr;
+	SDL_GLContext gl_context = nullptr;
+
+	// context ownership: the context is made current once on the thread running the frame loop.
+	// The runtime leaves it current across OpenXR calls (XR_KHR_opengl_enable), so it is not queried per call
+	std::thread::id contextOwner;
+
+	// OpenGL 4.5 direct state access objects. The program, vertex array and texture unit are bound once (initResources)
+	GLuint vao = 0;
+	GLuint program = 0;
+	GLuint texture = 0;
+	std::map<uint32_t, GLuint> swapchainFramebuffers;		// one framebuffer per swapchain image (key: swapchain image texture)
+
+	// visible area per view (XR_KHR_visibility_mask): the visible bands are uploaded and the visible triangles drawn instead of the full-view quad.
+	// The areas read by the upload worker are only modified while no upload of the view is active (upload mutex)
+	std::vector<VisibleArea> visibleAreas;
+	std::vector<GLuint> visibleAreaVertexBuffers;
+	std::vector<GLuint> visibleAreaIndexBuffers;
+
+#ifdef XR_USE_PLATFORM_EGL
+	// surfaceless (or pbuffer) EGL context, used instead of the SDL window and GLX (XR_MNDX_egl_enable)
+	EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+	EGLContext eglContext = EGL_NO_CONTEXT;
+	EGLSurface eglSurface = EGL_NO_SURFACE;
+#endif
+
+	// frame texture size (immutable storage, re-created only when the frame size changes)
+	int textureWidth = 0;
+	int textureHeight = 0;
+
+	// linear depth texture (XR_KHR_composition_layer_depth and XR_FB_space_warp), drawn into the depth swapchain images
+	GLuint depthTexture = 0;
+	int depthTextureWidth = 0;
+	int depthTextureHeight = 0;
+
+	// desktop mirror: one eye's swapchain image blitted into the SDL window at a reduced size and rate
+	bool mirrorEnabled = false;
+	bool mirrorWindowShown = false;
+	float mirrorScale = 0.5;
+	double mirrorInterval = 1.0 / 15.0;
+	std::chrono::steady_clock::time_point mirrorLastTime;
+
+	// upload worker: a second context (shared with the compositor context) owned by a thread 
+	// that uploads the frames as soon as they are set. The compositor only waits on the upload fence and draws
+	bool uploadEnabled = false;
+	bool uploadStop = false;
+	std::thread uploadThread;
+	std::mutex uploadMutex;
+	std::condition_variable uploadCondition;		// new job or stop request
+	std::condition_variable uploadDoneCondition;	// job completed
+	std::vector<UploadJob> uploadJobs;					// latest pending frame per view
+	std::vector<std::vector<UploadTexture>> uploadTextures;	// texture ring per view
+	std::vector<int> uploadPublished;					// latest uploaded texture per view (-1: none)
+	std::vector<int> uploadSampling;						// texture being drawn by the compositor per view (-1: none)
+	int uploadActive = -1;							// view whose frame is being uploaded (-1: none)
+	uint64_t uploadSubmitted = 0;
+	uint64_t uploadCompleted = 0;
+	SDL_GLContext uploadGlContext = nullptr;
+#ifdef XR_USE_PLATFORM_EGL
+	EGLConfig eglConfig = nullptr;
+	EGLContext eglUploadContext = EGL_NO_CONTEXT;
+	EGLSurface eglUploadSurface = EGL_NO_SURFACE;
+#endif
+
+	bool checkShader(GLuint);
+	bool checkProgram(GLuint);
+
+	bool compileProgram(bool);
+	std::string programCacheKey();
+	bool loadProgramBinary(const std::string &, const std::string &);
+	void saveProgramBinary(const std::string &, const std::string &);
+
+	void loadTexture(std::string, GLuint *);
+	void uploadLoop();
+	void stopUploadWorker();
+	void uploadFrame(GLuint, int, int, int, void *, bool);
+
+public:
+	OpenGLHandler();
+	~OpenGLHandler();
+
+	bool getRequirements(XrInstance xr_instance, XrSystemId xr_system_id);
+	bool initGraphicsBinding(Display** xDisplay, uint32_t* visualid, GLXFBConfig* glxFBConfig, GLXDrawable* glxDrawable, GLXContext* glxContext, int witdh, int height);
+#ifdef XR_USE_PLATFORM_EGL
+	bool initEglGraphicsBinding(XrGraphicsBindingEGLMNDX * graphicsBinding);
+#endif
+	bool initResources(XrInstance xr_instance, XrSystemId xr_system_id);
+	void releaseResources();
+
+	void acquireContext();
+	void restorePipelineState();
+	bool prepareSwapchainImages(const SwapchainHandler &, bool);
+	void releaseSwapchainImages(const SwapchainHandler &);
+	GLuint getSwapchainFramebuffer(uint32_t);
+	void renderView(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *, int64_t, int view = -1);
+	void renderViewFromImage(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *, int64_t, int, int, void *, bool, int view = -1);
+	void setVisibleArea(int, const std::vector<XrVector2f> &, const std::vector<uint32_t> &);
+
+	void setMirror(bool, float, float);
+	void renderMirror(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *);
+
+	bool startUploadWorker(int);
+	bool isUploadWorkerRunning(){ return uploadEnabled; }
+	void submitFrame(int, int, int, void *, bool);
+	void waitUploads();
+	bool renderViewFromUpload(const XrCompositionLayerProjectionView &, const XrSwapchainImageBaseHeader *, int);
+	int getFenceCount();
+
+	uint32_t getSupportedSwapchainSampleCount(XrViewConfigurationView){ return 1; }
+
+	// swapchains (the frame loop is instantiated per handler)
+	static constexpr bool hasSwapchains = true;
+	const char * getExtensionName(){ return XR_KHR_OPENGL_ENABLE_EXTENSION_NAME; }
+	std::vector<int64_t> getSupportedSwapchainFormats(){ return {GL_RGB10_A2, GL_RGBA16F, GL_RGBA8, GL_RGBA8_SNORM}; }
+	XrSwapchainUsageFlags getSwapchainUsageFlags(){ return XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT; }
+	XrSwapchainImageBaseHeader * allocateSwapchainImages(SwapchainHandler & swapchain, uint32_t count){
+		swapchain.openglImages.resize(count, {XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR});
+		return (XrSwapchainImageBaseHeader*)swapchain.openglImages.data();
+	}
+	const XrSwapchainImageBaseHeader * getSwapchainImage(const SwapchainHandler & swapchain, uint32_t index){ return (const XrSwapchainImageBaseHeader*)&swapchain.openglImages[index]; }
+
+	// depth swapchains (XR_KHR_composition_layer_depth): the linear depth is drawn into the swapchain image (converted to window depth by the fragment shader)
+	std::vector<int64_t> getSupportedDepthSwapchainFormats(){ return {GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT16}; }
+	XrSwapchainUsageFlags getDepthSwapchainUsageFlags(){ return XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT; }
+	void renderDepthFromImage(const XrSwapchainImageBaseHeader *, int64_t, int, int, int, int, const float *, float, float);
+
+	// motion vector swapchains (XR_FB_space_warp): the motion vectors are uploaded into the swapchain image
+	std::vector<int64_t> getSupportedMotionVectorSwapchainFormats(){ return {GL_RGBA16F}; }
+	XrSwapchainUsageFlags getMotionVectorSwapchainUsageFlags(){ return XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT; }
+	void renderMotionVectorsFromImage(const XrSwapchainImageBaseHeader *, int64_t, int, int, const float *);
+
+	// cube map swapchains (XR_KHR_composition_layer_cube): the 6 faces are copied once into the static swapchain image (no framebuffers)
+	XrSwapchainUsageFlags getCubeSwapchainUsageFlags(){ return XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT; }
+	void renderCubeFromImages(const XrSwapchainImageBaseHeader *, int64_t, int, const void *, bool);
+};
+#endif
+
+// tracking-only session (XR_MND_headless): no context, no graphics binding and no swapchains
+class HeadlessHandler{
+public:
+	static constexpr bool hasSwapchains = false;
+	void acquireContext(){};
+};
+
+// graphics bindings and handlers of the compiled graphics APIs (owned by OpenXrApplication)
+struct GraphicsBackends{
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+	XrGraphicsBindingVulkan2KHR vulkanBinding = {XR_TYPE_GRAPHICS_BINDING_VULKAN2_KHR};
+	VulkanHandler vulkanHandler;
+#endif
+#ifdef XR_USE_GRAPHICS_API_OPENGL
+	XrGraphicsBindingOpenGLXlibKHR openglBinding = {XR_TYPE_GRAPHICS_BINDING_OPENGL_XLIB_KHR};
+	OpenGLHandler openglHandler;
+#endif
+#ifdef XR_USE_PLATFORM_EGL
+	XrGraphicsBindingEGLMNDX eglBinding = {XR_TYPE_GRAPHICS_BINDING_EGL_MNDX};
+#endif
+	HeadlessHandler headlessHandler;
+};